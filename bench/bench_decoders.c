@@ -0,0 +1,203 @@
+/**
+ * Benchmark comparing the generic (type `switch` based) w/ the generated (per-syscall) decoders
+ *
+ * 1. Records register snapshots of a (traced) child running a small, representative workload
+ * 2. Replays these snapshots (w/o tracee) through both decoding paths, writing to `/dev/null`
+ *
+ * Since there's no tracee during replay, reads of tracee memory (`ptrace_read_string`) are
+ * replaced (via `-Wl,--wrap`) by a stub returning a canned payload
+ */
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/ptrace.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <common/error.h>
+#include <common/str_utils.h>
+#include "trace/internal/ptrace_utils.h"
+#include "trace/internal/syscalls.h"
+
+
+/* -- Consts -- */
+#define PTRACE_TRAP_INDICATOR_BIT (1 << 7)
+
+#define MAX_RECORDED_SNAPSHOTS 4096
+#define WORKLOAD_ITERATIONS    64
+#define DEFAULT_REPLAY_ROUNDS  200
+
+#define STUB_STR_MAX_LEN 200       /* Same limit as `ptrace_read_string` (when not printing complete strings) */
+
+
+/* -- Function prototypes -- */
+size_t __wrap_ptrace_read_string(pid_t tid, unsigned long addr, ssize_t bytes_to_read, char** read_str_ptr_ptr);
+
+static size_t record_snapshots(struct user_regs_struct_full *snapshots, size_t max_snapshots);
+static void run_workload(void);
+static double replay_snapshots(FILE *stream, void (*print_args)(FILE*, pid_t, struct user_regs_struct_full*),
+                               struct user_regs_struct_full *snapshots, size_t snapshots_count, long rounds);
+static size_t count_mismatches(struct user_regs_struct_full *snapshots, size_t snapshots_count);
+
+
+/* -- Functions -- */
+int main(int argc, char** argv) {
+    long rounds = DEFAULT_REPLAY_ROUNDS;
+    if (argc > 2 || (2 == argc && (-1 == str_to_long(argv[1], &rounds) || rounds <= 0))) {
+        fprintf(stderr, "Usage: %s [<replay rounds>]\n", argv[0]);
+        return 1;
+    }
+
+/* 1. Record */
+    static struct user_regs_struct_full snapshots[MAX_RECORDED_SNAPSHOTS];
+    const size_t snapshots_count = record_snapshots(snapshots, MAX_RECORDED_SNAPSHOTS);
+    if (!snapshots_count) {
+        LOG_ERROR_AND_DIE("Recorded no register snapshots");
+    }
+
+/* 2. Replay */
+    FILE *devnull = DIE_WHEN_ERRNO_VPTR( fopen("/dev/null", "w") );
+
+    const double generic_ns = replay_snapshots(devnull, syscalls_print_args_generic, snapshots, snapshots_count, rounds);
+    const double generated_ns = replay_snapshots(devnull, syscalls_print_args, snapshots, snapshots_count, rounds);
+
+    fclose(devnull);
+
+/* 3. Report */
+    const double events = (double)snapshots_count * (double)rounds;
+    printf("recorded snapshots : %zu\n", snapshots_count);
+    printf("replay rounds      : %ld\n", rounds);
+    printf("%-10s %14s %14s\n", "decoder", "ns/event", "events/s");
+    printf("%-10s %14.1f %14.0f\n", "generic", generic_ns / events, events / (generic_ns / 1e9));
+    printf("%-10s %14.1f %14.0f\n", "generated", generated_ns / events, events / (generated_ns / 1e9));
+    printf("speedup            : %.2fx\n", generic_ns / generated_ns);
+    printf("output mismatches  : %zu (expected only for syscalls w/ hand-written decoders)\n",
+           count_mismatches(snapshots, snapshots_count));
+
+    return 0;
+}
+
+
+/* - Record - */
+static size_t record_snapshots(struct user_regs_struct_full *snapshots, size_t max_snapshots) {
+    const pid_t child_pid = DIE_WHEN_ERRNO( fork() );
+    if (!child_pid) {
+        DIE_WHEN_ERRNO( ptrace(PTRACE_TRACEME) );
+        DIE_WHEN_ERRNO( kill(getpid(), SIGSTOP) );
+        run_workload();
+        _exit(0);
+    }
+
+    int status;
+    DIE_WHEN_ERRNO( waitpid(child_pid, &status, 0) );
+    DIE_WHEN_ERRNO( ptrace(PTRACE_SETOPTIONS, child_pid, 0, PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL) );
+
+    size_t snapshots_count = 0;
+    for (int pending_signal = 0; ; ) {
+        DIE_WHEN_ERRNO( ptrace(PTRACE_SYSCALL, child_pid, 0, pending_signal) );
+        DIE_WHEN_ERRNO( waitpid(child_pid, &status, 0) );
+        pending_signal = 0;
+
+        if (!WIFSTOPPED(status)) { break; }
+        if ((SIGTRAP | PTRACE_TRAP_INDICATOR_BIT) != WSTOPSIG(status)) {
+            pending_signal = WSTOPSIG(status);
+            continue;
+        }
+
+        struct user_regs_struct_full regs;
+        if (-1 == ptrace_get_regs_content(child_pid, &regs)) { break; }
+        if (!USER_REGS_STRUCT_SC_HAS_RTNED(regs) && snapshots_count < max_snapshots) {
+            snapshots[snapshots_count++] = regs;
+        }
+    }
+
+    return snapshots_count;
+}
+
+static void run_workload(void) {
+    char buf[512];
+    for (int i = 0; i < WORKLOAD_ITERATIONS; i++) {
+        const int fd = open("/proc/self/stat", O_RDONLY);
+        if (-1 != fd) {
+            if (read(fd, buf, sizeof(buf)) < 0) { /* Ignore */ }
+            close(fd);
+        }
+
+        const int null_fd = open("/dev/null", O_WRONLY);
+        if (-1 != null_fd) {
+            if (write(null_fd, "benchmark payload\n", 18) < 0) { /* Ignore */ }
+            close(null_fd);
+        }
+
+        struct stat st;
+        stat("/", &st);
+        access("/etc/passwd", R_OK);
+        getpid();
+
+        void *mem = mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED != mem) {
+            munmap(mem, 4096);
+        }
+    }
+}
+
+
+/* - Replay - */
+static double replay_snapshots(FILE *stream, void (*print_args)(FILE*, pid_t, struct user_regs_struct_full*),
+                               struct user_regs_struct_full *snapshots, size_t snapshots_count, long rounds) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (long round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < snapshots_count; i++) {
+            print_args(stream, 0, &snapshots[i]);
+        }
+    }
+    fflush(stream);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+}
+
+static size_t count_mismatches(struct user_regs_struct_full *snapshots, size_t snapshots_count) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < snapshots_count; i++) {
+        char generic_buf[4096] = { 0 }, generated_buf[4096] = { 0 };
+
+        FILE *generic_stream = DIE_WHEN_ERRNO_VPTR( fmemopen(generic_buf, sizeof(generic_buf) - 1, "w") );
+        syscalls_print_args_generic(generic_stream, 0, &snapshots[i]);
+        fclose(generic_stream);
+
+        FILE *generated_stream = DIE_WHEN_ERRNO_VPTR( fmemopen(generated_buf, sizeof(generated_buf) - 1, "w") );
+        syscalls_print_args(generated_stream, 0, &snapshots[i]);
+        fclose(generated_stream);
+
+        mismatches += !!strcmp(generic_buf, generated_buf);
+    }
+    return mismatches;
+}
+
+
+/* - Stubs - */
+size_t __wrap_ptrace_read_string(__attribute__((unused)) pid_t tid, __attribute__((unused)) unsigned long addr,
+                                 ssize_t bytes_to_read, char** read_str_ptr_ptr) {
+    static const char payload[STUB_STR_MAX_LEN + 1] =
+        "/usr/lib/x86_64-linux-gnu/libc.so.6\n\tcanned payload w/ \"quotes\" and \\backslashes\\ ...";
+
+    size_t len = (bytes_to_read >= 0) ? ((size_t)bytes_to_read) : (strlen(payload));
+    if (len > STUB_STR_MAX_LEN) {
+        len = STUB_STR_MAX_LEN;
+    }
+
+    char *read_str_ptr = DIE_WHEN_ERRNO_VPTR( malloc(len + 1) );
+    memcpy(read_str_ptr, payload, len);
+    read_str_ptr[len] = '\0';
+
+    *read_str_ptr_ptr = read_str_ptr;
+    return len;
+}
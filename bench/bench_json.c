@@ -0,0 +1,224 @@
+/**
+ * Benchmark comparing the text- w/ the JSON (`--format=json`) formatter
+ *
+ * Formats a fixed set of syscall events (once w/ mostly textual payloads (paths, short strings), once w/ binary
+ * payloads of `read` / `write`, which require escaping most bytes) repeatedly into `/dev/null`
+ *   - text: Like the ptrace backend's output (`name(args) = rval <duration>`)
+ *   - json: `json_fprint_syscall`
+ * Also checks whether all JSON lines are plain ASCII (i.e., whether escaping is complete)
+ *
+ * Since there's no tracee, reads of tracee memory (`ptrace_read_string`) are replaced (via `-Wl,--wrap`) by a
+ * stub returning a canned payload (selected by the "address")
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <common/error.h>
+#include <common/str_utils.h>
+#include "trace/internal/json.h"
+#include "trace/internal/syscalls.h"
+#include "trace/internal/timestamps.h"
+
+
+/* -- Consts -- */
+#define DEFAULT_ROUNDS 20000
+
+#define STUB_ADDR_PATH   0x1000
+#define STUB_ADDR_TEXT   0x2000
+#define STUB_ADDR_BINARY 0x3000
+
+#define STUB_BINARY_LEN 200         /* Same limit as `ptrace_read_string` (when not printing complete strings) */
+
+
+/* -- Types -- */
+typedef struct {
+    const char* name;
+    long args[SYSCALL_MAX_ARGS];
+    long rtn_val;
+} bench_event_spec_t;
+
+typedef struct {
+    const char* name;
+    syscall_event_t* events;
+    size_t events_count;
+} bench_workload_t;
+
+
+/* -- Function prototypes -- */
+size_t __wrap_ptrace_read_string(pid_t tid, unsigned long addr, ssize_t bytes_to_read, char** read_str_ptr_ptr);
+
+static size_t build_events(const bench_event_spec_t* specs, size_t specs_count, syscall_event_t* events);
+static void fprint_text(FILE* stream, const syscall_event_t* event);
+static void fprint_json(FILE* stream, const syscall_event_t* event);
+static double run(FILE* stream, void (*fprint_event)(FILE*, const syscall_event_t*), const bench_workload_t* workload, long rounds);
+static size_t output_size(void (*fprint_event)(FILE*, const syscall_event_t*), const bench_workload_t* workload, bool* ascii_only);
+
+
+/* -- Functions -- */
+int main(int argc, char** argv) {
+    long rounds = DEFAULT_ROUNDS;
+    if (argc > 2 || (2 == argc && (-1 == str_to_long(argv[1], &rounds) || rounds <= 0))) {
+        fprintf(stderr, "Usage: %s [<rounds>]\n", argv[0]);
+        return 1;
+    }
+
+/* 0. Init */
+    timestamps_init(TIMESTAMPS_NONE, false);
+    json_init(false);
+
+    static const bench_event_spec_t text_specs[] = {
+        { "openat",   { -100, STUB_ADDR_PATH, 0x80000, 0, 0, 0 }, 3 },
+        { "newfstatat", { 3, STUB_ADDR_PATH, 0x7ffc0000, 0x1000, 0, 0 }, 0 },
+        { "access",   { STUB_ADDR_PATH, 4, 0, 0, 0, 0 }, -2 },
+        { "write",    { 1, STUB_ADDR_TEXT, 18, 0, 0, 0 }, 18 },
+        { "mmap",     { 0, 4096, 3, 34, -1, 0 }, 0x7f0000001000 },
+        { "close",    { 3, 0, 0, 0, 0, 0 }, 0 },
+        { "getpid",   { 0, 0, 0, 0, 0, 0 }, 4242 },
+    };
+    static const bench_event_spec_t binary_specs[] = {
+        { "read",     { 3, STUB_ADDR_BINARY, STUB_BINARY_LEN, 0, 0, 0 }, STUB_BINARY_LEN },
+        { "write",    { 4, STUB_ADDR_BINARY, STUB_BINARY_LEN, 0, 0, 0 }, STUB_BINARY_LEN },
+    };
+    static syscall_event_t text_events[sizeof(text_specs) / sizeof(*text_specs)];
+    static syscall_event_t binary_events[sizeof(binary_specs) / sizeof(*binary_specs)];
+    const bench_workload_t workloads[] = {
+        { "text", text_events, build_events(text_specs, sizeof(text_specs) / sizeof(*text_specs), text_events) },
+        { "binary", binary_events, build_events(binary_specs, sizeof(binary_specs) / sizeof(*binary_specs), binary_events) },
+    };
+
+/* 1. Run + report */
+    FILE* const devnull = DIE_WHEN_ERRNO_VPTR( fopen("/dev/null", "w") );
+
+    printf("rounds             : %ld\n", rounds);
+    printf("%-8s %-6s %12s %14s %10s %12s\n", "payload", "format", "ns/event", "events/s", "B/event", "MB/s");
+    bool ascii_only = true;
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(*workloads); i++) {
+        const bench_workload_t* const workload = &workloads[i];
+        const double events = (double)workload->events_count * (double)rounds;
+
+        const struct { const char* name; void (*fprint_event)(FILE*, const syscall_event_t*); } formats[] = {
+            { "text", fprint_text },
+            { "json", fprint_json },
+        };
+        double text_ns = 0;
+        for (size_t j = 0; j < sizeof(formats) / sizeof(*formats); j++) {
+            bool format_ascii_only = true;
+            const double bytes_per_event = (double)output_size(formats[j].fprint_event, workload, &format_ascii_only) /
+                                           (double)workload->events_count;
+            const double ns = run(devnull, formats[j].fprint_event, workload, rounds);
+            printf("%-8s %-6s %12.1f %14.0f %10.1f %12.1f\n", workload->name, formats[j].name,
+                   ns / events, events / (ns / 1e9), bytes_per_event, bytes_per_event * events / (ns / 1e3));
+
+            if (fprint_json == formats[j].fprint_event) {
+                ascii_only &= format_ascii_only;
+                printf("%-8s json vs. text      : %.2fx\n", workload->name, ns / text_ns);
+            } else {
+                text_ns = ns;
+            }
+        }
+    }
+    printf("json is plain ASCII: %s\n", (ascii_only) ? ("yes") : ("NO"));
+
+    fclose(devnull);
+    return (ascii_only) ? (0) : (1);
+}
+
+
+static size_t build_events(const bench_event_spec_t* specs, size_t specs_count, syscall_event_t* events) {
+    for (size_t i = 0; i < specs_count; i++) {
+        memset(&events[i], 0, sizeof(events[i]));
+        if (-1 == (events[i].nr = syscalls_get_nr((char*)specs[i].name))) {
+            LOG_ERROR_AND_DIE("Unknown syscall \"%s\"", specs[i].name);
+        }
+        events[i].tid = 4242;
+        memcpy(events[i].args, specs[i].args, sizeof(events[i].args));
+        events[i].rtn_val = specs[i].rtn_val;
+        events[i].enter_ns = 1000000000ULL * (i + 1);
+        events[i].exit_ns = events[i].enter_ns + 12345;
+    }
+    return specs_count;
+}
+
+
+/* - Formatters - */
+static void fprint_text(FILE* stream, const syscall_event_t* event) {
+    fprintf(stream, "[%d] %s(", event->tid, syscalls_get_name(event->nr));
+    syscalls_fprint_args(stream, event->tid, event->nr, event->args);
+    fputs(") = ", stream);
+    syscalls_fprint_rtn_val(stream, event->rtn_val);
+    timestamps_fprint_duration(stream, event->exit_ns - event->enter_ns);
+    fputc('\n', stream);
+}
+
+static void fprint_json(FILE* stream, const syscall_event_t* event) {
+    json_fprint_syscall(stream, event->tid, event, event->exit_ns - event->enter_ns, NULL, false);
+}
+
+
+/* - Measuring - */
+static double run(FILE* stream, void (*fprint_event)(FILE*, const syscall_event_t*), const bench_workload_t* workload, long rounds) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (long round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < workload->events_count; i++) {
+            fprint_event(stream, &workload->events[i]);
+        }
+    }
+    fflush(stream);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+}
+
+static size_t output_size(void (*fprint_event)(FILE*, const syscall_event_t*), const bench_workload_t* workload, bool* ascii_only) {
+    char* output = NULL;
+    size_t output_len = 0;
+    FILE* const stream = DIE_WHEN_ERRNO_VPTR( open_memstream(&output, &output_len) );
+    for (size_t i = 0; i < workload->events_count; i++) {
+        fprint_event(stream, &workload->events[i]);
+    }
+    fclose(stream);
+
+    for (size_t i = 0; i < output_len; i++) {
+        if ((output[i] < 0x20 || output[i] > 0x7e) && '\n' != output[i]) {
+            *ascii_only = false;
+        }
+    }
+    free(output);
+    return output_len;
+}
+
+
+/* - Stubs - */
+size_t __wrap_ptrace_read_string(__attribute__((unused)) pid_t tid, unsigned long addr,
+                                 ssize_t bytes_to_read, char** read_str_ptr_ptr) {
+    static const char path_payload[] = "/usr/lib/x86_64-linux-gnu/libc.so.6";
+    static const char text_payload[] = "benchmark payload w/ \"quotes\" and \\backslashes\\\n";
+    static char binary_payload[STUB_BINARY_LEN];
+    for (size_t i = 0; i < sizeof(binary_payload); i++) {
+        binary_payload[i] = (char)(i * 7);      /* (All byte values, incl. NUL + non-ASCII) */
+    }
+
+    const char* payload;
+    size_t len;
+    switch (addr) {
+        case STUB_ADDR_PATH:   payload = path_payload; len = strlen(path_payload); break;
+        case STUB_ADDR_BINARY: payload = binary_payload; len = sizeof(binary_payload); break;
+        case STUB_ADDR_TEXT:
+        default:               payload = text_payload; len = strlen(text_payload); break;
+    }
+    if (bytes_to_read >= 0 && (size_t)bytes_to_read < len) {
+        len = (size_t)bytes_to_read;
+    }
+
+    char *read_str_ptr = DIE_WHEN_ERRNO_VPTR( malloc(len + 1) );
+    memcpy(read_str_ptr, payload, len);
+    read_str_ptr[len] = '\0';
+
+    *read_str_ptr_ptr = read_str_ptr;
+    return len;
+}
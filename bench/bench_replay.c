@@ -0,0 +1,196 @@
+/**
+ * Offline benchmark + regression harness for the text path (decoding -> formatting -> output)
+ *
+ * Replays a recording (made w/ `ministrace --record=<file> ...`) w/o tracee  (reads of tracee memory are
+ * served from the recorded words):
+ *   1. Replays once into memory and compares the produced text w/ a golden file (if given)
+ *   2. Replays repeatedly into `/dev/null`, reporting events/s and bytes/s
+ *
+ * Usage: bench_replay [--rounds <n>] [--golden <file> [--update-golden]] [--unbuffered] <recording>
+ *   `--unbuffered`: Output stream is unbuffered (like the tracer's `stderr`)
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include <common/str_utils.h>
+#include <common/time_utils.h>
+#include "trace/internal/recording.h"
+
+
+/* -- Consts -- */
+#define DEFAULT_REPLAY_ROUNDS 100
+
+
+/* -- Types -- */
+typedef struct {
+    recording_file_header_t header;
+    recorded_event_t* events;
+    size_t events_count;
+} recording_t;
+
+
+/* -- Function prototypes -- */
+static void load_recording(const char* path, recording_t* recording);
+static void replay(FILE* stream, const recording_t* recording);
+static int compare_with_golden(const char* golden_path, const char* text, size_t text_size);
+
+
+/* -- Functions -- */
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--rounds <n>] [--golden <file> [--update-golden]] [--unbuffered] <recording>\n", prog);
+}
+
+int main(int argc, char** argv) {
+    long rounds = DEFAULT_REPLAY_ROUNDS;
+    const char* golden_path = NULL;
+    bool update_golden = false;
+    bool unbuffered = false;
+
+    static const struct option long_options[] = {
+        { "rounds",        required_argument, NULL, 'r' },
+        { "golden",        required_argument, NULL, 'g' },
+        { "update-golden", no_argument,       NULL, 'u' },
+        { "unbuffered",    no_argument,       NULL, 'b' },
+        { "help",          no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    for (int opt; -1 != (opt = getopt_long(argc, argv, "", long_options, NULL)); ) {
+        switch (opt) {
+            case 'r':
+                if (-1 == str_to_long(optarg, &rounds) || rounds <= 0) {
+                    fprintf(stderr, "Invalid number of rounds \"%s\"\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'g': golden_path = optarg; break;
+            case 'u': update_golden = true; break;
+            case 'b': unbuffered = true; break;
+            case 'h':
+                usage(argv[0]);
+                return 0;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (optind != argc - 1 || (update_golden && !golden_path)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+/* 1. Load recording (into memory  -> Reading the file isn't measured) */
+    recording_t recording;
+    load_recording(argv[optind], &recording);
+    recording_mode = RECORDING_REPLAY;
+
+/* 2. Regression check: Replay once into memory + compare w/ golden file */
+    char* text = NULL;
+    size_t text_size;
+    FILE* text_stream = DIE_WHEN_ERRNO_VPTR( open_memstream(&text, &text_size) );
+    replay(text_stream, &recording);
+    fclose(text_stream);
+
+    int exit_code = 0;
+    if (golden_path) {
+        if (update_golden) {
+            FILE* golden_file = DIE_WHEN_ERRNO_VPTR( fopen(golden_path, "w") );
+            fwrite(text, 1, text_size, golden_file);
+            if (fclose(golden_file)) {
+                LOG_ERROR_AND_DIE("Couldn't write golden file \"%s\" -- %s", golden_path, strerror(errno));
+            }
+            printf("golden file        : updated (%zu bytes)\n", text_size);
+        } else {
+            exit_code = compare_with_golden(golden_path, text, text_size);
+        }
+    }
+
+/* 3. Benchmark: Replay repeatedly into `/dev/null` */
+    FILE* devnull = DIE_WHEN_ERRNO_VPTR( fopen("/dev/null", "w") );
+    if (unbuffered) {
+        setvbuf(devnull, NULL, _IONBF, 0);
+    }
+
+    const uint64_t start_ns = time_now_ns();
+    for (long round = 0; round < rounds; round++) {
+        replay(devnull, &recording);
+    }
+    fflush(devnull);
+    const double elapsed_s = (double)(time_now_ns() - start_ns) / 1e9;
+    fclose(devnull);
+
+/* 4. Report */
+    const double events = (double)recording.events_count * (double)rounds;
+    const double bytes = (double)text_size * (double)rounds;
+    printf("recorded events    : %zu\n", recording.events_count);
+    printf("output per round   : %zu bytes\n", text_size);
+    printf("replay rounds      : %ld (%s output)\n", rounds, (unbuffered) ? ("unbuffered") : ("buffered"));
+    printf("events/s           : %.0f (%.1f ns/event)\n", events / elapsed_s, elapsed_s * 1e9 / events);
+    printf("bytes/s            : %.0f (%.1f MiB/s)\n", bytes / elapsed_s, bytes / elapsed_s / (1024 * 1024));
+
+    free(text);
+    for (size_t i = 0; i < recording.events_count; i++) {
+        free(recording.events[i].memory);
+    }
+    free(recording.events);
+    return exit_code;
+}
+
+
+static void load_recording(const char* path, recording_t* recording) {
+    FILE* file;
+    if (! (file = fopen(path, "rb")) ) {
+        LOG_ERROR_AND_DIE("Couldn't open recording \"%s\" -- %s", path, strerror(errno));
+    }
+    if (-1 == recording_read_file_header(file, &recording->header)) {
+        LOG_ERROR_AND_DIE("\"%s\" isn't a recording (of this version)", path);
+    }
+
+    size_t capacity = 0;
+    recording->events = NULL;
+    recording->events_count = 0;
+    for (recorded_event_t event; -1 != recording_read_event(file, &event); ) {
+        if (recording->events_count == capacity) {
+            capacity = (capacity) ? (capacity * 2) : (1024);
+            recording->events = DIE_WHEN_ERRNO_VPTR( realloc(recording->events, capacity * sizeof(*(recording->events))) );
+        }
+        recording->events[recording->events_count++] = event;
+    }
+    fclose(file);
+
+    if (!recording->events_count) {
+        LOG_ERROR_AND_DIE("Recording \"%s\" contains no events", path);
+    }
+}
+
+static void replay(FILE* stream, const recording_t* recording) {
+    for (size_t i = 0; i < recording->events_count; i++) {
+        recording_replay_event(stream, recording->header.flags, &recording->events[i]);
+    }
+}
+
+static int compare_with_golden(const char* golden_path, const char* text, size_t text_size) {
+    FILE* golden_file;
+    if (! (golden_file = fopen(golden_path, "r")) ) {
+        LOG_ERROR_AND_DIE("Couldn't open golden file \"%s\" -- %s", golden_path, strerror(errno));
+    }
+
+    size_t offset = 0;
+    int c;
+    while (EOF != (c = fgetc(golden_file)) && offset < text_size && text[offset] == (char)c) {
+        offset++;
+    }
+    fclose(golden_file);
+
+    if (offset == text_size && EOF == c) {
+        printf("golden file        : match\n");
+        return 0;
+    }
+    printf("golden file        : MISMATCH (first difference at byte %zu)\n", offset);
+    return 1;
+}
@@ -0,0 +1,637 @@
+/**
+ * Benchmark measuring the tracer's overhead per system call (and how it scales w/ threads / processes)
+ *
+ * Each workload runs in a child (re-executing this binary as `workload <name> <iterations> <threads> <processes> <cpu>`),
+ * once untraced and once under ministrace per mode. The workload times itself (i.e., the tracer's startup isn't
+ * included) and reports `<syscalls> <elapsed ns>` via stdout, from which the overhead (ns/syscall) and the
+ * slowdown (vs. untraced) are derived.  The best of several runs is reported (as CSV or JSON on stdout).
+ *
+ * Modes which the tracer doesn't support (e.g., `-k` w/o `WITH_STACK_UNWINDING`) are skipped.
+ *
+ * W/ `--placement`, the workload is bound to one CPU and each traced mode is run once per placement of the tracer
+ * relative to it (reported as `<mode>@<placement>`): On the same core, on another core sharing the LLC, on another
+ * NUMA node, or chosen by the tracer itself (`--tracer-cpu=auto`). Placements the machine doesn't offer are skipped.
+ */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <getopt.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <common/cpu_utils.h>
+#include <common/error.h>
+#include <common/str_utils.h>
+#include <common/time_utils.h>
+
+
+/* -- Consts -- */
+#ifndef MINISTRACE_PATH
+#  define MINISTRACE_PATH "ministrace"
+#endif
+
+#define DEFAULT_ITERATIONS 20000
+#define DEFAULT_THREADS    4
+#define DEFAULT_PROCESSES  4
+#define DEFAULT_RUNS       3
+
+#define SMALL_IO_SIZE 1
+#define LARGE_IO_SIZE (32 * 1024)          /* (< Default pipe capacity  -> Single-threaded write + read won't block) */
+
+#define MAX_SELECTED 16
+
+
+/* -- Types -- */
+typedef struct {
+    long iterations;
+    long threads;
+    long processes;
+    int cpu;                            /* Workload binds itself to it (`-1` = unbound) */
+} workload_params_t;
+
+typedef struct {
+    const char* name;
+    unsigned long (*run)(const workload_params_t* params);      /* Returns nr of issued syscalls */
+} workload_t;
+
+typedef struct {
+    const char* name;
+    const char* tracer_args[5];         /* `NULL` terminated; `tracer_args[0] == NULL` = untraced */
+} bench_mode_t;
+
+typedef struct {
+    unsigned long syscalls;
+    unsigned long long elapsed_ns;
+} workload_result_t;
+
+typedef enum {
+    OUTPUT_CSV,
+    OUTPUT_JSON
+} output_format_t;
+
+typedef enum {
+    PLACEMENT_SAME_CORE,                /* Tracer on (SMT sibling of) workload's CPU */
+    PLACEMENT_SAME_LLC,                 /* Tracer on other core sharing LLC w/ workload's CPU */
+    PLACEMENT_CROSS_NODE,               /* Tracer on other NUMA node */
+    PLACEMENT_AUTO,                     /* `--tracer-cpu=auto` */
+    PLACEMENTS_COUNT
+} placement_t;
+
+
+/* -- Function prototypes -- */
+static unsigned long workload_getpid(const workload_params_t* params);
+static unsigned long workload_pipe_small(const workload_params_t* params);
+static unsigned long workload_pipe_large(const workload_params_t* params);
+static unsigned long workload_file_small(const workload_params_t* params);
+static unsigned long workload_file_large(const workload_params_t* params);
+static unsigned long workload_futex_pingpong(const workload_params_t* params);
+static unsigned long workload_fanout_threads(const workload_params_t* params);
+static unsigned long workload_fanout_processes(const workload_params_t* params);
+
+static int run_workload(const char* name, const workload_params_t* params);
+static bool run_benchmark(const char* ministrace_path, const bench_mode_t* mode, const char* tracer_cpu,
+                          const char* workload_name, const workload_params_t* params, long runs,
+                          workload_result_t* result);
+static int first_usable_cpu(void);
+static int placement_tracer_cpu(placement_t placement, int workload_cpu);
+static void print_result(output_format_t format, bool first, const char* workload_name, const char* mode_name,
+                         const workload_result_t* result, const workload_result_t* baseline);
+
+
+/* -- Globals -- */
+static const workload_t workloads[] = {
+    { "getpid",         workload_getpid },
+    { "pipe-small",     workload_pipe_small },
+    { "pipe-large",     workload_pipe_large },
+    { "file-small",     workload_file_small },
+    { "file-large",     workload_file_large },
+    { "futex-pingpong", workload_futex_pingpong },
+    { "fanout-threads", workload_fanout_threads },
+    { "fanout-procs",   workload_fanout_processes },
+};
+#define WORKLOADS_COUNT (sizeof(workloads) / sizeof(*workloads))
+
+static const bench_mode_t modes[] = {
+    { "untraced", { NULL } },
+    { "full",     { "-f", NULL } },
+    { "subset",   { "-f", "-e", "openat", NULL } },     /* Hot syscalls still stop, but aren't printed */
+    { "summary",  { "-f", "-c", NULL } },
+    { "stack",    { "-f", "-k", NULL } },
+    { "perf-summary", { "-f", "-c", "--backend=perf", NULL } },       /* (Falls back to ptrace if tracepoints aren't available) */
+    { "notif-subset", { "-e", "openat", "--backend=seccomp-notif", NULL } },     /* Hot syscalls don't leave the kernel */
+    { "zstd-output", { "-f", "-o", "/dev/null", "--compress=zstd", NULL } },    /* Compressed by writer thread */
+    { "lz4-output",  { "-f", "-o", "/dev/null", "--compress=lz4", NULL } },
+};
+#define MODES_COUNT (sizeof(modes) / sizeof(*modes))
+
+static const char* const placement_names[PLACEMENTS_COUNT] = {
+    [PLACEMENT_SAME_CORE]  = "same-core",
+    [PLACEMENT_SAME_LLC]   = "same-llc",
+    [PLACEMENT_CROSS_NODE] = "cross-node",
+    [PLACEMENT_AUTO]       = "auto",
+};
+
+
+/* -- Functions -- */
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--ministrace <path>] [--iterations <n>] [--threads <n>] [--processes <m>]\n"
+                    "       %*s [--runs <r>] [--format csv|json] [--workload <name>]... [--mode <name>]...\n"
+                    "       %*s [--placement <name>]...\n",
+            prog, (int)strlen(prog), "", (int)strlen(prog), "");
+    fputs("Workloads:", stderr);
+    for (size_t i = 0; i < WORKLOADS_COUNT; i++) { fprintf(stderr, " %s", workloads[i].name); }
+    fputs("\nModes:    ", stderr);
+    for (size_t i = 1; i < MODES_COUNT; i++) { fprintf(stderr, " %s", modes[i].name); }
+    fputs("\nPlacements:", stderr);
+    for (size_t i = 0; i < PLACEMENTS_COUNT; i++) { fprintf(stderr, " %s", placement_names[i]); }
+    fputc('\n', stderr);
+}
+
+int main(int argc, char** argv) {
+    workload_params_t params = { DEFAULT_ITERATIONS, DEFAULT_THREADS, DEFAULT_PROCESSES, -1 };
+
+/* 0. Child: Run workload */
+    if (argc == 7 && !strcmp("workload", argv[1])) {
+        long cpu = -1;
+        if (-1 == str_to_long(argv[3], &params.iterations) ||
+            -1 == str_to_long(argv[4], &params.threads) ||
+            -1 == str_to_long(argv[5], &params.processes) ||
+            (strcmp("any", argv[6]) && -1 == str_to_long(argv[6], &cpu))) {
+            LOG_ERROR_AND_DIE("Invalid workload params");
+        }
+        params.cpu = (int)cpu;
+        return run_workload(argv[2], &params);
+    }
+
+/* 1. Parse CLI args */
+    const char* ministrace_path = MINISTRACE_PATH;
+    long runs = DEFAULT_RUNS;
+    output_format_t format = OUTPUT_CSV;
+    const char* selected_workloads[MAX_SELECTED];
+    size_t selected_workloads_count = 0;
+    const char* selected_modes[MAX_SELECTED];
+    size_t selected_modes_count = 0;
+    bool selected_placements[PLACEMENTS_COUNT] = { false };
+    bool any_placement_selected = false;
+
+    static const struct option long_options[] = {
+        { "ministrace", required_argument, NULL, 'm' },
+        { "iterations", required_argument, NULL, 'i' },
+        { "threads",    required_argument, NULL, 't' },
+        { "processes",  required_argument, NULL, 'p' },
+        { "runs",       required_argument, NULL, 'r' },
+        { "format",     required_argument, NULL, 'o' },
+        { "workload",   required_argument, NULL, 'w' },
+        { "mode",       required_argument, NULL, 'M' },
+        { "placement",  required_argument, NULL, 'P' },
+        { "help",       no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    for (int opt; -1 != (opt = getopt_long(argc, argv, "", long_options, NULL)); ) {
+        long* num = NULL;
+        switch (opt) {
+            case 'm': ministrace_path = optarg; break;
+            case 'i': num = &params.iterations; break;
+            case 't': num = &params.threads; break;
+            case 'p': num = &params.processes; break;
+            case 'r': num = &runs; break;
+            case 'o':
+                if (!strcmp("csv", optarg)) {
+                    format = OUTPUT_CSV;
+                } else if (!strcmp("json", optarg)) {
+                    format = OUTPUT_JSON;
+                } else {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'w':
+            case 'M':
+            {
+                const char** const selected = ('w' == opt) ? (selected_workloads) : (selected_modes);
+                size_t* const selected_count = ('w' == opt) ? (&selected_workloads_count) : (&selected_modes_count);
+                if (*selected_count == MAX_SELECTED) {
+                    LOG_ERROR_AND_DIE("Too many workloads / modes selected");
+                }
+                selected[(*selected_count)++] = optarg;
+            }
+                break;
+            case 'P':
+            {
+                size_t placement = 0;
+                while (placement < PLACEMENTS_COUNT && strcmp(placement_names[placement], optarg)) { placement++; }
+                if (PLACEMENTS_COUNT == placement) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                selected_placements[placement] = any_placement_selected = true;
+            }
+                break;
+            case 'h':
+                usage(argv[0]);
+                return 0;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+        if (num && (-1 == str_to_long(optarg, num) || *num <= 0)) {
+            fprintf(stderr, "Invalid number \"%s\"\n", optarg);
+            return 1;
+        }
+    }
+    if (optind != argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+/* 2. Determine CPUs of tracer per placement  (relative to workload, which is bound to a single CPU) */
+    char tracer_cpus[PLACEMENTS_COUNT][32];
+    if (any_placement_selected) {
+        params.cpu = first_usable_cpu();
+        for (size_t p = 0; p < PLACEMENTS_COUNT; p++) {
+            if (!selected_placements[p]) { continue; }
+
+            if (PLACEMENT_AUTO == p) {
+                snprintf(tracer_cpus[p], sizeof(tracer_cpus[p]), "--tracer-cpu=auto");
+                continue;
+            }
+            const int tracer_cpu = placement_tracer_cpu((placement_t)p, params.cpu);
+            if (-1 == tracer_cpu) {
+                fprintf(stderr, "Skipping placement \"%s\" (not offered by this machine)\n", placement_names[p]);
+                selected_placements[p] = false;
+                continue;
+            }
+            snprintf(tracer_cpus[p], sizeof(tracer_cpus[p]), "--tracer-cpu=%d", tracer_cpu);
+        }
+    }
+
+/* 3. Run benchmarks (always incl. untraced baseline) */
+    if (OUTPUT_CSV == format) {
+        puts("workload,mode,syscalls,elapsed_ns,ns_per_syscall,overhead_ns_per_syscall,slowdown");
+    } else {
+        puts("[");
+    }
+    bool first_result = true;
+    for (size_t w = 0; w < WORKLOADS_COUNT; w++) {
+        bool workload_selected = !selected_workloads_count;
+        for (size_t i = 0; i < selected_workloads_count; i++) {
+            workload_selected |= !strcmp(selected_workloads[i], workloads[w].name);
+        }
+        if (!workload_selected) { continue; }
+
+        workload_result_t baseline;
+        if (!run_benchmark(ministrace_path, &modes[0], NULL, workloads[w].name, &params, runs, &baseline)) {
+            LOG_ERROR_AND_DIE("Workload \"%s\" failed", workloads[w].name);
+        }
+        print_result(format, first_result, workloads[w].name, modes[0].name, &baseline, &baseline);
+        first_result = false;
+
+        for (size_t m = 1; m < MODES_COUNT; m++) {
+            bool mode_selected = !selected_modes_count;
+            for (size_t i = 0; i < selected_modes_count; i++) {
+                mode_selected |= !strcmp(selected_modes[i], modes[m].name);
+            }
+            if (!mode_selected) { continue; }
+
+            for (size_t p = 0; p < ((any_placement_selected) ? (PLACEMENTS_COUNT) : (1)); p++) {
+                if (any_placement_selected && !selected_placements[p]) { continue; }
+                char mode_name[64];
+                snprintf(mode_name, sizeof(mode_name), "%s%s%s", modes[m].name,
+                         (any_placement_selected) ? ("@") : (""), (any_placement_selected) ? (placement_names[p]) : (""));
+
+                workload_result_t result;
+                if (!run_benchmark(ministrace_path, &modes[m], (any_placement_selected) ? (tracer_cpus[p]) : (NULL),
+                                   workloads[w].name, &params, runs, &result)) {
+                    fprintf(stderr, "Skipping mode \"%s\" for workload \"%s\" (not supported by tracer?)\n",
+                            mode_name, workloads[w].name);
+                    continue;
+                }
+                print_result(format, false, workloads[w].name, mode_name, &result, &baseline);
+            }
+        }
+    }
+    if (OUTPUT_JSON == format) {
+        puts("\n]");
+    }
+
+    return 0;
+}
+
+
+/* - Driver - */
+/*
+ * Runs workload `runs` times (in a child, traced according to `mode`; tracer bound according to `tracer_cpu`,
+ * if not `NULL`) and returns the fastest run
+ */
+static bool run_benchmark(const char* ministrace_path, const bench_mode_t* mode, const char* tracer_cpu,
+                          const char* workload_name, const workload_params_t* params, long runs,
+                          workload_result_t* result) {
+    char self_path[4096];
+    const ssize_t self_path_len = DIE_WHEN_ERRNO( readlink("/proc/self/exe", self_path, sizeof(self_path) - 1) );
+    self_path[self_path_len] = '\0';
+
+    char iterations_str[32], threads_str[32], processes_str[32], cpu_str[32];
+    snprintf(iterations_str, sizeof(iterations_str), "%ld", params->iterations);
+    snprintf(threads_str, sizeof(threads_str), "%ld", params->threads);
+    snprintf(processes_str, sizeof(processes_str), "%ld", params->processes);
+    if (-1 != params->cpu) {
+        snprintf(cpu_str, sizeof(cpu_str), "%d", params->cpu);
+    } else {
+        snprintf(cpu_str, sizeof(cpu_str), "any");      /* (`-1` would be parsed as option by tracer) */
+    }
+
+/* 1. Assemble command line:  [ministrace <tracer args>] <self> workload <name> <iterations> <threads> <processes> <cpu> */
+    const char* child_argv[16];
+    int child_argc = 0;
+    if (mode->tracer_args[0]) {
+        child_argv[child_argc++] = ministrace_path;
+        for (int i = 0; mode->tracer_args[i]; i++) {
+            child_argv[child_argc++] = mode->tracer_args[i];
+        }
+        if (tracer_cpu) {
+            child_argv[child_argc++] = tracer_cpu;
+        }
+    }
+    child_argv[child_argc++] = self_path;
+    child_argv[child_argc++] = "workload";
+    child_argv[child_argc++] = workload_name;
+    child_argv[child_argc++] = iterations_str;
+    child_argv[child_argc++] = threads_str;
+    child_argv[child_argc++] = processes_str;
+    child_argv[child_argc++] = cpu_str;
+    child_argv[child_argc] = NULL;
+
+    for (long run = 0; run < runs; run++) {
+/* 2. Run child  (workload's report via stdout -> pipe; tracer's output -> `/dev/null`) */
+        int report_pipe[2];
+        DIE_WHEN_ERRNO( pipe(report_pipe) );
+
+        const pid_t child_pid = DIE_WHEN_ERRNO( fork() );
+        if (!child_pid) {
+            const int devnull_fd = DIE_WHEN_ERRNO( open("/dev/null", O_WRONLY) );
+            DIE_WHEN_ERRNO( dup2(report_pipe[1], STDOUT_FILENO) );
+            DIE_WHEN_ERRNO( dup2(devnull_fd, STDERR_FILENO) );
+            close(report_pipe[0]);
+            close(report_pipe[1]);
+            close(devnull_fd);
+            execv(child_argv[0], (char* const*)child_argv);
+            _exit(127);
+        }
+        close(report_pipe[1]);
+
+        char report[128];
+        size_t report_len = 0;
+        for (ssize_t read_bytes; report_len < sizeof(report) - 1 &&
+                                 (read_bytes = read(report_pipe[0], report + report_len, sizeof(report) - 1 - report_len)) != 0; ) {
+            if (-1 == read_bytes) {
+                if (EINTR == errno) { continue; }
+                break;
+            }
+            report_len += (size_t)read_bytes;
+        }
+        report[report_len] = '\0';
+        close(report_pipe[0]);
+
+        int status;
+        DIE_WHEN_ERRNO( waitpid(child_pid, &status, 0) );
+
+/* 3. Parse report */
+        workload_result_t run_result;
+        if (!WIFEXITED(status) || 0 != WEXITSTATUS(status) ||
+            2 != sscanf(report, "%lu %llu", &run_result.syscalls, &run_result.elapsed_ns) ||
+            !run_result.syscalls) {
+            return false;
+        }
+        if (!run || run_result.elapsed_ns < result->elapsed_ns) {
+            *result = run_result;
+        }
+    }
+
+    return true;
+}
+
+static void print_result(output_format_t format, bool first, const char* workload_name, const char* mode_name,
+                         const workload_result_t* result, const workload_result_t* baseline) {
+    const double ns_per_syscall = (double)result->elapsed_ns / (double)result->syscalls;
+    const double baseline_ns_per_syscall = (double)baseline->elapsed_ns / (double)baseline->syscalls;
+    const double overhead_ns_per_syscall = ns_per_syscall - baseline_ns_per_syscall;
+    const double slowdown = ns_per_syscall / baseline_ns_per_syscall;
+
+    switch (format) {
+        case OUTPUT_CSV:
+            printf("%s,%s,%lu,%llu,%.1f,%.1f,%.2f\n", workload_name, mode_name,
+                   result->syscalls, result->elapsed_ns, ns_per_syscall, overhead_ns_per_syscall, slowdown);
+            break;
+        case OUTPUT_JSON:
+        default:
+            printf("%s  {\"workload\": \"%s\", \"mode\": \"%s\", \"syscalls\": %lu, \"elapsed_ns\": %llu, "
+                   "\"ns_per_syscall\": %.1f, \"overhead_ns_per_syscall\": %.1f, \"slowdown\": %.2f}",
+                   (first) ? ("") : (",\n"), workload_name, mode_name,
+                   result->syscalls, result->elapsed_ns, ns_per_syscall, overhead_ns_per_syscall, slowdown);
+            break;
+    }
+}
+
+
+/* - Placement - */
+static int first_usable_cpu(void) {
+    cpu_set_t cpus;
+    DIE_WHEN_ERRNO( sched_getaffinity(0, sizeof(cpus), &cpus) );
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &cpus)) { return cpu; }
+    }
+    return 0;
+}
+
+/*
+ * CPU for tracer according to `placement`, relative to `workload_cpu` (`-1` = machine doesn't offer placement)
+ */
+static int placement_tracer_cpu(placement_t placement, int workload_cpu) {
+    cpu_set_t usable_cpus;
+    DIE_WHEN_ERRNO( sched_getaffinity(0, sizeof(usable_cpus), &usable_cpus) );
+    bool core_cpus[CPU_UTILS_MAX_CPUS], llc_cpus[CPU_UTILS_MAX_CPUS];
+    if (-1 == cpu_core_siblings(workload_cpu, core_cpus) || -1 == cpu_llc_siblings(workload_cpu, llc_cpus)) {
+        return -1;
+    }
+    const int workload_node = cpu_numa_node(workload_cpu);
+
+    for (int cpu = 0; cpu < CPU_UTILS_MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &usable_cpus)) { continue; }
+
+        switch (placement) {
+            case PLACEMENT_SAME_CORE:           /* (Prefers SMT sibling, otherwise workload's CPU itself) */
+                if (cpu != workload_cpu && core_cpus[cpu]) { return cpu; }
+                break;
+            case PLACEMENT_SAME_LLC:
+                if (!core_cpus[cpu] && llc_cpus[cpu]) { return cpu; }
+                break;
+            case PLACEMENT_CROSS_NODE:
+                if (-1 != workload_node && -1 != cpu_numa_node(cpu) && workload_node != cpu_numa_node(cpu)) { return cpu; }
+                break;
+            case PLACEMENT_AUTO:
+            case PLACEMENTS_COUNT:
+            default:
+                return -1;
+        }
+    }
+    return (PLACEMENT_SAME_CORE == placement) ? (workload_cpu) : (-1);
+}
+
+
+/* - Workloads - */
+static int run_workload(const char* name, const workload_params_t* params) {
+    if (-1 != params->cpu) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(params->cpu, &cpus);
+        DIE_WHEN_ERRNO( sched_setaffinity(0, sizeof(cpus), &cpus) );
+    }
+
+    for (size_t i = 0; i < WORKLOADS_COUNT; i++) {
+        if (!strcmp(name, workloads[i].name)) {
+            const uint64_t start_ns = time_now_ns();
+            const unsigned long syscalls = workloads[i].run(params);
+            const uint64_t elapsed_ns = time_now_ns() - start_ns;
+
+            printf("%lu %llu\n", syscalls, (unsigned long long)elapsed_ns);
+            return 0;
+        }
+    }
+    fprintf(stderr, "Unknown workload \"%s\"\n", name);
+    return 1;
+}
+
+static unsigned long workload_getpid(const workload_params_t* params) {
+    for (long i = 0; i < params->iterations; i++) {
+        syscall(SYS_getpid);            /* (Bypasses any caching in libc) */
+    }
+    return (unsigned long)params->iterations;
+}
+
+static unsigned long pipe_read_write(const workload_params_t* params, size_t size) {
+    static char buf[LARGE_IO_SIZE];
+    int fds[2];
+    DIE_WHEN_ERRNO( pipe(fds) );
+
+    for (long i = 0; i < params->iterations; i++) {
+        DIE_WHEN_ERRNO( write(fds[1], buf, size) );
+        DIE_WHEN_ERRNO( read(fds[0], buf, size) );
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+    return 2 * (unsigned long)params->iterations;
+}
+
+static unsigned long workload_pipe_small(const workload_params_t* params) {
+    return pipe_read_write(params, SMALL_IO_SIZE);
+}
+
+static unsigned long workload_pipe_large(const workload_params_t* params) {
+    return pipe_read_write(params, LARGE_IO_SIZE);
+}
+
+static unsigned long file_read_write(const workload_params_t* params, size_t size) {
+    static char buf[LARGE_IO_SIZE];
+    char path[] = "/tmp/ministrace-bench-XXXXXX";
+    const int fd = DIE_WHEN_ERRNO( mkstemp(path) );
+    unlink(path);
+
+    for (long i = 0; i < params->iterations; i++) {
+        DIE_WHEN_ERRNO( pwrite(fd, buf, size, 0) );
+        DIE_WHEN_ERRNO( pread(fd, buf, size, 0) );
+    }
+
+    close(fd);
+    return 2 * (unsigned long)params->iterations;
+}
+
+static unsigned long workload_file_small(const workload_params_t* params) {
+    return file_read_write(params, SMALL_IO_SIZE);
+}
+
+static unsigned long workload_file_large(const workload_params_t* params) {
+    return file_read_write(params, LARGE_IO_SIZE);
+}
+
+
+typedef struct {
+    int* turn;                  /* Whose turn it is (`0` = ping, `1` = pong) */
+    int self;
+    long iterations;
+    unsigned long syscalls;
+} futex_player_t;
+
+static void* futex_play(void* arg) {
+    futex_player_t* const player = arg;
+
+    for (long i = 0; i < player->iterations; i++) {
+        /* Wait for own turn */
+        int turn;
+        while ((turn = __atomic_load_n(player->turn, __ATOMIC_ACQUIRE)) != player->self) {
+            syscall(SYS_futex, player->turn, FUTEX_WAIT_PRIVATE, turn, NULL, NULL, 0);
+            player->syscalls++;
+        }
+        /* Pass turn to other player */
+        __atomic_store_n(player->turn, !player->self, __ATOMIC_RELEASE);
+        syscall(SYS_futex, player->turn, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+        player->syscalls++;
+    }
+    return NULL;
+}
+
+static unsigned long workload_futex_pingpong(const workload_params_t* params) {
+    int turn = 0;
+    futex_player_t ping = { &turn, 0, params->iterations, 0 },
+                   pong = { &turn, 1, params->iterations, 0 };
+
+    pthread_t pong_thread;
+    if (pthread_create(&pong_thread, NULL, futex_play, &pong)) {
+        LOG_ERROR_AND_DIE("Couldn't create thread");
+    }
+    futex_play(&ping);
+    pthread_join(pong_thread, NULL);
+
+    return ping.syscalls + pong.syscalls;
+}
+
+
+static void* getpid_thread(void* arg) {
+    workload_getpid(arg);
+    return NULL;
+}
+
+static unsigned long workload_fanout_threads(const workload_params_t* params) {
+    pthread_t* const threads = DIE_WHEN_ERRNO_VPTR( calloc((size_t)params->threads, sizeof(*threads)) );
+    for (long i = 0; i < params->threads; i++) {
+        if (pthread_create(&threads[i], NULL, getpid_thread, (void*)params)) {
+            LOG_ERROR_AND_DIE("Couldn't create thread");
+        }
+    }
+    for (long i = 0; i < params->threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    return (unsigned long)(params->threads * params->iterations);
+}
+
+static unsigned long workload_fanout_processes(const workload_params_t* params) {
+    for (long i = 0; i < params->processes; i++) {
+        if (!DIE_WHEN_ERRNO( fork() )) {
+            workload_getpid(params);
+            _exit(0);
+        }
+    }
+    for (long i = 0; i < params->processes; i++) {
+        int status;
+        DIE_WHEN_ERRNO( wait(&status) );
+    }
+    return (unsigned long)(params->processes * params->iterations);
+}
@@ -2,6 +2,7 @@
 
 '''
 Generates header file containing information for syscalls
+(+ specialized per-syscall decoder functions & dispatch table indexed by syscall nr)
 
 TODOs: - Improve parsing for ARM (`Some syscalls have missing args`; overview: https://thog.github.io/syscalls-table-aarch64/latest.html)
        - Add exceptions for args which should be pointers (but are of type unsigned long ?), e.g., `mmap`, `mprotect`. ... ??
@@ -21,18 +22,21 @@ LINUX_SRC_PARSING_ARCH_SPECIFIC = {
         'tbl_file': "./arch/x86/entry/syscalls/syscall_64.tbl",
         'src_dirs': ['arch/x86'],
         'compat_abi': "x32",
+        'compat32_tbl_file': "./arch/x86/entry/syscalls/syscall_32.tbl",     # i386 syscalls (of 32-bit tasks); mapped onto native ones w/ same entry point
         'preprocess_src_callback': None
     },
     'i386': {
         'tbl_file': "./arch/x86/entry/syscalls/syscall_32.tbl",
         'src_dirs': ['arch/x86'],
         'compat_abi': None,              # ??
+        'compat32_tbl_file': None,
         'preprocess_src_callback': None
     },
     'aarch64': {
         'tbl_file': "./arch/arm/tools/syscall.tbl",
         'src_dirs': ['arch/arm64'],
         'compat_abi': None,              # ??
+        'compat32_tbl_file': None,
         'preprocess_src_callback': lambda code_fragment: code_fragment if "arg_u32p" not in code_fragment else
             re.sub(r"arg_u32p\((.+?)\)", r"u32, \1_lo, u32, \1_hi", code_fragment)   # Little endian seems to be most common ??
     }
@@ -41,11 +45,14 @@ LINUX_SRC_PARSING_ARCH_SPECIFIC = {
 
 # - Existing src -
 GENERATED_HEADER_INCLUDE_TYPES_HEADER = "trace/syscall_types.h"
+GENERATED_HEADER_INCLUDE_DECODERS_HEADER = "trace/syscall_decoders.h"
 
 class GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM:
     INT = "ARG_INT"
     PTR = "ARG_PTR"
     STR = "ARG_STR"
+    FD  = "ARG_FD"
+    PATH = "ARG_PATH"
 
 GENERATED_HEADER_STRUCT_ARG_ARRAY_MAX_SIZE = 6
 
@@ -53,9 +60,29 @@ GENERATED_HEADER_STRUCT_ARG_ARRAY_MAX_SIZE = 6
 # - Generated source -
 GENERATED_HEADER_SYSCALL_STRUCT_NAME = "syscall_entry_t"
 GENERATED_HEADER_SYSCALL_ARRAY_NAME = "syscalls"
+GENERATED_HEADER_COMPAT32_ARRAY_NAME = "syscalls_compat32_to_native"
+
+GENERATED_DECODER_TYPE_NAME = "syscall_decoder_t"
+GENERATED_DECODER_ARRAY_NAME = "syscall_decoders"
+GENERATED_DECODER_FCT_PREFIX = "syscall_decode_"
 
 GENERATED_SRC_FILES_DEFAULT_OUTPUT_DIR = "."
 GENERATED_SRC_FILENAME = 'syscallents'
+GENERATED_DECODERS_SRC_FILENAME = 'syscalldecoders'
+
+
+# - Decoder specifics -
+# String args whose length is given by another arg (i.e., arbitrary binary data which isn't NUL-terminated)
+#   Format: <syscall name>: (<str arg idx>, <len arg idx>)
+DECODER_STR_ARG_LEN_FROM_ARG = {
+    'read':  (1, 2),
+    'write': (1, 2),
+}
+
+DECODER_C_FORMAT_BY_ARG_TYPE = {
+    GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.INT: ("%ld", "args[{}]"),
+    GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.PTR: ("0x%lx", "(unsigned long)args[{}]"),
+}
 
 
 
@@ -88,7 +115,7 @@ class SRCFoundSyscallFragment:
 class SRCParsedFoundSyscallFragment:
     def __init__(self, found_code_fragment: SRCFoundSyscallFragment, parsed_args: list):
         self.found_code_fragment = found_code_fragment
-        self.parsed_args = parsed_args
+        self.parsed_args = parsed_args          # List of `(<type>, <name>)` tuples
 
 
 
@@ -105,6 +132,11 @@ def parse_syscalls_name_and_nr_from_tbl(tbl_file: str) -> dict:
 
 
 
+def normalize_entry_point(entry_point: str) -> str:
+    entry_point = entry_point.split()[0]                # (Entry point may be followed by compat entry point)
+    return re.sub(r'^__(x64|ia32)_', '', entry_point)   # (Kernels 4.17 - 5.x prefix entry points w/ their ABI)
+
+
 def find_and_parse_syscalls_args_from_src(linux_src_dir: str, arch_specific_src_dirs: list, preprocess_src_callback: Callable) -> dict:
     syscalls_args = {}
 
@@ -151,7 +183,7 @@ def parse_found_syscall_code_fragment(syscall_code_fragment: str) -> tuple:
             print("Unable to parse (1):", syscall_code_fragment, file=sys.stderr)
             return (None, None)
         syscall_name, args = m.groups()
-        parsed_syscall_arg_types = [s.strip().rsplit(" ", 1)[0] for s in args.split(",")]
+        parsed_syscall_arg_types = [tuple(s.strip().rsplit(" ", 1)) if " " in s.strip() else (s.strip(), None) for s in args.split(",")]
     else:
         m = re.search(r'^(?:COMPAT_)?SYSCALL_DEFINE(\d)\(([^,]+)\s*(?:,\s*([^)]+))?\)$', syscall_code_fragment)
         if not m:
@@ -160,7 +192,7 @@ def parse_found_syscall_code_fragment(syscall_code_fragment: str) -> tuple:
         nargs, syscall_name, argstr = m.groups()
         if argstr is not None:
             argspec = [s.strip() for s in argstr.split(",")]
-            parsed_syscall_arg_types = argspec[0:len(argspec):2]
+            parsed_syscall_arg_types = list(zip(argspec[0:len(argspec):2], argspec[1:len(argspec):2]))
         else:
             parsed_syscall_arg_types = []
 
@@ -172,7 +204,8 @@ def parse_found_syscall_code_fragment(syscall_code_fragment: str) -> tuple:
 def generate_src_files(kernel_version: str, cpu_arch: str,
                              arch_compat_abi: str,
                              target_dir: str, src_filename: str,
-                             syscalls_parsed_from_tbl: dict, syscalls_parsed_from_scr: dict) -> None:
+                             syscalls_parsed_from_tbl: dict, syscalls_parsed_from_scr: dict,
+                             compat32_syscalls_parsed_from_tbl: dict) -> None:
     print(f"Writing parsed syscalls to {os.path.abspath(target_dir)}")
 
     generate_syscall_macro_name = lambda name, abi: f"__SNR_{'COMPAT_' if abi == arch_compat_abi else ''}{name}"
@@ -204,6 +237,14 @@ def generate_src_files(kernel_version: str, cpu_arch: str,
 
         print("\n", file=out_header)
 
+        # - 32-bit (compat) syscalls: Nr of native syscall w/ same name -
+        if compat32_syscalls_parsed_from_tbl:
+            print("/* -- Syscalls of 32-bit tasks (mapped onto native syscall nrs; `-1` = no native equivalent) -- */", file=out_header)
+            print("#define HAVE_COMPAT32_SYSCALLS", file=out_header)
+            print(f"#define MAX_COMPAT32_SYSCALL_NUM {max(compat32_syscalls_parsed_from_tbl.keys())}\n", file=out_header)
+            print(f"extern const long {GENERATED_HEADER_COMPAT32_ARRAY_NAME}[MAX_COMPAT32_SYSCALL_NUM + 1];", file=out_header)
+            print("\n", file=out_header)
+
         # - End of header file (guard) -
         print(f"#endif /* {header_guard_name} */", file=out_header)
 
@@ -228,7 +269,7 @@ def generate_src_files(kernel_version: str, cpu_arch: str,
                 parsed_syscall_args = syscalls_parsed_from_scr[syscall_name].parsed_args
                 print(f"/* {syscall_code_fragment} */", file=out_cfile)
             else:
-                parsed_syscall_args = ["void*"] * GENERATED_HEADER_STRUCT_ARG_ARRAY_MAX_SIZE
+                parsed_syscall_args = [("void*", None)] * GENERATED_HEADER_STRUCT_ARG_ARRAY_MAX_SIZE
                 syscalls_with_no_parsed_args = True
                 print("/* WARNING: Found no args for syscall \"%s\", using default (all pointers) */" % (syscall_name,), file=out_cfile)
 
@@ -236,26 +277,150 @@ def generate_src_files(kernel_version: str, cpu_arch: str,
             print("    .name  = \"%s\"," % (syscall_name,), file=out_cfile)
             print("    .nargs = %d," % (len(parsed_syscall_args,)), file=out_cfile)
             out_cfile.write(   "    .args  = {")
-            out_cfile.write(", ".join([parse_syscall_arg_type(t) for t in parsed_syscall_args] + ["-1"] * (6 - len(parsed_syscall_args))))  # `-1` means N/A
+            out_cfile.write(", ".join([parse_syscall_arg_type(t, n) for (t, n) in parsed_syscall_args] + ["-1"] * (6 - len(parsed_syscall_args))))  # `-1` means N/A
             out_cfile.write("}},\n")
         print("};", file=out_cfile)
 
+        if compat32_syscalls_parsed_from_tbl:
+            # NOTE: Mapped by (kernel) entry point, NOT by name, as names may be the same while the calling convention differs
+            #       (e.g., i386's `mmap` = `sys_old_mmap`, taking a single struct ptr)  -> i386 specific syscalls (e.g., `mmap2`,
+            #       `_llseek`, `socketcall`) have no native equivalent (i.e., can't be decoded w/ the native table)
+            native_syscall_macro_names = {}
+            for native_syscall in (syscalls_parsed_from_tbl[num] for num in sorted(syscalls_parsed_from_tbl.keys())):
+                if native_syscall.abi != arch_compat_abi and native_syscall.entry_point:
+                    native_syscall_macro_names.setdefault(normalize_entry_point(native_syscall.entry_point),
+                                                          generate_syscall_macro_name(native_syscall.name, native_syscall.abi))
+            print("\n", file=out_cfile)
+            print("const long %s[MAX_COMPAT32_SYSCALL_NUM + 1] = {" % (GENERATED_HEADER_COMPAT32_ARRAY_NAME,), file=out_cfile)
+            for num in range(max(compat32_syscalls_parsed_from_tbl.keys()) + 1):
+                compat32_syscall = compat32_syscalls_parsed_from_tbl.get(num)
+                native_macro_name = native_syscall_macro_names.get(normalize_entry_point(compat32_syscall.entry_point)) if compat32_syscall and compat32_syscall.entry_point else None
+                print(f"  [{num}] = {native_macro_name if native_macro_name else '-1'},{f'   /* {compat32_syscall.name} */' if compat32_syscall else ''}", file=out_cfile)
+            print("};", file=out_cfile)
+
         if syscalls_with_no_parsed_args:
             print("WARNING: Some syscalls have missing args", file=sys.stderr)
 
 
-def parse_syscall_arg_type(arg_str: str) -> GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM:
+def generate_decoder_src_files(kernel_version: str, cpu_arch: str,
+                               arch_compat_abi: str,
+                               target_dir: str, src_filename: str, syscallents_filename: str,
+                               syscalls_parsed_from_tbl: dict, syscalls_parsed_from_scr: dict,
+                               handwritten_decoder_names: set) -> None:
+    generate_syscall_macro_name = lambda name, abi: f"__SNR_{'COMPAT_' if abi == arch_compat_abi else ''}{name}"
+    generate_decoder_fct_name = lambda name, abi: f"{GENERATED_DECODER_FCT_PREFIX}{'compat_' if abi == arch_compat_abi else ''}{name}"
+    generated_file_disclaimer = f"/*\n * Generated file (for kernel version {kernel_version} on {cpu_arch}). Do not edit manually or check in VCS.\n *\n */"
+    decoder_fct_signature = lambda fct_name: f"void {fct_name}(FILE *stream, pid_t tid, const long args[SYSCALL_MAX_ARGS])"
+
+    with open(os.path.join(target_dir, src_filename + ".h"), 'w') as out_header:
+        header_guard_name = f"{src_filename}.h".replace("-", "_").replace(".", "_").upper()
+
+        print(generated_file_disclaimer, file=out_header)
+        print("#ifndef {0}\n#define {0}\n".format(header_guard_name), file=out_header)
+
+        print(f"#include <{GENERATED_HEADER_INCLUDE_DECODERS_HEADER}>", file=out_header)
+        print(f"#include \"{syscallents_filename}.h\"\n\n", file=out_header)
+
+        # - Prototypes of hand-written decoders (overriding generated ones) -
+        print("/* -- Function prototypes -- */", file=out_header)
+        for decoder_fct_name in sorted(handwritten_decoder_names):
+            print(decoder_fct_signature(decoder_fct_name) + ";", file=out_header)
+
+        print("\n", file=out_header)
+
+        print(f"extern const {GENERATED_DECODER_TYPE_NAME} {GENERATED_DECODER_ARRAY_NAME}[SYSCALLS_ARR_SIZE];", file=out_header)
+
+        print("\n", file=out_header)
+
+        print(f"#endif /* {header_guard_name} */", file=out_header)
+
+    with open(os.path.join(target_dir, src_filename + ".c"), 'w') as out_cfile:
+        print(generated_file_disclaimer, file=out_cfile)
+
+        print(f"#include \"{src_filename}.h\"", file=out_cfile)
+
+        print("\n", file=out_cfile)
+
+        # - One specialized decoder per syscall (constant arg count + types) -
+        for num in sorted(syscalls_parsed_from_tbl.keys()):
+            syscall_name = syscalls_parsed_from_tbl[num].name
+            syscall_abi = syscalls_parsed_from_tbl[num].abi
+            decoder_fct_name = generate_decoder_fct_name(syscall_name, syscall_abi)
+
+            print(f"/* {syscalls_parsed_from_tbl[num]} */", file=out_cfile)
+            if decoder_fct_name in handwritten_decoder_names:
+                print(f"/* NOTE: Uses hand-written decoder `{decoder_fct_name}` */\n", file=out_cfile)
+                continue
+
+            if syscall_name in syscalls_parsed_from_scr:
+                parsed_syscall_args = syscalls_parsed_from_scr[syscall_name].parsed_args
+            else:
+                parsed_syscall_args = [("void*", None)] * GENERATED_HEADER_STRUCT_ARG_ARRAY_MAX_SIZE
+            parsed_syscall_arg_types = [parse_syscall_arg_type(t, n) for (t, n) in parsed_syscall_args]
+            str_arg_len = DECODER_STR_ARG_LEN_FROM_ARG.get(syscall_name)
+
+            print(f"static {decoder_fct_signature(decoder_fct_name)} {{", file=out_cfile)
+            if not parsed_syscall_arg_types:
+                print("    (void)stream; (void)args;", file=out_cfile)
+            if not {GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.STR, GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.PATH, GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.FD} & set(parsed_syscall_arg_types):
+                print("    (void)tid;", file=out_cfile)
+
+            # Consecutive non-string args (incl. separators) are merged into one `fprintf` call w/ constant format string
+            pending_fmt, pending_fmt_args = "", []
+            for arg_nr, arg_type in enumerate(parsed_syscall_arg_types):
+                separator = ", " if arg_nr > 0 else ""
+                if arg_type in (GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.STR, GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.PATH, GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.FD):
+                    pending_fmt += separator
+                    if pending_fmt:
+                        print(f"    fprintf(stream, \"{pending_fmt}\"{''.join(', ' + a for a in pending_fmt_args)});" if pending_fmt_args else
+                              f"    fputs(\"{pending_fmt}\", stream);", file=out_cfile)
+                    pending_fmt, pending_fmt_args = "", []
+                    if arg_type == GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.FD:
+                        print(f"    syscall_decoder_fprint_fd(stream, tid, args[{arg_nr}]);", file=out_cfile)
+                        continue
+                    bytes_to_read = f"args[{str_arg_len[1]}]" if str_arg_len and str_arg_len[0] == arg_nr else "-1"
+                    print(f"    syscall_decoder_fprint_str(stream, tid, args[{arg_nr}], {bytes_to_read});", file=out_cfile)
+                else:
+                    (c_fmt, c_fmt_arg) = DECODER_C_FORMAT_BY_ARG_TYPE[arg_type]
+                    pending_fmt += separator + c_fmt
+                    pending_fmt_args.append(c_fmt_arg.format(arg_nr))
+            if pending_fmt:
+                print(f"    fprintf(stream, \"{pending_fmt}\"{''.join(', ' + a for a in pending_fmt_args)});", file=out_cfile)
+            print("}\n", file=out_cfile)
+
+        print("\n", file=out_cfile)
+
+        # - Dispatch table (indexed by syscall nr) -
+        print("const %s %s[SYSCALLS_ARR_SIZE] = {" % (GENERATED_DECODER_TYPE_NAME, GENERATED_DECODER_ARRAY_NAME), file=out_cfile)
+        for num in sorted(syscalls_parsed_from_tbl.keys()):
+            syscall_name = syscalls_parsed_from_tbl[num].name
+            syscall_abi = syscalls_parsed_from_tbl[num].abi
+            print(f"  [{generate_syscall_macro_name(syscall_name, syscall_abi)}] = {generate_decoder_fct_name(syscall_name, syscall_abi)},", file=out_cfile)
+        print("};", file=out_cfile)
+
+
+def parse_handwritten_decoder_names(handwritten_decoders_src_file: str) -> set:
+    if not handwritten_decoders_src_file:
+        return set()
+    return set(re.findall(r'^void\s+(' + GENERATED_DECODER_FCT_PREFIX + r'\w+)\s*\(', open(handwritten_decoders_src_file).read(), re.MULTILINE))
+
+
+def parse_syscall_arg_type(arg_str: str, arg_name: str = None) -> GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM:
     if re.search(r'^(const\s*)?char\s*(__user\s*)?\*\s*$', arg_str):
+        if arg_name and re.search(r'^(?:\w*path|\w*filename|pathname|(?:old|new)name|dir_name|dev_name|library|specialfile)$', arg_name):     # e.g., `filename`, `pathname`, `oldpath`
+            return GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.PATH
         return GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.STR
     if arg_str.endswith('*'):
         return GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.PTR
+    if arg_name and re.search(r'^(?:\w+_)?(?:[a-z]*fd|fildes)(?:_\w+)?$', arg_name):     # e.g., `fd`, `dfd`, `oldfd`, `epfd`, `fd_in`, `out_fd`
+        return GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.FD
     return GENERATED_HEADER_STRUCT_ARG_TYPE_ENUM.INT
 # ----------------------------------------- ----------------------------------------- ----------------------------------------- -----------------------------------------
 
 
 def main(args):
-    if not args or len(args) > 2:
-        print("Usage: %s /path/to/linux_src_dir [target-dir]" % (sys.argv[0],), file=sys.stderr)
+    if not args or len(args) > 3:
+        print("Usage: %s /path/to/linux_src_dir [target-dir] [handwritten-decoders-src-file]" % (sys.argv[0],), file=sys.stderr)
         return 1
 
     _, _, kernel_version, _, cpu_arch = os.uname()
@@ -270,19 +435,34 @@ def main(args):
     arch_tbl_file = arch_spec['tbl_file']
     arch_specific_src_dirs = arch_spec['src_dirs']
     arch_compat_abi = arch_spec['compat_abi']
+    arch_compat32_tbl_file = arch_spec['compat32_tbl_file']
     arch_preprocess_src_callback = arch_spec['preprocess_src_callback']
 
 
     linux_src_dir = args[0]
     syscalls_parsed_from_tbl = parse_syscalls_name_and_nr_from_tbl(os.path.join(linux_src_dir, arch_tbl_file))
     syscalls_parsed_from_scr = find_and_parse_syscalls_args_from_src(linux_src_dir, arch_specific_src_dirs, arch_preprocess_src_callback)
+    compat32_syscalls_parsed_from_tbl = {}
+    if arch_compat32_tbl_file:
+        if os.path.isfile(os.path.join(linux_src_dir, arch_compat32_tbl_file)):
+            compat32_syscalls_parsed_from_tbl = parse_syscalls_name_and_nr_from_tbl(os.path.join(linux_src_dir, arch_compat32_tbl_file))
+        else:
+            print(f"WARNING: Found no {arch_compat32_tbl_file} (syscalls of 32-bit tasks won't be decoded)", file=sys.stderr)
 
-    target_dir = args[1] if len(args) == 2 else GENERATED_SRC_FILES_DEFAULT_OUTPUT_DIR
+    target_dir = args[1] if len(args) >= 2 else GENERATED_SRC_FILES_DEFAULT_OUTPUT_DIR
+    handwritten_decoder_names = parse_handwritten_decoder_names(args[2] if len(args) == 3 else None)
     generate_src_files(
             kernel_version, cpu_arch,
             arch_compat_abi,
             target_dir, GENERATED_SRC_FILENAME,
-            syscalls_parsed_from_tbl, syscalls_parsed_from_scr)
+            syscalls_parsed_from_tbl, syscalls_parsed_from_scr,
+            compat32_syscalls_parsed_from_tbl)
+    generate_decoder_src_files(
+            kernel_version, cpu_arch,
+            arch_compat_abi,
+            target_dir, GENERATED_DECODERS_SRC_FILENAME, GENERATED_SRC_FILENAME,
+            syscalls_parsed_from_tbl, syscalls_parsed_from_scr,
+            handwritten_decoder_names)
 
 
 if __name__ == '__main__':
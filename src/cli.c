@@ -6,14 +6,91 @@
 #include <errno.h>
 
 #include "cli.h"
+#include <common/cpu_utils.h>
 #include <common/error.h>
 #include <common/str_utils.h>
+#include "trace/internal/errnos.h"
+#include "trace/internal/filter_expr.h"
+#include "trace/tracing.h"
+#include "trace/internal/flight_recorder.h"
 #include "trace/internal/syscalls.h"
 
 
+/* -- Consts -- */
+/* Keys of options w/o short option (outside of ASCII range) */
+enum {
+    CLI_KEY_TRACE_FD = 0x100,
+    CLI_KEY_FILTER,
+    CLI_KEY_SECCOMP_BPF,
+    CLI_KEY_FLIGHT_RECORDER,
+    CLI_KEY_FLIGHT_RECORDER_TRIGGER,
+    CLI_KEY_FLIGHT_RECORDER_BINARY,
+    CLI_KEY_ESCALATE_LATENCY,
+    CLI_KEY_ESCALATE_ON,
+    CLI_KEY_ESCALATE_WINDOW,
+    CLI_KEY_SAMPLE_EVERY,
+    CLI_KEY_SAMPLE_BURST,
+    CLI_KEY_SAMPLE_THREADS,
+    CLI_KEY_OVERHEAD_BUDGET,
+    CLI_KEY_STATS,
+    CLI_KEY_RECORD,
+    CLI_KEY_CALIBRATE,
+    CLI_KEY_TRACER_CPU,
+    CLI_KEY_TRACER_AFFINITY,
+    CLI_KEY_BACKEND,
+    CLI_KEY_NOTIF_WORKERS,
+    CLI_KEY_CGROUP,
+    CLI_KEY_OUTPUT_MODE,
+    CLI_KEY_FORMAT,
+    CLI_KEY_INTERVAL,
+    CLI_KEY_METRICS_FORMAT,
+    CLI_KEY_METRICS_OUTPUT,
+    CLI_KEY_METRICS_PER_PROCESS,
+    CLI_KEY_METRICS_RESET,
+    CLI_KEY_CONTROL_SOCKET,
+    CLI_KEY_ROTATE_SIZE,
+    CLI_KEY_ROTATE_INTERVAL,
+    CLI_KEY_ROTATE_KEEP,
+    CLI_KEY_COMPRESS,
+};
+
+#define CLI_DEFAULT_ESCALATION_WINDOW_NS (1000ULL * 1000 * 1000)
+#define CLI_MAX_NOTIF_WORKERS 64
+#define CLI_DEFAULT_ROTATE_KEEP 10
+
+
 /* -- Functions -- */
-static bool arg_was_passed_as_single_arg(char* arg) {
-    return !strncmp("-", arg, strlen("-"));   /* CLI arg+option can be 1 arg when passed as `arg=val` or 2 when `arg val` */
+/* Parses comma-list seperated set of syscall- and / or errno names (e.g., `execve,ENOENT`); returns nr of parsed syscalls */
+static int parse_trigger_set(struct argp_state *state, char* arg,
+                             bool* trigger_syscalls, int* trigger_errnos, int* trigger_errnos_count) {
+    char* arg_copy = DIE_WHEN_ERRNO_VPTR( strdup(arg) );
+
+    int trigger_syscalls_count = 0;
+    char* pch = NULL;
+    while ((pch = strtok((!pch) ? (arg_copy) : (NULL), ","))) {
+        long scall_nr;
+        int err;
+        if (-1 != (scall_nr = syscalls_get_nr(pch))) {
+            trigger_syscalls[scall_nr] = true;
+            trigger_syscalls_count++;
+        } else if (-1 != (err = errnos_get_nr(pch)) &&
+                   CLI_MAX_TRIGGER_ERRNOS > *trigger_errnos_count) {
+            trigger_errnos[(*trigger_errnos_count)++] = err;
+        } else {
+            argp_error(state, "Invalid trigger \"%s\" (must be a system call or errno name)", pch);
+        }
+    }
+
+    free(arg_copy);
+    return trigger_syscalls_count;
+}
+
+static unsigned parse_sampling_rate(struct argp_state *state, char* arg) {
+    long rate = -1;
+    if (-1 == str_to_long(arg, &rate) || rate < 1) {
+        argp_error(state, "Invalid sampling rate \"%s\" (must be a positive number)", arg);
+    }
+    return (unsigned)rate;
 }
 
 static error_t parse_cli_opt(int key, char *arg, struct argp_state *state) {
@@ -25,21 +102,31 @@ static error_t parse_cli_opt(int key, char *arg, struct argp_state *state) {
             arguments->list_syscalls = true;
             break;
 
-    /* Attach to already running process w/ corresponding pid */
+    /* Attach to already running process(es) w/ corresponding pid(s)  (may be passed multiple times + as comma- / space-seperated list) */
         case 'p':
         {
-            long parsed_attach_pid = -1;
-            if (-1 == str_to_long(arg, &parsed_attach_pid)) {
-                argp_usage(state);
+            char* pch = NULL;
+            while ((pch = strtok((!pch) ? (arg) : (NULL), ", "))) {
+                long parsed_attach_pid = -1;
+                if (-1 == str_to_long(pch, &parsed_attach_pid) || parsed_attach_pid < 1) {
+                    argp_error(state, "Invalid pid \"%s\"", pch);
+                }
+                if (CLI_MAX_ATTACH_PIDS <= arguments->pids_to_attach_to_count) {
+                    argp_error(state, "Too many pids (max. %d)", CLI_MAX_ATTACH_PIDS);
+                }
+                arguments->pids_to_attach_to[arguments->pids_to_attach_to_count++] = (pid_t)parsed_attach_pid;
             }
-            arguments->pid_to_attach_to = (pid_t)parsed_attach_pid;
         }
             break;
 
+    /* Attach to all tasks in cgroup (+ those joining it later) */
+        case CLI_KEY_CGROUP:
+            arguments->cgroup_to_attach_to = arg;
+            break;
+
     /* Follow `clone`'s */
         case 'f':
             arguments->follow_fork = true;
-            arguments->exec_arg_offset++;
             break;
 
     /* Pause on specified syscall (passed as number) */
@@ -52,7 +139,6 @@ static error_t parse_cli_opt(int key, char *arg, struct argp_state *state) {
                 argp_usage(state);
             }
             arguments->pause_on_scall_nr = (int)parsed_syscall_nr;
-            arguments->exec_arg_offset += arg_was_passed_as_single_arg(state->argv[state->next - 1]) ? (1) : (2);
         }
             break;
 
@@ -65,7 +151,6 @@ static error_t parse_cli_opt(int key, char *arg, struct argp_state *state) {
                 argp_usage(state);
             }
             arguments->pause_on_scall_nr = syscall_nr;
-            arguments->exec_arg_offset += arg_was_passed_as_single_arg(state->argv[state->next - 1]) ? (1) : (2);
         }
             break;
 
@@ -73,7 +158,6 @@ static error_t parse_cli_opt(int key, char *arg, struct argp_state *state) {
     /* Print stack when printing syscall */
         case 'k':
             arguments->print_stack_traces = true;
-            arguments->exec_arg_offset++;
             break;
 #endif /* WITH_STACK_UNWINDING */
 
@@ -105,26 +189,365 @@ static error_t parse_cli_opt(int key, char *arg, struct argp_state *state) {
                 }
                 arguments->syscall_subset_to_be_traced[scall_nr] = true;
             }
-            arguments->exec_arg_offset += arg_was_passed_as_single_arg(state->argv[state->next - 1]) ? (1) : (2);
         }
             break;
 
     /* Daemonize tracer */
         case 'D':
             arguments->daemonize_tracer = true;
-            arguments->exec_arg_offset++;
+            break;
+
+    /* Print paths associated w/ fds */
+        case 'y':
+            arguments->annotate_fds = true;
+            break;
+
+    /* Trace only syscalls accessing specified path (prefix) */
+        case 'P':
+            if (CLI_MAX_PATH_FILTERS == arguments->path_prefixes_to_be_traced_count || !*arg) {
+                argp_usage(state);
+            }
+            arguments->path_prefixes_to_be_traced[arguments->path_prefixes_to_be_traced_count++] = arg;
+            break;
+
+    /* Trace only syscalls accessing specified fds */
+        case CLI_KEY_TRACE_FD:
+        {
+            char* arg_copy = DIE_WHEN_ERRNO_VPTR( strdup(arg) );
+
+            char* pch = NULL;
+            while ((pch = strtok((!pch) ? (arg_copy) : (NULL), ","))) {
+                long fd = -1;
+                if (CLI_MAX_FD_FILTERS == arguments->fds_to_be_traced_count ||
+                    -1 == str_to_long(pch, &fd) || fd < 0) {
+                    argp_usage(state);
+                }
+                arguments->fds_to_be_traced[arguments->fds_to_be_traced_count++] = (int)fd;
+            }
+
+            free(arg_copy);
+        }
+            break;
+
+    /* Trace only syscalls matching filter expression */
+        case CLI_KEY_FILTER:
+        {
+            char err_msg[256];
+            if (arguments->filter) {
+                argp_usage(state);
+            }
+            if (! (arguments->filter = filter_expr_compile(arg, err_msg, sizeof(err_msg))) ) {
+                argp_error(state, "Invalid filter expression \"%s\": %s", arg, err_msg);
+            }
+        }
+            break;
+
+    /* Trace only failed / successful syscalls */
+        case 'Z':
+        case 'z':
+            if (arguments->failed_only || arguments->successful_only) {
+                argp_usage(state);
+            }
+            *(('Z' == key) ? (&arguments->failed_only) : (&arguments->successful_only)) = true;
+            break;
+
+    /* Prefilter syscalls in kernel using seccomp-BPF */
+        case CLI_KEY_SECCOMP_BPF:
+            arguments->seccomp_bpf = true;
+            break;
+
+    /* Keep recent syscalls in in-memory ring (only dumped on trigger) */
+        case CLI_KEY_FLIGHT_RECORDER:
+            if (-1 == str_to_size(arg, &arguments->flight_recorder_size) ||
+                arguments->flight_recorder_size < sizeof(flight_record_t)) {
+                argp_error(state, "Invalid flight recorder size \"%s\" (must be at least %zu bytes)", arg, sizeof(flight_record_t));
+            }
+            break;
+
+        case CLI_KEY_FLIGHT_RECORDER_TRIGGER:
+            parse_trigger_set(state, arg, arguments->flight_recorder_trigger_syscalls,
+                              arguments->flight_recorder_trigger_errnos, &arguments->flight_recorder_trigger_errnos_count);
+            break;
+
+        case CLI_KEY_FLIGHT_RECORDER_BINARY:
+            arguments->flight_recorder_binary_path = arg;
+            break;
+
+    /* Time columns */
+        case 't':
+            if (++(arguments->timestamps_level) > TIMESTAMPS_EPOCH_US) {
+                argp_error(state, "-t may be specified at most 3 times (-ttt)");
+            }
+            break;
+
+        case 'r':
+            arguments->relative_timestamps = true;
+            break;
+
+        case 'T':
+            arguments->print_durations = true;
+            break;
+
+        case CLI_KEY_CALIBRATE:
+            if (arg && strcmp("only", arg)) {
+                argp_error(state, "Invalid calibration mode \"%s\" (only \"only\" is supported)", arg);
+            }
+            arguments->calibrate_durations = true;
+            arguments->calibrate_only = (NULL != arg);
+            break;
+
+        case CLI_KEY_FORMAT:
+            if (!strcmp("text", arg)) {
+                arguments->output_format = OUTPUT_FORMAT_TEXT;
+            } else if (!strcmp("json", arg)) {
+                arguments->output_format = OUTPUT_FORMAT_JSON;
+            } else {
+                argp_error(state, "Invalid format \"%s\" (must be \"text\" or \"json\")", arg);
+            }
+            break;
+
+        case CLI_KEY_OUTPUT_MODE:
+            if (!strcmp("interleaved", arg)) {
+                arguments->output_mode = OUTPUT_MODE_INTERLEAVED;
+            } else if (!strcmp("complete", arg)) {
+                arguments->output_mode = OUTPUT_MODE_COMPLETE;
+            } else if (!strcmp("strace", arg)) {
+                arguments->output_mode = OUTPUT_MODE_STRACE;
+            } else {
+                argp_error(state, "Invalid output mode \"%s\" (must be \"interleaved\", \"complete\" or \"strace\")", arg);
+            }
+            break;
+
+    /* Tracing backend */
+        case CLI_KEY_BACKEND:
+            if (!strcmp("ptrace", arg)) {
+                arguments->backend = TRACE_BACKEND_PTRACE;
+            } else if (!strcmp("perf", arg)) {
+                arguments->backend = TRACE_BACKEND_PERF;
+            } else if (!strcmp("seccomp-notif", arg)) {
+                arguments->backend = TRACE_BACKEND_SECCOMP_NOTIF;
+            } else {
+                argp_error(state, "Invalid backend \"%s\" (must be \"ptrace\", \"perf\" or \"seccomp-notif\")", arg);
+            }
+            break;
+
+        case CLI_KEY_NOTIF_WORKERS:
+        {
+            long workers = -1;
+            if (-1 == str_to_long(arg, &workers) || workers < 1 || workers > CLI_MAX_NOTIF_WORKERS) {
+                argp_error(state, "Invalid nr of notification workers \"%s\" (must be in [1, %d])", arg, CLI_MAX_NOTIF_WORKERS);
+            }
+            arguments->notif_workers = (unsigned)workers;
+        }
+            break;
+
+    /* CPU placement of tracer */
+        case CLI_KEY_TRACER_CPU:
+            if (!strcmp("auto", arg)) {
+                arguments->tracer_placement = TRACER_PLACEMENT_AUTO;
+            } else {
+                long cpu = -1;
+                if (-1 == str_to_long(arg, &cpu) || cpu < 0 || cpu >= CPU_UTILS_MAX_CPUS) {
+                    argp_error(state, "Invalid tracer CPU \"%s\" (must be a CPU nr or \"auto\")", arg);
+                }
+                if (arguments->tracer_cpus_given) {
+                    argp_error(state, "--tracer-cpu=<cpu> and --tracer-affinity are mutually exclusive");
+                }
+                memset(arguments->tracer_cpus, 0, sizeof(arguments->tracer_cpus));
+                arguments->tracer_cpus[cpu] = true;
+                arguments->tracer_cpus_given = true;
+                arguments->tracer_placement = TRACER_PLACEMENT_PINNED;
+            }
+            break;
+
+        case CLI_KEY_TRACER_AFFINITY:
+            if (arguments->tracer_cpus_given) {
+                argp_error(state, "--tracer-cpu=<cpu> and --tracer-affinity are mutually exclusive");
+            }
+            if (-1 == cpu_list_parse(arg, arguments->tracer_cpus)) {
+                argp_error(state, "Invalid CPU list \"%s\" (e.g., \"0-3,8\")", arg);
+            }
+            arguments->tracer_cpus_given = true;
+            if (TRACER_PLACEMENT_NONE == arguments->tracer_placement) {     /* (Restricts `--tracer-cpu=auto`) */
+                arguments->tracer_placement = TRACER_PLACEMENT_PINNED;
+            }
+            break;
+
+    /* Count syscalls (instead of printing them) + print summary at exit */
+        case 'c':
+        case 'C':
+            arguments->summary = true;
+            arguments->summary_with_output = ('C' == key);
+            break;
+
+    /* Tracer's own cost */
+        case CLI_KEY_STATS:
+            arguments->print_stats = true;
+            break;
+
+    /* Record raw stop data (for offline replay) */
+        case CLI_KEY_RECORD:
+            arguments->record_path = arg;
+            break;
+
+    /* Sample syscalls  (non-sampled ones are only counted) */
+        case CLI_KEY_SAMPLE_EVERY:
+        case CLI_KEY_SAMPLE_BURST:
+        case CLI_KEY_SAMPLE_THREADS:
+            *((CLI_KEY_SAMPLE_EVERY == key) ? (&arguments->sample_every_nth) :
+              ((CLI_KEY_SAMPLE_BURST == key) ? (&arguments->sample_burst_per_window) : (&arguments->sample_every_nth_thread))) =
+                parse_sampling_rate(state, arg);
+            break;
+
+    /* Throttle tracing to stay within overhead budget */
+        case CLI_KEY_OVERHEAD_BUDGET:
+        {
+            char* p_end_ptr = NULL;
+            errno = 0;
+            arguments->overhead_budget_percent = strtod(arg, &p_end_ptr);
+            if ('%' == *p_end_ptr) { p_end_ptr++; }
+            if (arg == p_end_ptr || '\0' != *p_end_ptr || ERANGE == errno ||
+                !(arguments->overhead_budget_percent > 0 && arguments->overhead_budget_percent < 100)) {
+                argp_error(state, "Invalid overhead budget \"%s\" (must be a percentage in (0, 100), e.g., 5%%)", arg);
+            }
+        }
+            break;
+
+    /* Escalate to full tracing (for a window) on slow / specified syscalls */
+        case CLI_KEY_ESCALATE_LATENCY:
+            if (-1 == str_to_duration_ns(arg, &arguments->escalation_latency_ns) || !arguments->escalation_latency_ns) {
+                argp_error(state, "Invalid latency \"%s\" (e.g., 10ms)", arg);
+            }
+            break;
+
+        case CLI_KEY_ESCALATE_ON:
+            arguments->escalation_trigger_syscalls_count +=
+                parse_trigger_set(state, arg, arguments->escalation_trigger_syscalls,
+                                  arguments->escalation_trigger_errnos, &arguments->escalation_trigger_errnos_count);
+            break;
+
+        case CLI_KEY_ESCALATE_WINDOW:
+            if (-1 == str_to_duration_ns(arg, &arguments->escalation_window_ns)) {
+                argp_error(state, "Invalid window \"%s\" (e.g., 500ms)", arg);
+            }
+            break;
+
+    /* Periodic metrics snapshots */
+        case CLI_KEY_INTERVAL:
+        {
+            long seconds = -1;
+            if (arg[0] && strlen(arg) == strspn(arg, "0123456789")) {     /* W/o unit = seconds */
+                if (-1 == str_to_long(arg, &seconds) || seconds < 1) {
+                    argp_error(state, "Invalid interval \"%s\" (e.g., 10 or 500ms)", arg);
+                }
+                arguments->metrics_interval_ns = (uint64_t)seconds * 1000000000ULL;
+            } else if (-1 == str_to_duration_ns(arg, &arguments->metrics_interval_ns) || !arguments->metrics_interval_ns) {
+                argp_error(state, "Invalid interval \"%s\" (e.g., 10 or 500ms)", arg);
+            }
+        }
+            break;
+
+        case CLI_KEY_METRICS_FORMAT:
+            if (!strcmp("openmetrics", arg)) {
+                arguments->metrics_format = METRICS_FORMAT_OPENMETRICS;
+            } else if (!strcmp("json", arg)) {
+                arguments->metrics_format = METRICS_FORMAT_JSON;
+            } else {
+                argp_error(state, "Invalid metrics format \"%s\" (must be \"openmetrics\" or \"json\")", arg);
+            }
+            break;
+
+        case CLI_KEY_METRICS_OUTPUT:
+            arguments->metrics_output = arg;
+            break;
+
+        case CLI_KEY_METRICS_PER_PROCESS:
+            arguments->metrics_per_process = true;
+            break;
+
+        case CLI_KEY_METRICS_RESET:
+            arguments->metrics_reset = true;
+            break;
+
+        case CLI_KEY_CONTROL_SOCKET:
+            arguments->control_socket = arg;
+            break;
+
+        /* Output file (+ rotation / compression) */
+        case 'o':
+            arguments->output_path = arg;
+            break;
+
+        case CLI_KEY_ROTATE_SIZE:
+            if (-1 == str_to_size(arg, &arguments->output_rotate_size) || !arguments->output_rotate_size) {
+                argp_error(state, "Invalid rotation size \"%s\" (e.g., 100M)", arg);
+            }
+            break;
+
+        case CLI_KEY_ROTATE_INTERVAL:
+            if (-1 == str_to_duration_ns(arg, &arguments->output_rotate_interval_ns) ||
+                arguments->output_rotate_interval_ns < 1000000000ULL) {
+                argp_error(state, "Invalid rotation interval \"%s\" (must be at least 1s; e.g., 30min or 1h)", arg);
+            }
+            break;
+
+        case CLI_KEY_ROTATE_KEEP:
+            if (-1 == str_to_long(arg, &arguments->output_rotate_keep) || arguments->output_rotate_keep < 1 ||
+                arguments->output_rotate_keep > 1000) {
+                argp_error(state, "Invalid nr of files \"%s\" (must be in [1, 1000])", arg);
+            }
+            break;
+
+        case CLI_KEY_COMPRESS:
+            if (!strcmp("zstd", arg)) {
+#ifdef WITH_ZSTD
+                arguments->output_compression = OUTPUT_COMPRESSION_ZSTD;
+#else
+                argp_error(state, "zstd compression isn't available (built w/o libzstd)");
+#endif /* WITH_ZSTD */
+            } else if (!strcmp("lz4", arg)) {
+#ifdef WITH_LZ4
+                arguments->output_compression = OUTPUT_COMPRESSION_LZ4;
+#else
+                argp_error(state, "lz4 compression isn't available (built w/o liblz4)");
+#endif /* WITH_LZ4 */
+            } else {
+                argp_error(state, "Invalid compression \"%s\" (must be \"zstd\" or \"lz4\")", arg);
+            }
             break;
 
 
         case ARGP_KEY_ARG:
-          /* Too many arguments */
+          /* First non-option arg = program to be traced  (NOTE: argp permutes args  -> ALL options, incl. clustered ones like `-tt`, precede it) */
+          if (0 == state->arg_num) {
+            arguments->exec_arg_offset = state->next - 2;       /* Excl. `argv[0]` + program itself */
+          }
           break;
 
         case ARGP_KEY_END:
           /* Not enough arguments */
-          if (state->arg_num < 1 && (!arguments->list_syscalls && -1 == arguments->pid_to_attach_to)) {
+          if (state->arg_num < 1 && (!arguments->list_syscalls && !arguments->calibrate_only &&
+                                      !arguments->pids_to_attach_to_count && !arguments->cgroup_to_attach_to)) {
             argp_usage(state);
           }
+          if (OUTPUT_FORMAT_JSON == arguments->output_format && arguments->record_path) {
+            argp_error(state, "--record requires --format=text");
+          }
+          if (!arguments->metrics_interval_ns && (METRICS_FORMAT_OPENMETRICS != arguments->metrics_format ||
+                arguments->metrics_output || arguments->metrics_per_process || arguments->metrics_reset)) {
+            argp_error(state, "--metrics-* options require --interval");
+          }
+          if (arguments->control_socket && !arguments->pids_to_attach_to_count && !arguments->cgroup_to_attach_to &&
+              !arguments->daemonize_tracer) {
+            argp_error(state, "--control-socket requires -p / --cgroup / -D");
+          }
+          if (!arguments->output_path && (arguments->output_rotate_size || arguments->output_rotate_interval_ns ||
+                                          arguments->output_rotate_keep || OUTPUT_COMPRESSION_NONE != arguments->output_compression)) {
+            argp_error(state, "--rotate-* / --compress options require -o");
+          }
+          if (!arguments->output_rotate_keep) {
+            arguments->output_rotate_keep = CLI_DEFAULT_ROTATE_KEEP;
+          }
           break;
 
         default:
@@ -139,7 +562,8 @@ void parse_cli_args(int argc, char** argv,
                     cli_args_t* parsed_cli_args_ptr) {
     static const struct argp_option cli_options[] = {
         {"list-syscalls", 'l', NULL,          0, "List supported system calls",                                                    0},
-        {"attach",        'p', "pid",         0, "Attach to already running process",                                              1},
+        {"attach",        'p', "pid",         0, "Attach to already running process (may be passed multiple times, or as comma-list seperated set of pids; output lines are then prefixed w/ tid)", 1},
+        {"cgroup",        CLI_KEY_CGROUP, "path", 0, "Attach to all tasks in the specified cgroup (absolute, or relative to /sys/fs/cgroup), incl. those joining it later", 1},
         {"follow-forks",  'f', NULL,          0, "Follow `fork`ed child processes",                                                2},
         {"pause-snr",     'n', "nr",          0, "Pause on specified system call nr",                                              3},
         {"pause-sname",   'a', "name",        0, "Pause on specified system call name",                                            3},
@@ -147,13 +571,58 @@ void parse_cli_args(int argc, char** argv,
         {"stack-traces",  'k', NULL,          0, "Print the execution stack trace of the traced processes after each system call", 4},
 #endif /* WITH_STACK_UNWINDING */
         {"trace",         'e', "syscall_set", 0, "Trace only the specified (as comma-list seperated) set of system calls",         4},
+        {"backend",       CLI_KEY_BACKEND, "name", 0, "Tracing backend: ptrace (default), perf (tracees never stop, but args are printed raw; for counting + latencies) or seccomp-notif (launched programs only; only selected system calls are reported, w/o return values; implies -f); falls back to ptrace if unavailable", 5},
+        {"notif-workers", CLI_KEY_NOTIF_WORKERS, "n", 0, "Nr of threads handling system call notifications in parallel w/ --backend=seccomp-notif (default: 1)", 5},
         {"daemonize",     'D', NULL,          0, "Run tracer process as a grandchild, not as the parent of the tracee",            5},
+        {"decode-fds",    'y', NULL,          0, "Print paths associated w/ file descriptor args + returned file descriptors",    6},
+        {"trace-path",    'P', "path",        0, "Trace only system calls accessing the specified path (prefix); may be passed multiple times", 4},
+        {"fd",            CLI_KEY_TRACE_FD, "fd_set", 0, "Trace only system calls accessing the specified (as comma-list seperated) set of file descriptors", 4},
+        {"filter",        CLI_KEY_FILTER, "expr", 0, "Trace only system calls matching the filter expression (e.g., \"rval < 0 && errno != EAGAIN\", \"write && arg2 > 65536\", \"futex && duration > 10ms\")", 4},
+        {"timestamps",    't', NULL,          0, "Prefix each line w/ the wall-clock time (-tt: w/ microseconds, -ttt: as seconds since epoch)", 6},
+        {"relative-timestamps", 'r', NULL,    0, "Prefix each line w/ the time since the previous system call",                   6},
+        {"syscall-times", 'T', NULL,          0, "Print the time spent in each system call",                                      6},
+        {"format",        CLI_KEY_FORMAT, "format", 0, "Output format: text (default) or json (one JSON object per line for each system call / signal / exit, w/ typed args; ptrace backend only)", 6},
+        {"output",        'o', "file",        0, "Write trace output to the specified file (instead of stderr)",                   6},
+        {"rotate-size",   CLI_KEY_ROTATE_SIZE, "size", 0, "Rotate -o file once it exceeds the specified size (e.g., 100M); rotated files are renamed to <file>.1, <file>.2, ...", 6},
+        {"rotate-interval", CLI_KEY_ROTATE_INTERVAL, "duration", 0, "Rotate -o file every specified duration (e.g., 1h)", 6},
+        {"rotate-keep",   CLI_KEY_ROTATE_KEEP, "n", 0, "Max. nr of -o files kept (incl. the current one) when rotating (default: 10)", 6},
+        {"compress",      CLI_KEY_COMPRESS, "codec", 0, "Compress -o file w/ zstd or lz4 (if built w/ it) in a writer thread; written as independently decodable blocks (i.e., frames, readable w/ `zstd -dc` / `lz4 -dc`, even once truncated)", 6},
+        {"output-mode",   CLI_KEY_OUTPUT_MODE, "mode", 0, "How lines of concurrently traced tasks are written: interleaved (default; syscall-exit on own line w/ -f), complete (each line written at once on syscall-exit) or strace (lines are only split (`<unfinished ...>` / `<... resumed>`) when another task's output interleaves)", 6},
+        {"calibrate",     CLI_KEY_CALIBRATE, "only", OPTION_ARG_OPTIONAL, "Measure the distribution of ptrace stop round-trips at startup (report it and subtract its median from all syscall durations), or only report it (=only)", 6},
+        {"tracer-cpu",    CLI_KEY_TRACER_CPU, "cpu", 0, "Bind tracer to the specified CPU, or (=auto) keep it near the CPUs the tracees last ran on (i.e., on their LLC)", 10},
+        {"tracer-affinity", CLI_KEY_TRACER_AFFINITY, "cpu_list", 0, "Bind tracer to the specified CPUs (e.g., 0-3,8); w/ --tracer-cpu=auto, only these CPUs are considered", 10},
+        {"failed-only",   'Z', NULL,          0, "Trace only system calls returning an error",                                     4},
+        {"successful-only", 'z', NULL,        0, "Trace only system calls not returning an error",                                 4},
+        {"seccomp-bpf",   CLI_KEY_SECCOMP_BPF, NULL, 0, "Don't stop on system calls which can't be traced (using seccomp-BPF; implies -f)", 4},
+        {"flight-recorder", CLI_KEY_FLIGHT_RECORDER, "size", 0, "Don't print system calls, but keep the most recent ones in an in-memory ring of the specified size (e.g., 4M), which is dumped when the tracee receives a fatal signal, on SIGUSR2 or on a trigger", 7},
+        {"flight-recorder-trigger", CLI_KEY_FLIGHT_RECORDER_TRIGGER, "trigger_set", 0, "Dump flight recorder when one of the specified (as comma-list seperated) system calls or errnos (e.g., ENOENT) occurs", 7},
+        {"flight-recorder-binary", CLI_KEY_FLIGHT_RECORDER_BINARY, "file", 0, "Append flight recorder dumps in binary format to the specified file (instead of printing them)", 7},
+        {"summary",       'c', NULL,          0, "Count time, calls and errors of each system call (instead of printing them) and print a summary at exit (w/ -f / multiple -p / --cgroup, also per process (as tree) + per executable)", 7},
+        {"summary-with-output", 'C', NULL,    0, "Like -c, but also print system calls",                                           7},
+        {"stats",         CLI_KEY_STATS, NULL, 0, "Print where the tracer itself spends its time (waiting, reading registers / memory, decoding, formatting, output, ...) at exit", 7},
+        {"record",        CLI_KEY_RECORD, "file", 0, "Record raw data (args + tracee memory read for decoding them) of printed system calls to the specified file (for replaying them offline, e.g., by `bench_replay`)", 7},
+        {"sample-every",  CLI_KEY_SAMPLE_EVERY, "n", 0, "Print only every n-th call of each system call (others are only counted by -c / -C)", 9},
+        {"sample-burst",  CLI_KEY_SAMPLE_BURST, "m", 0, "Print only the first m system calls per 100 ms (others are only counted by -c / -C)", 9},
+        {"sample-threads", CLI_KEY_SAMPLE_THREADS, "n", 0, "Print only system calls of every n-th thread (by tid; others are only counted by -c / -C)", 9},
+        {"overhead-budget", CLI_KEY_OVERHEAD_BUDGET, "percent", 0, "Degrade tracing (stack unwinding, arg decoding, sampling, ...) step by step while the tracer holds tracees stopped for more than the specified share of time (e.g., 5%)", 9},
+        {"escalate-latency", CLI_KEY_ESCALATE_LATENCY, "duration", 0, "Print system calls (w/ stack traces, if supported) only for a window after one took longer than the specified duration (e.g., 10ms)", 8},
+        {"escalate-on",   CLI_KEY_ESCALATE_ON, "trigger_set", 0, "Print system calls (w/ stack traces, if supported) only for a window after one of the specified (as comma-list seperated) system calls or errnos occurred", 8},
+        {"escalate-window", CLI_KEY_ESCALATE_WINDOW, "duration", 0, "Duration of full tracing after an escalation trigger fired (default: 1s)", 8},
+        {"interval",      CLI_KEY_INTERVAL, "sec", 0, "Report a snapshot of per-system-call calls, errors, transferred bytes + latency quantiles every sec seconds (or e.g. 500ms) and at exit (w/o stopping the tracees for it; ptrace backend only)", 11},
+        {"metrics-format", CLI_KEY_METRICS_FORMAT, "format", 0, "Format of --interval snapshots: openmetrics (default) or json (one object per line)", 11},
+        {"metrics-output", CLI_KEY_METRICS_OUTPUT, "dest", 0, "Write --interval snapshots to the specified file (appended) or, as unix:<path>, to a UNIX stream socket (default: stderr)", 11},
+        {"metrics-per-process", CLI_KEY_METRICS_PER_PROCESS, NULL, 0, "Also report --interval snapshots per process", 11},
+        {"metrics-reset", CLI_KEY_METRICS_RESET, NULL, 0, "Report only the last interval in each --interval snapshot (instead of the totals since start)", 11},
+        {"control-socket", CLI_KEY_CONTROL_SOCKET, "path", 0, "W/ -p / --cgroup / -D: Accept commands (one per line; see `help`) on the specified UNIX socket to change the traced system calls, sampling, string size, stack unwinding + output at runtime, report stats or detach", 12},
         {0}
     };
 
   /* Defaults */
+    parsed_cli_args_ptr->backend = TRACE_BACKEND_PTRACE;
+    parsed_cli_args_ptr->notif_workers = 1;
     parsed_cli_args_ptr->list_syscalls = false;
-    parsed_cli_args_ptr->pid_to_attach_to = -1;
+    parsed_cli_args_ptr->pids_to_attach_to_count = 0;
+    parsed_cli_args_ptr->cgroup_to_attach_to = NULL;
     parsed_cli_args_ptr->follow_fork = false;
     parsed_cli_args_ptr->pause_on_scall_nr = -1;
 #ifdef WITH_STACK_UNWINDING
@@ -161,6 +630,52 @@ void parse_cli_args(int argc, char** argv,
 #endif /* WITH_STACK_UNWINDING */
     parsed_cli_args_ptr->trace_only_syscall_subset = false;
     parsed_cli_args_ptr->daemonize_tracer = false;
+    parsed_cli_args_ptr->annotate_fds = false;
+    parsed_cli_args_ptr->path_prefixes_to_be_traced_count = 0;
+    parsed_cli_args_ptr->fds_to_be_traced_count = 0;
+    parsed_cli_args_ptr->filter = NULL;
+    parsed_cli_args_ptr->failed_only = false;
+    parsed_cli_args_ptr->successful_only = false;
+    parsed_cli_args_ptr->seccomp_bpf = false;
+    parsed_cli_args_ptr->flight_recorder_size = 0;
+    memset(parsed_cli_args_ptr->flight_recorder_trigger_syscalls, 0,
+           SYSCALLS_ARR_SIZE * sizeof(*(parsed_cli_args_ptr->flight_recorder_trigger_syscalls)));
+    parsed_cli_args_ptr->flight_recorder_trigger_errnos_count = 0;
+    parsed_cli_args_ptr->flight_recorder_binary_path = NULL;
+    parsed_cli_args_ptr->summary = false;
+    parsed_cli_args_ptr->summary_with_output = false;
+    parsed_cli_args_ptr->print_stats = false;
+    parsed_cli_args_ptr->record_path = NULL;
+    parsed_cli_args_ptr->sample_every_nth = 0;
+    parsed_cli_args_ptr->sample_burst_per_window = 0;
+    parsed_cli_args_ptr->sample_every_nth_thread = 0;
+    parsed_cli_args_ptr->overhead_budget_percent = 0;
+    parsed_cli_args_ptr->escalation_latency_ns = 0;
+    memset(parsed_cli_args_ptr->escalation_trigger_syscalls, 0,
+           SYSCALLS_ARR_SIZE * sizeof(*(parsed_cli_args_ptr->escalation_trigger_syscalls)));
+    parsed_cli_args_ptr->escalation_trigger_syscalls_count = 0;
+    parsed_cli_args_ptr->escalation_trigger_errnos_count = 0;
+    parsed_cli_args_ptr->escalation_window_ns = CLI_DEFAULT_ESCALATION_WINDOW_NS;
+    parsed_cli_args_ptr->metrics_interval_ns = 0;
+    parsed_cli_args_ptr->metrics_format = METRICS_FORMAT_OPENMETRICS;
+    parsed_cli_args_ptr->metrics_output = NULL;
+    parsed_cli_args_ptr->metrics_per_process = false;
+    parsed_cli_args_ptr->metrics_reset = false;
+    parsed_cli_args_ptr->control_socket = NULL;
+    parsed_cli_args_ptr->output_path = NULL;
+    parsed_cli_args_ptr->output_rotate_size = 0;
+    parsed_cli_args_ptr->output_rotate_interval_ns = 0;
+    parsed_cli_args_ptr->output_rotate_keep = 0;
+    parsed_cli_args_ptr->output_compression = OUTPUT_COMPRESSION_NONE;
+    parsed_cli_args_ptr->timestamps_level = TIMESTAMPS_NONE;
+    parsed_cli_args_ptr->relative_timestamps = false;
+    parsed_cli_args_ptr->print_durations = false;
+    parsed_cli_args_ptr->output_format = OUTPUT_FORMAT_TEXT;
+    parsed_cli_args_ptr->output_mode = OUTPUT_MODE_INTERLEAVED;
+    parsed_cli_args_ptr->calibrate_durations = false;
+    parsed_cli_args_ptr->calibrate_only = false;
+    parsed_cli_args_ptr->tracer_placement = TRACER_PLACEMENT_NONE;
+    parsed_cli_args_ptr->tracer_cpus_given = false;
     parsed_cli_args_ptr->exec_arg_offset = 0;
 
     static const struct argp argp = {
@@ -5,25 +5,99 @@
 #define CLI_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
+#include <common/cpu_utils.h>
 #include <trace/syscallents.h>
+#include "trace/tracing.h"
+
+
+/* -- Consts -- */
+#define CLI_MAX_PATH_FILTERS 16
+#define CLI_MAX_FD_FILTERS   64
+#define CLI_MAX_TRIGGER_ERRNOS 16
+#define CLI_MAX_ATTACH_PIDS  64
+
+
+/* -- Type declarations -- */
+struct filter_expr ;
 
 
 /* -- Types -- */
 typedef struct {
+    trace_backend_t backend;
+    unsigned notif_workers;
     bool list_syscalls;
-    pid_t pid_to_attach_to;
+    pid_t pids_to_attach_to[CLI_MAX_ATTACH_PIDS];
+    int pids_to_attach_to_count;
+    const char* cgroup_to_attach_to;
     bool follow_fork;
     long pause_on_scall_nr;
 #ifdef WITH_STACK_UNWINDING
     bool print_stack_traces;
 #endif /* WITH_STACK_UNWINDING */
     bool daemonize_tracer;
+    bool annotate_fds;
 
     bool trace_only_syscall_subset;
     bool syscall_subset_to_be_traced[SYSCALLS_ARR_SIZE];
 
+    const char* path_prefixes_to_be_traced[CLI_MAX_PATH_FILTERS];
+    int path_prefixes_to_be_traced_count;
+    int fds_to_be_traced[CLI_MAX_FD_FILTERS];
+    int fds_to_be_traced_count;
+
+    struct filter_expr* filter;
+    int timestamps_level;
+    bool relative_timestamps;
+    bool print_durations;
+    output_format_t output_format;
+    output_mode_t output_mode;
+    bool calibrate_durations;
+    bool calibrate_only;
+    tracer_placement_t tracer_placement;
+    bool tracer_cpus_given;
+    bool tracer_cpus[CPU_UTILS_MAX_CPUS];
+    bool failed_only;
+    bool successful_only;
+    bool seccomp_bpf;
+
+    size_t flight_recorder_size;
+    bool flight_recorder_trigger_syscalls[SYSCALLS_ARR_SIZE];
+    int flight_recorder_trigger_errnos[CLI_MAX_TRIGGER_ERRNOS];
+    int flight_recorder_trigger_errnos_count;
+    const char* flight_recorder_binary_path;
+
+    bool summary;
+    bool summary_with_output;
+    bool print_stats;
+    const char* record_path;
+    unsigned sample_every_nth;
+    unsigned sample_burst_per_window;
+    unsigned sample_every_nth_thread;
+    double overhead_budget_percent;
+    uint64_t escalation_latency_ns;
+    bool escalation_trigger_syscalls[SYSCALLS_ARR_SIZE];
+    int escalation_trigger_syscalls_count;
+    int escalation_trigger_errnos[CLI_MAX_TRIGGER_ERRNOS];
+    int escalation_trigger_errnos_count;
+    uint64_t escalation_window_ns;
+
+    uint64_t metrics_interval_ns;
+    metrics_format_t metrics_format;
+    const char* metrics_output;
+    bool metrics_per_process;
+    bool metrics_reset;
+
+    const char* control_socket;
+
+    const char* output_path;
+    size_t output_rotate_size;
+    uint64_t output_rotate_interval_ns;
+    long output_rotate_keep;
+    output_compression_t output_compression;
+
     int exec_arg_offset;
 } cli_args_t;
 
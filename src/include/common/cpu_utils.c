@@ -0,0 +1,173 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_utils.h"
+
+
+/* -- Consts -- */
+#define SYSFS_CPU_DIR "/sys/devices/system/cpu"
+
+#define SYSFS_MAX_CACHE_INDICES 16
+
+#define PROC_STAT_PROCESSOR_FIELD 39    /* CPU last executed on (see `proc`(5)) */
+
+
+/* -- Function prototypes -- */
+static int read_file(const char* path, char* buf, size_t buf_size);
+static int read_sysfs_cpu_list(const char* path, bool* cpus);
+static void single_cpu(int cpu, bool* cpus);
+
+
+/* -- Functions -- */
+/* Parses CPU list (as used by sysfs / `taskset -c`), e.g., `0-3,8,10-11` */
+int cpu_list_parse(const char* list, bool* cpus) {
+    if (NULL == list || NULL == cpus) {
+        return -1;
+    }
+    memset(cpus, 0, CPU_UTILS_MAX_CPUS * sizeof(*cpus));
+
+    bool any_cpu = false;
+    for (const char* p = list; *p; ) {
+        char* p_end_ptr = NULL;
+        const long first = strtol(p, &p_end_ptr, 10);
+        if (p == p_end_ptr || first < 0 || first >= CPU_UTILS_MAX_CPUS) { return -1; }
+        p = p_end_ptr;
+
+        long last = first;
+        if ('-' == *p) {
+            p++;
+            last = strtol(p, &p_end_ptr, 10);
+            if (p == p_end_ptr || last < first || last >= CPU_UTILS_MAX_CPUS) { return -1; }
+            p = p_end_ptr;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            cpus[cpu] = true;
+        }
+        any_cpu = true;
+
+        if (',' == *p) { p++; }
+        else if (*p && '\n' != *p) { return -1; }
+        else { break; }
+    }
+    return (any_cpu) ? (0) : (-1);
+}
+
+int cpu_online_cpus(bool* cpus) {
+    return read_sysfs_cpu_list(SYSFS_CPU_DIR "/online", cpus);
+}
+
+
+/*
+ * CPUs sharing the last level cache w/ `cpu` (falls back to its package, if caches aren't exposed, or only `cpu` itself)
+ */
+int cpu_llc_siblings(int cpu, bool* cpus) {
+    if (cpu < 0 || cpu >= CPU_UTILS_MAX_CPUS) {
+        return -1;
+    }
+
+    char path[128], level_str[16];
+    long llc_level = -1;
+    int llc_index = -1;
+    for (int index = 0; index < SYSFS_MAX_CACHE_INDICES; index++) {
+        snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/cache/index%d/level", cpu, index);
+        if (-1 == read_file(path, level_str, sizeof(level_str))) { break; }
+        const long level = strtol(level_str, NULL, 10);
+        if (level > llc_level) {
+            llc_level = level;
+            llc_index = index;
+        }
+    }
+
+    if (-1 != llc_index) {
+        snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/cache/index%d/shared_cpu_list", cpu, llc_index);
+        if (-1 != read_sysfs_cpu_list(path, cpus)) { return 0; }
+    }
+    snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/topology/core_siblings_list", cpu);
+    if (-1 != read_sysfs_cpu_list(path, cpus)) { return 0; }
+
+    single_cpu(cpu, cpus);
+    return 0;
+}
+
+/*
+ * CPUs sharing the (physical) core w/ `cpu`, i.e., its SMT siblings (incl. `cpu` itself)
+ */
+int cpu_core_siblings(int cpu, bool* cpus) {
+    if (cpu < 0 || cpu >= CPU_UTILS_MAX_CPUS) {
+        return -1;
+    }
+
+    char path[128];
+    snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/topology/thread_siblings_list", cpu);
+    if (-1 != read_sysfs_cpu_list(path, cpus)) { return 0; }
+
+    single_cpu(cpu, cpus);
+    return 0;
+}
+
+/*
+ * NUMA node of `cpu` (`-1` = unknown, e.g., kernel w/o NUMA support)
+ */
+int cpu_numa_node(int cpu) {
+    char path[128];
+    snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d", cpu);
+    DIR* const cpu_dir = opendir(path);
+    if (!cpu_dir) {
+        return -1;
+    }
+
+    int node = -1;
+    for (struct dirent* entry; (entry = readdir(cpu_dir)); ) {     /* (Node is exposed as link `node<n>`) */
+        if (!strncmp("node", entry->d_name, strlen("node")) &&
+            1 == sscanf(entry->d_name + strlen("node"), "%d", &node)) {
+            break;
+        }
+    }
+    closedir(cpu_dir);
+    return node;
+}
+
+
+/*
+ * CPU on which task `tid` ran last (`-1` = unknown, e.g., task has already exited)
+ */
+int cpu_last_of_task(pid_t tid) {
+    char stat_path[64];
+    snprintf(stat_path, sizeof(stat_path), "/proc/%d/stat", tid);
+    char stat[1024];
+    if (-1 == read_file(stat_path, stat, sizeof(stat))) {
+        return -1;
+    }
+
+    /* Fields after `comm` (which may contain spaces  -> Search from its closing paren) */
+    char* field = strrchr(stat, ')');
+    for (int field_nr = 2; field && field_nr < PROC_STAT_PROCESSOR_FIELD; field_nr++) {
+        field = strchr(field + 1, ' ');
+    }
+    return (field) ? (atoi(field + 1)) : (-1);
+}
+
+
+/* - Helpers - */
+static int read_file(const char* path, char* buf, size_t buf_size) {
+    FILE* file;
+    if (! (file = fopen(path, "r")) ) {
+        return -1;
+    }
+    const size_t len = fread(buf, 1, buf_size - 1, file);
+    fclose(file);
+    buf[len] = '\0';
+    return 0;
+}
+
+static int read_sysfs_cpu_list(const char* path, bool* cpus) {
+    char list[4096];
+    return (-1 != read_file(path, list, sizeof(list))) ? (cpu_list_parse(list, cpus)) : (-1);
+}
+
+static void single_cpu(int cpu, bool* cpus) {
+    memset(cpus, 0, CPU_UTILS_MAX_CPUS * sizeof(*cpus));
+    cpus[cpu] = true;
+}
@@ -0,0 +1,24 @@
+#ifndef COMMON_CPU_UTILS_H_
+#define COMMON_CPU_UTILS_H_
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+
+/* -- Consts -- */
+#define CPU_UTILS_MAX_CPUS 1024         /* (= `CPU_SETSIZE`) */
+
+
+/* -- Function prototypes -- */
+/* CPU sets are passed as `bool[CPU_UTILS_MAX_CPUS]` (i.e., `cpus[i]` = CPU `i` is member) */
+int cpu_list_parse(const char* list, bool* cpus);
+int cpu_online_cpus(bool* cpus);
+
+int cpu_llc_siblings(int cpu, bool* cpus);
+int cpu_core_siblings(int cpu, bool* cpus);
+int cpu_numa_node(int cpu);
+
+int cpu_last_of_task(pid_t tid);
+
+
+#endif /* COMMON_CPU_UTILS_H_ */
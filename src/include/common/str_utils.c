@@ -1,5 +1,6 @@
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "str_utils.h"
 
@@ -17,3 +18,60 @@ int str_to_long(char* str, long* num) {
     }
     return -1;
 }
+
+/* Parses size w/ optional (binary) unit suffix, e.g., `64K`, `16M`, `1G` */
+int str_to_size(char* str, size_t* size) {
+    if (NULL == str || NULL == size) {
+        return -1;
+    }
+
+    char* p_end_ptr = NULL;
+    errno = 0;
+    const unsigned long long parsed_number = strtoull(str, &p_end_ptr, 10);
+    if (str == p_end_ptr || ERANGE == errno || '-' == *str) {
+        return -1;
+    }
+
+    unsigned shift = 0;
+    switch (*p_end_ptr) {
+        case 'K': case 'k': shift = 10; p_end_ptr++; break;
+        case 'M': case 'm': shift = 20; p_end_ptr++; break;
+        case 'G': case 'g': shift = 30; p_end_ptr++; break;
+        default: break;
+    }
+    if ('\0' != *p_end_ptr || (parsed_number << shift) >> shift != parsed_number) {
+        return -1;
+    }
+
+    *size = (size_t)(parsed_number << shift);
+    return 0;
+}
+
+/* Parses duration w/ optional unit suffix (`ns` (default), `us`, `ms`, `s`, `min`, `h`), e.g., `500us`, `10ms`, `2s`, `1h` */
+int str_to_duration_ns(char* str, uint64_t* ns) {
+    if (NULL == str || NULL == ns) {
+        return -1;
+    }
+
+    char* p_end_ptr = NULL;
+    errno = 0;
+    const unsigned long long parsed_number = strtoull(str, &p_end_ptr, 10);
+    if (str == p_end_ptr || ERANGE == errno || '-' == *str) {
+        return -1;
+    }
+
+    unsigned long long multiplier;
+    if      (!strcmp(p_end_ptr, "") || !strcmp(p_end_ptr, "ns")) { multiplier = 1; }
+    else if (!strcmp(p_end_ptr, "us"))                           { multiplier = 1000ULL; }
+    else if (!strcmp(p_end_ptr, "ms"))                           { multiplier = 1000ULL * 1000; }
+    else if (!strcmp(p_end_ptr, "s"))                            { multiplier = 1000ULL * 1000 * 1000; }
+    else if (!strcmp(p_end_ptr, "min"))                          { multiplier = 60ULL * 1000 * 1000 * 1000; }
+    else if (!strcmp(p_end_ptr, "h"))                            { multiplier = 3600ULL * 1000 * 1000 * 1000; }
+    else { return -1; }
+    if (parsed_number > UINT64_MAX / multiplier) {
+        return -1;
+    }
+
+    *ns = (uint64_t)(parsed_number * multiplier);
+    return 0;
+}
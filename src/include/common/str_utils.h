@@ -1,9 +1,14 @@
 #ifndef COMMON_STR_UTILS_H_
 #define COMMON_STR_UTILS_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 
 /* -- Function prototypes -- */
 int str_to_long(char* str, long* num);
+int str_to_size(char* str, size_t* size);
+int str_to_duration_ns(char* str, uint64_t* ns);
 
 
 #endif /* COMMON_STR_UTILS_H_ */
@@ -0,0 +1,18 @@
+#include <signal.h>
+
+#include "thread_utils.h"
+
+
+/* -- Functions -- */
+/*
+ * Creates helper thread w/ all signals blocked, as they're meant for the trace loop (e.g., to interrupt `waitpid`)
+ *   Returns `pthread_create`'s error (`0` = success)
+ */
+int thread_create_w_signals_blocked(pthread_t* thread, void* (*start_routine)(void*), void* arg) {
+    sigset_t all_signals, prev_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_SETMASK, &all_signals, &prev_signals);
+    const int error = pthread_create(thread, NULL, start_routine, arg);
+    pthread_sigmask(SIG_SETMASK, &prev_signals, NULL);
+    return error;
+}
@@ -0,0 +1,11 @@
+#ifndef COMMON_THREAD_UTILS_H_
+#define COMMON_THREAD_UTILS_H_
+
+#include <pthread.h>
+
+
+/* -- Function prototypes -- */
+int thread_create_w_signals_blocked(pthread_t* thread, void* (*start_routine)(void*), void* arg);
+
+
+#endif /* COMMON_THREAD_UTILS_H_ */
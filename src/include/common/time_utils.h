@@ -0,0 +1,16 @@
+#ifndef COMMON_TIME_UTILS_H_
+#define COMMON_TIME_UTILS_H_
+
+#include <stdint.h>
+#include <time.h>
+
+
+/* -- Functions -- */
+static inline uint64_t time_now_ns(void) {      /* `CLOCK_MONOTONIC` */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+#endif /* COMMON_TIME_UTILS_H_ */
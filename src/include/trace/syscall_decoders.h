@@ -0,0 +1,35 @@
+/**
+ * Types + formatting helpers used by the (generated) per-syscall decoders
+ *   Hand-written decoders (in `trace/internal/syscall_decoders.c`, named
+ *   `syscall_decode_<name>`) are picked up by the generator and replace
+ *   the generated ones (used for syscalls requiring struct decoding)
+ */
+#ifndef SYSCALL_DECODERS_H
+#define SYSCALL_DECODERS_H
+
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "syscall_types.h"
+
+
+/* -- Types -- */
+typedef void (*syscall_decoder_t)(FILE *stream, pid_t tid, const long args[SYSCALL_MAX_ARGS]);
+
+
+/* -- Functions -- */
+static inline void syscall_decoder_fprint_int(FILE *stream, long arg) {
+    fprintf(stream, "%ld", arg);
+}
+
+static inline void syscall_decoder_fprint_ptr(FILE *stream, long arg) {
+    fprintf(stream, "0x%lx", (unsigned long)arg);
+}
+
+
+/* -- Function prototypes -- */
+void syscall_decoder_fprint_str(FILE *stream, pid_t tid, long addr, long bytes_to_read);
+void syscall_decoder_fprint_fd(FILE *stream, pid_t tid, long fd);
+
+
+#endif /* SYSCALL_DECODERS_H */
@@ -10,7 +10,9 @@
 typedef enum {
     ARG_INT,
     ARG_PTR,
-    ARG_STR
+    ARG_STR,
+    ARG_FD,
+    ARG_PATH
 } arg_type_t;
 
 typedef struct {
@@ -7,7 +7,6 @@
  *   - Do we need PTRACE_DETATCH when using `-p` (i.e., `PTRACE_ATTACH`) option like strace does ??
  *
  * - Known issues:
- *   - execve(2) offset calculation is off when passing CLI options together (e.g., -fk) (causes app to SEGFAULT) ==> Hence options must be passed separately
  *   - Tracing:
  *      - Daemon mode (-D) + attach (-p <pid>) causes ministrace to not react to ^C ?? (e.g., `sudo ./src/ministrace -D -p `pidof wireshark``)
  *      - Running `wireshark` and attaching w/ follow flag (sudo ./src/ministrace -f -p `pidof wireshark`) crashes wireshark (when e.g., opening OS related UIs)
@@ -23,6 +22,8 @@
 #include <common/error.h>
 #include "cli.h"
 #include "trace/tracing.h"
+#include "trace/internal/calibration.h"
+#include "trace/internal/placement.h"
 #include "trace/internal/syscalls.h"
 
 
@@ -39,19 +40,101 @@ int main(int argc, char **argv) {
         return 0;
     }
 
+    /* Check CPUs prior forking tracee (which would otherwise run untraced when tracer fails to bind itself later) */
+    if (parsed_cli_args.tracer_cpus_given && !placement_cpus_usable(parsed_cli_args.tracer_cpus)) {
+        LOG_ERROR_AND_DIE("None of the specified tracer CPUs is available");
+    }
+
+/* Option 1b: Only report calibration of ptrace stop round-trip (on tracer's placement, if pinned) */
+    if (parsed_cli_args.calibrate_only) {
+        if (TRACER_PLACEMENT_PINNED == parsed_cli_args.tracer_placement) {
+            placement_init(TRACER_PLACEMENT_PINNED, parsed_cli_args.tracer_cpus);
+        }
+        calibration_t calibration;
+        if (-1 == calibration_run(&calibration)) {
+            return 1;
+        }
+        calibration_fprint(stdout, &calibration);
+        return 0;
+    }
+
 
     tracer_options_t tracer_options = {
-        .tracee_pid = parsed_cli_args.pid_to_attach_to,           /* May be later overwritten when not attaching */
-        .attach_to_tracee = (-1 != parsed_cli_args.pid_to_attach_to),
+        .backend = parsed_cli_args.backend,
+        .notif_workers = parsed_cli_args.notif_workers,
+        .tracee_pid = (parsed_cli_args.pids_to_attach_to_count > 0) ? (parsed_cli_args.pids_to_attach_to[0]) : (-1),  /* May be later overwritten when not attaching */
+        .attach_to_tracee = (parsed_cli_args.pids_to_attach_to_count > 0 || parsed_cli_args.cgroup_to_attach_to),
+        .attach_pids = parsed_cli_args.pids_to_attach_to,
+        .attach_pids_count = parsed_cli_args.pids_to_attach_to_count,
+        .attach_cgroup = parsed_cli_args.cgroup_to_attach_to,
         .pause_on_syscall_nr = parsed_cli_args.pause_on_scall_nr,
         .syscall_subset_to_be_traced = (parsed_cli_args.trace_only_syscall_subset) ? (parsed_cli_args.syscall_subset_to_be_traced) : (NULL),
         .follow_fork = parsed_cli_args.follow_fork,
         .daemonize = parsed_cli_args.daemonize_tracer,
+        .annotate_fds = parsed_cli_args.annotate_fds,
+        .trace_path_prefixes = parsed_cli_args.path_prefixes_to_be_traced,
+        .trace_path_prefixes_count = parsed_cli_args.path_prefixes_to_be_traced_count,
+        .trace_fds = parsed_cli_args.fds_to_be_traced,
+        .trace_fds_count = parsed_cli_args.fds_to_be_traced_count,
+        .filter = parsed_cli_args.filter,
+        .timestamps = (timestamps_format_t)parsed_cli_args.timestamps_level,
+        .relative_timestamps = parsed_cli_args.relative_timestamps,
+        .print_durations = parsed_cli_args.print_durations,
+        .output_format = parsed_cli_args.output_format,
+        .output_mode = parsed_cli_args.output_mode,
+        .calibrate_durations = parsed_cli_args.calibrate_durations,
+        .tracer_placement = parsed_cli_args.tracer_placement,
+        .tracer_cpus = (parsed_cli_args.tracer_cpus_given) ? (parsed_cli_args.tracer_cpus) : (NULL),
+        .trace_status = (parsed_cli_args.failed_only) ? (TRACE_STATUS_FAILED) :
+                        ((parsed_cli_args.successful_only) ? (TRACE_STATUS_SUCCESSFUL) : (TRACE_STATUS_ALL)),
+        .seccomp_bpf = parsed_cli_args.seccomp_bpf,
+        .flight_recorder_size = parsed_cli_args.flight_recorder_size,
+        .flight_recorder_trigger_syscalls = parsed_cli_args.flight_recorder_trigger_syscalls,
+        .flight_recorder_trigger_errnos = parsed_cli_args.flight_recorder_trigger_errnos,
+        .flight_recorder_trigger_errnos_count = parsed_cli_args.flight_recorder_trigger_errnos_count,
+        .flight_recorder_binary_path = parsed_cli_args.flight_recorder_binary_path,
+        .summary = parsed_cli_args.summary,
+        .summary_with_output = parsed_cli_args.summary_with_output,
+        .sample_every_nth = parsed_cli_args.sample_every_nth,
+        .sample_burst_per_window = parsed_cli_args.sample_burst_per_window,
+        .sample_every_nth_thread = parsed_cli_args.sample_every_nth_thread,
+        .overhead_budget_percent = parsed_cli_args.overhead_budget_percent,
+        .print_stats = parsed_cli_args.print_stats,
+        .record_path = parsed_cli_args.record_path,
+        .escalation_latency_ns = parsed_cli_args.escalation_latency_ns,
+        .escalation_trigger_syscalls = (parsed_cli_args.escalation_trigger_syscalls_count > 0) ? (parsed_cli_args.escalation_trigger_syscalls) : (NULL),
+        .escalation_trigger_errnos = parsed_cli_args.escalation_trigger_errnos,
+        .escalation_trigger_errnos_count = parsed_cli_args.escalation_trigger_errnos_count,
+        .escalation_window_ns = parsed_cli_args.escalation_window_ns,
+        .metrics_interval_ns = parsed_cli_args.metrics_interval_ns,
+        .metrics_format = parsed_cli_args.metrics_format,
+        .metrics_output = parsed_cli_args.metrics_output,
+        .metrics_per_process = parsed_cli_args.metrics_per_process,
+        .metrics_cumulative = !parsed_cli_args.metrics_reset,
+        .control_socket = parsed_cli_args.control_socket,
+        .output_path = parsed_cli_args.output_path,
+        .output_rotate_size = parsed_cli_args.output_rotate_size,
+        .output_rotate_interval_ns = parsed_cli_args.output_rotate_interval_ns,
+        .output_rotate_keep = (unsigned)parsed_cli_args.output_rotate_keep,
+        .output_compression = parsed_cli_args.output_compression,
 #ifdef WITH_STACK_UNWINDING
         .print_stacktrace = parsed_cli_args.print_stack_traces
 #endif /* WITH_STACK_UNWINDING */
     };
 
+    /* seccomp filter is installed by tracee itself (prior `exec`) + inherited by all its children (which hence must be traced too) */
+    if (tracer_options.seccomp_bpf) {
+        if (tracer_options.attach_to_tracee || tracer_options.daemonize) {
+            LOG_WARN("seccomp-BPF can't be used when attaching to a process or daemonizing -- Ignoring it");
+            tracer_options.seccomp_bpf = false;
+        } else {
+            tracer_options.follow_fork = true;
+        }
+    }
+
+    /* seccomp-notif backend is set up by tracee itself too  -> Decide prior forking whether it can be used */
+    tracing_select_backend(&tracer_options);
+
 /* Option 2a: Attach to existing process */
     if (tracer_options.attach_to_tracee) {
         return do_tracer(&tracer_options);
@@ -12,14 +12,13 @@
 /* ----------------------- ----------------------- i386 / amd64 ----------------------- ----------------------- */
 #if defined(__i386__) || defined(__x86_64__)
 
+/*
+ * NOTE: `PTRACE_GETREGS` (instead of `PTRACE_GETREGSET`), as it always yields the tracer's layout, whereas `NT_PRSTATUS`
+ *       yields the tracee's one (i.e., i386's `user_regs_struct` for 32-bit tasks traced on amd64)
+ */
 int ptrace_get_regs_content(pid_t tid, struct user_regs_struct_full *regs) {
-    struct iovec iov = {
-            .iov_base = regs,
-            .iov_len = sizeof(struct user_regs_struct_full),
-    };
-
     errno = 0;
-    ptrace(PTRACE_GETREGSET, tid, NT_PRSTATUS, &iov);
+    ptrace(PTRACE_GETREGS, tid, NULL, regs);
     if (errno) {
         if (ESRCH == errno) { return -1; }
         LOG_ERROR_AND_DIE("Reading registers failed -- %s", strerror(errno));
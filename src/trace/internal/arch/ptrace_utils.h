@@ -38,6 +38,16 @@
 #    define USER_REGS_STRUCT_SC_ARG4(regss)      (regss.r8)
 #    define USER_REGS_STRUCT_SC_ARG5(regss)      (regss.r9)
 #    define USER_REGS_STRUCT_SC_HAS_RTNED(regss) (regss.rax != ((unsigned long long)-38))     /* -38 (ENOSYS) is put into RAX as a default return value by the kernel's syscall entry code */
+
+/* - Syscalls of 32-bit tasks (i.e., i386 ABI: other nrs + arg registers) - */
+#    define USER_REGS_STRUCT_SC_IS_COMPAT32(regss)  (0x23 == regss.cs)    /* i386 code segment (32-bit task; NOT `int 0x80` in 64-bit task, which keeps its cs) */
+/*   NOTE: Zero-extended (i.e., valid as ptrs into tracee); int args are sign-extended based on the syscall's signature (see `syscalls_get_args`) */
+#    define USER_REGS_STRUCT_SC_COMPAT32_ARG0(regss) ((unsigned int)regss.rbx)
+#    define USER_REGS_STRUCT_SC_COMPAT32_ARG1(regss) ((unsigned int)regss.rcx)
+#    define USER_REGS_STRUCT_SC_COMPAT32_ARG2(regss) ((unsigned int)regss.rdx)
+#    define USER_REGS_STRUCT_SC_COMPAT32_ARG3(regss) ((unsigned int)regss.rsi)
+#    define USER_REGS_STRUCT_SC_COMPAT32_ARG4(regss) ((unsigned int)regss.rdi)
+#    define USER_REGS_STRUCT_SC_COMPAT32_ARG5(regss) ((unsigned int)regss.rbp)
 #  else /* __i386__ */
 #    define USER_REGS_STRUCT_IP(regss)           (regss.eip)
 #    define USER_REGS_STRUCT_SP(regss)           (regss.esp)
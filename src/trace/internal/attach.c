@@ -0,0 +1,177 @@
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ptrace.h>
+#include <sys/time.h>
+
+#include <common/error.h>
+#include "tracees.h"
+#include "attach.h"
+
+
+/* -- Consts -- */
+#define ATTACH_MAX_PASSES 8             /* Threads are re-enumerated until no new ones show up (they may be created meanwhile) */
+
+
+/* -- Globals -- */
+static struct {
+    int ptrace_options;
+    char cgroup_tasks_path[4096];       /* Empty = no cgroup */
+    sigset_t poll_signal_set;           /* `SIGALRM` */
+} attach;
+
+static volatile sig_atomic_t cgroup_scan_requested = 0;
+
+
+/* -- Function prototypes -- */
+static int seize_task(pid_t tid);
+static void request_cgroup_scan(int signo);
+
+
+/* -- Functions -- */
+void attach_init(int ptrace_options, const char* cgroup_path) {
+    attach.ptrace_options = ptrace_options;
+    attach.cgroup_tasks_path[0] = '\0';
+    if (!cgroup_path) {
+        return;
+    }
+
+/* Resolve file listing tasks of cgroup (v2: `cgroup.threads`, v1: `tasks`) */
+    char cgroup_dir[sizeof(attach.cgroup_tasks_path) - 32];
+    if ('/' == cgroup_path[0]) {
+        snprintf(cgroup_dir, sizeof(cgroup_dir), "%s", cgroup_path);
+    } else {
+        snprintf(cgroup_dir, sizeof(cgroup_dir), ATTACH_CGROUP_FS_DIR "/%s", cgroup_path);
+    }
+    static const char* const tasks_files[] = { "cgroup.threads", "tasks" };
+    for (size_t i = 0; i < sizeof(tasks_files) / sizeof(*tasks_files); i++) {
+        snprintf(attach.cgroup_tasks_path, sizeof(attach.cgroup_tasks_path), "%s/%s", cgroup_dir, tasks_files[i]);
+        if (!access(attach.cgroup_tasks_path, R_OK)) {
+            return;
+        }
+    }
+    LOG_ERROR_AND_DIE("Couldn't read tasks of cgroup \"%s\"", cgroup_dir);
+}
+
+void attach_fin(void) {
+    if (attach.cgroup_tasks_path[0]) {
+        const struct itimerval no_timer = { { 0, 0 }, { 0, 0 } };
+        setitimer(ITIMER_REAL, &no_timer, NULL);
+        signal(SIGALRM, SIG_IGN);       /* (Discards pending one) */
+        pthread_sigmask(SIG_UNBLOCK, &attach.poll_signal_set, NULL);
+        signal(SIGALRM, SIG_DFL);
+    }
+}
+
+
+/*
+ * Seizes all threads of process `pid` (returns nr of seized threads; `-1` = none could be seized)
+ */
+int attach_process(pid_t pid) {
+    char task_dir_path[64];
+    snprintf(task_dir_path, sizeof(task_dir_path), "/proc/%d/task", pid);
+
+    int seized_count = 0;
+    for (int pass = 0, pass_seized_count = 1; pass < ATTACH_MAX_PASSES && pass_seized_count > 0; pass++) {
+        DIR* const task_dir = opendir(task_dir_path);
+        if (!task_dir) {
+            break;
+        }
+        pass_seized_count = 0;
+        for (struct dirent* entry; (entry = readdir(task_dir)); ) {
+            const pid_t tid = (pid_t)atoi(entry->d_name);
+            if (tid > 0 && 1 == seize_task(tid)) {
+                pass_seized_count++;
+            }
+        }
+        closedir(task_dir);
+        seized_count += pass_seized_count;
+    }
+    return (seized_count || tracees_get(pid)) ? (seized_count) : (-1);
+}
+
+/*
+ * Seizes tasks in cgroup which aren't traced yet (returns nr of newly seized tasks; `-1` = cgroup couldn't be read)
+ */
+int attach_cgroup_scan(void) {
+    FILE* const tasks_file = fopen(attach.cgroup_tasks_path, "r");
+    if (!tasks_file) {
+        return -1;
+    }
+
+    int seized_count = 0;
+    for (int tid; 1 == fscanf(tasks_file, "%d", &tid); ) {
+        if (1 == seize_task((pid_t)tid)) {
+            seized_count++;
+        }
+    }
+    fclose(tasks_file);
+    return seized_count;
+}
+
+
+/*
+ * Starts poll timer  (NOTE: Its signal is kept blocked, except while waiting for tracees, as it's delivered w/o
+ * `SA_RESTART` to interrupt `waitpid`(2) -- but must NOT interrupt other blocking calls, e.g., writes of the output)
+ */
+void attach_cgroup_start_polling(void) {
+    sigemptyset(&attach.poll_signal_set);
+    sigaddset(&attach.poll_signal_set, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &attach.poll_signal_set, NULL);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = request_cgroup_scan;
+    sigemptyset(&sa.sa_mask);
+    DIE_WHEN_ERRNO( sigaction(SIGALRM, &sa, NULL) );
+
+    const struct itimerval poll_timer = {
+        .it_interval = { .tv_sec = 0, .tv_usec = ATTACH_CGROUP_POLL_INTERVAL_MS * 1000 },
+        .it_value    = { .tv_sec = 0, .tv_usec = ATTACH_CGROUP_POLL_INTERVAL_MS * 1000 }
+    };
+    DIE_WHEN_ERRNO( setitimer(ITIMER_REAL, &poll_timer, NULL) );
+}
+
+/*
+ * Trace loop: Unblocks poll signal right before waiting for tracees (+ blocks it again right after)
+ *   (A signal arriving in between is pending until the next wait  -> Delays scan by at most one poll interval)
+ */
+void attach_cgroup_set_poll_signal_unblocked(bool unblocked) {
+    pthread_sigmask((unblocked) ? (SIG_UNBLOCK) : (SIG_BLOCK), &attach.poll_signal_set, NULL);
+}
+
+void attach_cgroup_scan_if_requested(void) {
+    if (cgroup_scan_requested) {
+        cgroup_scan_requested = 0;
+        attach_cgroup_scan();
+    }
+}
+
+
+/* - Helpers - */
+/*
+ * Returns `1` = seized, `0` = already a tracee, `-1` = couldn't be seized (e.g., exited meanwhile, or traced by someone else)
+ */
+static int seize_task(pid_t tid) {
+    if (tracees_get(tid)) {
+        return 0;
+    }
+
+    if (-1 == ptrace(PTRACE_SEIZE, tid, 0, attach.ptrace_options) ||
+        -1 == ptrace(PTRACE_INTERRUPT, tid, 0, 0)) {
+        LOG_DEBUG("Couldn't seize task %d -- %s", tid, strerror(errno));
+        return -1;
+    }
+    tracees_get_or_add(tid);
+    return 1;
+}
+
+static void request_cgroup_scan(int signo) {
+    (void)signo;
+    cgroup_scan_requested = 1;
+}
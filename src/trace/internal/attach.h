@@ -0,0 +1,35 @@
+/**
+ * Attaching to multiple running processes (`-p` passed multiple times) / all tasks of a cgroup (`--cgroup`)
+ *   - Tasks are seized (`PTRACE_SEIZE`, which also sets the ptrace options) + interrupted (`PTRACE_INTERRUPT`), i.e.,
+ *     unlike `PTRACE_ATTACH`, no `SIGSTOP` is injected; their `PTRACE_EVENT_STOP` is consumed (+ restarted) by the trace loop
+ *   - Processes: All their threads (`/proc/<pid>/task`)
+ *   - cgroup:    All tasks listed in `cgroup.threads` (v2) / `tasks` (v1); polled for new tasks every
+ *                `ATTACH_CGROUP_POLL_INTERVAL_MS` (membership changes can't be watched via inotify)  -> `SIGALRM` interrupts
+ *                the tracer's `waitpid`(2) (it's blocked otherwise), after which it calls `attach_cgroup_scan_if_requested`
+ *   Seized tasks are registered as tracees (i.e., tasks which are already tracees aren't seized again)
+ */
+#ifndef ATTACH_H
+#define ATTACH_H
+
+#include <stdbool.h>
+#include <unistd.h>
+
+
+/* -- Consts -- */
+#define ATTACH_CGROUP_POLL_INTERVAL_MS 100
+#define ATTACH_CGROUP_FS_DIR "/sys/fs/cgroup"           /* Relative cgroup paths are resolved against it */
+
+
+/* -- Function prototypes -- */
+void attach_init(int ptrace_options, const char* cgroup_path);
+void attach_fin(void);
+
+int attach_process(pid_t pid);
+int attach_cgroup_scan(void);
+
+void attach_cgroup_start_polling(void);
+void attach_cgroup_set_poll_signal_unblocked(bool unblocked);
+void attach_cgroup_scan_if_requested(void);
+
+
+#endif /* ATTACH_H */
@@ -0,0 +1,123 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/ptrace.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <common/cpu_utils.h>
+#include <common/error.h>
+#include <common/time_utils.h>
+#include "ptrace_utils.h"
+#include "calibration.h"
+
+
+/* -- Consts -- */
+#define PTRACE_TRAP_INDICATOR_BIT (1 << 7)
+
+#define CALIBRATION_WARMUP_SYSCALLS 100
+#define CALIBRATION_SYSCALLS        2000
+
+
+/* -- Globals -- */
+uint64_t calibration_stop_roundtrip_ns = 0;
+
+
+/* -- Function prototypes -- */
+static void run_helper(void);
+static int compare_u64(const void* a, const void* b);
+
+
+/* -- Functions -- */
+int calibration_run(calibration_t* calibration) {
+/* 0. Start helper (stops itself until tracer is ready) */
+    const pid_t helper_pid = DIE_WHEN_ERRNO( fork() );
+    if (!helper_pid) {
+        DIE_WHEN_ERRNO( ptrace(PTRACE_TRACEME) );
+        DIE_WHEN_ERRNO( kill(getpid(), SIGSTOP) );
+        run_helper();
+        _exit(0);
+    }
+
+    int status;
+    DIE_WHEN_ERRNO( waitpid(helper_pid, &status, 0) );
+    DIE_WHEN_ERRNO( ptrace(PTRACE_SETOPTIONS, helper_pid, 0, PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL) );
+
+/* 1. Trace helper: Time from syscall-enter- to syscall-exit-stop of each no-op syscall  (incl. reading registers, like the tracer) */
+    uint64_t* const samples = DIE_WHEN_ERRNO_VPTR( calloc(CALIBRATION_SYSCALLS, sizeof(*samples)) );
+    size_t samples_count = 0, noop_syscalls_seen = 0;
+    uint64_t enter_ns = 0;
+    int helper_cpu = -1;
+
+    for (int pending_signal = 0; ; ) {
+        DIE_WHEN_ERRNO( ptrace(PTRACE_SYSCALL, helper_pid, 0, pending_signal) );
+        DIE_WHEN_ERRNO( waitpid(helper_pid, &status, 0) );
+        const uint64_t stop_ns = time_now_ns();
+        pending_signal = 0;
+
+        if (!WIFSTOPPED(status)) { break; }
+        if ((SIGTRAP | PTRACE_TRAP_INDICATOR_BIT) != WSTOPSIG(status)) {
+            pending_signal = WSTOPSIG(status);
+            continue;
+        }
+
+        struct user_regs_struct_full regs;
+        if (-1 == ptrace_get_regs_content(helper_pid, &regs)) { break; }
+        if (SYS_getppid != USER_REGS_STRUCT_SC_NO(regs)) { continue; }
+
+        if (!USER_REGS_STRUCT_SC_HAS_RTNED(regs)) {
+            enter_ns = stop_ns;
+        } else if (enter_ns && noop_syscalls_seen++ >= CALIBRATION_WARMUP_SYSCALLS &&
+                   samples_count < CALIBRATION_SYSCALLS) {
+            samples[samples_count++] = stop_ns - enter_ns;
+            if (CALIBRATION_SYSCALLS == samples_count) {
+                helper_cpu = cpu_last_of_task(helper_pid);
+            }
+        }
+    }
+    waitpid(helper_pid, &status, 0);        /* (Reap, if not already) */
+
+/* 2. Distribution */
+    if (!samples_count) {
+        free(samples);
+        LOG_WARN("Calibration failed (traced no syscalls of helper)");
+        return -1;
+    }
+    qsort(samples, samples_count, sizeof(*samples), compare_u64);
+    calibration->samples_count = samples_count;
+    calibration->min_ns = samples[0];
+    calibration->p50_ns = samples[samples_count / 2];
+    calibration->p90_ns = samples[samples_count * 90 / 100];
+    calibration->p99_ns = samples[samples_count * 99 / 100];
+    calibration->max_ns = samples[samples_count - 1];
+    calibration->tracer_cpu = sched_getcpu();
+    calibration->helper_cpu = helper_cpu;
+    free(samples);
+
+    return 0;
+}
+
+void calibration_fprint(FILE* stream, const calibration_t* calibration) {
+    fprintf(stream, "+++ Calibration: ptrace stop round-trip of %zu no-op syscalls (tracer on CPU %d, tracee on CPU %d):"
+                    " min %llu ns, p50 %llu ns, p90 %llu ns, p99 %llu ns, max %llu ns +++\n",
+            calibration->samples_count, calibration->tracer_cpu, calibration->helper_cpu,
+            (unsigned long long)calibration->min_ns, (unsigned long long)calibration->p50_ns,
+            (unsigned long long)calibration->p90_ns, (unsigned long long)calibration->p99_ns,
+            (unsigned long long)calibration->max_ns);
+}
+
+
+/* - Helpers - */
+static void run_helper(void) {
+    for (int i = 0; i < CALIBRATION_WARMUP_SYSCALLS + CALIBRATION_SYSCALLS; i++) {
+        syscall(SYS_getppid);
+    }
+}
+
+static int compare_u64(const void* a, const void* b) {
+    const uint64_t lhs = *(const uint64_t*)a, rhs = *(const uint64_t*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
@@ -0,0 +1,40 @@
+/**
+ * Calibration of the ptrace stop round-trip (`--calibrate`)
+ *   Durations measured between a syscall-enter- and a syscall-exit-stop include the cost of the stops
+ *   themselves (waking the tracer, reading registers, restarting the tracee, ...), which dominates for fast syscalls
+ *   -> Measured (at startup or on request, i.e., `--calibrate=only`) by tracing a helper process issuing
+ *      no-op syscalls (`getppid`) on the tracer's CPU placement
+ *   -> Median is subtracted from all durations (`-T`, `-c`, `duration` in filter expressions, escalation latency, ...)
+ */
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/* -- Types -- */
+typedef struct {
+    size_t samples_count;
+    uint64_t min_ns, p50_ns, p90_ns, p99_ns, max_ns;
+    int tracer_cpu, helper_cpu;         /* `-1` = unknown */
+} calibration_t;
+
+
+/* -- Globals -- */
+extern uint64_t calibration_stop_roundtrip_ns;     /* Subtracted from durations (`0` = not calibrated) */
+
+
+/* -- Function prototypes -- */
+int calibration_run(calibration_t* calibration);
+void calibration_fprint(FILE* stream, const calibration_t* calibration);
+
+
+/* -- Functions -- */
+static inline uint64_t calibration_correct_duration_ns(uint64_t duration_ns) {
+    return (duration_ns > calibration_stop_roundtrip_ns) ? (duration_ns - calibration_stop_roundtrip_ns) : (0);
+}
+
+
+#endif /* CALIBRATION_H */
@@ -0,0 +1,438 @@
+#define _GNU_SOURCE             /* `accept4`, `F_DUPFD_CLOEXEC` */
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <common/error.h>
+#include <common/str_utils.h>
+#include <common/thread_utils.h>
+#include "syscalls.h"
+#include "control.h"
+
+
+/* -- Consts -- */
+#define CONTROL_WAKE_UP_RETRY_NS (100ULL * 1000 * 1000)     /* Signal may arrive right before trace loop blocks in `waitpid`  -> Resent */
+#define CONTROL_MIN_STRSIZE 16
+#define CONTROL_MAX_STRSIZE (1024 * 1024)
+
+static const char* const USAGE =
+    "trace <syscall_set> | all\n"
+    "sample-every <n>\n"
+    "strsize <bytes>\n"
+    "unwind on | off\n"
+    "output <path> | -\n"
+    "stats\n"
+    "detach\n"
+    "help\n";
+
+
+/* -- Globals -- */
+static struct {
+    const char* socket_path;
+    int listen_fd;
+    int client_fd;                          /* `-1` = none */
+    int stderr_fd;                          /* (Dup of) original `stderr` (for `output -`) */
+    bool unwinding_available;
+
+    control_config_t* config;               /* Active config (only replaced by trace loop, while a request is in flight) */
+
+    pthread_t loop_thread;
+    pthread_t thread;
+    pthread_mutex_t lock;                   /* Protects all below */
+    pthread_cond_t completed_cond;
+    control_request_t request;              /* In flight (at most one) */
+    control_config_t* request_config;       /* New config of request (`NULL` = unchanged) */
+    bool request_pending;                   /* Handed to trace loop, not taken yet (also accessed atomically w/o lock) */
+    bool request_completed;
+    bool stop;
+
+    char error[256];                        /* (Control thread only) */
+} control;
+
+
+/* -- Function prototypes -- */
+static void* control_main(void* ctx);
+static void serve_client(int client_fd);
+static const char* handle_command(char* line, FILE* reply);
+static const char* submit(control_command_t command, control_config_t* new_config, int output_fd, FILE* reply);
+static control_config_t* copy_config(void);
+static void send_all(int fd, const char* buf, size_t len);
+static void wake_up(int sig);
+
+
+/* -- Functions -- */
+void control_init(const char* socket_path, const control_config_t* initial_config, bool unwinding_available) {
+/* 0. State */
+    control.socket_path = socket_path;
+    control.client_fd = -1;
+    control.unwinding_available = unwinding_available;
+    control.config = DIE_WHEN_ERRNO_VPTR( malloc(sizeof(*control.config)) );
+    *control.config = *initial_config;
+    control.request_config = NULL;
+    control.request_pending = control.request_completed = control.stop = false;
+    control.stderr_fd = DIE_WHEN_ERRNO( fcntl(STDERR_FILENO, F_DUPFD_CLOEXEC, 0) );
+
+/* 1. Socket (accessible only by owner) */
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        LOG_ERROR_AND_DIE("Control socket path \"%s\" is too long", socket_path);
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    struct stat st;
+    if (!lstat(socket_path, &st) && S_ISSOCK(st.st_mode)) {     /* Stale socket (e.g., of killed tracer) */
+        unlink(socket_path);
+    }
+    control.listen_fd = DIE_WHEN_ERRNO( socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) );
+    const mode_t prev_umask = umask(0077);
+    const int bind_rtn = bind(control.listen_fd, (const struct sockaddr*)&addr, sizeof(addr));
+    umask(prev_umask);
+    if (-1 == bind_rtn || -1 == listen(control.listen_fd, 1)) {
+        LOG_ERROR_AND_DIE("Couldn't create control socket \"%s\" -- %s", socket_path, strerror(errno));
+    }
+
+/* 2. Wake-up signal of trace loop (w/o `SA_RESTART`, to interrupt `waitpid`) */
+    control.loop_thread = pthread_self();
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = wake_up;
+    sigemptyset(&sa.sa_mask);
+    DIE_WHEN_ERRNO( sigaction(CONTROL_WAKE_UP_SIGNAL, &sa, NULL) );
+
+/* 3. Control thread */
+    pthread_mutex_init(&control.lock, NULL);
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&control.completed_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    const int error = thread_create_w_signals_blocked(&control.thread, control_main, NULL);
+    if (error) {
+        LOG_ERROR_AND_DIE("Couldn't create control thread -- %s", strerror(error));
+    }
+}
+
+/*
+ * Trace loop (once it has ended): Stops control thread (requests not taken yet are answered w/ an error)
+ */
+void control_fin(void) {
+    pthread_mutex_lock(&control.lock);
+    control.stop = true;
+    pthread_cond_signal(&control.completed_cond);
+    if (-1 != control.client_fd) {
+        shutdown(control.client_fd, SHUT_RD);       /* (Reply of request in flight, e.g., `detach`, is still sent) */
+    }
+    pthread_mutex_unlock(&control.lock);
+    shutdown(control.listen_fd, SHUT_RDWR);         /* (Interrupts `accept`) */
+    pthread_join(control.thread, NULL);
+
+    close(control.listen_fd);
+    unlink(control.socket_path);
+    signal(CONTROL_WAKE_UP_SIGNAL, SIG_DFL);
+    pthread_cond_destroy(&control.completed_cond);
+    pthread_mutex_destroy(&control.lock);
+    close(control.stderr_fd);
+    free(control.config);
+    control.config = NULL;
+}
+
+
+const control_config_t* control_get_config(void) {
+    return control.config;
+}
+
+/*
+ * Trace loop: Takes pending request (`NULL` = none), whose config (if changed) becomes the active one at once
+ *   Taken requests MUST be completed (`control_complete_request`)
+ */
+control_request_t* control_take_request(void) {
+    if (!__atomic_load_n(&control.request_pending, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&control.lock);
+    control_request_t* request = NULL;
+    if (control.request_pending) {
+        control.request_pending = false;
+        if (control.request_config) {
+            free(control.config);
+            control.config = control.request_config;
+            control.request_config = NULL;
+        }
+        request = &control.request;
+    }
+    pthread_mutex_unlock(&control.lock);
+    return request;
+}
+
+void control_complete_request(__attribute__((unused)) control_request_t* request) {
+    pthread_mutex_lock(&control.lock);
+    control.request_completed = true;
+    pthread_cond_signal(&control.completed_cond);
+    pthread_mutex_unlock(&control.lock);
+}
+
+/*
+ * Trace loop: Replaces `stderr` (i.e., trace output) w/ the specified file (`-1` = original `stderr`)
+ */
+void control_redirect_output(int output_fd) {
+    fflush(stderr);
+    DIE_WHEN_ERRNO( dup2((-1 == output_fd) ? (control.stderr_fd) : (output_fd), STDERR_FILENO) );
+    if (-1 != output_fd) {
+        close(output_fd);
+    }
+}
+
+
+/* - Control thread - */
+static void* control_main(__attribute__((unused)) void* ctx) {
+    for (;;) {
+        const int client_fd = accept4(control.listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (-1 == client_fd) {
+            if (__atomic_load_n(&control.stop, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            if (EINTR == errno || ECONNABORTED == errno) {
+                continue;
+            }
+            LOG_WARN("Couldn't accept control connection -- %s", strerror(errno));
+            break;
+        }
+
+        pthread_mutex_lock(&control.lock);
+        const bool stop = control.stop;
+        control.client_fd = (stop) ? (-1) : (client_fd);
+        pthread_mutex_unlock(&control.lock);
+        if (!stop) {
+            serve_client(client_fd);
+        }
+
+        pthread_mutex_lock(&control.lock);
+        control.client_fd = -1;
+        pthread_mutex_unlock(&control.lock);
+        close(client_fd);
+    }
+    return NULL;
+}
+
+static void serve_client(int client_fd) {
+    const int in_fd = fcntl(client_fd, F_DUPFD_CLOEXEC, 0);
+    FILE* const in = (-1 != in_fd) ? (fdopen(in_fd, "r")) : (NULL);
+    if (!in) {
+        LOG_WARN("Couldn't read from control connection -- %s", strerror(errno));
+        if (-1 != in_fd) {
+            close(in_fd);
+        }
+        return;
+    }
+
+    char* line = NULL;
+    size_t line_size = 0;
+    for (ssize_t line_len; -1 != (line_len = getline(&line, &line_size, in)); ) {
+        while (line_len > 0 && ('\n' == line[line_len - 1] || '\r' == line[line_len - 1])) {
+            line[--line_len] = '\0';
+        }
+
+        char* reply_buf = NULL;
+        size_t reply_len = 0;
+        FILE* const reply = DIE_WHEN_ERRNO_VPTR( open_memstream(&reply_buf, &reply_len) );
+        const char* const error = handle_command(line, reply);
+        if (error) {
+            fprintf(reply, "error: %s\n", error);
+        } else {
+            fputs("ok\n", reply);
+        }
+        fclose(reply);
+        send_all(client_fd, reply_buf, reply_len);
+        free(reply_buf);
+
+        if (__atomic_load_n(&control.stop, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+    }
+    free(line);
+    fclose(in);
+}
+
+/*
+ * Parses + validates command, then (if valid) hands it to the trace loop; returns error (`NULL` = none)
+ */
+static const char* handle_command(char* line, FILE* reply) {
+    char* save_ptr = NULL;
+    const char* const command = strtok_r(line, " \t", &save_ptr);
+    char* arg = strtok_r(NULL, "", &save_ptr);          /* (Rest of line, e.g., paths w/ spaces) */
+    while (arg && (' ' == *arg || '\t' == *arg)) {
+        arg++;
+    }
+    if (arg && !*arg) {
+        arg = NULL;
+    }
+
+    if (!command) {
+        return "empty command";
+    }
+    if (!strcmp("help", command)) {
+        fputs(USAGE, reply);
+        return NULL;
+    }
+
+    if (!strcmp("stats", command) || !strcmp("detach", command)) {
+        if (arg) {
+            return "command takes no argument";
+        }
+        return submit(('s' == command[0]) ? (CONTROL_COMMAND_STATS) : (CONTROL_COMMAND_DETACH), NULL, -1, reply);
+    }
+
+    if (!arg) {
+        static const char* const COMMANDS_W_ARG[] = { "trace", "sample-every", "strsize", "unwind", "output" };
+        for (size_t i = 0; i < sizeof(COMMANDS_W_ARG) / sizeof(*COMMANDS_W_ARG); i++) {
+            if (!strcmp(COMMANDS_W_ARG[i], command)) {
+                return "missing argument (see help)";
+            }
+        }
+        return "unknown command (see help)";
+    }
+    if (!strcmp("trace", command)) {
+        control_config_t* const config = copy_config();
+        config->syscall_subset_enabled = !!strcmp("all", arg);
+        memset(config->syscall_subset, 0, sizeof(config->syscall_subset));
+        if (config->syscall_subset_enabled) {
+            char* name_save_ptr = NULL;
+            for (char* name = strtok_r(arg, ",", &name_save_ptr); name; name = strtok_r(NULL, ",", &name_save_ptr)) {
+                const long scall_nr = syscalls_get_nr(name);
+                if (-1 == scall_nr) {
+                    free(config);
+                    snprintf(control.error, sizeof(control.error), "unknown system call \"%s\"", name);
+                    return control.error;
+                }
+                config->syscall_subset[scall_nr] = true;
+            }
+        }
+        return submit(CONTROL_COMMAND_SET_TRACE, config, -1, reply);
+
+    } else if (!strcmp("sample-every", command)) {
+        long every_nth = -1;
+        if (strlen(arg) != strspn(arg, "0123456789") || -1 == str_to_long(arg, &every_nth) || every_nth < 0) {
+            return "invalid sampling rate (must be >= 0)";
+        }
+        control_config_t* const config = copy_config();
+        config->sample_every_nth = (unsigned)every_nth;
+        return submit(CONTROL_COMMAND_SET_SAMPLE_EVERY, config, -1, reply);
+
+    } else if (!strcmp("strsize", command)) {
+#ifdef PRINT_COMPLETE_STRING_ARGS
+        return "strings are always read completely (built w/ PRINT_COMPLETE_STRING_ARGS)";
+#else
+        size_t max_bytes = 0;
+        if (-1 == str_to_size(arg, &max_bytes) || max_bytes < CONTROL_MIN_STRSIZE || max_bytes > CONTROL_MAX_STRSIZE) {
+            snprintf(control.error, sizeof(control.error), "invalid size (must be in [%d, %d])",
+                     CONTROL_MIN_STRSIZE, CONTROL_MAX_STRSIZE);
+            return control.error;
+        }
+        control_config_t* const config = copy_config();
+        config->string_max_bytes = max_bytes;
+        return submit(CONTROL_COMMAND_SET_STRSIZE, config, -1, reply);
+#endif /* PRINT_COMPLETE_STRING_ARGS */
+
+    } else if (!strcmp("unwind", command)) {
+        const bool on = !strcmp("on", arg);
+        if (!on && strcmp("off", arg)) {
+            return "must be \"on\" or \"off\"";
+        }
+        if (!control.unwinding_available) {
+            return "stack unwinding isn't set up (requires -k or --escalate-*)";
+        }
+        control_config_t* const config = copy_config();
+        config->unwinding = on;
+        return submit(CONTROL_COMMAND_SET_UNWIND, config, -1, reply);
+
+    } else if (!strcmp("output", command)) {
+        int output_fd = -1;
+        if (strcmp("-", arg) && -1 == (output_fd = open(arg, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644))) {
+            snprintf(control.error, sizeof(control.error), "couldn't open \"%s\" -- %s", arg, strerror(errno));
+            return control.error;
+        }
+        return submit(CONTROL_COMMAND_SET_OUTPUT, NULL, output_fd, reply);
+    }
+
+    return "unknown command (see help)";
+}
+
+/*
+ * Hands request to trace loop + waits until it has been completed (or tracing stopped)
+ */
+static const char* submit(control_command_t command, control_config_t* new_config, int output_fd, FILE* reply) {
+    pthread_mutex_lock(&control.lock);
+    if (control.stop) {
+        pthread_mutex_unlock(&control.lock);
+        free(new_config);
+        if (-1 != output_fd) {
+            close(output_fd);
+        }
+        return "tracing has ended";
+    }
+    control.request.command = command;
+    control.request.output_fd = output_fd;
+    control.request.reply = reply;
+    control.request_config = new_config;
+    control.request_completed = false;
+    __atomic_store_n(&control.request_pending, true, __ATOMIC_RELEASE);
+
+    while (!control.request_completed && !control.stop) {
+        pthread_kill(control.loop_thread, CONTROL_WAKE_UP_SIGNAL);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        const uint64_t deadline_ns = (uint64_t)deadline.tv_nsec + CONTROL_WAKE_UP_RETRY_NS;
+        deadline.tv_sec += (time_t)(deadline_ns / 1000000000ULL);
+        deadline.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+        pthread_cond_timedwait(&control.completed_cond, &control.lock, &deadline);
+    }
+
+    const char* error = NULL;
+    if (!control.request_completed) {       /* Tracing stopped prior taking it */
+        control.request_pending = false;
+        free(control.request_config);
+        control.request_config = NULL;
+        if (-1 != output_fd) {
+            close(output_fd);
+        }
+        error = "tracing has ended";
+    }
+    pthread_mutex_unlock(&control.lock);
+    return error;
+}
+
+/*
+ * Copy of active config (to be changed + handed to trace loop)
+ */
+static control_config_t* copy_config(void) {
+    control_config_t* const config = DIE_WHEN_ERRNO_VPTR( malloc(sizeof(*config)) );
+    *config = *control.config;      /* (Not replaced meanwhile, as only replaced while a request is in flight) */
+    return config;
+}
+
+static void send_all(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        const ssize_t sent = send(fd, buf, len, MSG_NOSIGNAL);      /* (W/o `SIGPIPE`) */
+        if (-1 == sent) {
+            if (EINTR == errno) { continue; }
+            return;
+        }
+        buf += sent;
+        len -= (size_t)sent;
+    }
+}
+
+static void wake_up(__attribute__((unused)) int sig) { }
@@ -0,0 +1,73 @@
+/**
+ * Control socket (`--control-socket=<path>`, w/ `-p` / `--cgroup` / `-D`): Changes what's traced w/o detaching
+ *   - Local UNIX stream socket accepting one command per line (one client at a time); each command is answered by
+ *     its output (if any), followed by a line `ok` or `error: <reason>`:
+ *       trace <syscall_set> | all      Trace only the specified (as comma-list seperated) system calls (`-e`)
+ *       sample-every <n>               Print only every n-th call of each system call (`0` = all)
+ *       strsize <bytes>                Max. bytes read of string args + payloads
+ *       unwind on | off                Stack unwinding (requires it to be set up, i.e., `-k` or `--escalate-*`)
+ *       output <path> | -              Write trace output to file (appended) / back to `stderr` (or `-o` file)
+ *       stats                          Report `--stats` / `-c` / sampling statistics so far
+ *       detach                         Detach from all tracees (which continue running) + exit
+ *       help
+ *   - Commands are parsed + validated by a control thread, which then hands them to the trace loop + waits until
+ *     it has applied them  -> Requests are only taken by the trace loop between stops (i.e., w/o any tracee held
+ *     stopped) right before waiting for the next one; a blocked `waitpid` is interrupted via `CONTROL_WAKE_UP_SIGNAL`
+ *   - Config changes are made to a copy, which replaces the active config at once (i.e., the trace loop never sees a
+ *     partially updated config)
+ *   NOTE: seccomp-BPF (whose filter could be regenerated) isn't available when attaching / daemonizing
+ */
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include <trace/syscallents.h>
+
+
+/* -- Consts -- */
+#define CONTROL_WAKE_UP_SIGNAL SIGURG       /* (Ignored by default) */
+
+
+/* -- Types -- */
+typedef struct {
+    bool syscall_subset_enabled;            /* `false` = all syscalls are traced */
+    bool syscall_subset[SYSCALLS_ARR_SIZE];
+    unsigned sample_every_nth;              /* `0` = disabled */
+    size_t string_max_bytes;                /* `0` = default */
+    bool unwinding;
+} control_config_t;
+
+typedef enum {
+    CONTROL_COMMAND_SET_TRACE,              /* (Config is already swapped when request is taken) */
+    CONTROL_COMMAND_SET_SAMPLE_EVERY,
+    CONTROL_COMMAND_SET_STRSIZE,
+    CONTROL_COMMAND_SET_UNWIND,
+    CONTROL_COMMAND_SET_OUTPUT,
+    CONTROL_COMMAND_STATS,
+    CONTROL_COMMAND_DETACH
+} control_command_t;
+
+typedef struct {
+    control_command_t command;
+    int output_fd;                          /* `CONTROL_COMMAND_SET_OUTPUT`: Opened by control thread (`-1` = `stderr`) */
+    FILE* reply;                            /* Output of command (written by trace loop) */
+} control_request_t;
+
+
+/* -- Function prototypes -- */
+void control_init(const char* socket_path, const control_config_t* initial_config, bool unwinding_available);
+void control_fin(void);
+
+const control_config_t* control_get_config(void);
+
+control_request_t* control_take_request(void);
+void control_complete_request(control_request_t* request);
+
+void control_redirect_output(int output_fd);
+
+
+#endif /* CONTROL_H */
@@ -0,0 +1,17 @@
+/**
+ * Symbolic errno names (e.g., `ENOENT`), incl. kernel internal ones (e.g., `ERESTARTSYS`)
+ */
+#ifndef ERRNOS_H
+#define ERRNOS_H
+
+
+/* -- Consts -- */
+#define ERRNOS_FIRST_KERNEL_INTERNAL 512        /* e.g., `ERESTARTSYS` (syscall will be restarted) */
+
+
+/* -- Function prototypes -- */
+const char* errnos_get_name(long err);          /* `NULL` if unknown */
+int errnos_get_nr(const char* name);            /* `-1` if unknown */
+
+
+#endif /* ERRNOS_H */
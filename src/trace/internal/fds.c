@@ -0,0 +1,320 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include <common/str_utils.h>
+#include <trace/syscallents.h>
+#include "ptrace_utils.h"
+#include "fds.h"
+
+
+/* -- Consts -- */
+#define FDS_INITIAL_CAPACITY 64
+
+#ifndef CLOSE_RANGE_CLOEXEC
+#  define CLOSE_RANGE_CLOEXEC (1U << 2)
+#endif
+
+
+/* -- Types -- */
+struct fds {
+    int refcount;
+    int capacity;
+    char** paths;               /* Indexed by fd; `NULL` = not cached (i.e., cache miss -> `readlink`) */
+};
+
+
+/* -- Function prototypes -- */
+static void fds_ensure_capacity(fds_t* fds, int fd);
+static void fds_set_path(fds_t* fds, int fd, const char* path);
+static void fds_invalidate(fds_t* fds, int fd);
+static void fds_dup(fds_t* fds, int old_fd, int new_fd);
+static char* readlink_fd(pid_t tid, int fd);
+
+
+/* -- Functions -- */
+fds_t* fds_new(void) {
+    fds_t* fds = DIE_WHEN_ERRNO_VPTR( calloc(1, sizeof(*fds)) );
+    fds->refcount = 1;
+    return fds;
+}
+
+fds_t* fds_copy(const fds_t* fds) {
+    fds_t* copy = fds_new();
+    for (int fd = 0; fd < fds->capacity; fd++) {
+        if (fds->paths[fd]) {
+            fds_set_path(copy, fd, fds->paths[fd]);
+        }
+    }
+    return copy;
+}
+
+fds_t* fds_ref(fds_t* fds) {
+    fds->refcount++;
+    return fds;
+}
+
+void fds_unref(fds_t* fds) {
+    if (!fds || --(fds->refcount) > 0) {
+        return;
+    }
+    fds_clear(fds);
+    free(fds->paths);
+    free(fds);
+}
+
+
+void fds_seed(fds_t* fds, pid_t tid) {
+    char fd_dir_path[64];
+    snprintf(fd_dir_path, sizeof(fd_dir_path), "/proc/%d/fd", tid);
+
+    DIR* fd_dir;
+    if (! (fd_dir = opendir(fd_dir_path)) ) {
+        LOG_WARN("Couldn't seed fd table of %d -- %s", tid, strerror(errno));
+        return;
+    }
+
+    for (struct dirent* entry; (entry = readdir(fd_dir)); ) {
+        long fd;
+        if ('.' == entry->d_name[0] || -1 == str_to_long(entry->d_name, &fd)) {
+            continue;
+        }
+
+        char* path;
+        if ((path = readlink_fd(tid, (int)fd))) {
+            fds_set_path(fds, (int)fd, path);
+            free(path);
+        }
+    }
+
+    closedir(fd_dir);
+}
+
+void fds_clear(fds_t* fds) {
+    for (int fd = 0; fd < fds->capacity; fd++) {
+        fds_invalidate(fds, fd);
+    }
+}
+
+
+const char* fds_get_path(fds_t* fds, pid_t tid, int fd) {
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fd < fds->capacity && fds->paths[fd]) {        /* Cache hit */
+        return fds->paths[fd];
+    }
+
+    char* path;
+    if (! (path = readlink_fd(tid, fd)) ) {             /* Cache miss */
+        return NULL;
+    }
+    fds_ensure_capacity(fds, fd);
+    fds->paths[fd] = path;
+    return path;
+}
+
+
+/* - Maintenance based on syscall results - */
+bool fds_syscall_returns_fd(long syscall_nr, const long args[SYSCALL_MAX_ARGS]) {
+    switch (syscall_nr) {
+#ifdef __SNR_open
+        case __SNR_open:
+#endif
+#ifdef __SNR_creat
+        case __SNR_creat:
+#endif
+#ifdef __SNR_dup2
+        case __SNR_dup2:
+#endif
+#ifdef __SNR_epoll_create
+        case __SNR_epoll_create:
+#endif
+#ifdef __SNR_eventfd
+        case __SNR_eventfd:
+#endif
+#ifdef __SNR_signalfd
+        case __SNR_signalfd:
+#endif
+#ifdef __SNR_inotify_init
+        case __SNR_inotify_init:
+#endif
+        case __SNR_openat:
+        case __SNR_openat2:
+        case __SNR_open_by_handle_at:
+        case __SNR_socket:
+        case __SNR_accept:
+        case __SNR_accept4:
+        case __SNR_dup:
+        case __SNR_dup3:
+        case __SNR_epoll_create1:
+        case __SNR_eventfd2:
+        case __SNR_signalfd4:
+        case __SNR_timerfd_create:
+        case __SNR_inotify_init1:
+        case __SNR_fanotify_init:
+        case __SNR_memfd_create:
+        case __SNR_userfaultfd:
+        case __SNR_perf_event_open:
+        case __SNR_pidfd_open:
+        case __SNR_pidfd_getfd:
+        case __SNR_io_uring_setup:
+            return true;
+
+        case __SNR_fcntl:
+            return (F_DUPFD == args[1] || F_DUPFD_CLOEXEC == args[1]);
+
+        default:
+            return false;
+    }
+}
+
+/* Whether syscall (depending on its args / result) may change the fd table  (i.e., its syscall-exit must be seen) */
+bool fds_syscall_may_change_fds(long syscall_nr) {
+    static const long fcntl_dupfd_args[SYSCALL_MAX_ARGS] = { 0, F_DUPFD };
+
+    switch (syscall_nr) {
+#ifdef __SNR_dup2
+        case __SNR_dup2:
+#endif
+#ifdef __SNR_pipe
+        case __SNR_pipe:
+#endif
+        case __SNR_dup:
+        case __SNR_dup3:
+        case __SNR_close:
+        case __SNR_close_range:
+        case __SNR_pipe2:
+        case __SNR_socketpair:
+            return true;
+
+        default:
+            return fds_syscall_returns_fd(syscall_nr, fcntl_dupfd_args);
+    }
+}
+
+void fds_update_on_syscall_exit(fds_t* fds, pid_t tid,
+                                long syscall_nr, const long args[SYSCALL_MAX_ARGS], long rtn_val) {
+    if (rtn_val < 0) {          /* Failed syscalls don't change the fd table */
+        return;
+    }
+
+    switch (syscall_nr) {
+    /* Duplicated fds refer to the same file */
+        case __SNR_dup:
+            fds_dup(fds, (int)args[0], (int)rtn_val);
+            return;
+#ifdef __SNR_dup2
+        case __SNR_dup2:
+#endif
+        case __SNR_dup3:
+            fds_dup(fds, (int)args[0], (int)args[1]);
+            return;
+        case __SNR_fcntl:
+            if (F_DUPFD == args[1] || F_DUPFD_CLOEXEC == args[1]) {
+                fds_dup(fds, (int)args[0], (int)rtn_val);
+            }
+            return;
+
+    /* Closed fds */
+        case __SNR_close:
+            fds_invalidate(fds, (int)args[0]);
+            return;
+        case __SNR_close_range:
+            if (!((unsigned long)args[2] & CLOSE_RANGE_CLOEXEC) && fds->capacity > 0) {
+                const unsigned int last_fd = ((unsigned int)args[1] < (unsigned int)fds->capacity) ? ((unsigned int)args[1]) : ((unsigned int)fds->capacity - 1);
+                for (unsigned int fd = (unsigned int)args[0]; fd <= last_fd; fd++) {
+                    fds_invalidate(fds, (int)fd);
+                }
+            }
+            return;
+
+    /* New fds written into tracee's memory (`int[2]`) */
+#ifdef __SNR_pipe
+        case __SNR_pipe:
+#endif
+        case __SNR_pipe2:
+        case __SNR_socketpair:
+        {
+            unsigned long fd_pair;
+            const long fd_pair_addr = (__SNR_socketpair == syscall_nr) ? (args[3]) : (args[0]);
+            if (-1 != ptrace_read_word(tid, fd_pair_addr, &fd_pair)) {
+                int fd_pair_ints[2];
+                memcpy(fd_pair_ints, &fd_pair, sizeof(fd_pair_ints));
+                fds_invalidate(fds, fd_pair_ints[0]);
+                fds_invalidate(fds, fd_pair_ints[1]);
+            }
+            return;
+        }
+
+    /* New fd returned -> Path will be (lazily) looked up on first use */
+        default:
+            if (fds_syscall_returns_fd(syscall_nr, args)) {
+                fds_invalidate(fds, (int)rtn_val);
+            }
+            return;
+    }
+}
+
+
+/* - Helpers - */
+static void fds_ensure_capacity(fds_t* fds, int fd) {
+    if (fd < fds->capacity) {
+        return;
+    }
+
+    int new_capacity = (fds->capacity) ? (fds->capacity) : (FDS_INITIAL_CAPACITY);
+    while (new_capacity <= fd) {
+        new_capacity *= 2;
+    }
+
+    fds->paths = DIE_WHEN_ERRNO_VPTR( realloc(fds->paths, new_capacity * sizeof(*(fds->paths))) );
+    memset(fds->paths + fds->capacity, 0, (new_capacity - fds->capacity) * sizeof(*(fds->paths)));
+    fds->capacity = new_capacity;
+}
+
+static void fds_set_path(fds_t* fds, int fd, const char* path) {
+    if (fd < 0) {
+        return;
+    }
+    fds_ensure_capacity(fds, fd);
+    free(fds->paths[fd]);
+    fds->paths[fd] = DIE_WHEN_ERRNO_VPTR( strdup(path) );
+}
+
+static void fds_invalidate(fds_t* fds, int fd) {
+    if (fd >= 0 && fd < fds->capacity) {
+        free(fds->paths[fd]);
+        fds->paths[fd] = NULL;
+    }
+}
+
+static void fds_dup(fds_t* fds, int old_fd, int new_fd) {
+    if (old_fd == new_fd) {
+        return;
+    }
+    if (old_fd >= 0 && old_fd < fds->capacity && fds->paths[old_fd]) {
+        fds_set_path(fds, new_fd, fds->paths[old_fd]);
+    } else {
+        fds_invalidate(fds, new_fd);
+    }
+}
+
+static char* readlink_fd(pid_t tid, int fd) {
+    char fd_link_path[64];
+    snprintf(fd_link_path, sizeof(fd_link_path), "/proc/%d/fd/%d", tid, fd);
+
+    char path[PATH_MAX];
+    const ssize_t path_len = readlink(fd_link_path, path, sizeof(path) - 1);
+    if (-1 == path_len) {
+        return NULL;
+    }
+    path[path_len] = '\0';
+
+    return DIE_WHEN_ERRNO_VPTR( strdup(path) );
+}
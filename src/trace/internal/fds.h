@@ -0,0 +1,38 @@
+/**
+ * Per-process fd table (caches fd -> path mappings)
+ *   - Seeded once from `/proc/<pid>/fd`, then maintained incrementally
+ *     based on the results of traced syscalls (`open`, `dup`, `close`, ...)
+ *   - Falls back to `readlink`(2) of `/proc/<tid>/fd/<fd>` only on cache miss
+ *   - Ref-counted, since it's shared by tasks created w/ `CLONE_FILES` (e.g., threads)
+ */
+#ifndef FDS_H
+#define FDS_H
+
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <trace/syscall_types.h>
+
+
+/* -- Types -- */
+typedef struct fds fds_t;
+
+
+/* -- Function prototypes -- */
+fds_t* fds_new(void);
+fds_t* fds_copy(const fds_t* fds);
+fds_t* fds_ref(fds_t* fds);
+void fds_unref(fds_t* fds);
+
+void fds_seed(fds_t* fds, pid_t tid);
+void fds_clear(fds_t* fds);
+
+const char* fds_get_path(fds_t* fds, pid_t tid, int fd);
+
+bool fds_syscall_returns_fd(long syscall_nr, const long args[SYSCALL_MAX_ARGS]);
+bool fds_syscall_may_change_fds(long syscall_nr);
+void fds_update_on_syscall_exit(fds_t* fds, pid_t tid,
+                                long syscall_nr, const long args[SYSCALL_MAX_ARGS], long rtn_val);
+
+
+#endif /* FDS_H */
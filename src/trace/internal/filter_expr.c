@@ -0,0 +1,475 @@
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include "calibration.h"
+#include "errnos.h"
+#include "syscalls.h"
+#include "filter_expr.h"
+
+
+/* -- Consts -- */
+#define FILTER_IDENT_MAX_LEN 64
+
+typedef enum {
+    FILTER_OP_LOAD_FIELD,
+    FILTER_OP_LOAD_CONST,
+    FILTER_OP_CMP,
+    FILTER_OP_AND,
+    FILTER_OP_OR,
+    FILTER_OP_NOT
+} filter_op_t;
+
+static const char* const field_names[] = {
+    [FILTER_FIELD_NR]       = "nr",
+    [FILTER_FIELD_ARG0]     = "arg0",
+    [FILTER_FIELD_ARG1]     = "arg1",
+    [FILTER_FIELD_ARG2]     = "arg2",
+    [FILTER_FIELD_ARG3]     = "arg3",
+    [FILTER_FIELD_ARG4]     = "arg4",
+    [FILTER_FIELD_ARG5]     = "arg5",
+    [FILTER_FIELD_TID]      = "tid",
+    [FILTER_FIELD_RVAL]     = "rval",
+    [FILTER_FIELD_ERRNO]    = "errno",
+    [FILTER_FIELD_DURATION] = "duration",
+};
+
+/* NOTE: Longer operators first (prefix of shorter ones) */
+static const struct {
+    const char* str;
+    filter_cmp_t cmp;
+} cmp_operators[] = {
+    { "==", FILTER_CMP_EQ }, { "!=", FILTER_CMP_NE },
+    { "<=", FILTER_CMP_LE }, { ">=", FILTER_CMP_GE },
+    { "<",  FILTER_CMP_LT }, { ">",  FILTER_CMP_GT },
+};
+
+static const struct {
+    const char* suffix;
+    long factor;
+} duration_units[] = {
+    { "ns", 1L }, { "us", 1000L }, { "ms", 1000L * 1000L }, { "s", 1000L * 1000L * 1000L },
+};
+
+
+/* -- Types -- */
+typedef struct {
+    const char* str;
+    const char* pos;
+    filter_expr_t* expr;
+    int nodes_capacity;
+    int nesting;                    /* Of `!` / `(` (bounds recursion of parser) */
+
+    char* err_msg;
+    size_t err_msg_size;
+    bool failed;
+} parser_t;
+
+
+/* -- Function prototypes -- */
+static int parse_or(parser_t* parser);
+static int parse_and(parser_t* parser);
+static int parse_unary(parser_t* parser);
+static int parse_cmp(parser_t* parser);
+static bool parse_operand(parser_t* parser, filter_operand_t* operand, bool* is_syscall_name);
+static bool accept(parser_t* parser, const char* token);
+static int add_node(parser_t* parser, filter_node_type_t type, int lhs, int rhs);
+static void parse_error(parser_t* parser, const char* fmt, ...);
+
+static int compile_node(filter_expr_t* expr, int node_idx, filter_insn_t* code);
+static int max_stack_depth(const filter_expr_t* expr, int node_idx);
+static long event_field_value(const syscall_event_t* event, filter_field_t field);
+
+
+/* -- Functions -- */
+filter_expr_t* filter_expr_compile(const char* expr_str,
+                                   char* err_msg, size_t err_msg_size) {
+    filter_expr_t* expr = DIE_WHEN_ERRNO_VPTR( calloc(1, sizeof(*expr)) );
+    parser_t parser = {
+        .str = expr_str, .pos = expr_str,
+        .expr = expr, .nodes_capacity = 0, .nesting = 0,
+        .err_msg = err_msg, .err_msg_size = err_msg_size,
+        .failed = false
+    };
+
+/* 1. Parse into AST */
+    expr->root = parse_or(&parser);
+    if (!parser.failed && !accept(&parser, "")) {       /* Trailing garbage */
+        parse_error(&parser, "Unexpected \"%s\"", parser.pos);
+    }
+    if (!parser.failed && max_stack_depth(expr, expr->root) > FILTER_EXPR_MAX_STACK_DEPTH) {
+        parse_error(&parser, "Expression is nested too deeply");
+    }
+    if (parser.failed) {
+        filter_expr_free(expr);
+        return NULL;
+    }
+
+/* 2. Compile AST to postfix bytecode  (each node results in <= 3 instructions) */
+    expr->code = DIE_WHEN_ERRNO_VPTR( calloc(3 * expr->nodes_count, sizeof(*(expr->code))) );
+    expr->code_len = compile_node(expr, expr->root, expr->code);
+
+    return expr;
+}
+
+void filter_expr_free(filter_expr_t* expr) {
+    if (expr) {
+        free(expr->nodes);
+        free(expr->code);
+        free(expr);
+    }
+}
+
+
+filter_result_t filter_expr_eval(const filter_expr_t* expr, const syscall_event_t* event, unsigned known_fields) {
+    long values[FILTER_EXPR_MAX_STACK_DEPTH];
+    bool known[FILTER_EXPR_MAX_STACK_DEPTH];
+    int sp = 0;
+
+    for (const filter_insn_t* insn = expr->code; insn < expr->code + expr->code_len; insn++) {
+        switch ((filter_op_t)insn->op) {
+            case FILTER_OP_LOAD_FIELD:
+                known[sp] = known_fields & (1U << insn->arg);
+                values[sp] = (known[sp]) ? (event_field_value(event, (filter_field_t)insn->arg)) : (0);
+                sp++;
+                break;
+            case FILTER_OP_LOAD_CONST:
+                known[sp] = true;
+                values[sp] = insn->value;
+                sp++;
+                break;
+
+            case FILTER_OP_CMP:
+                sp--;
+                known[sp - 1] = known[sp - 1] && known[sp];
+                values[sp - 1] = known[sp - 1] && filter_expr_cmp((filter_cmp_t)insn->arg, values[sp - 1], values[sp]);
+                break;
+
+            /* Three-valued logic: Result is known if it doesn't depend on the unknown operand */
+            case FILTER_OP_AND:
+                sp--;
+                if ((known[sp - 1] && !values[sp - 1]) || (known[sp] && !values[sp])) {
+                    known[sp - 1] = true;
+                    values[sp - 1] = false;
+                } else {
+                    known[sp - 1] = known[sp - 1] && known[sp];
+                    values[sp - 1] = true;
+                }
+                break;
+            case FILTER_OP_OR:
+                sp--;
+                if ((known[sp - 1] && values[sp - 1]) || (known[sp] && values[sp])) {
+                    known[sp - 1] = true;
+                    values[sp - 1] = true;
+                } else {
+                    known[sp - 1] = known[sp - 1] && known[sp];
+                    values[sp - 1] = false;
+                }
+                break;
+            case FILTER_OP_NOT:
+                values[sp - 1] = !values[sp - 1];
+                break;
+            default:
+                break;
+        }
+    }
+
+    return (!known[0]) ? (FILTER_UNKNOWN) : ((values[0]) ? (FILTER_MATCH) : (FILTER_NO_MATCH));
+}
+
+
+/* - Parser (recursive descent) - */
+static int parse_or(parser_t* parser) {
+    int lhs = parse_and(parser);
+    while (!parser->failed && accept(parser, "||")) {
+        const int rhs = parse_and(parser);
+        lhs = add_node(parser, FILTER_NODE_OR, lhs, rhs);
+    }
+    return lhs;
+}
+
+static int parse_and(parser_t* parser) {
+    int lhs = parse_unary(parser);
+    while (!parser->failed && accept(parser, "&&")) {
+        const int rhs = parse_unary(parser);
+        lhs = add_node(parser, FILTER_NODE_AND, lhs, rhs);
+    }
+    return lhs;
+}
+
+static int parse_unary(parser_t* parser) {
+    if (parser->failed) {
+        return -1;
+    }
+
+    const bool is_not = accept(parser, "!");
+    const bool is_parenthesized = !is_not && accept(parser, "(");
+    if (!is_not && !is_parenthesized) {
+        return parse_cmp(parser);
+    }
+
+    if (++parser->nesting > FILTER_EXPR_MAX_STACK_DEPTH) {     /* (Checked prior recursing further) */
+        parse_error(parser, "Expression is nested too deeply");
+        return -1;
+    }
+    int node;
+    if (is_not) {
+        node = add_node(parser, FILTER_NODE_NOT, parse_unary(parser), -1);
+    } else {
+        node = parse_or(parser);
+        if (!parser->failed && !accept(parser, ")")) {
+            parse_error(parser, "Expected \")\"");
+        }
+    }
+    parser->nesting--;
+    return node;
+}
+
+static int parse_cmp(parser_t* parser) {
+    filter_operand_t operands[2];
+    bool is_syscall_name;
+    if (!parse_operand(parser, &operands[0], &is_syscall_name)) {
+        return -1;
+    }
+
+    filter_cmp_t cmp;
+    size_t i;
+    for (i = 0; i < sizeof(cmp_operators) / sizeof(cmp_operators[0]); i++) {
+        if (accept(parser, cmp_operators[i].str)) {
+            cmp = cmp_operators[i].cmp;
+            break;
+        }
+    }
+
+    if (i < sizeof(cmp_operators) / sizeof(cmp_operators[0])) {
+        if (!parse_operand(parser, &operands[1], &(bool){ false })) {
+            return -1;
+        }
+    } else if (is_syscall_name) {                   /* `<syscall-name>`  -> `nr == <syscall-name>` */
+        cmp = FILTER_CMP_EQ;
+        operands[1] = operands[0];
+        operands[0] = (filter_operand_t){ .is_field = true, .field = FILTER_FIELD_NR };
+    } else {                                        /* `<operand>`  -> `<operand> != 0` */
+        cmp = FILTER_CMP_NE;
+        operands[1] = (filter_operand_t){ .is_field = false, .value = 0 };
+    }
+
+    const int node = add_node(parser, FILTER_NODE_CMP, -1, -1);
+    parser->expr->nodes[node].cmp = cmp;
+    memcpy(parser->expr->nodes[node].operands, operands, sizeof(operands));
+    for (int j = 0; j < 2; j++) {
+        if (operands[j].is_field) {
+            parser->expr->used_fields |= (1U << operands[j].field);
+        }
+    }
+    return node;
+}
+
+static bool parse_operand(parser_t* parser, filter_operand_t* operand, bool* is_syscall_name) {
+    accept(parser, "");     /* Skip whitespace */
+    const char* const start = parser->pos;
+    *is_syscall_name = false;
+
+/* Number (w/ optional unit) */
+    if (isdigit((unsigned char)*start) || ('-' == *start && isdigit((unsigned char)start[1]))) {
+        char* end;
+        errno = 0;
+        const long value = strtol(start, &end, 0);
+        if (ERANGE == errno) {
+            parse_error(parser, "Number \"%.*s\" out of range", (int)(end - start), start);
+            return false;
+        }
+
+        long factor = 1;
+        if (isalpha((unsigned char)*end)) {
+            size_t i;
+            for (i = 0; i < sizeof(duration_units) / sizeof(duration_units[0]); i++) {
+                const size_t suffix_len = strlen(duration_units[i].suffix);
+                if (!strncmp(end, duration_units[i].suffix, suffix_len) && !isalnum((unsigned char)end[suffix_len])) {
+                    factor = duration_units[i].factor;
+                    end += suffix_len;
+                    break;
+                }
+            }
+            if (i == sizeof(duration_units) / sizeof(duration_units[0])) {
+                parse_error(parser, "Unknown unit in \"%s\"", start);
+                return false;
+            }
+        }
+
+        if (value > LONG_MAX / factor || value < LONG_MIN / factor) {     /* (Would overflow w/ unit applied) */
+            parse_error(parser, "Number \"%.*s\" out of range", (int)(end - start), start);
+            return false;
+        }
+
+        *operand = (filter_operand_t){ .is_field = false, .value = value * factor };
+        parser->pos = end;
+        return true;
+    }
+
+/* Identifier (field, syscall- or errno name) */
+    if (!isalpha((unsigned char)*start) && '_' != *start) {
+        parse_error(parser, "Expected operand");
+        return false;
+    }
+    const char* end = start;
+    while (isalnum((unsigned char)*end) || '_' == *end) {
+        end++;
+    }
+    char ident[FILTER_IDENT_MAX_LEN];
+    if ((size_t)(end - start) >= sizeof(ident)) {
+        parse_error(parser, "Identifier too long");
+        return false;
+    }
+    memcpy(ident, start, end - start);
+    ident[end - start] = '\0';
+    parser->pos = end;
+
+    for (size_t i = 0; i < sizeof(field_names) / sizeof(field_names[0]); i++) {
+        if (!strcmp(ident, field_names[i])) {
+            *operand = (filter_operand_t){ .is_field = true, .field = (filter_field_t)i };
+            return true;
+        }
+    }
+
+    long value;
+    if (-1 != (value = syscalls_get_nr(ident))) {
+        *operand = (filter_operand_t){ .is_field = false, .value = value };
+        *is_syscall_name = true;
+        return true;
+    }
+    if (-1 != (value = errnos_get_nr(ident))) {
+        *operand = (filter_operand_t){ .is_field = false, .value = value };
+        return true;
+    }
+
+    parser->pos = start;
+    parse_error(parser, "Unknown field, syscall- or errno name \"%s\"", ident);
+    return false;
+}
+
+/* Consumes `token` (if next), skipping preceding whitespace  (empty `token` = matches only at end of input) */
+static bool accept(parser_t* parser, const char* token) {
+    while (isspace((unsigned char)*parser->pos)) {
+        parser->pos++;
+    }
+
+    if (!*token) {
+        return !*parser->pos;
+    }
+    const size_t token_len = strlen(token);
+    if (strncmp(parser->pos, token, token_len)) {
+        return false;
+    }
+    if (!strcmp("!", token) && '=' == parser->pos[1]) {      /* `!=` isn't a negation */
+        return false;
+    }
+    parser->pos += token_len;
+    return true;
+}
+
+static int add_node(parser_t* parser, filter_node_type_t type, int lhs, int rhs) {
+    if (parser->failed) {
+        return -1;
+    }
+
+    filter_expr_t* const expr = parser->expr;
+    if (expr->nodes_count == parser->nodes_capacity) {
+        parser->nodes_capacity = (parser->nodes_capacity) ? (parser->nodes_capacity * 2) : (16);
+        expr->nodes = DIE_WHEN_ERRNO_VPTR( realloc(expr->nodes, parser->nodes_capacity * sizeof(*(expr->nodes))) );
+    }
+
+    expr->nodes[expr->nodes_count] = (filter_node_t){ .type = type, .lhs = lhs, .rhs = rhs };
+    return expr->nodes_count++;
+}
+
+static void parse_error(parser_t* parser, const char* fmt, ...) {
+    if (parser->failed) {       /* Report only 1st error */
+        return;
+    }
+    parser->failed = true;
+
+    va_list args;
+    va_start(args, fmt);
+    const int err_msg_len = vsnprintf(parser->err_msg, parser->err_msg_size, fmt, args);
+    va_end(args);
+
+    if (err_msg_len >= 0 && (size_t)err_msg_len < parser->err_msg_size) {
+        snprintf(parser->err_msg + err_msg_len, parser->err_msg_size - err_msg_len,
+                 " (at offset %d)", (int)(parser->pos - parser->str));
+    }
+}
+
+
+/* - Compiler - */
+static int compile_node(filter_expr_t* expr, int node_idx, filter_insn_t* code) {
+    const filter_node_t* const node = &expr->nodes[node_idx];
+    int len = 0;
+
+    switch (node->type) {
+        case FILTER_NODE_CMP:
+            for (int i = 0; i < 2; i++) {
+                code[len++] = (node->operands[i].is_field) ?
+                    ((filter_insn_t){ .op = FILTER_OP_LOAD_FIELD, .arg = (unsigned char)node->operands[i].field }) :
+                    ((filter_insn_t){ .op = FILTER_OP_LOAD_CONST, .value = node->operands[i].value });
+            }
+            code[len++] = (filter_insn_t){ .op = FILTER_OP_CMP, .arg = (unsigned char)node->cmp };
+            break;
+
+        case FILTER_NODE_NOT:
+            len += compile_node(expr, node->lhs, code);
+            code[len++] = (filter_insn_t){ .op = FILTER_OP_NOT };
+            break;
+
+        case FILTER_NODE_AND:
+        case FILTER_NODE_OR:
+        default:
+            len += compile_node(expr, node->lhs, code);
+            len += compile_node(expr, node->rhs, code + len);
+            code[len++] = (filter_insn_t){ .op = (FILTER_NODE_AND == node->type) ? (FILTER_OP_AND) : (FILTER_OP_OR) };
+            break;
+    }
+    return len;
+}
+
+static int max_stack_depth(const filter_expr_t* expr, int node_idx) {
+    const filter_node_t* const node = &expr->nodes[node_idx];
+
+    switch (node->type) {
+        case FILTER_NODE_CMP:
+            return 2;
+        case FILTER_NODE_NOT:
+            return max_stack_depth(expr, node->lhs);
+        case FILTER_NODE_AND:
+        case FILTER_NODE_OR:
+        default: {
+            const int lhs_depth = max_stack_depth(expr, node->lhs);
+            const int rhs_depth = 1 + max_stack_depth(expr, node->rhs);     /* Result of `lhs` remains on stack */
+            return (lhs_depth > rhs_depth) ? (lhs_depth) : (rhs_depth);
+        }
+    }
+}
+
+
+/* - Evaluation - */
+static long event_field_value(const syscall_event_t* event, filter_field_t field) {
+    switch (field) {
+        case FILTER_FIELD_NR:       return event->nr;
+        case FILTER_FIELD_TID:      return event->tid;
+        case FILTER_FIELD_RVAL:     return event->rtn_val;
+        case FILTER_FIELD_ERRNO:    return syscall_event_errno(event);
+        case FILTER_FIELD_DURATION: return (long)calibration_correct_duration_ns(event->exit_ns - event->enter_ns);
+        case FILTER_FIELD_ARG0:
+        case FILTER_FIELD_ARG1:
+        case FILTER_FIELD_ARG2:
+        case FILTER_FIELD_ARG3:
+        case FILTER_FIELD_ARG4:
+        case FILTER_FIELD_ARG5:
+        default:                    return event->args[field - FILTER_FIELD_ARG0];
+    }
+}
@@ -0,0 +1,131 @@
+/**
+ * Filter expressions (`--filter <expr>`), e.g., `rval < 0 && errno != EAGAIN`, `write && arg2 > 65536`,
+ * `futex && duration > 10ms` or `tid == 1234`
+ *   - Parsed once (into an AST) and compiled to a compact postfix bytecode
+ *   - Evaluated against the raw syscall event  -> Prior any reads of tracee memory or formatting
+ *   - Three-valued evaluation: Fields which aren't known yet (e.g., `rval` on syscall-enter) are "unknown"
+ *     -> Syscalls which can't match anymore are discarded as early as possible (e.g., already on syscall-enter)
+ *
+ * Grammar:
+ *   expr    := and ('||' and)*
+ *   and     := unary ('&&' unary)*
+ *   unary   := '!' unary | '(' expr ')' | cmp
+ *   cmp     := operand [('==' | '!=' | '<' | '<=' | '>' | '>=') operand]
+ *   operand := field | <syscall-name> | <errno-name> | ['-'] <number> [unit]
+ *   field   := 'nr' | 'arg0' .. 'arg5' | 'rval' | 'errno' | 'tid' | 'duration'
+ *   unit    := 'ns' | 'us' | 'ms' | 's'        (`duration` is in ns)
+ * A lone syscall name is short for `nr == <syscall-name>`, any other lone operand for `<operand> != 0`
+ */
+#ifndef FILTER_EXPR_H
+#define FILTER_EXPR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "syscall_event.h"
+
+
+/* -- Consts -- */
+#define FILTER_EXPR_MAX_STACK_DEPTH 32
+
+
+/* -- Types -- */
+typedef enum {
+    FILTER_FIELD_NR,
+    FILTER_FIELD_ARG0,
+    FILTER_FIELD_ARG1,
+    FILTER_FIELD_ARG2,
+    FILTER_FIELD_ARG3,
+    FILTER_FIELD_ARG4,
+    FILTER_FIELD_ARG5,
+    FILTER_FIELD_TID,
+    FILTER_FIELD_RVAL,
+    FILTER_FIELD_ERRNO,
+    FILTER_FIELD_DURATION
+} filter_field_t;
+
+/* Bitmasks of fields known at a given point in time (passed to `filter_expr_eval`) */
+#define FILTER_FIELDS_NR    (1U << FILTER_FIELD_NR)
+#define FILTER_FIELDS_ENTRY (FILTER_FIELDS_NR | (((1U << SYSCALL_MAX_ARGS) - 1) << FILTER_FIELD_ARG0) | (1U << FILTER_FIELD_TID))
+#define FILTER_FIELDS_EXIT  (FILTER_FIELDS_ENTRY | (1U << FILTER_FIELD_RVAL) | (1U << FILTER_FIELD_ERRNO) | (1U << FILTER_FIELD_DURATION))
+
+typedef enum {
+    FILTER_CMP_EQ,
+    FILTER_CMP_NE,
+    FILTER_CMP_LT,
+    FILTER_CMP_LE,
+    FILTER_CMP_GT,
+    FILTER_CMP_GE
+} filter_cmp_t;
+
+typedef struct {
+    bool is_field;
+    filter_field_t field;
+    long value;                 /* Only if `!is_field` */
+} filter_operand_t;
+
+typedef enum {
+    FILTER_NODE_AND,
+    FILTER_NODE_OR,
+    FILTER_NODE_NOT,
+    FILTER_NODE_CMP
+} filter_node_type_t;
+
+typedef struct {
+    filter_node_type_t type;
+    int lhs, rhs;               /* Indices of child nodes (`FILTER_NODE_NOT`: only `lhs`) */
+    filter_cmp_t cmp;           /* Only `FILTER_NODE_CMP` */
+    filter_operand_t operands[2];
+} filter_node_t;
+
+typedef struct {
+    unsigned char op;
+    unsigned char arg;          /* Field / comparison operator */
+    long value;                 /* Constant */
+} filter_insn_t;
+
+typedef struct filter_expr {
+    filter_node_t* nodes;       /* AST (used, e.g., for generating the seccomp-BPF program) */
+    int nodes_count;
+    int root;
+
+    filter_insn_t* code;        /* Postfix bytecode */
+    int code_len;
+
+    unsigned used_fields;       /* Bitmask of `1 << filter_field_t` */
+} filter_expr_t;
+
+typedef enum {
+    FILTER_NO_MATCH,
+    FILTER_MATCH,
+    FILTER_UNKNOWN              /* Depends on fields which aren't known yet */
+} filter_result_t;
+
+
+/* -- Function prototypes -- */
+filter_expr_t* filter_expr_compile(const char* expr_str,
+                                   char* err_msg, size_t err_msg_size);
+void filter_expr_free(filter_expr_t* expr);
+
+filter_result_t filter_expr_eval(const filter_expr_t* expr, const syscall_event_t* event, unsigned known_fields);
+
+
+/* -- Functions -- */
+static inline bool filter_expr_uses_field(const filter_expr_t* expr, filter_field_t field) {
+    return expr->used_fields & (1U << field);
+}
+
+static inline bool filter_expr_cmp(filter_cmp_t cmp, long lhs, long rhs) {
+    switch (cmp) {
+        case FILTER_CMP_EQ: return lhs == rhs;
+        case FILTER_CMP_NE: return lhs != rhs;
+        case FILTER_CMP_LT: return lhs <  rhs;
+        case FILTER_CMP_LE: return lhs <= rhs;
+        case FILTER_CMP_GT: return lhs >  rhs;
+        case FILTER_CMP_GE:
+        default:            return lhs >= rhs;
+    }
+}
+
+
+#endif /* FILTER_EXPR_H */
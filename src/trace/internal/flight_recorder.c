@@ -0,0 +1,230 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include <common/time_utils.h>
+#include <trace/syscallents.h>
+#include "calibration.h"
+#include "syscalls.h"
+#include "tracees.h"
+#include "flight_recorder.h"
+
+
+/* -- Types -- */
+typedef struct {
+    flight_record_t* records;
+    size_t count, capacity;
+} unfinished_records_t;
+
+
+/* -- Globals -- */
+static struct {
+    flight_record_t* ring;
+    size_t capacity;
+    size_t head;                /* Next slot to be written */
+    size_t count;
+
+    triggers_t triggers;
+
+    const char* binary_dump_path;
+} recorder;
+
+static volatile sig_atomic_t dump_requested = 0;
+
+
+/* -- Function prototypes -- */
+static void request_dump(int signo);
+static void record_from_event(flight_record_t* record, const syscall_event_t* event, unsigned long ip, uint32_t flags);
+static void collect_unfinished(tracee_t* tracee, void* unfinished_records);
+static void dump_text(const char* trigger, const flight_record_t* unfinished, size_t unfinished_count, uint64_t dump_ns);
+static void dump_binary(const char* trigger, const flight_record_t* unfinished, size_t unfinished_count, uint64_t dump_ns);
+static void fprint_record(FILE* stream, const flight_record_t* record, uint64_t dump_ns);
+
+
+/* -- Functions -- */
+void flight_recorder_init(size_t size, const triggers_t* triggers,
+                          const char* binary_dump_path) {
+    recorder.capacity = size / sizeof(flight_record_t);
+    if (!recorder.capacity) {
+        LOG_ERROR_AND_DIE("Flight recorder size must be at least %zu bytes", sizeof(flight_record_t));
+    }
+    recorder.ring = DIE_WHEN_ERRNO_VPTR( calloc(recorder.capacity, sizeof(*(recorder.ring))) );
+    recorder.head = recorder.count = 0;
+
+    recorder.triggers = *triggers;
+    recorder.binary_dump_path = binary_dump_path;
+
+    /* Dump on `SIGUSR2`  (NOTE: No `SA_RESTART`, so that a blocking `waitpid`(2) is interrupted, e.g., when all tracees stall) */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = request_dump;
+    sigemptyset(&sa.sa_mask);
+    DIE_WHEN_ERRNO( sigaction(SIGUSR2, &sa, NULL) );
+}
+
+void flight_recorder_fin(void) {
+    signal(SIGUSR2, SIG_DFL);
+    free(recorder.ring);
+    recorder.ring = NULL;
+    recorder.capacity = recorder.head = recorder.count = 0;
+}
+
+
+void flight_recorder_record(const syscall_event_t* event, unsigned long ip) {
+/* 1. Append to ring (overwriting oldest record when full) */
+    record_from_event(&recorder.ring[recorder.head], event, ip, FLIGHT_RECORD_COMPLETED);
+    recorder.head = (recorder.head + 1) % recorder.capacity;
+    if (recorder.count < recorder.capacity) {
+        recorder.count++;
+    }
+
+/* 2. Check triggers */
+    char trigger[64];
+    if (triggers_match(&recorder.triggers, event, trigger, sizeof(trigger))) {
+        flight_recorder_dump(trigger);
+    }
+}
+
+
+void flight_recorder_dump(const char* trigger) {
+    const uint64_t dump_ns = time_now_ns();
+
+    /* Syscalls still in progress */
+    unfinished_records_t unfinished = { NULL, 0, 0 };
+    tracees_for_each(collect_unfinished, &unfinished);
+
+    if (recorder.binary_dump_path) {
+        dump_binary(trigger, unfinished.records, unfinished.count, dump_ns);
+    } else {
+        dump_text(trigger, unfinished.records, unfinished.count, dump_ns);
+    }
+    free(unfinished.records);
+
+    /* Next dump shall only contain new events */
+    recorder.head = recorder.count = 0;
+}
+
+void flight_recorder_dump_if_requested(void) {
+    if (dump_requested) {
+        dump_requested = 0;
+        flight_recorder_dump("SIGUSR2");
+    }
+}
+
+
+/* - Helpers - */
+static void request_dump(int signo) {
+    (void)signo;
+    dump_requested = 1;
+}
+
+static void record_from_event(flight_record_t* record, const syscall_event_t* event, unsigned long ip, uint32_t flags) {
+    record->tid = event->tid;
+    record->flags = flags;
+    record->nr = event->nr;
+    for (int i = 0; i < SYSCALL_MAX_ARGS; i++) {
+        record->args[i] = event->args[i];
+    }
+    record->rtn_val = event->rtn_val;
+    record->enter_ns = event->enter_ns;
+    record->exit_ns = event->exit_ns;
+    record->ip = ip;
+}
+
+static void collect_unfinished(tracee_t* tracee, void* unfinished_records) {
+    unfinished_records_t* const unfinished = unfinished_records;
+
+    if (!tracee->syscall_in_flight) {
+        return;
+    }
+    if (unfinished->count == unfinished->capacity) {
+        unfinished->capacity = (unfinished->capacity) ? (unfinished->capacity * 2) : (16);
+        unfinished->records = DIE_WHEN_ERRNO_VPTR( realloc(unfinished->records, unfinished->capacity * sizeof(*(unfinished->records))) );
+    }
+    record_from_event(&unfinished->records[unfinished->count++], &tracee->syscall_event, tracee->syscall_ip, 0);
+}
+
+static void dump_text(const char* trigger, const flight_record_t* unfinished, size_t unfinished_count, uint64_t dump_ns) {
+    fprintf(stderr, "\n=== Flight recorder dump (trigger: %s) -- %zu events, %zu unfinished ===\n",
+            trigger, recorder.count, unfinished_count);
+
+    const size_t oldest = (recorder.head + recorder.capacity - recorder.count) % recorder.capacity;
+    for (size_t i = 0; i < recorder.count; i++) {
+        fprint_record(stderr, &recorder.ring[(oldest + i) % recorder.capacity], dump_ns);
+    }
+    for (size_t i = 0; i < unfinished_count; i++) {
+        fprint_record(stderr, &unfinished[i], dump_ns);
+    }
+
+    fprintf(stderr, "=== End of flight recorder dump ===\n");
+}
+
+static void dump_binary(const char* trigger, const flight_record_t* unfinished, size_t unfinished_count, uint64_t dump_ns) {
+    FILE* dump_file;
+    if (! (dump_file = fopen(recorder.binary_dump_path, "ab")) ) {
+        LOG_WARN("Couldn't open flight recorder dump file \"%s\" -- %s", recorder.binary_dump_path, strerror(errno));
+        return;
+    }
+
+    flight_recorder_dump_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FLIGHT_RECORDER_BINARY_MAGIC, sizeof(header.magic));
+    header.version = FLIGHT_RECORDER_BINARY_VERSION;
+    header.record_size = sizeof(flight_record_t);
+    header.records_count = (uint32_t)(recorder.count + unfinished_count);
+    header.dump_ns = dump_ns;
+    strncpy(header.trigger, trigger, sizeof(header.trigger) - 1);
+    fwrite(&header, sizeof(header), 1, dump_file);
+
+    /* Ring may wrap around  -> Write (up to) 2 chunks */
+    const size_t oldest = (recorder.head + recorder.capacity - recorder.count) % recorder.capacity;
+    const size_t first_chunk_count = (oldest + recorder.count <= recorder.capacity) ? (recorder.count) : (recorder.capacity - oldest);
+    fwrite(&recorder.ring[oldest], sizeof(flight_record_t), first_chunk_count, dump_file);
+    fwrite(recorder.ring, sizeof(flight_record_t), recorder.count - first_chunk_count, dump_file);
+    fwrite(unfinished, sizeof(flight_record_t), unfinished_count, dump_file);
+
+    if (fclose(dump_file)) {
+        LOG_WARN("Couldn't write flight recorder dump file \"%s\" -- %s", recorder.binary_dump_path, strerror(errno));
+    } else {
+        fprintf(stderr, "\n+++ Flight recorder dump (trigger: %s) -- %u events written to \"%s\" +++\n",
+                trigger, header.records_count, recorder.binary_dump_path);
+    }
+}
+
+/*
+ * Prints record w/ raw args (tracee memory may have changed since then  -> Pointers aren't dereferenced)
+ */
+static void fprint_record(FILE* stream, const flight_record_t* record, uint64_t dump_ns) {
+    const char* const scall_name = syscalls_get_name((long)record->nr);
+    const syscall_entry_t* const scall = (scall_name) ? (&syscalls[record->nr]) : (NULL);
+
+    fprintf(stream, "[-%.6fs] [%d] ", (double)(dump_ns - record->enter_ns) / 1e9, record->tid);
+    if (scall_name) {
+        fprintf(stream, "%s(", scall_name);
+    } else {
+        fprintf(stream, "sys_%ld(", (long)record->nr);
+    }
+    const int nargs = (scall) ? (scall->nargs) : (SYSCALL_MAX_ARGS);
+    for (int arg_nr = 0; arg_nr < nargs; arg_nr++) {
+        if (arg_nr > 0) { fputs(", ", stream); }
+        if (scall && ARG_FD == scall->args[arg_nr]) {
+            fprintf(stream, "%d", (int)record->args[arg_nr]);
+        } else if (scall && ARG_INT == scall->args[arg_nr]) {
+            fprintf(stream, "%ld", (long)record->args[arg_nr]);
+        } else {
+            fprintf(stream, "0x%lx", (unsigned long)record->args[arg_nr]);
+        }
+    }
+    fputc(')', stream);
+
+    if (record->flags & FLIGHT_RECORD_COMPLETED) {
+        fputs(" = ", stream);
+        syscalls_fprint_rtn_val(stream, (long)record->rtn_val);
+        fprintf(stream, " <%.6fs>", (double)calibration_correct_duration_ns(record->exit_ns - record->enter_ns) / 1e9);
+    } else {
+        fputs(" <unfinished ...>", stream);
+    }
+    fprintf(stream, " [ip=0x%lx]\n", (unsigned long)record->ip);
+}
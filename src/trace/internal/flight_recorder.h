@@ -0,0 +1,63 @@
+/**
+ * Flight recorder (`--flight-recorder=<size>`)
+ *   Keeps the most recent raw (i.e., unformatted) syscall events (incl. call-site IPs) in a fixed-size
+ *   in-memory ring, which is only dumped (as text or binary) when a trigger fires:
+ *     - Tracee receives a fatal signal
+ *     - Tracer receives `SIGUSR2`
+ *     - A configured syscall or errno occurs
+ *   Syscalls still in progress when dumping (e.g., of stalled threads) are included as "unfinished"
+ */
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "syscall_event.h"
+#include "triggers.h"
+
+
+/* -- Consts -- */
+#define FLIGHT_RECORDER_BINARY_MAGIC   "MSFR"
+#define FLIGHT_RECORDER_BINARY_VERSION 1
+
+#define FLIGHT_RECORD_COMPLETED (1U << 0)       /* Syscall has returned (otherwise: still in progress when dumped) */
+
+
+/* -- Types -- */
+/* Ring entry (also the record format of binary dumps) */
+typedef struct {
+    int32_t tid;
+    uint32_t flags;
+    int64_t nr;
+    int64_t args[SYSCALL_MAX_ARGS];
+    int64_t rtn_val;
+    uint64_t enter_ns;          /* `CLOCK_MONOTONIC` */
+    uint64_t exit_ns;
+    uint64_t ip;                /* Call-site (i.e., instruction pointer on syscall-enter) */
+} flight_record_t;
+
+/* Header of each binary dump (followed by `records_count` records, oldest first) */
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t records_count;
+    uint64_t dump_ns;
+    char trigger[48];
+} flight_recorder_dump_header_t;
+
+
+/* -- Function prototypes -- */
+void flight_recorder_init(size_t size, const triggers_t* triggers,
+                          const char* binary_dump_path);
+void flight_recorder_fin(void);
+
+void flight_recorder_record(const syscall_event_t* event, unsigned long ip);
+
+void flight_recorder_dump(const char* trigger);
+void flight_recorder_dump_if_requested(void);
+
+
+#endif /* FLIGHT_RECORDER_H */
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <common/time_utils.h>
+#include <trace/syscallents.h>
+#include "syscalls.h"
+#include "governor.h"
+
+
+/* -- Globals -- */
+static struct {
+    double budget_percent;
+    governor_knobs_t knobs;
+    int next_step;                      /* Index in degradation ladder (see `governor.h`) */
+
+    uint64_t window_start_ns;
+    uint64_t window_stops;
+    uint64_t window_stopped_ns;
+    uint64_t window_syscall_counts[SYSCALLS_ARR_SIZE];
+
+    uint64_t stop_begin_ns;             /* `0` = not in a stop */
+    bool shed_syscalls[SYSCALLS_ARR_SIZE];
+} governor;
+
+
+/* -- Function prototypes -- */
+static bool next_action(governor_decision_t* decision, double overshoot);
+static void reset_window(uint64_t now);
+
+
+/* -- Functions -- */
+void governor_init(double budget_percent, const governor_knobs_t* knobs) {
+    memset(&governor, 0, sizeof(governor));
+    governor.budget_percent = budget_percent;
+    governor.knobs = *knobs;
+    reset_window(time_now_ns());
+}
+
+
+void governor_stop_begin(void) {
+    governor.stop_begin_ns = time_now_ns();
+    governor.window_stops++;
+}
+
+void governor_stop_end(void) {
+    if (governor.stop_begin_ns) {
+        governor.window_stopped_ns += time_now_ns() - governor.stop_begin_ns;
+        governor.stop_begin_ns = 0;
+    }
+}
+
+void governor_count_syscall(long syscall_nr) {
+    if (syscall_nr >= 0 && syscall_nr <= MAX_SYSCALL_NUM) {
+        governor.window_syscall_counts[syscall_nr]++;
+    }
+}
+
+
+/*
+ * Checks (once per window) whether the overhead exceeds the budget; if so, returns the next degradation step
+ * (to be reported by caller, e.g., via `governor_fprint_decision`)
+ */
+bool governor_poll(governor_decision_t* decision) {
+    const uint64_t now = time_now_ns();
+    const uint64_t window_ns = now - governor.window_start_ns;
+    if (window_ns < GOVERNOR_WINDOW_NS) {
+        return false;
+    }
+
+    const double overhead_percent = 100.0 * (double)governor.window_stopped_ns / (double)window_ns;
+    const double stops_per_sec = (double)governor.window_stops * 1e9 / (double)window_ns;
+    const double us_per_stop = (governor.window_stops) ?
+                                   ((double)governor.window_stopped_ns / 1e3 / (double)governor.window_stops) : (0.0);
+
+    bool degraded = false;
+    if (overhead_percent > governor.budget_percent && (degraded = next_action(decision, overhead_percent / governor.budget_percent))) {
+        decision->overhead_percent = overhead_percent;
+        decision->budget_percent = governor.budget_percent;
+        decision->stops_per_sec = stops_per_sec;
+        decision->us_per_stop = us_per_stop;
+    }
+
+    reset_window(now);
+    return degraded;
+}
+
+void governor_fprint_decision(FILE* stream, const governor_decision_t* decision) {
+    fprintf(stream, "\n+++ Governor: Overhead %.1f%% exceeds budget of %.1f%% (%.0f stops/s, %.1f us/stop) -- ",
+            decision->overhead_percent, decision->budget_percent, decision->stops_per_sec, decision->us_per_stop);
+    switch (decision->action) {
+        case GOVERNOR_ACTION_DISABLE_UNWINDING:
+            fprintf(stream, "disabling stack unwinding +++\n");
+            break;
+        case GOVERNOR_ACTION_DISABLE_PAYLOADS:
+            fprintf(stream, "disabling payload capture (args are printed raw) +++\n");
+            break;
+        case GOVERNOR_ACTION_TIGHTEN_SAMPLING:
+            fprintf(stream, "sampling 1-in-%u calls of each system call +++\n", decision->sample_every_nth);
+            break;
+        case GOVERNOR_ACTION_SHED_SYSCALL:
+            fprintf(stream, "shedding system call \"%s\" (isn't traced nor counted anymore) +++\n",
+                    syscalls_get_name(decision->shed_syscall_nr));
+            break;
+        case GOVERNOR_ACTION_NONE:
+        default:
+            break;
+    }
+}
+
+
+/* - Helpers - */
+static bool next_action(governor_decision_t* decision, double overshoot) {
+    for ( ; ; governor.next_step++) {
+        switch (governor.next_step) {
+            case 0:
+                if (governor.knobs.can_disable_unwinding) {
+                    governor.next_step++;
+                    decision->action = GOVERNOR_ACTION_DISABLE_UNWINDING;
+                    return true;
+                }
+                break;
+
+            case 1:
+                if (governor.knobs.can_disable_payloads) {
+                    governor.next_step++;
+                    decision->action = GOVERNOR_ACTION_DISABLE_PAYLOADS;
+                    return true;
+                }
+                break;
+
+            case 2:                             /* (Repeated until max is reached) */
+                if (governor.knobs.sample_every_nth < GOVERNOR_MAX_SAMPLE_EVERY_NTH) {
+                    /* Tighten proportionally to overshoot (at least 2x) */
+                    unsigned factor = 2;
+                    while (factor < overshoot && factor < GOVERNOR_MAX_SAMPLE_EVERY_NTH) { factor *= 2; }
+                    const unsigned every_nth = ((governor.knobs.sample_every_nth) ? (governor.knobs.sample_every_nth) : (1)) * factor;
+                    governor.knobs.sample_every_nth = (every_nth < GOVERNOR_MAX_SAMPLE_EVERY_NTH) ? (every_nth) : (GOVERNOR_MAX_SAMPLE_EVERY_NTH);
+                    decision->action = GOVERNOR_ACTION_TIGHTEN_SAMPLING;
+                    decision->sample_every_nth = governor.knobs.sample_every_nth;
+                    return true;
+                }
+                break;
+
+            case 3:                             /* (Repeated; stays at this step, also when a window has no candidate) */
+            {
+                if (!governor.knobs.can_shed_syscalls) {
+                    break;
+                }
+                long hottest_nr = -1;
+                for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+                    if (!governor.shed_syscalls[nr] && governor.window_syscall_counts[nr] &&
+                        (-1 == hottest_nr || governor.window_syscall_counts[nr] > governor.window_syscall_counts[hottest_nr])) {
+                        hottest_nr = nr;
+                    }
+                }
+                if (-1 != hottest_nr) {
+                    governor.shed_syscalls[hottest_nr] = true;
+                    decision->action = GOVERNOR_ACTION_SHED_SYSCALL;
+                    decision->shed_syscall_nr = hottest_nr;
+                    return true;
+                }
+                return false;               /* (Hot syscalls may show up in later windows) */
+            }
+
+            default:                            /* Nothing left to degrade */
+                return false;
+        }
+    }
+}
+
+static void reset_window(uint64_t now) {
+    governor.window_start_ns = now;
+    governor.window_stops = 0;
+    governor.window_stopped_ns = 0;
+    memset(governor.window_syscall_counts, 0, sizeof(governor.window_syscall_counts));
+}
@@ -0,0 +1,65 @@
+/**
+ * Overhead governor (`--overhead-budget=<percent>`): Throttles tracing to stay within a budget
+ *   - Measures the tracer's own cost per stop (i.e., time from `waitpid` returning until the tracee is restarted)
+ *     + the stop rate  -> Overhead = share of (wall clock) time tracees are held stopped by the tracer
+ *   - Once per window, if the overhead exceeds the budget, it degrades tracing by one step
+ *     (steps which don't apply are skipped):
+ *       1. Disable stack unwinding
+ *       2. Disable payload capture (i.e., args aren't read from tracee memory anymore)
+ *       3. Tighten sampling (1-in-N per syscall nr; N grows w/ the overshoot each time, up to `GOVERNOR_MAX_SAMPLE_EVERY_NTH`)
+ *       4. Shed the most frequent syscall, i.e., don't stop on its syscall-exit anymore (only w/ seccomp-BPF)
+ */
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/* -- Consts -- */
+#define GOVERNOR_WINDOW_NS              (1000ULL * 1000 * 1000)
+#define GOVERNOR_MAX_SAMPLE_EVERY_NTH   1024
+
+
+/* -- Types -- */
+typedef enum {
+    GOVERNOR_ACTION_NONE,
+    GOVERNOR_ACTION_DISABLE_UNWINDING,
+    GOVERNOR_ACTION_DISABLE_PAYLOADS,
+    GOVERNOR_ACTION_TIGHTEN_SAMPLING,
+    GOVERNOR_ACTION_SHED_SYSCALL
+} governor_action_t;
+
+typedef struct {
+    bool can_disable_unwinding;
+    bool can_disable_payloads;
+    unsigned sample_every_nth;          /* Initial sampling rate (`0` = not sampling) */
+    bool can_shed_syscalls;
+} governor_knobs_t;
+
+typedef struct {
+    governor_action_t action;
+    unsigned sample_every_nth;          /* Only `GOVERNOR_ACTION_TIGHTEN_SAMPLING` */
+    long shed_syscall_nr;               /* Only `GOVERNOR_ACTION_SHED_SYSCALL` */
+
+    /* Window which caused the decision (for reporting) */
+    double overhead_percent;
+    double budget_percent;
+    double stops_per_sec;
+    double us_per_stop;
+} governor_decision_t;
+
+
+/* -- Function prototypes -- */
+void governor_init(double budget_percent, const governor_knobs_t* knobs);
+
+void governor_stop_begin(void);
+void governor_stop_end(void);
+void governor_count_syscall(long syscall_nr);
+
+bool governor_poll(governor_decision_t* decision);
+void governor_fprint_decision(FILE* stream, const governor_decision_t* decision);
+
+
+#endif /* GOVERNOR_H */
@@ -0,0 +1,539 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include <trace/syscallents.h>
+#include "errnos.h"
+#include "fds.h"
+#include "ptrace_utils.h"
+#include "stats.h"
+#include "syscalls.h"
+#include "timestamps.h"
+#include "tracees.h"
+#ifdef WITH_STACK_UNWINDING
+#  include "unwind.h"
+#endif /* WITH_STACK_UNWINDING */
+#include "json.h"
+
+
+/* -- Consts -- */
+#define STR_ARRAY_MAX_ELEMENTS_TO_BE_PRINTED 32     /* (Same as text output) */
+
+#define NS_PER_SEC 1000000000ULL
+#define NS_PER_US  1000ULL
+
+
+/* -- Globals -- */
+static struct {
+    FILE* stream;
+    char buf[JSON_BUF_SIZE];
+    size_t len;
+
+    bool annotate_fds;
+    char escapes[256];          /* Per byte: `0` = copied as is, otherwise char following the `\` (`u` = `\u00XX`) */
+} json;
+
+static const char hex_digits[] = "0123456789abcdef";
+
+
+/* -- Function prototypes -- */
+static void begin_event(FILE* stream, uint64_t timestamp_ns);
+static void end_event(void);
+
+static void put_args(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS], const long* rtn_val);
+static void put_str_arg(const char* type, pid_t tid, long addr, long bytes_to_read);
+static void put_str_array_arg(pid_t tid, long addr);
+static void put_fd_path(const char* key, pid_t tid, long fd);
+#ifdef WITH_STACK_UNWINDING
+static void put_frame(const char* module_name, const char* symbol, unsigned long offset, unsigned long ip, void* ctx);
+#endif /* WITH_STACK_UNWINDING */
+
+static void put(const char* data, size_t len);
+static void put_char(char c);
+static void put_lit(const char* lit);
+static void put_str(const char* str, size_t len);
+static void put_long(long value);
+static void put_ulong(unsigned long value);
+static void put_hex(unsigned long value);
+static void put_seconds(int64_t ns);
+static void put_tenths(double value);
+static void flush(void);
+
+
+/* -- Functions -- */
+void json_init(bool annotate_fds) {
+    json.annotate_fds = annotate_fds;
+    json.len = 0;
+
+    for (int c = 0; c < 256; c++) {
+        json.escapes[c] = (c < 0x20 || c >= 0x7f) ? ('u') : (0);
+    }
+    json.escapes['"']  = '"';
+    json.escapes['\\'] = '\\';
+    json.escapes['\b'] = 'b';
+    json.escapes['\f'] = 'f';
+    json.escapes['\n'] = 'n';
+    json.escapes['\r'] = 'r';
+    json.escapes['\t'] = 't';
+}
+
+
+/*
+ * `formatted_args` = `args` array formatted on syscall-enter (see `json_format_args`; `NULL` = format now)
+ */
+void json_fprint_syscall(FILE* stream, pid_t pid, const syscall_event_t* event, uint64_t duration_ns,
+                         const char* formatted_args, bool with_stack) {
+    STATS_TIMER_BEGIN(STATS_TIMER_FORMAT);
+    begin_event(stream, event->enter_ns);
+
+    put_lit(",\"pid\":");
+    put_long(pid);
+    put_lit(",\"tid\":");
+    put_long(event->tid);
+
+    put_lit(",\"syscall\":");
+    const char* const scall_name = syscalls_get_name(event->nr);
+    if (scall_name) {
+        put_str(scall_name, strlen(scall_name));
+    } else {
+        put_long(event->nr);
+    }
+
+    put_lit(",\"args\":");
+    if (formatted_args) {
+        put(formatted_args, strlen(formatted_args));
+    } else {
+        put_args(event->tid, event->nr, event->args, &event->rtn_val);
+    }
+
+/* Return value (errors like libc reports them: `-1` + errno) */
+    const long err = syscall_event_errno(event);
+    put_lit(",\"rval\":");
+    put_long((err) ? (-1) : (event->rtn_val));
+    put_lit(",\"errno\":");
+    const char* const err_name = (err) ? (errnos_get_name(err)) : (NULL);
+    if (err_name) {
+        put_str(err_name, strlen(err_name));
+    } else if (err) {
+        put_long(err);
+    } else {
+        put_lit("null");
+    }
+
+    put_lit(",\"duration\":");
+    put_seconds((int64_t)duration_ns);
+
+    if (json.annotate_fds && !err && fds_syscall_returns_fd(event->nr, event->args)) {
+        put_fd_path("rval_path", event->tid, event->rtn_val);
+    }
+
+#ifdef WITH_STACK_UNWINDING
+    if (with_stack) {
+        STATS_TIMER_BEGIN(STATS_TIMER_UNWIND);
+        put_lit(",\"stack\":[");
+        bool first_frame = true;
+        unwind_for_each_frame_of_proc(event->tid, put_frame, &first_frame);
+        put_char(']');
+        STATS_TIMER_END(STATS_TIMER_UNWIND);
+    }
+#else
+    (void)with_stack;
+#endif /* WITH_STACK_UNWINDING */
+
+    end_event();
+    STATS_TIMER_END(STATS_TIMER_FORMAT);
+}
+
+/*
+ * Formats `args` array (for syscalls whose args can only be read on syscall-enter, e.g., `execve`)
+ */
+char* json_format_args(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]) {
+    char* formatted_args = NULL;
+    size_t formatted_args_size;
+    json.stream = DIE_WHEN_ERRNO_VPTR( open_memstream(&formatted_args, &formatted_args_size) );
+    STATS_COUNT(STATS_COUNTER_ALLOCS, 1);
+    json.len = 0;
+
+    put_args(tid, syscall_nr, args, NULL);
+
+    flush();
+    fclose(json.stream);
+    return formatted_args;
+}
+
+
+void json_fprint_signal(FILE* stream, uint64_t timestamp_ns, pid_t tid, int sig) {
+    begin_event(stream, timestamp_ns);
+    put_lit(",\"tid\":");
+    put_long(tid);
+    put_lit(",\"event\":\"signal\",\"signal\":");
+    put_long(sig);
+    put_lit(",\"name\":");
+    const char* const sig_name = strsignal(sig);
+    put_str(sig_name, strlen(sig_name));
+    end_event();
+}
+
+void json_fprint_exit(FILE* stream, uint64_t timestamp_ns, pid_t tid, int exit_status) {
+    begin_event(stream, timestamp_ns);
+    put_lit(",\"tid\":");
+    put_long(tid);
+    put_lit(",\"event\":\"exit\",\"status\":");
+    put_long(exit_status);
+    end_event();
+}
+
+/*
+ * `trigger` = `NULL`: Back to cheap mode
+ */
+void json_fprint_escalation(FILE* stream, uint64_t timestamp_ns, const char* trigger) {
+    begin_event(stream, timestamp_ns);
+    if (trigger) {
+        put_lit(",\"event\":\"escalate\",\"trigger\":");
+        put_str(trigger, strlen(trigger));
+    } else {
+        put_lit(",\"event\":\"deescalate\"");
+    }
+    end_event();
+}
+
+void json_fprint_calibration(FILE* stream, uint64_t timestamp_ns, const calibration_t* calibration) {
+    begin_event(stream, timestamp_ns);
+    put_lit(",\"event\":\"calibration\",\"samples\":");
+    put_ulong(calibration->samples_count);
+    put_lit(",\"tracer_cpu\":");
+    put_long(calibration->tracer_cpu);
+    put_lit(",\"tracee_cpu\":");
+    put_long(calibration->helper_cpu);
+    put_lit(",\"min_ns\":");
+    put_ulong(calibration->min_ns);
+    put_lit(",\"p50_ns\":");
+    put_ulong(calibration->p50_ns);
+    put_lit(",\"p90_ns\":");
+    put_ulong(calibration->p90_ns);
+    put_lit(",\"p99_ns\":");
+    put_ulong(calibration->p99_ns);
+    put_lit(",\"max_ns\":");
+    put_ulong(calibration->max_ns);
+    end_event();
+}
+
+void json_fprint_governor(FILE* stream, uint64_t timestamp_ns, const governor_decision_t* decision) {
+    begin_event(stream, timestamp_ns);
+    put_lit(",\"event\":\"governor\",\"overhead\":");
+    put_tenths(decision->overhead_percent);
+    put_lit(",\"budget\":");
+    put_tenths(decision->budget_percent);
+    put_lit(",\"stops_per_sec\":");
+    put_ulong((unsigned long)(decision->stops_per_sec + 0.5));
+    put_lit(",\"us_per_stop\":");
+    put_tenths(decision->us_per_stop);
+
+    put_lit(",\"action\":");
+    switch (decision->action) {
+        case GOVERNOR_ACTION_DISABLE_UNWINDING:
+            put_lit("\"disable-unwinding\"");
+            break;
+        case GOVERNOR_ACTION_DISABLE_PAYLOADS:
+            put_lit("\"disable-payloads\"");
+            break;
+        case GOVERNOR_ACTION_TIGHTEN_SAMPLING:
+            put_lit("\"tighten-sampling\",\"sample_every\":");
+            put_ulong(decision->sample_every_nth);
+            break;
+        case GOVERNOR_ACTION_SHED_SYSCALL: {
+            put_lit("\"shed-syscall\",\"syscall\":");
+            const char* const scall_name = syscalls_get_name(decision->shed_syscall_nr);
+            if (scall_name) {
+                put_str(scall_name, strlen(scall_name));
+            } else {
+                put_long(decision->shed_syscall_nr);
+            }
+            break;
+        }
+        case GOVERNOR_ACTION_NONE:
+        default:
+            put_lit("null");
+            break;
+    }
+    end_event();
+}
+
+void json_fprint_sampling(FILE* stream, uint64_t timestamp_ns, uint64_t sampled, uint64_t seen) {
+    begin_event(stream, timestamp_ns);
+    put_lit(",\"event\":\"sampling\",\"sampled\":");
+    put_ulong(sampled);
+    put_lit(",\"seen\":");
+    put_ulong(seen);
+    end_event();
+}
+
+
+/* - Helpers - */
+static void begin_event(FILE* stream, uint64_t timestamp_ns) {
+    json.stream = stream;
+    json.len = 0;
+    put_lit("{\"ts\":");
+    put_seconds(timestamps_to_realtime_ns(timestamp_ns));
+}
+
+static void end_event(void) {
+    put_lit("}\n");
+    flush();
+}
+
+
+/*
+ * Typed by syscall table (like the generic decoder); struct args are only printed as address
+ *   `rtn_val` = `NULL` if syscall hasn't returned yet (otherwise only the bytes `read` returned are printed)
+ */
+static void put_args(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS], const long* rtn_val) {
+    STATS_TIMER_BEGIN(STATS_TIMER_DECODE);
+    const syscall_entry_t* const scall = (syscalls_get_name(syscall_nr)) ? (&syscalls[syscall_nr]) : (NULL);
+    const int nargs = (scall) ? (scall->nargs) : (SYSCALL_MAX_ARGS);
+    const bool decode_payloads = syscalls_get_payload_decoding();
+
+    put_char('[');
+    for (int arg_nr = 0; arg_nr < nargs; arg_nr++) {
+        if (arg_nr > 0) { put_char(','); }
+        const long arg = args[arg_nr];
+        const arg_type_t type = (scall) ? (scall->args[arg_nr]) : (ARG_PTR);
+
+        switch (type) {
+            case ARG_INT:
+                put_lit("{\"int\":");
+                put_long(arg);
+                put_char('}');
+                break;
+            case ARG_FD:
+                put_lit("{\"fd\":");
+                put_long((int)arg);
+                if (json.annotate_fds) {
+                    put_fd_path("path", tid, arg);
+                }
+                put_char('}');
+                break;
+            case ARG_STR:
+            case ARG_PATH:
+                if (decode_payloads) {
+                    long bytes_to_read = (__SNR_write == syscall_nr || __SNR_read == syscall_nr) ?
+                                         (args[2]) : (-1);       /* (Binary data, which isn't NUL-terminated) */
+                    if (__SNR_read == syscall_nr && rtn_val && *rtn_val < bytes_to_read) {     /* (Only returned bytes are valid) */
+                        bytes_to_read = (*rtn_val > 0) ? (*rtn_val) : (0);
+                    }
+                    put_str_arg((ARG_PATH == type) ? ("path") : ("str"), tid, arg, bytes_to_read);
+                    break;
+                }
+                /* fall through */
+            case ARG_PTR:
+            default:
+                if (__SNR_execve == syscall_nr && 1 == arg_nr && decode_payloads) {
+                    put_str_array_arg(tid, arg);
+                    break;
+                }
+                put_lit("{\"ptr\":\"");
+                put_hex((unsigned long)arg);
+                put_lit("\"}");
+                break;
+        }
+    }
+    put_char(']');
+    STATS_TIMER_END(STATS_TIMER_DECODE);
+}
+
+static void put_str_arg(const char* type, pid_t tid, long addr, long bytes_to_read) {
+    char* read_str;
+    const size_t read_str_len = ptrace_read_string(tid, (unsigned long)addr, bytes_to_read, &read_str);
+
+    put_lit("{\"");
+    put_lit(type);
+    put_lit("\":");
+    put_str(read_str, read_str_len);
+    put_char('}');
+
+    free(read_str);
+}
+
+/*
+ * NULL-terminated array of strings (e.g., `argv`); falls back to address if it can't be read
+ */
+static void put_str_array_arg(pid_t tid, long addr) {
+    unsigned long element_addr;
+    if (!addr || -1 == ptrace_read_word(tid, (unsigned long)addr, &element_addr)) {
+        put_lit("{\"ptr\":\"");
+        put_hex((unsigned long)addr);
+        put_lit("\"}");
+        return;
+    }
+
+    put_lit("{\"strs\":[");
+    for (int i = 0; element_addr && i < STR_ARRAY_MAX_ELEMENTS_TO_BE_PRINTED; ) {
+        if (i > 0) { put_char(','); }
+
+        char* read_str;
+        const size_t read_str_len = ptrace_read_string(tid, element_addr, -1, &read_str);
+        put_str(read_str, read_str_len);
+        free(read_str);
+
+        if (-1 == ptrace_read_word(tid, (unsigned long)addr + (++i * sizeof(element_addr)), &element_addr)) {
+            break;
+        }
+    }
+    put_lit("]}");
+}
+
+static void put_fd_path(const char* key, pid_t tid, long fd) {
+    const char* const path = fds_get_path(tracees_get_fds(tracees_get_or_add(tid)), tid, (int)fd);
+    if (path) {
+        put_lit(",\"");
+        put_lit(key);
+        put_lit("\":");
+        put_str(path, strlen(path));
+    }
+}
+
+#ifdef WITH_STACK_UNWINDING
+static void put_frame(const char* module_name, const char* symbol, unsigned long offset, unsigned long ip, void* ctx) {
+    bool* const first_frame = ctx;
+    if (!*first_frame) { put_char(','); }
+    *first_frame = false;
+
+    put_lit("{\"module\":");
+    if (module_name) {
+        put_str(module_name, strlen(module_name));
+    } else {
+        put_lit("null");
+    }
+    put_lit(",\"symbol\":");
+    if (symbol) {
+        put_str(symbol, strlen(symbol));
+        put_lit(",\"offset\":");
+        put_ulong(offset);
+    } else {
+        put_lit("null");
+    }
+    put_lit(",\"ip\":\"");
+    put_hex(ip);
+    put_lit("\"}");
+}
+#endif /* WITH_STACK_UNWINDING */
+
+
+/* - Writer - */
+static void put(const char* data, size_t len) {
+    if (json.len + len > sizeof(json.buf)) {
+        flush();
+        if (len > sizeof(json.buf)) {
+            fwrite(data, 1, len, json.stream);
+            return;
+        }
+    }
+    memcpy(json.buf + json.len, data, len);
+    json.len += len;
+}
+
+static void put_char(char c) {
+    if (json.len == sizeof(json.buf)) {
+        flush();
+    }
+    json.buf[json.len++] = c;
+}
+
+static void put_lit(const char* lit) {
+    put(lit, strlen(lit));      /* (Folded for literals) */
+}
+
+/*
+ * Escapes (+ quotes) arbitrary binary data  (doesn't rely on NUL-terminator)
+ */
+static void put_str(const char* str, size_t len) {
+    put_char('"');
+    for (size_t i = 0; i < len; ) {
+        /* Run of chars which don't need escaping  -> Copied at once */
+        const size_t run_start = i;
+        while (i < len && !json.escapes[(unsigned char)str[i]]) {
+            i++;
+        }
+        put(str + run_start, i - run_start);
+
+        if (i < len) {
+            const unsigned char c = (unsigned char)str[i++];
+            const char escape = json.escapes[c];
+            if ('u' == escape) {
+                const char seq[] = { '\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 0xf] };
+                put(seq, sizeof(seq));
+            } else {
+                const char seq[] = { '\\', escape };
+                put(seq, sizeof(seq));
+            }
+        }
+    }
+    put_char('"');
+}
+
+static void put_long(long value) {
+    if (value < 0) {
+        put_char('-');
+        put_ulong(-(unsigned long)value);       /* (Also correct for `LONG_MIN`) */
+    } else {
+        put_ulong((unsigned long)value);
+    }
+}
+
+static void put_ulong(unsigned long value) {
+    char digits[24];
+    char* p = digits + sizeof(digits);
+    do {
+        *--p = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value);
+    put(p, (size_t)(digits + sizeof(digits) - p));
+}
+
+static void put_hex(unsigned long value) {
+    char digits[2 + 2 * sizeof(value)];
+    char* p = digits + sizeof(digits);
+    do {
+        *--p = hex_digits[value & 0xf];
+        value >>= 4;
+    } while (value);
+    *--p = 'x';
+    *--p = '0';
+    put(p, (size_t)(digits + sizeof(digits) - p));
+}
+
+/*
+ * `<seconds>.<us>`
+ */
+static void put_seconds(int64_t ns) {
+    if (ns < 0) {
+        put_char('-');
+        ns = -ns;
+    }
+    put_ulong((unsigned long)((uint64_t)ns / NS_PER_SEC));
+
+    char us[7] = { '.' };
+    unsigned long us_value = (unsigned long)(((uint64_t)ns % NS_PER_SEC) / NS_PER_US);
+    for (int i = 6; i > 0; i--) {
+        us[i] = (char)('0' + (us_value % 10));
+        us_value /= 10;
+    }
+    put(us, sizeof(us));
+}
+
+/*
+ * Non-negative value w/ 1 decimal place (like `%.1f`)
+ */
+static void put_tenths(double value) {
+    const unsigned long tenths = (value > 0) ? ((unsigned long)(value * 10 + 0.5)) : (0);
+    put_ulong(tenths / 10);
+    put_char('.');
+    put_char((char)('0' + tenths % 10));
+}
+
+static void flush(void) {
+    if (json.len) {
+        fwrite(json.buf, 1, json.len, json.stream);
+        json.len = 0;
+    }
+}
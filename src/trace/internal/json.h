@@ -0,0 +1,58 @@
+/**
+ * NDJSON output (`--format=json`): One JSON object per line for each event
+ *   - Syscalls (on syscall-exit):
+ *       {"ts":1700000000.123456,"pid":42,"tid":43,"syscall":"openat",
+ *        "args":[{"fd":-100},{"path":"/etc/hostname"},{"int":524288},{"int":0}],
+ *        "rval":3,"errno":null,"duration":0.000012[,"rval_path":"/etc/hostname"][,"stack":[...]]}
+ *       Args are typed by the syscall table (`int`, `fd` (+ `path` w/ `-y`), `str`, `path`, `ptr` (hex string,
+ *       as 64-bit values exceed a double's precision); `execve`'s argv: `strs`); errors: `"rval":-1,"errno":"ENOENT"`
+ *   - Signals:    {"ts":...,"tid":43,"event":"signal","signal":17,"name":"Child exited"}
+ *   - Exits:      {"ts":...,"tid":43,"event":"exit","status":0}
+ *   - Escalation: {"ts":...,"event":"escalate","trigger":"..."} / {"ts":...,"event":"deescalate"}
+ *   - Reports:    {"ts":...,"event":"calibration","samples":10000,"tracer_cpu":0,"tracee_cpu":1,"min_ns":...,"p50_ns":...,
+ *                  "p90_ns":...,"p99_ns":...,"max_ns":...}
+ *                 {"ts":...,"event":"governor","overhead":58.7,"budget":1.0,"stops_per_sec":110258,"us_per_stop":5.3,
+ *                  "action":"tighten-sampling","sample_every":128}  (`action`: `disable-unwinding`, `disable-payloads`,
+ *                  `tighten-sampling`, `shed-syscall` (+ `"syscall":"..."`))
+ *                 {"ts":...,"event":"sampling","sampled":106384,"seen":300030}
+ *   `ts` = wall-clock time (of syscall-enter), `duration` in seconds
+ *
+ *   Formatted by hand (no `printf`, no allocations) into a fixed-size buffer, which is written w/ a single `fwrite`
+ *   per event (only huge events are written in multiple chunks)
+ *   Strings (i.e., arbitrary binary payloads) are escaped table-driven (runs of plain chars are copied at once);
+ *   bytes which aren't printable ASCII become `\u00XX`  -> Output is always valid JSON (+ ASCII) & lossless (bytes
+ *   map to code points 0-255)
+ */
+#ifndef JSON_H
+#define JSON_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "calibration.h"
+#include "governor.h"
+#include "syscall_event.h"
+
+
+/* -- Consts -- */
+#define JSON_BUF_SIZE (16 * 1024)
+
+
+/* -- Function prototypes -- */
+void json_init(bool annotate_fds);
+
+void json_fprint_syscall(FILE* stream, pid_t pid, const syscall_event_t* event, uint64_t duration_ns,
+                         const char* formatted_args, bool with_stack);
+char* json_format_args(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]);     /* WARNING: MUST BE `free`(3)'ed */
+
+void json_fprint_signal(FILE* stream, uint64_t timestamp_ns, pid_t tid, int sig);
+void json_fprint_exit(FILE* stream, uint64_t timestamp_ns, pid_t tid, int exit_status);
+void json_fprint_escalation(FILE* stream, uint64_t timestamp_ns, const char* trigger);
+void json_fprint_calibration(FILE* stream, uint64_t timestamp_ns, const calibration_t* calibration);
+void json_fprint_governor(FILE* stream, uint64_t timestamp_ns, const governor_decision_t* decision);
+void json_fprint_sampling(FILE* stream, uint64_t timestamp_ns, uint64_t sampled, uint64_t seen);
+
+
+#endif /* JSON_H */
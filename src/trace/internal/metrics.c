@@ -0,0 +1,596 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+
+#include <common/error.h>
+#include <common/thread_utils.h>
+#include <common/time_utils.h>
+#include <trace/syscallents.h>
+#include "calibration.h"
+#include "syscalls.h"
+#include "metrics.h"
+
+
+/* -- Consts -- */
+#define METRICS_HISTOGRAM_BUCKETS 40            /* Bucket `b` = durations in [2^(b-1), 2^b) ns (`0` = 0 ns); last one is open-ended (~275 s) */
+#define METRICS_PROCESSES_INITIAL_CAPACITY 64   /* MUST be a power of 2 */
+
+static const double QUANTILES[] = { 0.5, 0.9, 0.99 };
+
+static const char* const BYTE_TRANSFERRING_SYSCALLS[] = {      /* Positive return value = nr of bytes transferred */
+    "read", "write", "pread64", "pwrite64", "readv", "writev", "preadv", "pwritev", "preadv2", "pwritev2",
+    "recvfrom", "sendto", "recvmsg", "sendmsg", "sendfile", "splice", "tee", "copy_file_range",
+    "process_vm_readv", "process_vm_writev"
+};
+
+
+/* -- Types -- */
+typedef struct {
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t bytes;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t histogram[METRICS_HISTOGRAM_BUCKETS];
+} syscall_metrics_t;
+
+typedef struct {
+    pid_t pid;                              /* `0` = empty slot */
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t bytes;
+    uint64_t total_ns;
+} process_metrics_t;
+
+typedef struct {
+    syscall_metrics_t syscalls[SYSCALLS_ARR_SIZE];     /* Indexed by syscall nr */
+    process_metrics_t* processes;           /* Hash table (open addressing w/ linear probing; `NULL` w/o per-process metrics) */
+    size_t processes_count, processes_capacity;
+} metrics_table_t;
+
+
+/* -- Globals -- */
+static struct {
+    metrics_table_t tables[2];              /* Double-buffered: One is recorded into by the trace loop, the other one is spare */
+    metrics_table_t* active;                /* (Swapped by reporter) */
+    bool recording;                         /* Whether trace loop is inside `metrics_record` (i.e., may still use the retired table) */
+
+    metrics_table_t cumulative;             /* Reporter only */
+    bool transfers_bytes[SYSCALLS_ARR_SIZE];
+
+    uint64_t interval_ns;
+    metrics_format_t format;
+    bool per_process;
+    bool cumulative_snapshots;
+
+    const char* output_path;                /* `NULL` = `stderr` */
+    bool output_is_socket;
+    int output_fd;                          /* `-1` = (socket) not connected */
+
+    pthread_t reporter;
+    pthread_mutex_t stop_lock;
+    pthread_cond_t stop_cond;
+    bool stop;
+    uint64_t last_snapshot_ns;
+} metrics;
+
+
+/* -- Function prototypes -- */
+static void* reporter_main(void* ctx);
+static void snapshot(void);
+
+static void fprint_openmetrics(FILE* stream, const metrics_table_t* table);
+static void fprint_openmetrics_family(FILE* stream, const char* name, const char* type, const char* unit, const char* help);
+static void fprint_json(FILE* stream, const metrics_table_t* table, uint64_t interval_ns);
+static double quantile_seconds(const syscall_metrics_t* entry, double quantile);
+static void fprint_syscall_name(FILE* stream, long nr);
+
+static void open_output(void);
+static void write_output(const char* buf, size_t len);
+
+static void table_init(metrics_table_t* table);
+static void table_fin(metrics_table_t* table);
+static void table_clear(metrics_table_t* table);
+static void table_merge(metrics_table_t* dst, const metrics_table_t* src);
+static process_metrics_t* table_process(metrics_table_t* table, pid_t pid);
+static void table_grow_processes(metrics_table_t* table);
+static unsigned histogram_bucket(uint64_t duration_ns);
+
+
+/* -- Functions -- */
+void metrics_init(uint64_t interval_ns, metrics_format_t format, const char* output,
+                  bool per_process, bool cumulative) {
+/* 0. Config */
+    metrics.interval_ns = interval_ns;
+    metrics.format = format;
+    metrics.per_process = per_process;
+    metrics.cumulative_snapshots = cumulative;
+
+    memset(metrics.transfers_bytes, 0, sizeof(metrics.transfers_bytes));
+    for (size_t i = 0; i < sizeof(BYTE_TRANSFERRING_SYSCALLS) / sizeof(*BYTE_TRANSFERRING_SYSCALLS); i++) {
+        const long nr = syscalls_get_nr((char*)BYTE_TRANSFERRING_SYSCALLS[i]);
+        if (nr >= 0 && nr <= MAX_SYSCALL_NUM) {     /* (Not all exist on all archs) */
+            metrics.transfers_bytes[nr] = true;
+        }
+    }
+
+/* 1. Tables */
+    table_init(&metrics.tables[0]);
+    table_init(&metrics.tables[1]);
+    table_init(&metrics.cumulative);
+    metrics.active = &metrics.tables[0];
+    metrics.recording = false;
+
+/* 2. Output (opened upfront, so that misconfigurations are reported immediately) */
+    metrics.output_is_socket = output && !strncmp(METRICS_SOCKET_PREFIX, output, strlen(METRICS_SOCKET_PREFIX));
+    metrics.output_path = (metrics.output_is_socket) ? (output + strlen(METRICS_SOCKET_PREFIX)) : (output);
+    metrics.output_fd = -1;
+    open_output();
+    if (-1 == metrics.output_fd) {
+        LOG_ERROR_AND_DIE("Couldn't open metrics output \"%s\" -- %s", output, strerror(errno));
+    }
+
+/* 3. Reporter thread */
+    metrics.stop = false;
+    metrics.last_snapshot_ns = time_now_ns();
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&metrics.stop_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    pthread_mutex_init(&metrics.stop_lock, NULL);
+
+    const int error = thread_create_w_signals_blocked(&metrics.reporter, reporter_main, NULL);
+    if (error) {
+        LOG_ERROR_AND_DIE("Couldn't create metrics reporter thread -- %s", strerror(error));
+    }
+}
+
+/*
+ * Stops the reporter (which reports a final snapshot)
+ */
+void metrics_fin(void) {
+    pthread_mutex_lock(&metrics.stop_lock);
+    metrics.stop = true;
+    pthread_cond_signal(&metrics.stop_cond);
+    pthread_mutex_unlock(&metrics.stop_lock);
+    pthread_join(metrics.reporter, NULL);
+
+    pthread_cond_destroy(&metrics.stop_cond);
+    pthread_mutex_destroy(&metrics.stop_lock);
+    if (-1 != metrics.output_fd && STDERR_FILENO != metrics.output_fd) {
+        close(metrics.output_fd);
+    }
+    table_fin(&metrics.tables[0]);
+    table_fin(&metrics.tables[1]);
+    table_fin(&metrics.cumulative);
+}
+
+
+/*
+ * Trace loop: Accounts completed syscall in the active table
+ */
+void metrics_record(const syscall_event_t* event, pid_t pid) {
+    if (event->nr < 0 || event->nr > MAX_SYSCALL_NUM) {
+        return;
+    }
+
+    /* Announce use of table prior loading it (pairs w/ swap in `snapshot`; both sequentially consistent) */
+    __atomic_store_n(&metrics.recording, true, __ATOMIC_SEQ_CST);
+    metrics_table_t* const table = __atomic_load_n(&metrics.active, __ATOMIC_SEQ_CST);
+
+    const uint64_t duration_ns = calibration_correct_duration_ns(event->exit_ns - event->enter_ns);
+    const bool failed = (0 != syscall_event_errno(event));
+    const uint64_t bytes = (metrics.transfers_bytes[event->nr] && event->rtn_val > 0) ? ((uint64_t)event->rtn_val) : (0);
+
+    syscall_metrics_t* const entry = &table->syscalls[event->nr];
+    entry->calls++;
+    entry->errors += failed;
+    entry->bytes += bytes;
+    entry->total_ns += duration_ns;
+    if (duration_ns > entry->max_ns) {
+        entry->max_ns = duration_ns;
+    }
+    entry->histogram[histogram_bucket(duration_ns)]++;
+
+    if (metrics.per_process) {
+        process_metrics_t* const process = table_process(table, pid);
+        process->calls++;
+        process->errors += failed;
+        process->bytes += bytes;
+        process->total_ns += duration_ns;
+    }
+
+    __atomic_store_n(&metrics.recording, false, __ATOMIC_RELEASE);
+}
+
+
+/* - Reporter - */
+static void* reporter_main(__attribute__((unused)) void* ctx) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    pthread_mutex_lock(&metrics.stop_lock);
+    while (!metrics.stop) {
+        const uint64_t deadline_ns = (uint64_t)deadline.tv_nsec + metrics.interval_ns;      /* (Fixed rate, i.e., w/o drift) */
+        deadline.tv_sec += (time_t)(deadline_ns / 1000000000ULL);
+        deadline.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+
+        while (!metrics.stop &&
+               ETIMEDOUT != pthread_cond_timedwait(&metrics.stop_cond, &metrics.stop_lock, &deadline)) { }
+
+        pthread_mutex_unlock(&metrics.stop_lock);
+        snapshot();                 /* (Also final one, when stopped) */
+        pthread_mutex_lock(&metrics.stop_lock);
+    }
+    pthread_mutex_unlock(&metrics.stop_lock);
+
+    return NULL;
+}
+
+static void snapshot(void) {
+/* 1. Swap tables + wait until trace loop has left the retired one */
+    metrics_table_t* const retired = metrics.active;
+    metrics_table_t* const spare = (retired == &metrics.tables[0]) ? (&metrics.tables[1]) : (&metrics.tables[0]);
+    __atomic_store_n(&metrics.active, spare, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&metrics.recording, __ATOMIC_SEQ_CST)) {
+        sched_yield();
+    }
+
+    const uint64_t now_ns = time_now_ns();
+    const uint64_t interval_ns = now_ns - metrics.last_snapshot_ns;
+    metrics.last_snapshot_ns = now_ns;
+
+/* 2. Format */
+    const metrics_table_t* reported = retired;
+    if (metrics.cumulative_snapshots) {
+        table_merge(&metrics.cumulative, retired);
+        reported = &metrics.cumulative;
+    }
+
+    char* buf = NULL;
+    size_t buf_len = 0;
+    FILE* const stream = DIE_WHEN_ERRNO_VPTR( open_memstream(&buf, &buf_len) );
+    switch (metrics.format) {
+        case METRICS_FORMAT_OPENMETRICS:
+            fprint_openmetrics(stream, reported);
+            break;
+        case METRICS_FORMAT_JSON:
+        default:
+            fprint_json(stream, reported, interval_ns);
+            break;
+    }
+    fclose(stream);
+
+/* 3. Write + recycle retired table (as next spare) */
+    write_output(buf, buf_len);
+    free(buf);
+
+    table_clear(retired);
+}
+
+
+/* - Formatting - */
+static void fprint_openmetrics(FILE* stream, const metrics_table_t* table) {
+    /* Per-interval snapshots aren't monotonic  -> Reported as gauges */
+    const char* const counter_type = (metrics.cumulative_snapshots) ? ("counter") : ("gauge");
+    const char* const counter_suffix = (metrics.cumulative_snapshots) ? ("_total") : ("");
+
+    fprint_openmetrics_family(stream, "ministrace_syscall_latency_seconds", "summary", "seconds",
+                              "Time spent in system calls (quantiles estimated from log2 histogram)");
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        const syscall_metrics_t* const entry = &table->syscalls[nr];
+        if (!entry->calls) { continue; }
+
+        for (size_t i = 0; i < sizeof(QUANTILES) / sizeof(*QUANTILES); i++) {
+            fputs("ministrace_syscall_latency_seconds{syscall=\"", stream);
+            fprint_syscall_name(stream, nr);
+            fprintf(stream, "\",quantile=\"%g\"} %.9f\n", QUANTILES[i], quantile_seconds(entry, QUANTILES[i]));
+        }
+        fputs("ministrace_syscall_latency_seconds_sum{syscall=\"", stream);
+        fprint_syscall_name(stream, nr);
+        fprintf(stream, "\"} %.9f\n", (double)entry->total_ns / 1e9);
+        fputs("ministrace_syscall_latency_seconds_count{syscall=\"", stream);
+        fprint_syscall_name(stream, nr);
+        fprintf(stream, "\"} %llu\n", (unsigned long long)entry->calls);
+    }
+
+    fprint_openmetrics_family(stream, "ministrace_syscall_latency_max_seconds", "gauge", "seconds",
+                              "Slowest system call");
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        if (!table->syscalls[nr].calls) { continue; }
+        fputs("ministrace_syscall_latency_max_seconds{syscall=\"", stream);
+        fprint_syscall_name(stream, nr);
+        fprintf(stream, "\"} %.9f\n", (double)table->syscalls[nr].max_ns / 1e9);
+    }
+
+    fprint_openmetrics_family(stream, "ministrace_syscall_errors", counter_type, NULL,
+                              "System calls which returned an error");
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        if (!table->syscalls[nr].calls) { continue; }
+        fprintf(stream, "ministrace_syscall_errors%s{syscall=\"", counter_suffix);
+        fprint_syscall_name(stream, nr);
+        fprintf(stream, "\"} %llu\n", (unsigned long long)table->syscalls[nr].errors);
+    }
+
+    fprint_openmetrics_family(stream, "ministrace_syscall_transferred_bytes", counter_type, "bytes",
+                              "Bytes read / written by system calls");
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        if (!table->syscalls[nr].calls || !metrics.transfers_bytes[nr]) { continue; }
+        fprintf(stream, "ministrace_syscall_transferred_bytes%s{syscall=\"", counter_suffix);
+        fprint_syscall_name(stream, nr);
+        fprintf(stream, "\"} %llu\n", (unsigned long long)table->syscalls[nr].bytes);
+    }
+
+    if (metrics.per_process) {
+        static const struct { const char* name; const char* unit; const char* help; } PROCESS_FAMILIES[] = {
+            { "ministrace_process_syscalls", NULL, "System calls of process" },
+            { "ministrace_process_syscall_errors", NULL, "System calls of process which returned an error" },
+            { "ministrace_process_transferred_bytes", "bytes", "Bytes read / written by system calls of process" },
+            { "ministrace_process_syscall_seconds", "seconds", "Time spent in system calls of process" },
+        };
+        for (size_t i = 0; i < sizeof(PROCESS_FAMILIES) / sizeof(*PROCESS_FAMILIES); i++) {
+            fprint_openmetrics_family(stream, PROCESS_FAMILIES[i].name, counter_type, PROCESS_FAMILIES[i].unit,
+                                      PROCESS_FAMILIES[i].help);
+            for (size_t slot = 0; slot < table->processes_capacity; slot++) {
+                const process_metrics_t* const process = &table->processes[slot];
+                if (!process->pid) { continue; }
+
+                fprintf(stream, "%s%s{pid=\"%d\"} ", PROCESS_FAMILIES[i].name, counter_suffix, process->pid);
+                switch (i) {
+                    case 0:  fprintf(stream, "%llu\n", (unsigned long long)process->calls); break;
+                    case 1:  fprintf(stream, "%llu\n", (unsigned long long)process->errors); break;
+                    case 2:  fprintf(stream, "%llu\n", (unsigned long long)process->bytes); break;
+                    default: fprintf(stream, "%.9f\n", (double)process->total_ns / 1e9); break;
+                }
+            }
+        }
+    }
+
+    fputs("# EOF\n", stream);
+}
+
+static void fprint_openmetrics_family(FILE* stream, const char* name, const char* type, const char* unit, const char* help) {
+    fprintf(stream, "# TYPE %s %s\n", name, type);
+    if (unit) {
+        fprintf(stream, "# UNIT %s %s\n", name, unit);
+    }
+    fprintf(stream, "# HELP %s %s\n", name, help);
+}
+
+static void fprint_json(FILE* stream, const metrics_table_t* table, uint64_t interval_ns) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    fprintf(stream, "{\"ts\":%lld.%06ld,\"interval\":%.6f,\"cumulative\":%s,\"syscalls\":[",
+            (long long)now.tv_sec, now.tv_nsec / 1000, (double)interval_ns / 1e9,
+            (metrics.cumulative_snapshots) ? ("true") : ("false"));
+
+    const char* separator = "";
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        const syscall_metrics_t* const entry = &table->syscalls[nr];
+        if (!entry->calls) { continue; }
+
+        fprintf(stream, "%s{\"syscall\":\"", separator);
+        fprint_syscall_name(stream, nr);
+        fprintf(stream, "\",\"calls\":%llu,\"errors\":%llu,\"bytes\":%llu,\"seconds\":%.9f,\"max\":%.9f",
+                (unsigned long long)entry->calls, (unsigned long long)entry->errors, (unsigned long long)entry->bytes,
+                (double)entry->total_ns / 1e9, (double)entry->max_ns / 1e9);
+        for (size_t i = 0; i < sizeof(QUANTILES) / sizeof(*QUANTILES); i++) {
+            fprintf(stream, ",\"p%g\":%.9f", QUANTILES[i] * 100, quantile_seconds(entry, QUANTILES[i]));
+        }
+        fputc('}', stream);
+        separator = ",";
+    }
+    fputc(']', stream);
+
+    if (metrics.per_process) {
+        fputs(",\"processes\":[", stream);
+        separator = "";
+        for (size_t slot = 0; slot < table->processes_capacity; slot++) {
+            const process_metrics_t* const process = &table->processes[slot];
+            if (!process->pid) { continue; }
+
+            fprintf(stream, "%s{\"pid\":%d,\"calls\":%llu,\"errors\":%llu,\"bytes\":%llu,\"seconds\":%.9f}", separator,
+                    process->pid, (unsigned long long)process->calls, (unsigned long long)process->errors,
+                    (unsigned long long)process->bytes, (double)process->total_ns / 1e9);
+            separator = ",";
+        }
+        fputc(']', stream);
+    }
+    fputs("}\n", stream);
+}
+
+/*
+ * Estimates quantile by linear interpolation within the histogram bucket it falls into (capped by the max. duration)
+ */
+static double quantile_seconds(const syscall_metrics_t* entry, double quantile) {
+    const double rank = quantile * (double)entry->calls;
+    double seen = 0;
+    for (unsigned b = 0; b < METRICS_HISTOGRAM_BUCKETS; b++) {
+        const double count = (double)entry->histogram[b];
+        if (count > 0 && seen + count >= rank) {
+            const double lower_ns = (b) ? ((double)(1ULL << (b - 1))) : (0);
+            double upper_ns = (b) ? ((double)(1ULL << b)) : (1);
+            if (upper_ns > (double)entry->max_ns) {
+                upper_ns = (double)entry->max_ns;
+            }
+            const double estimate_ns = lower_ns + (upper_ns - lower_ns) * ((rank - seen) / count);
+            return ((estimate_ns > lower_ns) ? (estimate_ns) : (lower_ns)) / 1e9;
+        }
+        seen += count;
+    }
+    return (double)entry->max_ns / 1e9;
+}
+
+static void fprint_syscall_name(FILE* stream, long nr) {
+    const char* const scall_name = syscalls_get_name(nr);
+    if (scall_name) {
+        fputs(scall_name, stream);
+    } else {
+        fprintf(stream, "sys_%ld", nr);
+    }
+}
+
+
+/* - Output - */
+static void open_output(void) {
+    if (!metrics.output_path) {
+        metrics.output_fd = STDERR_FILENO;
+
+    } else if (metrics.output_is_socket) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(metrics.output_path) >= sizeof(addr.sun_path)) {
+            errno = ENAMETOOLONG;
+            return;
+        }
+        strcpy(addr.sun_path, metrics.output_path);
+
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (-1 == fd) {
+            return;
+        }
+        if (-1 == connect(fd, (const struct sockaddr*)&addr, sizeof(addr))) {
+            const int connect_errno = errno;
+            close(fd);
+            errno = connect_errno;
+            return;
+        }
+        metrics.output_fd = fd;
+
+    } else {
+        metrics.output_fd = open(metrics.output_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    }
+}
+
+/*
+ * Writes snapshot entirely; a socket whose peer went away is reconnected on the next snapshot (which is lost otherwise)
+ */
+static void write_output(const char* buf, size_t len) {
+    if (-1 == metrics.output_fd) {
+        open_output();
+        if (-1 == metrics.output_fd) {
+            return;
+        }
+    }
+
+    while (len > 0) {
+        const ssize_t written = (metrics.output_is_socket) ?
+                                (send(metrics.output_fd, buf, len, MSG_NOSIGNAL)) :      /* (W/o `SIGPIPE`) */
+                                (write(metrics.output_fd, buf, len));
+        if (-1 == written) {
+            if (EINTR == errno) { continue; }
+
+            LOG_WARN("Couldn't write metrics snapshot -- %s", strerror(errno));
+            if (metrics.output_is_socket) {
+                close(metrics.output_fd);
+                metrics.output_fd = -1;
+            }
+            return;
+        }
+        buf += written;
+        len -= (size_t)written;
+    }
+}
+
+
+/* - Tables - */
+static void table_init(metrics_table_t* table) {
+    memset(table->syscalls, 0, sizeof(table->syscalls));
+    table->processes = NULL;
+    table->processes_count = table->processes_capacity = 0;
+    if (metrics.per_process) {
+        table->processes_capacity = METRICS_PROCESSES_INITIAL_CAPACITY;
+        table->processes = DIE_WHEN_ERRNO_VPTR( calloc(table->processes_capacity, sizeof(*table->processes)) );
+    }
+}
+
+static void table_fin(metrics_table_t* table) {
+    free(table->processes);
+    table->processes = NULL;
+}
+
+static void table_clear(metrics_table_t* table) {
+    memset(table->syscalls, 0, sizeof(table->syscalls));
+    if (table->processes) {
+        memset(table->processes, 0, table->processes_capacity * sizeof(*table->processes));
+        table->processes_count = 0;
+    }
+}
+
+static void table_merge(metrics_table_t* dst, const metrics_table_t* src) {
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        const syscall_metrics_t* const from = &src->syscalls[nr];
+        syscall_metrics_t* const to = &dst->syscalls[nr];
+        if (!from->calls) { continue; }
+
+        to->calls += from->calls;
+        to->errors += from->errors;
+        to->bytes += from->bytes;
+        to->total_ns += from->total_ns;
+        if (from->max_ns > to->max_ns) {
+            to->max_ns = from->max_ns;
+        }
+        for (unsigned b = 0; b < METRICS_HISTOGRAM_BUCKETS; b++) {
+            to->histogram[b] += from->histogram[b];
+        }
+    }
+
+    for (size_t slot = 0; slot < src->processes_capacity; slot++) {
+        const process_metrics_t* const from = &src->processes[slot];
+        if (!from->pid) { continue; }
+
+        process_metrics_t* const to = table_process(dst, from->pid);
+        to->calls += from->calls;
+        to->errors += from->errors;
+        to->bytes += from->bytes;
+        to->total_ns += from->total_ns;
+    }
+}
+
+/*
+ * Returns metrics of process (inserted if absent)
+ */
+static process_metrics_t* table_process(metrics_table_t* table, pid_t pid) {
+    if (2 * (table->processes_count + 1) > table->processes_capacity) {     /* Load factor <= 0.5 */
+        table_grow_processes(table);
+    }
+
+    size_t slot = (size_t)pid * 2654435761U & (table->processes_capacity - 1);
+    while (table->processes[slot].pid && table->processes[slot].pid != pid) {
+        slot = (slot + 1) & (table->processes_capacity - 1);
+    }
+    if (!table->processes[slot].pid) {
+        table->processes[slot].pid = pid;
+        table->processes_count++;
+    }
+    return &table->processes[slot];
+}
+
+static void table_grow_processes(metrics_table_t* table) {
+    process_metrics_t* const old_processes = table->processes;
+    const size_t old_capacity = table->processes_capacity;
+
+    table->processes_capacity = old_capacity * 2;
+    table->processes = DIE_WHEN_ERRNO_VPTR( calloc(table->processes_capacity, sizeof(*table->processes)) );
+    table->processes_count = 0;
+    for (size_t slot = 0; slot < old_capacity; slot++) {
+        if (old_processes[slot].pid) {
+            *table_process(table, old_processes[slot].pid) = old_processes[slot];
+        }
+    }
+    free(old_processes);
+}
+
+static unsigned histogram_bucket(uint64_t duration_ns) {
+    const unsigned bucket = (duration_ns) ? (64 - (unsigned)__builtin_clzll(duration_ns)) : (0);
+    return (bucket < METRICS_HISTOGRAM_BUCKETS) ? (bucket) : (METRICS_HISTOGRAM_BUCKETS - 1);
+}
@@ -0,0 +1,34 @@
+/**
+ * Periodic metrics snapshots (`--interval`): Per syscall (+ optionally per process) calls, errors, transferred bytes,
+ * time spent + latency quantiles, reported every interval (and at exit) as OpenMetrics text or JSON (one line per
+ * snapshot) to `stderr`, a file (appended) or a UNIX socket (`unix:<path>`; reconnected when the peer went away)
+ *   - The trace loop only increments counters + a log2 latency histogram of the active one of two (double-buffered)
+ *     tables; a reporter thread swaps in the spare table, waits until a concurrent `metrics_record` (if any) has left
+ *     the retired one (a few ns), then formats + writes the snapshot  -> The trace loop never waits for reporting
+ *   - Tables only hold the deltas of their interval; cumulative snapshots (default) are summed up by the reporter
+ *   - Quantiles are interpolated within the histogram bucket (i.e., accurate to a factor of 2 at worst)
+ */
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "../tracing.h"
+#include "syscall_event.h"
+
+
+/* -- Consts -- */
+#define METRICS_SOCKET_PREFIX "unix:"
+
+
+/* -- Function prototypes -- */
+void metrics_init(uint64_t interval_ns, metrics_format_t format, const char* output,
+                  bool per_process, bool cumulative);
+void metrics_fin(void);
+
+void metrics_record(const syscall_event_t* event, pid_t pid);
+
+
+#endif /* METRICS_H */
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+
+#include <common/error.h>
+#include "stats.h"
+#include "output.h"
+
+
+/* -- Consts -- */
+#define UNFINISHED_SUFFIX " <unfinished ...>\n"
+
+
+/* -- Globals -- */
+static struct {
+    output_mode_t mode;
+    bool tag_tids;
+    pid_t open_line_tid;        /* strace mode: Task whose syscall-enter has been written, but not its exit yet (`0` = none) */
+} output = { OUTPUT_MODE_INTERLEAVED, false, 0 };
+
+
+/* -- Function prototypes -- */
+static FILE* pending_line_of(tracee_t* tracee);
+static bool has_pending_line(const tracee_t* tracee);
+static void write_pending_line(tracee_t* tracee);
+
+
+/* -- Functions -- */
+void output_init(output_mode_t mode, bool tag_tids) {
+    output.mode = mode;
+    output.tag_tids = tag_tids;
+    output.open_line_tid = 0;
+}
+
+
+/*
+ * Returns stream syscall-enter shall be written to
+ *   (`tracee` may only be `NULL` in interleaved mode)
+ */
+FILE* output_begin_syscall(tracee_t* tracee, pid_t tid) {
+    switch (output.mode) {
+        case OUTPUT_MODE_COMPLETE:
+            if (has_pending_line(tracee)) {     /* Syscall-exit of previous syscall wasn't seen */
+                output_abandon_syscall(tracee, tid);
+            }
+            return pending_line_of(tracee);
+
+        case OUTPUT_MODE_STRACE:
+            output_interrupt();
+            output.open_line_tid = tid;
+            return stderr;
+
+        case OUTPUT_MODE_INTERLEAVED:
+        default:
+            return stderr;
+    }
+}
+
+/*
+ * Returns stream syscall-exit shall be written to; `resumed` = whether it's written on a line of its own
+ *   (i.e., w/o the syscall-enter on it)
+ */
+FILE* output_resume_syscall(tracee_t* tracee, pid_t tid, const char* scall_name, bool* resumed) {
+    *resumed = false;
+    switch (output.mode) {
+        case OUTPUT_MODE_COMPLETE:
+            if (has_pending_line(tracee)) {
+                return tracee->pending_line;
+            }
+            break;      /* Syscall-enter wasn't seen (e.g., attached w/in syscall) */
+
+        case OUTPUT_MODE_STRACE:
+            if (tid == output.open_line_tid) {
+                return stderr;
+            }
+            output_interrupt();
+            output.open_line_tid = tid;
+            if (output.tag_tids) {
+                fprintf(stderr, "[%d] ", tid);
+            }
+            fprintf(stderr, "<... %s resumed>", scall_name);
+            *resumed = true;
+            return stderr;
+
+        case OUTPUT_MODE_INTERLEAVED:
+        default:
+            break;
+    }
+
+    if (output.tag_tids) {        /* For task identification (in log) when following `clone`s */
+        fprintf(stderr, "\n... [%d - %s (%d)]", tid, scall_name, tid);
+        *resumed = true;
+    }
+    return stderr;
+}
+
+/*
+ * Syscall-exit (incl. the line's `\n`) has been written to the stream returned by `output_resume_syscall`
+ */
+void output_end_syscall(tracee_t* tracee) {
+    switch (output.mode) {
+        case OUTPUT_MODE_COMPLETE:
+            if (has_pending_line(tracee)) {
+                write_pending_line(tracee);
+            }
+            break;
+
+        case OUTPUT_MODE_STRACE:
+            output.open_line_tid = 0;
+            break;
+
+        case OUTPUT_MODE_INTERLEAVED:
+        default:
+            break;
+    }
+}
+
+/*
+ * Task won't return from its current syscall (e.g., terminated w/in `exit_group`)  -> Completes its line w/ `= ?`
+ */
+void output_abandon_syscall(tracee_t* tracee, pid_t tid) {
+    switch (output.mode) {
+        case OUTPUT_MODE_COMPLETE:
+            if (tracee && has_pending_line(tracee)) {
+                fputs(" = ?\n", tracee->pending_line);
+                write_pending_line(tracee);
+            }
+            break;
+
+        case OUTPUT_MODE_STRACE:
+            if (tid == output.open_line_tid) {
+                fputs(" = ?\n", stderr);
+                output.open_line_tid = 0;
+            }
+            break;
+
+        case OUTPUT_MODE_INTERLEAVED:
+        default:
+            break;
+    }
+}
+
+
+/*
+ * Something else is about to be written  -> Splits the open line (if any)
+ */
+void output_interrupt(void) {
+    if (output.open_line_tid) {
+        fputs(UNFINISHED_SUFFIX, stderr);
+        output.open_line_tid = 0;
+    }
+}
+
+
+/* - Helpers - */
+static FILE* pending_line_of(tracee_t* tracee) {
+    if (!tracee->pending_line) {
+        tracee->pending_line = DIE_WHEN_ERRNO_VPTR( open_memstream(&tracee->pending_line_buf, &tracee->pending_line_buf_size) );
+        STATS_COUNT(STATS_COUNTER_ALLOCS, 1);
+    }
+    return tracee->pending_line;
+}
+
+static bool has_pending_line(const tracee_t* tracee) {
+    return (tracee->pending_line && ftello(tracee->pending_line) > 0);
+}
+
+static void write_pending_line(tracee_t* tracee) {
+    const off_t line_len = ftello(tracee->pending_line);
+    fflush(tracee->pending_line);        /* (Updates `pending_line_buf`) */
+    fwrite(tracee->pending_line_buf, 1, (size_t)line_len, stderr);
+    rewind(tracee->pending_line);
+}
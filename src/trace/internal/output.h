@@ -0,0 +1,35 @@
+/**
+ * Writing the syscall lines of the ptrace backend, whose syscall-enter + -exit of different tasks may
+ * alternate (`-f`, multiple `-p`, `--cgroup`)  -> `--output-mode`
+ *   - interleaved: Syscall-enter + -exit are written when they happen; w/ tagged tids, the exit is always
+ *                  continued on its own `... [tid - name (tid)]` line (as other tasks' lines may lie in between)
+ *   - complete:    Syscall-enter is formatted into a pending line of its task (`open_memstream`), which is
+ *                  completed on syscall-exit + written w/ a single `fwrite` (`stderr` is unbuffered  -> 1 `write`)
+ *                  -> Lines never interleave (but are ordered by syscall-exit)
+ *   - strace:      Syscall-enter is written immediately; its line is only split (` <unfinished ...>` +
+ *                  `[tid] <... name resumed>`) when another task's output is written in between
+ *   Other output of the trace loop (e.g., `+++ ... +++` lines) MUST be preceded by `output_interrupt`
+ */
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "../tracing.h"
+#include "tracees.h"
+
+
+/* -- Function prototypes -- */
+void output_init(output_mode_t mode, bool tag_tids);
+
+FILE* output_begin_syscall(tracee_t* tracee, pid_t tid);
+FILE* output_resume_syscall(tracee_t* tracee, pid_t tid, const char* scall_name, bool* resumed);
+void output_end_syscall(tracee_t* tracee);
+void output_abandon_syscall(tracee_t* tracee, pid_t tid);
+
+void output_interrupt(void);
+
+
+#endif /* OUTPUT_H */
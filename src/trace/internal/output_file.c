@@ -0,0 +1,453 @@
+#define _GNU_SOURCE             /* `F_SETPIPE_SZ`, `memrchr` */
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#ifdef WITH_ZSTD
+#  include <zstd.h>
+#endif /* WITH_ZSTD */
+#ifdef WITH_LZ4
+#  include <lz4frame.h>
+#endif /* WITH_LZ4 */
+
+#include <common/error.h>
+#include <common/thread_utils.h>
+#include <common/time_utils.h>
+#include "output_file.h"
+
+
+/* -- Consts -- */
+#define OUTPUT_FILE_BLOCK_SIZE (256 * 1024)         /* Raw bytes per block (= frame) */
+#define OUTPUT_FILE_PIPE_SIZE (1024 * 1024)         /* Headroom for bursts while the writer thread compresses */
+#define OUTPUT_FILE_FLUSH_INTERVAL_NS (1000ULL * 1000 * 1000)     /* Max. age of buffered output (bounds loss when tracer gets killed) */
+
+#ifdef WITH_ZSTD
+#  define OUTPUT_FILE_ZSTD_LEVEL 3
+#endif /* WITH_ZSTD */
+
+
+/* -- Globals -- */
+static struct {
+    const char* path;
+    char* rotated_path_from;                /* `<path>.<n>` */
+    char* rotated_path_to;
+    uint64_t rotate_size;
+    uint64_t rotate_interval_ns;
+    unsigned rotate_keep;
+    output_compression_t compression;
+
+    bool active;                            /* Writer thread is running */
+    int original_stderr_fd;
+    int pipe_fd;                            /* Read end (non-blocking); write end = fd 2 */
+    int stop_fd;                            /* (eventfd) */
+    pthread_t writer_thread;
+
+    /* (Writer thread only) */
+    int fd;                                 /* Current file (`-1` = couldn't be opened) */
+    uint64_t file_bytes;
+    uint64_t file_opened_ns;
+    bool rotation_due;                      /* (Rotated prior writing the next frame  -> No empty files) */
+    char* block;
+    size_t block_len;
+    uint64_t block_since_ns;                /* When oldest buffered byte was read */
+    char* compressed;
+    size_t compressed_capacity;
+    bool write_failed;                      /* (Reported once per failure) */
+#ifdef WITH_ZSTD
+    ZSTD_CCtx* zstd_ctx;
+#endif /* WITH_ZSTD */
+#ifdef WITH_LZ4
+    LZ4F_preferences_t lz4_prefs;
+#endif /* WITH_LZ4 */
+} output_file = { .fd = -1 };
+
+
+/* -- Function prototypes -- */
+static void* writer_main(void* ctx);
+static bool drain_pipe(void);
+static void write_block(bool complete_lines_only);
+static size_t chunk_fitting_file(const char* data, size_t len);
+static void write_frame(const char* data, size_t len);
+static size_t compress_block(const char* data, size_t len, const char** compressed);
+static void rotate(void);
+static void open_file(void);
+static void warn(const char* fmt, ...);
+
+
+/* -- Functions -- */
+void output_file_init(const char* path, uint64_t rotate_size, uint64_t rotate_interval_ns, unsigned rotate_keep,
+                      output_compression_t compression) {
+    output_file.path = path;
+    output_file.rotate_size = rotate_size;
+    output_file.rotate_interval_ns = rotate_interval_ns;
+    output_file.rotate_keep = rotate_keep;
+    output_file.compression = compression;
+
+/* 0. Plain file  -> Simply replaces `stderr` */
+    if (!rotate_size && !rotate_interval_ns && OUTPUT_COMPRESSION_NONE == compression) {
+        const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (-1 == fd) {
+            LOG_ERROR_AND_DIE("Couldn't open output file \"%s\" -- %s", path, strerror(errno));
+        }
+        DIE_WHEN_ERRNO( dup2(fd, STDERR_FILENO) );
+        close(fd);
+        return;
+    }
+
+/* 1. Buffers + first file (errors of writer thread are reported via original `stderr`) */
+    output_file.original_stderr_fd = DIE_WHEN_ERRNO( fcntl(STDERR_FILENO, F_DUPFD_CLOEXEC, 0) );
+    output_file.rotated_path_from = DIE_WHEN_ERRNO_VPTR( malloc(strlen(path) + 16) );
+    output_file.rotated_path_to = DIE_WHEN_ERRNO_VPTR( malloc(strlen(path) + 16) );
+    output_file.block = DIE_WHEN_ERRNO_VPTR( malloc(OUTPUT_FILE_BLOCK_SIZE) );
+    switch (compression) {
+        case OUTPUT_COMPRESSION_ZSTD:
+#ifdef WITH_ZSTD
+            output_file.zstd_ctx = DIE_WHEN_ERRNO_VPTR( ZSTD_createCCtx() );
+            ZSTD_CCtx_setParameter(output_file.zstd_ctx, ZSTD_c_compressionLevel, OUTPUT_FILE_ZSTD_LEVEL);
+            ZSTD_CCtx_setParameter(output_file.zstd_ctx, ZSTD_c_checksumFlag, 1);
+            output_file.compressed_capacity = ZSTD_compressBound(OUTPUT_FILE_BLOCK_SIZE);
+#endif /* WITH_ZSTD */
+            break;
+        case OUTPUT_COMPRESSION_LZ4:
+#ifdef WITH_LZ4
+            memset(&output_file.lz4_prefs, 0, sizeof(output_file.lz4_prefs));
+            output_file.lz4_prefs.frameInfo.blockSizeID = LZ4F_max256KB;
+            output_file.lz4_prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+            output_file.compressed_capacity = LZ4F_compressFrameBound(OUTPUT_FILE_BLOCK_SIZE, &output_file.lz4_prefs);
+#endif /* WITH_LZ4 */
+            break;
+        case OUTPUT_COMPRESSION_NONE:
+        default:
+            break;
+    }
+    if (output_file.compressed_capacity) {
+        output_file.compressed = DIE_WHEN_ERRNO_VPTR( malloc(output_file.compressed_capacity) );
+    }
+    open_file();
+    if (-1 == output_file.fd) {
+        LOG_ERROR_AND_DIE("Couldn't open output file \"%s\" -- %s", path, strerror(errno));
+    }
+
+/* 2. Replace `stderr` w/ pipe (only the read end is non-blocking; a full pipe throttles writers) */
+    int pipe_fds[2];
+    DIE_WHEN_ERRNO( pipe2(pipe_fds, O_CLOEXEC) );
+    fcntl(pipe_fds[1], F_SETPIPE_SZ, OUTPUT_FILE_PIPE_SIZE);        /* (Best effort; may exceed `pipe-max-size`) */
+    DIE_WHEN_ERRNO( fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK) );
+    output_file.pipe_fd = pipe_fds[0];
+    output_file.stop_fd = DIE_WHEN_ERRNO( eventfd(0, EFD_CLOEXEC) );
+    DIE_WHEN_ERRNO( dup2(pipe_fds[1], STDERR_FILENO) );
+    close(pipe_fds[1]);
+
+/* 3. Writer thread */
+    const int error = thread_create_w_signals_blocked(&output_file.writer_thread, writer_main, NULL);
+    if (error) {
+        dup2(output_file.original_stderr_fd, STDERR_FILENO);
+        LOG_ERROR_AND_DIE("Couldn't create output writer thread -- %s", strerror(error));
+    }
+    output_file.active = true;
+
+    atexit(output_file_fin);        /* Also output written right before exiting (e.g., by `LOG_ERROR_AND_DIE`) is written */
+}
+
+/*
+ * Restores `stderr` + waits until writer thread has written all output (idempotent)
+ */
+void output_file_fin(void) {
+    if (!output_file.active) {
+        return;
+    }
+    output_file.active = false;
+
+    fflush(stderr);
+    dup2(output_file.original_stderr_fd, STDERR_FILENO);
+    const uint64_t stop = 1;
+    if ((ssize_t)sizeof(stop) != write(output_file.stop_fd, &stop, sizeof(stop))) {
+        LOG_WARN("Couldn't stop output writer thread -- %s", strerror(errno));
+        return;
+    }
+    pthread_join(output_file.writer_thread, NULL);
+
+    close(output_file.stop_fd);
+    close(output_file.pipe_fd);
+    close(output_file.original_stderr_fd);
+    free(output_file.rotated_path_from);
+    free(output_file.rotated_path_to);
+    free(output_file.block);
+    free(output_file.compressed);
+#ifdef WITH_ZSTD
+    ZSTD_freeCCtx(output_file.zstd_ctx);
+#endif /* WITH_ZSTD */
+}
+
+
+/* - Writer thread - */
+static void* writer_main(__attribute__((unused)) void* ctx) {
+    for (bool stop = false; !stop; ) {
+/* 1. Wait for output, the next flush / rotation or `output_file_fin` */
+        uint64_t now_ns = time_now_ns();
+        uint64_t wait_ns = UINT64_MAX;
+        if (output_file.block_len) {
+            const uint64_t since_ns = now_ns - output_file.block_since_ns;
+            wait_ns = (since_ns < OUTPUT_FILE_FLUSH_INTERVAL_NS) ? (OUTPUT_FILE_FLUSH_INTERVAL_NS - since_ns) : (0);
+        }
+        if (output_file.rotate_interval_ns && !output_file.rotation_due) {
+            const uint64_t since_ns = now_ns - output_file.file_opened_ns;
+            const uint64_t rotate_wait_ns = (since_ns < output_file.rotate_interval_ns) ? (output_file.rotate_interval_ns - since_ns) : (0);
+            wait_ns = (rotate_wait_ns < wait_ns) ? (rotate_wait_ns) : (wait_ns);
+        }
+        struct pollfd fds[] = {
+            { .fd = output_file.pipe_fd, .events = POLLIN, .revents = 0 },
+            { .fd = output_file.stop_fd, .events = POLLIN, .revents = 0 }
+        };
+        const uint64_t wait_ms = (wait_ns / 1000000) + ((wait_ns % 1000000) ? (1) : (0));
+        const int timeout_ms = (UINT64_MAX == wait_ns) ? (-1) :
+                               ((wait_ms > INT_MAX) ? (INT_MAX) : ((int)wait_ms));      /* (Clamped, as long intervals overflow `int`) */
+        if (-1 == poll(fds, sizeof(fds) / sizeof(*fds), timeout_ms) && EINTR != errno) {
+            warn("Couldn't wait for output -- %s", strerror(errno));
+            break;
+        }
+
+/* 2. Read output (all of it when stopping; the write end has been closed / restored already) */
+        stop = fds[1].revents;
+        if ((fds[0].revents || stop) && !drain_pipe()) {
+            stop = true;                /* (EOF) */
+        }
+
+/* 3. Flush old output / rotate */
+        now_ns = time_now_ns();
+        if (output_file.block_len && now_ns - output_file.block_since_ns >= OUTPUT_FILE_FLUSH_INTERVAL_NS) {
+            write_block(false);
+        }
+        if (output_file.rotate_interval_ns && !output_file.rotation_due &&
+            now_ns - output_file.file_opened_ns >= output_file.rotate_interval_ns) {
+            write_block(true);
+            output_file.rotation_due = true;
+        }
+    }
+
+    write_block(false);
+    if (-1 != output_file.fd) {
+        close(output_file.fd);
+    }
+    return NULL;
+}
+
+/*
+ * Reads all available output into the block (writing each full block)  -> Returns `false` on EOF
+ */
+static bool drain_pipe(void) {
+    for (;;) {
+        if (OUTPUT_FILE_BLOCK_SIZE == output_file.block_len) {
+            write_block(true);
+        }
+
+        const ssize_t read_bytes = read(output_file.pipe_fd, output_file.block + output_file.block_len,
+                                        OUTPUT_FILE_BLOCK_SIZE - output_file.block_len);
+        if (-1 == read_bytes) {
+            if (EINTR == errno) { continue; }
+            if (EAGAIN != errno) {
+                warn("Couldn't read output -- %s", strerror(errno));
+            }
+            return (EAGAIN == errno);
+        }
+        if (!read_bytes) {
+            return false;
+        }
+        if (!output_file.block_len) {
+            output_file.block_since_ns = time_now_ns();
+        }
+        output_file.block_len += (size_t)read_bytes;
+    }
+}
+
+/*
+ * Writes block (w/ `complete_lines_only`: only up to its last line end; the rest is kept for the next one)
+ *   Each chunk which fits into the current file (w/ `--rotate-size`) becomes one frame; rotation (if due) happens
+ *   right before writing the next chunk
+ */
+static void write_block(bool complete_lines_only) {
+    if (!output_file.block_len) {
+        return;
+    }
+
+/* 1. Cut at line end */
+    size_t len = output_file.block_len;
+    if (complete_lines_only) {
+        const char* const last_line_end = memrchr(output_file.block, '\n', output_file.block_len);
+        if (last_line_end) {
+            len = (size_t)(last_line_end - output_file.block) + 1;
+        }
+    }
+
+/* 2. Write in chunks */
+    for (size_t written_len = 0; written_len < len; ) {
+        if (output_file.rotation_due && output_file.file_bytes) {
+            rotate();
+        }
+        if (-1 == output_file.fd) {
+            open_file();            /* (Retry) */
+        }
+        const size_t chunk_len = chunk_fitting_file(output_file.block + written_len, len - written_len);
+        write_frame(output_file.block + written_len, chunk_len);
+        written_len += chunk_len;
+    }
+
+/* 3. Keep rest */
+    output_file.block_len -= len;
+    memmove(output_file.block, output_file.block + len, output_file.block_len);
+    if (output_file.block_len) {
+        output_file.block_since_ns = time_now_ns();
+    }
+}
+
+/*
+ * Length of leading part of `data` which fits into the current file (cut at its last line end)
+ *   `0` = file is full (-> Rotation is due); lines longer than `--rotate-size` are cut
+ *   NOTE: Based on raw size, as compressed frames are never larger (except for incompressible data; see `write_frame`)
+ */
+static size_t chunk_fitting_file(const char* data, size_t len) {
+    if (!output_file.rotate_size) {
+        return len;
+    }
+    const uint64_t space = (output_file.file_bytes < output_file.rotate_size) ?
+                               (output_file.rotate_size - output_file.file_bytes) : (0);
+    if (len <= space) {
+        return len;
+    }
+
+    const char* const last_line_end = (space) ? (memrchr(data, '\n', (size_t)space)) : (NULL);
+    if (last_line_end) {
+        return (size_t)(last_line_end - data) + 1;
+    }
+    if (output_file.file_bytes) {
+        output_file.rotation_due = true;
+        return 0;
+    }
+    return (size_t)space;
+}
+
+/*
+ * Compresses + writes chunk as one frame (output is dropped, if file can't be written)
+ */
+static void write_frame(const char* data, size_t len) {
+    if (!len) {
+        return;
+    }
+
+    const char* frame;
+    const size_t frame_len = compress_block(data, len, &frame);
+    if (output_file.rotate_size && output_file.file_bytes &&
+        output_file.file_bytes + frame_len > output_file.rotate_size) {     /* (Incompressible data  -> Frame is larger) */
+        rotate();
+    }
+    size_t written = 0;
+    while (-1 != output_file.fd && written < frame_len) {
+        const ssize_t rc = write(output_file.fd, frame + written, frame_len - written);
+        if (-1 == rc) {
+            if (EINTR == errno) { continue; }
+            break;
+        }
+        written += (size_t)rc;
+    }
+    if (written < frame_len && !output_file.write_failed) {
+        warn("Couldn't write output file \"%s\" -- %s (dropping output)", output_file.path, strerror(errno));
+    }
+    output_file.write_failed = (written < frame_len);
+    output_file.file_bytes += written;
+    output_file.rotation_due |= (output_file.rotate_size && output_file.file_bytes >= output_file.rotate_size);
+}
+
+/*
+ * Compresses data into a single, self-contained frame (w/ content size + checksum)  -> Returns its length
+ */
+static size_t compress_block(const char* data, size_t len, const char** compressed) {
+    switch (output_file.compression) {
+        case OUTPUT_COMPRESSION_ZSTD:
+#ifdef WITH_ZSTD
+        {
+            const size_t compressed_len = ZSTD_compress2(output_file.zstd_ctx, output_file.compressed,
+                                                         output_file.compressed_capacity, data, len);
+            if (!ZSTD_isError(compressed_len)) {
+                *compressed = output_file.compressed;
+                return compressed_len;
+            }
+            warn("Couldn't compress output -- %s", ZSTD_getErrorName(compressed_len));
+        }
+#endif /* WITH_ZSTD */
+            break;
+        case OUTPUT_COMPRESSION_LZ4:
+#ifdef WITH_LZ4
+        {
+            LZ4F_preferences_t prefs = output_file.lz4_prefs;
+            prefs.frameInfo.contentSize = len;
+            const size_t compressed_len = LZ4F_compressFrame(output_file.compressed, output_file.compressed_capacity,
+                                                             data, len, &prefs);
+            if (!LZ4F_isError(compressed_len)) {
+                *compressed = output_file.compressed;
+                return compressed_len;
+            }
+            warn("Couldn't compress output -- %s", LZ4F_getErrorName(compressed_len));
+        }
+#endif /* WITH_LZ4 */
+            break;
+        case OUTPUT_COMPRESSION_NONE:
+        default:
+            *compressed = data;
+            return len;
+    }
+
+    *compressed = NULL;         /* (Block is dropped, as writing it uncompressed would break decoding of the file) */
+    return 0;
+}
+
+/*
+ * `<path>` -> `<path>.1` -> ... -> `<path>.<keep - 1>` (oldest one is overwritten), then starts new `<path>`
+ */
+static void rotate(void) {
+    if (-1 != output_file.fd) {
+        close(output_file.fd);
+        output_file.fd = -1;
+    }
+
+    for (unsigned i = output_file.rotate_keep - 1; i > 0; i--) {
+        if (1 == i) {
+            strcpy(output_file.rotated_path_from, output_file.path);
+        } else {
+            sprintf(output_file.rotated_path_from, "%s.%u", output_file.path, i - 1);
+        }
+        sprintf(output_file.rotated_path_to, "%s.%u", output_file.path, i);
+        if (-1 == rename(output_file.rotated_path_from, output_file.rotated_path_to) && ENOENT != errno) {
+            warn("Couldn't rotate output file \"%s\" -- %s", output_file.rotated_path_from, strerror(errno));
+        }
+    }
+
+    open_file();
+}
+
+static void open_file(void) {
+    output_file.fd = open(output_file.path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    output_file.file_bytes = 0;
+    output_file.file_opened_ns = time_now_ns();
+    output_file.rotation_due = false;
+}
+
+
+/* - Helpers - */
+/* Writer thread can't use `stderr` (would write into the pipe it drains) */
+static void warn(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    dprintf(output_file.original_stderr_fd, "[WARN] output writer: ");
+    vdprintf(output_file.original_stderr_fd, fmt, args);
+    dprintf(output_file.original_stderr_fd, ".\n");
+    va_end(args);
+}
@@ -0,0 +1,31 @@
+/**
+ * Output file (`-o`) w/ optional rotation (`--rotate-size` / `--rotate-interval`, bounded by `--rotate-keep`) and
+ * block compression (`--compress`)
+ *   - W/o rotation + compression: The file simply replaces `stderr` (fd 2)
+ *   - Otherwise: fd 2 is replaced by a pipe, which is drained by a writer thread  -> The trace loop (+ everything else
+ *     writing to `stderr`, e.g., `--stats`' timing of the output) is unaffected, as compressing + writing files
+ *     happens solely in the writer thread
+ *   - The writer thread collects the output in blocks, which end at a line end (if any), and writes each one as
+ *     a complete zstd / lz4 frame  -> Blocks are independently decodable (frames may be concatenated), i.e., files
+ *     can be read w/ `zstd -dc` / `lz4 -dc`, also when truncated (e.g., when the tracer got killed)
+ *   - Buffered output is written at least every second (bounds the loss when the tracer gets killed)
+ *   - W/ `--rotate-size`, blocks are cut (at the last line end) to fit the remaining space of the current file, i.e.,
+ *     files don't exceed it (except for single lines longer than it, which are cut)
+ *   - Rotation happens right before writing the next frame (i.e., there are no empty files): The current file is
+ *     renamed to `<file>.1` (`<file>.1` to `<file>.2`, ...; the oldest one is dropped) + a new one is started
+ */
+#ifndef OUTPUT_FILE_H
+#define OUTPUT_FILE_H
+
+#include <stdint.h>
+
+#include "../tracing.h"
+
+
+/* -- Function prototypes -- */
+void output_file_init(const char* path, uint64_t rotate_size, uint64_t rotate_interval_ns, unsigned rotate_keep,
+                      output_compression_t compression);
+void output_file_fin(void);
+
+
+#endif /* OUTPUT_FILE_H */
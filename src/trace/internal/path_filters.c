@@ -0,0 +1,173 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include <trace/syscallents.h>
+#include "ptrace_utils.h"
+#include "path_filters.h"
+
+
+/* -- Globals -- */
+static struct {
+    char** path_prefixes;               /* Normalized (i.e., w/o trailing '/') */
+    size_t* path_prefixes_lens;
+    int path_prefixes_count;
+
+    const int* fds;
+    int fds_count;
+
+    /* Precomputed (based on arg types) bitmasks of fd- / path args per syscall */
+    uint8_t fd_args_mask[SYSCALLS_ARR_SIZE];
+    uint8_t path_args_mask[SYSCALLS_ARR_SIZE];
+} filters;
+
+
+/* -- Function prototypes -- */
+static bool fd_matches(tracee_t* tracee, int fd);
+static bool path_arg_matches(tracee_t* tracee, long path_addr, int dir_fd);
+static bool path_has_prefix(const char* path);
+
+
+/* -- Functions -- */
+void path_filters_init(const char* const* path_prefixes, int path_prefixes_count,
+                       const int* fds, int fds_count) {
+/* 1. Normalize path prefixes */
+    filters.path_prefixes_count = path_prefixes_count;
+    filters.path_prefixes = DIE_WHEN_ERRNO_VPTR( calloc(path_prefixes_count + 1, sizeof(*(filters.path_prefixes))) );
+    filters.path_prefixes_lens = DIE_WHEN_ERRNO_VPTR( calloc(path_prefixes_count + 1, sizeof(*(filters.path_prefixes_lens))) );
+    for (int i = 0; i < path_prefixes_count; i++) {
+        char* const prefix = DIE_WHEN_ERRNO_VPTR( strdup(path_prefixes[i]) );
+        size_t prefix_len = strlen(prefix);
+        while (prefix_len > 1 && '/' == prefix[prefix_len - 1]) {
+            prefix[--prefix_len] = '\0';
+        }
+        filters.path_prefixes[i] = prefix;
+        filters.path_prefixes_lens[i] = prefix_len;
+    }
+
+    filters.fds = fds;
+    filters.fds_count = fds_count;
+
+/* 2. Precompute which args of which syscall are fds / paths */
+    for (int nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        filters.fd_args_mask[nr] = filters.path_args_mask[nr] = 0;
+        if (!syscalls[nr].name) {
+            continue;
+        }
+        for (int arg_nr = 0; arg_nr < syscalls[nr].nargs; arg_nr++) {
+            if (ARG_FD == syscalls[nr].args[arg_nr]) {
+                filters.fd_args_mask[nr] |= (1 << arg_nr);
+            } else if (ARG_PATH == syscalls[nr].args[arg_nr]) {
+                filters.path_args_mask[nr] |= (1 << arg_nr);
+            }
+        }
+    }
+}
+
+void path_filters_fin(void) {
+    for (int i = 0; i < filters.path_prefixes_count; i++) {
+        free(filters.path_prefixes[i]);
+    }
+    free(filters.path_prefixes);
+    free(filters.path_prefixes_lens);
+    filters.path_prefixes = NULL;
+    filters.path_prefixes_lens = NULL;
+    filters.path_prefixes_count = 0;
+}
+
+
+bool path_filters_match(tracee_t* tracee, long syscall_nr, const long args[SYSCALL_MAX_ARGS]) {
+    if (syscall_nr < 0 || syscall_nr > MAX_SYSCALL_NUM) {
+        return false;
+    }
+
+/* 1. fd args  (cheap -- resolved via cached fd table) */
+    for (uint8_t mask = filters.fd_args_mask[syscall_nr]; mask; mask &= (uint8_t)(mask - 1)) {
+        if (fd_matches(tracee, (int)args[__builtin_ctz(mask)])) {
+            return true;
+        }
+    }
+
+/* 2. Path args  (requires reading tracee memory) */
+    if (filters.path_prefixes_count) {
+        for (uint8_t mask = filters.path_args_mask[syscall_nr]; mask; mask &= (uint8_t)(mask - 1)) {
+            const int arg_nr = __builtin_ctz(mask);
+            const int dir_fd = (arg_nr > 0 && (filters.fd_args_mask[syscall_nr] & (1 << (arg_nr - 1)))) ?     /* `*at` syscalls: dir fd precedes path */
+                                   ((int)args[arg_nr - 1]) : (AT_FDCWD);
+            if (path_arg_matches(tracee, args[arg_nr], dir_fd)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/* - Helpers - */
+static bool fd_matches(tracee_t* tracee, int fd) {
+    for (int i = 0; i < filters.fds_count; i++) {
+        if (fd == filters.fds[i]) {
+            return true;
+        }
+    }
+
+    if (fd < 0 || !filters.path_prefixes_count) {
+        return false;
+    }
+    const char* const path = fds_get_path(tracees_get_fds(tracee), tracee->tid, fd);
+    return path && path_has_prefix(path);
+}
+
+static bool path_arg_matches(tracee_t* tracee, long path_addr, int dir_fd) {
+    char path[PATH_MAX];
+    if (-1 == ptrace_read_path(tracee->tid, (unsigned long)path_addr, path)) {
+        return false;
+    }
+
+    bool matches;
+    if ('/' == path[0]) {
+        matches = path_has_prefix(path);
+
+/* Relative path  -> Resolve relative to dir fd (or cwd)   (NOTE: Doesn't normalize `..` components) */
+    } else {
+        char base_path[PATH_MAX];
+        const char* base_path_ptr = NULL;
+        if (AT_FDCWD != dir_fd) {
+            base_path_ptr = fds_get_path(tracees_get_fds(tracee), tracee->tid, dir_fd);
+        } else {
+            char cwd_link_path[64];
+            snprintf(cwd_link_path, sizeof(cwd_link_path), "/proc/%d/cwd", tracee->tid);
+            const ssize_t base_path_len = readlink(cwd_link_path, base_path, sizeof(base_path) - 1);
+            if (-1 != base_path_len) {
+                base_path[base_path_len] = '\0';
+                base_path_ptr = base_path;
+            }
+        }
+
+        matches = false;
+        if (base_path_ptr) {
+            char resolved_path[2 * PATH_MAX];
+            snprintf(resolved_path, sizeof(resolved_path), "%s/%s", base_path_ptr, path);
+            matches = path_has_prefix(resolved_path);
+        }
+    }
+
+    return matches;
+}
+
+static bool path_has_prefix(const char* path) {
+    for (int i = 0; i < filters.path_prefixes_count; i++) {
+        const char* const prefix = filters.path_prefixes[i];
+        const size_t prefix_len = filters.path_prefixes_lens[i];
+        if (!strncmp(path, prefix, prefix_len) &&
+            ('\0' == path[prefix_len] || '/' == path[prefix_len] || '/' == prefix[prefix_len - 1])) {     /* Match only whole path components */
+            return true;
+        }
+    }
+    return false;
+}
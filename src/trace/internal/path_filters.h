@@ -0,0 +1,25 @@
+/**
+ * Path- & fd-based syscall filters (`-P <path-prefix>`, `--fd <n>`)
+ *   Evaluated on syscall-enter using the raw syscall args:
+ *     - fd args are resolved via the (cached) fd table of the tracee  -> No reads of tracee memory
+ *     - Path args (only present for path- / `*at` syscalls) are read from tracee memory
+ *   Syscalls w/o fd- or path args never match
+ */
+#ifndef PATH_FILTERS_H
+#define PATH_FILTERS_H
+
+#include <stdbool.h>
+
+#include <trace/syscall_types.h>
+#include "tracees.h"
+
+
+/* -- Function prototypes -- */
+void path_filters_init(const char* const* path_prefixes, int path_prefixes_count,
+                       const int* fds, int fds_count);
+void path_filters_fin(void);
+
+bool path_filters_match(tracee_t* tracee, long syscall_nr, const long args[SYSCALL_MAX_ARGS]);
+
+
+#endif /* PATH_FILTERS_H */
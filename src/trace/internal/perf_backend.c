@@ -0,0 +1,317 @@
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <poll.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+
+#include <common/cpu_utils.h>
+#include <common/error.h>
+#include <common/time_utils.h>
+#include "stats.h"
+#include "perf_backend.h"
+
+
+/* -- Consts -- */
+static const char* const TRACEFS_DIRS[] = { "/sys/kernel/tracing", "/sys/kernel/debug/tracing" };
+#define TRACEFS_DIRS_COUNT (sizeof(TRACEFS_DIRS) / sizeof(*TRACEFS_DIRS))
+
+
+/* -- Types -- */
+/* Layout of `PERF_RAW` data of `raw_syscalls` tracepoints (see `events/raw_syscalls/sys_{enter,exit}/format` in tracefs) */
+typedef struct {
+    uint16_t common_type;               /* Tracepoint id */
+    uint8_t common_flags;
+    uint8_t common_preempt_count;
+    int32_t common_pid;
+    int64_t id;                         /* Syscall nr */
+    union {
+        uint64_t args[6];               /* sys_enter */
+        int64_t ret;                    /* sys_exit */
+    } data;
+} raw_syscalls_record_t;
+
+typedef struct {
+    int enter_fd, exit_fd;              /* (`exit_fd` outputs to ring of `enter_fd`) */
+    struct perf_event_mmap_page* ring;
+} cpu_ring_t;
+
+
+/* -- Globals -- */
+static struct {
+    cpu_ring_t* rings;
+    int rings_count;
+    size_t ring_data_size;
+    long sys_enter_id, sys_exit_id;
+
+    /* Events read from rings, but not delivered yet (sorted by time on delivery) */
+    perf_backend_event_t* pending;
+    size_t pending_count, pending_capacity;
+    size_t delivered_count;             /* Delivered by last `perf_backend_read`  -> Removed on next call */
+    uint64_t next_seq;
+
+    uint64_t lost_events;
+} backend;
+
+
+/* -- Function prototypes -- */
+static long read_tracepoint_id(const char* event_name);
+static int open_tracepoint(long tracepoint_id, pid_t pid, int cpu, bool follow_fork);
+static void drain_ring(cpu_ring_t* cpu_ring);
+static void handle_sample(const unsigned char* sample, size_t sample_size);
+static int compare_events(const void* a, const void* b);
+
+
+/* -- Functions -- */
+int perf_backend_open(pid_t pid, bool follow_fork, char* error, size_t error_size) {
+    memset(&backend, 0, sizeof(backend));
+
+/* 0. Tracepoint ids (from tracefs) */
+    if (-1 == (backend.sys_enter_id = read_tracepoint_id("sys_enter")) ||
+        -1 == (backend.sys_exit_id = read_tracepoint_id("sys_exit"))) {
+        snprintf(error, error_size, "raw_syscalls tracepoints not found (tracefs not mounted?)");
+        return -1;
+    }
+
+/* 1. Open both tracepoints on each online CPU (+ map ring) */
+    bool online_cpus[CPU_UTILS_MAX_CPUS];
+    if (-1 == cpu_online_cpus(online_cpus)) {
+        snprintf(error, error_size, "couldn't determine online CPUs");
+        return -1;
+    }
+    backend.rings = DIE_WHEN_ERRNO_VPTR( calloc(CPU_UTILS_MAX_CPUS, sizeof(*backend.rings)) );
+    backend.ring_data_size = (size_t)PERF_BACKEND_RING_PAGES * (size_t)sysconf(_SC_PAGESIZE);
+
+    for (int cpu = 0; cpu < CPU_UTILS_MAX_CPUS; cpu++) {
+        if (!online_cpus[cpu]) { continue; }
+
+        cpu_ring_t* const cpu_ring = &backend.rings[backend.rings_count++];
+        cpu_ring->enter_fd = cpu_ring->exit_fd = -1;
+        if (-1 == (cpu_ring->enter_fd = open_tracepoint(backend.sys_enter_id, pid, cpu, follow_fork)) ||
+            -1 == (cpu_ring->exit_fd = open_tracepoint(backend.sys_exit_id, pid, cpu, follow_fork))) {
+            snprintf(error, error_size, "`perf_event_open` failed -- %s", strerror(errno));
+            goto fail;
+        }
+
+        void* const ring = mmap(NULL, (size_t)sysconf(_SC_PAGESIZE) + backend.ring_data_size,
+                                PROT_READ | PROT_WRITE, MAP_SHARED, cpu_ring->enter_fd, 0);
+        if (MAP_FAILED == ring) {
+            snprintf(error, error_size, "couldn't map ring buffer -- %s", strerror(errno));
+            goto fail;
+        }
+        cpu_ring->ring = ring;
+        if (-1 == ioctl(cpu_ring->exit_fd, PERF_EVENT_IOC_SET_OUTPUT, cpu_ring->enter_fd)) {
+            snprintf(error, error_size, "couldn't share ring buffer -- %s", strerror(errno));
+            goto fail;
+        }
+    }
+
+/* 2. Enable (all at once) */
+    for (int i = 0; i < backend.rings_count; i++) {
+        ioctl(backend.rings[i].enter_fd, PERF_EVENT_IOC_ENABLE, 0);
+        ioctl(backend.rings[i].exit_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    return 0;
+
+fail:
+    perf_backend_close();
+    return -1;
+}
+
+void perf_backend_close(void) {
+    for (int i = 0; i < backend.rings_count; i++) {
+        cpu_ring_t* const cpu_ring = &backend.rings[i];
+        if (cpu_ring->ring) {
+            munmap(cpu_ring->ring, (size_t)sysconf(_SC_PAGESIZE) + backend.ring_data_size);
+        }
+        if (cpu_ring->exit_fd >= 0) { close(cpu_ring->exit_fd); }
+        if (cpu_ring->enter_fd >= 0) { close(cpu_ring->enter_fd); }
+    }
+    free(backend.rings);
+    free(backend.pending);
+    memset(&backend, 0, sizeof(backend));
+}
+
+
+/*
+ * Waits (up to `timeout_ms`) for events + returns those which are complete, sorted by time
+ *   (Events newer than the time at which the rings were drained are held back, since another CPU's ring may still
+ *    receive older ones; `flush` = deliver all, e.g., after the tracee exited)
+ *   Returned events remain valid until the next call
+ */
+size_t perf_backend_read(perf_backend_event_t** events, int timeout_ms, bool flush) {
+/* 0. Remove events delivered by last call */
+    if (backend.delivered_count) {
+        backend.pending_count -= backend.delivered_count;
+        memmove(backend.pending, backend.pending + backend.delivered_count, backend.pending_count * sizeof(*backend.pending));
+        backend.delivered_count = 0;
+    }
+
+/* 1. Wait for data (in any ring) */
+    if (!flush) {
+        struct pollfd poll_fds[backend.rings_count];
+        for (int i = 0; i < backend.rings_count; i++) {
+            poll_fds[i].fd = backend.rings[i].enter_fd;
+            poll_fds[i].events = POLLIN;
+        }
+        STATS_TIMER_BEGIN(STATS_TIMER_WAITPID);
+        poll(poll_fds, (nfds_t)backend.rings_count, timeout_ms);
+        STATS_TIMER_END(STATS_TIMER_WAITPID);
+    }
+
+/* 2. Drain rings + order events */
+    const uint64_t drained_ns = time_now_ns();
+    for (int i = 0; i < backend.rings_count; i++) {
+        drain_ring(&backend.rings[i]);
+    }
+    qsort(backend.pending, backend.pending_count, sizeof(*backend.pending), compare_events);
+
+    size_t complete_count = backend.pending_count;
+    if (!flush) {
+        while (complete_count && backend.pending[complete_count - 1].time_ns > drained_ns) {
+            complete_count--;
+        }
+    }
+    backend.delivered_count = complete_count;
+    *events = backend.pending;
+    return complete_count;
+}
+
+uint64_t perf_backend_lost_events(void) {
+    return backend.lost_events;
+}
+
+
+/* - Helpers - */
+static long read_tracepoint_id(const char* event_name) {
+    for (size_t i = 0; i < TRACEFS_DIRS_COUNT; i++) {
+        char id_path[128];
+        snprintf(id_path, sizeof(id_path), "%s/events/raw_syscalls/%s/id", TRACEFS_DIRS[i], event_name);
+        FILE* id_file;
+        if (! (id_file = fopen(id_path, "r")) ) { continue; }
+
+        long id = -1;
+        if (1 != fscanf(id_file, "%ld", &id)) { id = -1; }
+        fclose(id_file);
+        if (-1 != id) { return id; }
+    }
+    return -1;
+}
+
+static int open_tracepoint(long tracepoint_id, pid_t pid, int cpu, bool follow_fork) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_TRACEPOINT;
+    attr.config = (uint64_t)tracepoint_id;
+    attr.sample_period = 1;
+    attr.sample_type = PERF_SAMPLE_TID | PERF_SAMPLE_TIME | PERF_SAMPLE_RAW;
+    attr.disabled = 1;
+    attr.inherit = follow_fork;         /* (Also children created after opening) */
+    attr.use_clockid = 1;
+    attr.clockid = CLOCK_MONOTONIC;     /* (Same as timestamps of ptrace backend) */
+    attr.watermark = 1;
+    attr.wakeup_watermark = (uint32_t)(backend.ring_data_size / 4);
+
+    return (int)syscall(SYS_perf_event_open, &attr, pid, cpu, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+static void drain_ring(cpu_ring_t* cpu_ring) {
+    struct perf_event_mmap_page* const ring = cpu_ring->ring;
+    const unsigned char* const data = (const unsigned char*)ring + ring->data_offset;
+    const size_t data_size = (ring->data_size) ? ((size_t)ring->data_size) : (backend.ring_data_size);
+
+    const uint64_t head = __atomic_load_n(&ring->data_head, __ATOMIC_ACQUIRE);
+    uint64_t tail = ring->data_tail;
+
+    while (tail < head) {
+        /* Copy record (may wrap around end of ring) */
+        unsigned char record[sizeof(struct perf_event_header) + 512];
+        struct perf_event_header header;
+        for (size_t i = 0; i < sizeof(header); i++) {
+            ((unsigned char*)&header)[i] = data[(tail + i) % data_size];
+        }
+        if (header.size < sizeof(header)) { break; }       /* (Corrupt  -> Skip rest) */
+        const size_t record_size = (header.size < sizeof(record)) ? (header.size) : (sizeof(record));
+        for (size_t i = 0; i < record_size; i++) {
+            record[i] = data[(tail + i) % data_size];
+        }
+        tail += header.size;
+
+        switch (header.type) {
+            case PERF_RECORD_SAMPLE:
+                handle_sample(record + sizeof(header), record_size - sizeof(header));
+                break;
+            case PERF_RECORD_LOST:
+            {
+                struct { uint64_t id, lost; } lost;
+                if (record_size >= sizeof(header) + sizeof(lost)) {
+                    memcpy(&lost, record + sizeof(header), sizeof(lost));
+                    backend.lost_events += lost.lost;
+                    STATS_COUNT(STATS_COUNTER_DROPPED_EVENTS, lost.lost);
+                }
+            }
+                break;
+            default:
+                break;
+        }
+    }
+
+    __atomic_store_n(&ring->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+/*
+ * Sample layout (according to `PERF_SAMPLE_TID | PERF_SAMPLE_TIME | PERF_SAMPLE_RAW`):
+ *   `u32 pid, tid;  u64 time;  u32 raw_size;  char raw[raw_size]`
+ */
+static void handle_sample(const unsigned char* sample, size_t sample_size) {
+    struct { uint32_t pid, tid; uint64_t time; uint32_t raw_size; } __attribute__((packed)) sample_header;
+    raw_syscalls_record_t raw;
+    memset(&raw, 0, sizeof(raw));
+    if (sample_size < sizeof(sample_header)) {
+        return;
+    }
+    memcpy(&sample_header, sample, sizeof(sample_header));
+    const size_t raw_size = (sample_header.raw_size < sizeof(raw)) ? (sample_header.raw_size) : (sizeof(raw));
+    if (raw_size > sample_size - sizeof(sample_header) || raw_size < offsetof(raw_syscalls_record_t, data)) {
+        return;
+    }
+    memcpy(&raw, sample + sizeof(sample_header), raw_size);
+
+    if (backend.pending_count == backend.pending_capacity) {
+        backend.pending_capacity = (backend.pending_capacity) ? (backend.pending_capacity * 2) : (1024);
+        backend.pending = DIE_WHEN_ERRNO_VPTR( realloc(backend.pending, backend.pending_capacity * sizeof(*backend.pending)) );
+    }
+    perf_backend_event_t* const event = &backend.pending[backend.pending_count++];
+    memset(event, 0, sizeof(*event));
+    event->time_ns = sample_header.time;
+    event->seq = backend.next_seq++;
+    event->event.tid = (pid_t)sample_header.tid;
+    event->event.nr = (long)raw.id;
+
+    if (backend.sys_enter_id == raw.common_type) {
+        event->type = PERF_BACKEND_SYS_ENTER;
+        for (int i = 0; i < SYSCALL_MAX_ARGS; i++) {
+            event->event.args[i] = (long)raw.data.args[i];
+        }
+        event->event.enter_ns = sample_header.time;
+    } else {
+        event->type = PERF_BACKEND_SYS_EXIT;
+        event->event.rtn_val = (long)raw.data.ret;
+        event->event.exit_ns = sample_header.time;
+    }
+}
+
+static int compare_events(const void* a, const void* b) {
+    const perf_backend_event_t* const lhs = a;
+    const perf_backend_event_t* const rhs = b;
+    if (lhs->time_ns != rhs->time_ns) {
+        return (lhs->time_ns > rhs->time_ns) - (lhs->time_ns < rhs->time_ns);
+    }
+    return (lhs->seq > rhs->seq) - (lhs->seq < rhs->seq);
+}
@@ -0,0 +1,47 @@
+/**
+ * Stop-free tracing backend (`--backend=perf`): Consumes the `raw_syscalls:sys_enter` / `sys_exit` tracepoints via
+ * `perf_event_open`(2), i.e., the tracee never stops (no context switches to the tracer per syscall)
+ *   - One ring buffer per CPU (shared by both tracepoints), filtered to the tracee (+ its children when following forks)
+ *   - Events are merged across CPUs and delivered in timestamp order (`CLOCK_MONOTONIC`)
+ *   - Only raw syscall data is available (nr, args, return value, timestamps), i.e., args aren't read from tracee memory
+ *   - Requires tracefs (for the tracepoint ids) + permission to use `perf_event_open` (see `perf_event_paranoid`)
+ *     -> Not available: `perf_backend_open` fails (caller falls back to ptrace)
+ */
+#ifndef PERF_BACKEND_H
+#define PERF_BACKEND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "syscall_event.h"
+
+
+/* -- Consts -- */
+#define PERF_BACKEND_RING_PAGES 256         /* Per CPU (must be power of 2) */
+
+
+/* -- Types -- */
+typedef enum {
+    PERF_BACKEND_SYS_ENTER,
+    PERF_BACKEND_SYS_EXIT
+} perf_backend_event_type_t;
+
+typedef struct {
+    perf_backend_event_type_t type;
+    uint64_t time_ns;
+    uint64_t seq;                       /* Order of arrival (tie-breaker for equal timestamps) */
+    syscall_event_t event;              /* Enter: `nr` + `args`; Exit: `nr` + `rtn_val` */
+} perf_backend_event_t;
+
+
+/* -- Function prototypes -- */
+int perf_backend_open(pid_t pid, bool follow_fork, char* error, size_t error_size);
+void perf_backend_close(void);
+
+size_t perf_backend_read(perf_backend_event_t** events, int timeout_ms, bool flush);
+uint64_t perf_backend_lost_events(void);
+
+
+#endif /* PERF_BACKEND_H */
@@ -0,0 +1,153 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/cpu_utils.h>
+#include <common/error.h>
+#include <common/time_utils.h>
+#include "stats.h"
+#include "placement.h"
+
+
+/* -- Globals -- */
+static struct {
+    cpu_set_t allowed_cpus;
+
+    uint64_t next_sample_ns;
+    uint64_t window_end_ns;             /* `0` = first sample (binds immediately) */
+    unsigned votes[CPU_UTILS_MAX_CPUS];         /* Per LLC (indexed by its lowest CPU) */
+    int llc_of_cpu[CPU_UTILS_MAX_CPUS];         /* Lowest CPU of LLC (`-1` = not looked up yet) */
+    int bound_llc;                              /* `-1` = not bound yet */
+} placement;
+
+
+/* -- Function prototypes -- */
+static int llc_of_cpu(int cpu);
+static void bind_to_llc(int llc);
+
+
+/* -- Functions -- */
+/*
+ * Whether the tracer may run on any of `cpus` (i.e., whether they're online + part of its current affinity)
+ */
+bool placement_cpus_usable(const bool* cpus) {
+    cpu_set_t current_cpus;
+    DIE_WHEN_ERRNO( sched_getaffinity(0, sizeof(current_cpus), &current_cpus) );
+    for (int cpu = 0; cpu < CPU_UTILS_MAX_CPUS; cpu++) {
+        if (cpus[cpu] && CPU_ISSET(cpu, &current_cpus)) { return true; }
+    }
+    return false;
+}
+
+void placement_init(tracer_placement_t tracer_placement, const bool* allowed_cpus) {
+    switch (tracer_placement) {
+        case TRACER_PLACEMENT_PINNED:
+        {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (int cpu = 0; cpu < CPU_UTILS_MAX_CPUS; cpu++) {
+                if (allowed_cpus[cpu]) { CPU_SET(cpu, &cpus); }
+            }
+            if (-1 == sched_setaffinity(0, sizeof(cpus), &cpus)) {
+                LOG_ERROR_AND_DIE("Couldn't bind tracer to the specified CPUs -- %s", strerror(errno));
+            }
+        }
+            break;
+
+        case TRACER_PLACEMENT_AUTO:
+            DIE_WHEN_ERRNO( sched_getaffinity(0, sizeof(placement.allowed_cpus), &placement.allowed_cpus) );
+            for (int cpu = 0; cpu < CPU_UTILS_MAX_CPUS; cpu++) {
+                if (allowed_cpus && !allowed_cpus[cpu]) { CPU_CLR(cpu, &placement.allowed_cpus); }
+                placement.llc_of_cpu[cpu] = -1;
+            }
+            memset(placement.votes, 0, sizeof(placement.votes));
+            placement.next_sample_ns = 0;
+            placement.window_end_ns = 0;
+            placement.bound_llc = -1;
+            break;
+
+        case TRACER_PLACEMENT_NONE:
+        default:
+            break;
+    }
+}
+
+
+void placement_on_stop(pid_t tid) {
+/* 0. Sample (at most once per interval) CPU tracee last ran on */
+    const uint64_t now_ns = time_now_ns();
+    if (now_ns < placement.next_sample_ns) {
+        return;
+    }
+    placement.next_sample_ns = now_ns + PLACEMENT_SAMPLE_INTERVAL_NS;
+
+    const int llc = llc_of_cpu(cpu_last_of_task(tid));
+    if (-1 != llc) {
+        placement.votes[llc]++;
+    }
+
+/* 1. Once per window: Bind to LLC w/ most samples */
+    if (now_ns < placement.window_end_ns) {
+        return;
+    }
+    placement.window_end_ns = now_ns + PLACEMENT_WINDOW_NS;
+
+    int best_llc = -1;
+    for (int cpu = 0; cpu < CPU_UTILS_MAX_CPUS; cpu++) {
+        if (placement.votes[cpu] && (-1 == best_llc || placement.votes[cpu] > placement.votes[best_llc])) {
+            best_llc = cpu;
+        }
+    }
+    memset(placement.votes, 0, sizeof(placement.votes));
+
+    if (-1 != best_llc && best_llc != placement.bound_llc) {
+        bind_to_llc(best_llc);
+    }
+}
+
+
+/* - Helpers - */
+static int llc_of_cpu(int cpu) {
+    if (cpu < 0 || cpu >= CPU_UTILS_MAX_CPUS) {
+        return -1;
+    }
+
+    if (-1 == placement.llc_of_cpu[cpu]) {      /* (Topology is looked up only once per CPU) */
+        bool llc_cpus[CPU_UTILS_MAX_CPUS];
+        placement.llc_of_cpu[cpu] = cpu;
+        if (-1 != cpu_llc_siblings(cpu, llc_cpus)) {
+            for (int sibling = 0; sibling < cpu; sibling++) {
+                if (llc_cpus[sibling]) {
+                    placement.llc_of_cpu[cpu] = sibling;
+                    break;
+                }
+            }
+        }
+    }
+    return placement.llc_of_cpu[cpu];
+}
+
+static void bind_to_llc(int llc) {
+    bool llc_cpus[CPU_UTILS_MAX_CPUS];
+    if (-1 == cpu_llc_siblings(llc, llc_cpus)) {
+        return;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu = 0; cpu < CPU_UTILS_MAX_CPUS; cpu++) {
+        if (llc_cpus[cpu] && CPU_ISSET(cpu, &placement.allowed_cpus)) { CPU_SET(cpu, &cpus); }
+    }
+    if (!CPU_COUNT(&cpus)) {             /* LLC of tracees isn't allowed for tracer  -> Stay where we are */
+        return;
+    }
+
+    if (-1 == sched_setaffinity(0, sizeof(cpus), &cpus)) {
+        LOG_DEBUG("Couldn't bind tracer to LLC of CPU %d -- %s", llc, strerror(errno));
+        return;
+    }
+    placement.bound_llc = llc;
+    STATS_COUNT(STATS_COUNTER_TRACER_REBINDS, 1);
+}
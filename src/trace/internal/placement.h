@@ -0,0 +1,31 @@
+/**
+ * CPU placement of the tracer (`--tracer-cpu`, `--tracer-affinity`)
+ *   Each stop wakes up the tracer and, once it's restarted, the tracee  -> When both run far apart (different LLC or
+ *   NUMA node), each wake-up (+ the tracer's accesses to the tracee's state) crosses caches, making every stop costlier
+ *   - Pinned: Tracer is bound once (at startup) to the given CPU(s)
+ *   - Auto:   CPUs the stopped tracees last ran on (`/proc/<tid>/stat`) are sampled periodically; once per window, the
+ *             tracer is bound to the LLC (restricted to the allowed CPUs) which got most samples
+ *   NOTE: Tracees aren't bound (they're forked before the tracer binds itself)
+ */
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "../tracing.h"
+
+
+/* -- Consts -- */
+#define PLACEMENT_SAMPLE_INTERVAL_NS (10ULL * 1000 * 1000)
+#define PLACEMENT_WINDOW_NS          (250ULL * 1000 * 1000)
+
+
+/* -- Function prototypes -- */
+bool placement_cpus_usable(const bool* cpus);
+void placement_init(tracer_placement_t placement, const bool* allowed_cpus);
+
+void placement_on_stop(pid_t tid);
+
+
+#endif /* PLACEMENT_H */
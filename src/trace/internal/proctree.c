@@ -0,0 +1,438 @@
+#define _GNU_SOURCE             /* `CLONE_THREAD` */
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include "calibration.h"
+#include "summary.h"
+#include "proctree.h"
+
+
+/* -- Consts -- */
+#define PROCTREE_INITIAL_CAPACITY 64            /* Of processes + task table (latter MUST be a power of 2) */
+#define PROCTREE_EXES_INITIAL_CAPACITY 8
+#define PROCTREE_COMM_LEN 16                    /* Incl. '\0' (kernel's `TASK_COMM_LEN`) */
+#define PROCTREE_MAX_INDENT_DEPTH 16
+
+
+/* -- Types -- */
+typedef struct {
+    pid_t pid;
+    int parent, first_child, last_child, next_sibling;     /* Indices into `proctree.processes` (`-1` = none) */
+    int exe;                                /* Index into `proctree.exes` (`-1` = unknown) */
+    unsigned live_tasks;
+    bool exited;
+    int exit_status;
+    char comm[PROCTREE_COMM_LEN];
+    uint64_t calls, errors, total_ns;
+} process_t;
+
+typedef struct {
+    char* path;
+    unsigned processes;                     /* Nr of processes which ran it */
+    uint64_t total_ns;
+    summary_table_t* summary;               /* Created lazily (on first recorded syscall) */
+} exe_t;
+
+typedef struct {
+    pid_t tid;                              /* `0` = empty slot */
+    int process;
+} task_t;
+
+
+/* -- Globals -- */
+static struct {
+    process_t* processes;                   /* In order of appearance (never removed) */
+    size_t processes_count, processes_capacity;
+    int first_root, last_root;              /* Processes whose parent isn't traced (linked via `next_sibling`) */
+
+    exe_t* exes;
+    size_t exes_count, exes_capacity;
+
+    task_t* tasks;                          /* Hash table (live tasks only; open addressing w/ linear probing) */
+    size_t tasks_count, tasks_capacity;
+} proctree;
+
+
+/* -- Function prototypes -- */
+static int process_of(pid_t tid);
+static int process_new(pid_t pid, int parent);
+static void process_set_exe(int process, pid_t tid);
+static void read_comm(pid_t tid, char comm[PROCTREE_COMM_LEN]);
+static void read_ids(pid_t tid, pid_t* tgid, pid_t* ppid);
+static int exes_intern(const char* path);
+static int cmp_exes_by_time(const void* lhs, const void* rhs);
+
+static size_t tasks_slot_of(pid_t tid);
+static int tasks_lookup(pid_t tid);
+static void tasks_insert(pid_t tid, int process);
+static void tasks_remove(pid_t tid);
+static void tasks_grow(void);
+
+
+/* -- Functions -- */
+void proctree_init(void) {
+    memset(&proctree, 0, sizeof(proctree));
+    proctree.first_root = proctree.last_root = -1;
+}
+
+void proctree_fin(void) {
+    for (size_t i = 0; i < proctree.exes_count; i++) {
+        free(proctree.exes[i].path);
+        summary_table_free(proctree.exes[i].summary);
+    }
+    free(proctree.exes);
+    free(proctree.processes);
+    free(proctree.tasks);
+    memset(&proctree, 0, sizeof(proctree));
+}
+
+
+void proctree_on_clone(pid_t parent_tid, pid_t child_tid, unsigned long clone_flags) {
+    const int parent = process_of(parent_tid);
+    if (-1 != tasks_lookup(child_tid)) {        /* Already registered (child stopped before parent's event was seen) */
+        return;
+    }
+
+    if (clone_flags & CLONE_THREAD) {
+        tasks_insert(child_tid, parent);
+        proctree.processes[parent].live_tasks++;
+        return;
+    }
+
+    /* New process inherits comm + executable of its parent (until it `exec`s) */
+    const int child = process_new(child_tid, parent);
+    memcpy(proctree.processes[child].comm, proctree.processes[parent].comm, PROCTREE_COMM_LEN);
+    if (-1 != (proctree.processes[child].exe = proctree.processes[parent].exe)) {
+        proctree.exes[proctree.processes[child].exe].processes++;
+    }
+    tasks_insert(child_tid, child);
+    proctree.processes[child].live_tasks++;
+}
+
+/*
+ * `former_tid` != `tid`: A non-leader thread `exec`d (+ took over the leader's tid)
+ */
+void proctree_on_exec(pid_t tid, pid_t former_tid) {
+    if (former_tid != tid) {
+        const int former_process = tasks_lookup(former_tid);
+        if (-1 != former_process) {
+            tasks_remove(former_tid);
+            proctree.processes[former_process].live_tasks--;
+        }
+    }
+
+    const int process = process_of(tid);
+    read_comm(tid, proctree.processes[process].comm);
+    process_set_exe(process, tid);
+}
+
+/*
+ * Task is about to exit (still readable via `/proc`)  -> Final comm of process
+ */
+void proctree_on_exit(pid_t tid) {
+    const int process = tasks_lookup(tid);
+    if (-1 != process && tid == proctree.processes[process].pid) {
+        read_comm(tid, proctree.processes[process].comm);
+    }
+}
+
+void proctree_on_terminated(pid_t tid, int exit_status) {
+    const int process = tasks_lookup(tid);
+    if (-1 == process) {
+        return;
+    }
+    tasks_remove(tid);
+
+    process_t* const p = &proctree.processes[process];
+    if (p->live_tasks && !--(p->live_tasks)) {
+        p->exited = true;
+        p->exit_status = exit_status;
+    }
+}
+
+
+void proctree_record(const syscall_event_t* event) {
+    const int process = process_of(event->tid);
+    process_t* const p = &proctree.processes[process];
+    const uint64_t duration_ns = calibration_correct_duration_ns(event->exit_ns - event->enter_ns);
+    p->calls++;
+    p->errors += (0 != syscall_event_errno(event));
+    p->total_ns += duration_ns;
+
+    if (-1 != p->exe) {
+        exe_t* const exe = &proctree.exes[p->exe];
+        if (!exe->summary) {
+            exe->summary = summary_table_new();
+        }
+        summary_table_record(exe->summary, event);
+        exe->total_ns += duration_ns;
+    }
+}
+
+
+void proctree_fprint(FILE* stream) {
+/* 1. Per process  (depth-first, i.e., children are indented below their parent) */
+    fprintf(stream, "    pid     calls    errors     seconds   exit process\n"
+                    "------- --------- --------- ----------- ------ ----------------\n");
+    int process = proctree.first_root;
+    for (int depth = 0; -1 != process; ) {
+        const process_t* const p = &proctree.processes[process];
+        fprintf(stream, "%7d %9llu ", p->pid, (unsigned long long)p->calls);
+        if (p->errors) {
+            fprintf(stream, "%9llu ", (unsigned long long)p->errors);
+        } else {
+            fprintf(stream, "%9s ", "");
+        }
+        fprintf(stream, "%11.6f ", (double)p->total_ns / 1e9);
+        if (p->exited) {
+            fprintf(stream, "%6d ", p->exit_status);
+        } else {
+            fprintf(stream, "%6s ", "-");
+        }
+        fprintf(stream, "%*s%s%s (%s)\n",
+                2 * ((depth < PROCTREE_MAX_INDENT_DEPTH) ? (depth) : (PROCTREE_MAX_INDENT_DEPTH)), "",
+                (depth) ? ("`- ") : (""), p->comm,
+                (-1 != p->exe) ? (proctree.exes[p->exe].path) : ("?"));
+
+        /* Next: First child, otherwise next sibling of closest ancestor which has one */
+        if (-1 != p->first_child) {
+            process = p->first_child;
+            depth++;
+            continue;
+        }
+        while (-1 != process && -1 == proctree.processes[process].next_sibling) {
+            process = proctree.processes[process].parent;
+            depth--;
+        }
+        if (-1 != process) {
+            process = proctree.processes[process].next_sibling;
+        }
+    }
+
+/* 2. Per executable  (sorted by time spent) */
+    int* const sorted_exes = DIE_WHEN_ERRNO_VPTR( malloc((proctree.exes_count + 1) * sizeof(*sorted_exes)) );
+    for (size_t i = 0; i < proctree.exes_count; i++) {
+        sorted_exes[i] = (int)i;
+    }
+    qsort(sorted_exes, proctree.exes_count, sizeof(*sorted_exes), cmp_exes_by_time);
+
+    for (size_t i = 0; i < proctree.exes_count; i++) {
+        const exe_t* const exe = &proctree.exes[sorted_exes[i]];
+        if (!exe->summary) {
+            continue;
+        }
+        fprintf(stream, "\n%s (%u process%s):\n", exe->path, exe->processes, (1 == exe->processes) ? ("") : ("es"));
+        summary_table_fprint(stream, exe->summary);
+    }
+    free(sorted_exes);
+}
+
+
+/* - Helpers - */
+/*
+ * Process of task (registered first if its creation wasn't seen)
+ */
+static int process_of(pid_t tid) {
+    int process;
+    if (-1 != (process = tasks_lookup(tid))) {
+        return process;
+    }
+
+    pid_t tgid = tid, ppid = 0;
+    read_ids(tid, &tgid, &ppid);
+    if (tgid == tid || -1 == (process = tasks_lookup(tgid))) {
+        process = process_new(tgid, tasks_lookup(ppid));
+        read_comm(tgid, proctree.processes[process].comm);
+        process_set_exe(process, tgid);
+        if (tgid != tid) {          /* (Leader is traced too, but hasn't stopped yet) */
+            tasks_insert(tgid, process);
+            proctree.processes[process].live_tasks++;
+        }
+    }
+    tasks_insert(tid, process);
+    proctree.processes[process].live_tasks++;
+    return process;
+}
+
+static int process_new(pid_t pid, int parent) {
+    if (proctree.processes_count == proctree.processes_capacity) {
+        proctree.processes_capacity = (proctree.processes_capacity) ? (proctree.processes_capacity * 2) : (PROCTREE_INITIAL_CAPACITY);
+        proctree.processes = DIE_WHEN_ERRNO_VPTR( realloc(proctree.processes, proctree.processes_capacity * sizeof(*(proctree.processes))) );
+    }
+
+    const int process = (int)proctree.processes_count++;
+    process_t* const p = &proctree.processes[process];
+    memset(p, 0, sizeof(*p));
+    p->pid = pid;
+    p->parent = parent;
+    p->first_child = p->last_child = p->next_sibling = p->exe = -1;
+    strcpy(p->comm, "?");
+
+    /* Append to children of parent (or roots) */
+    int* const first = (-1 != parent) ? (&proctree.processes[parent].first_child) : (&proctree.first_root);
+    int* const last = (-1 != parent) ? (&proctree.processes[parent].last_child) : (&proctree.last_root);
+    if (-1 == *last) {
+        *first = process;
+    } else {
+        proctree.processes[*last].next_sibling = process;
+    }
+    *last = process;
+    return process;
+}
+
+static void process_set_exe(int process, pid_t tid) {
+    char exe_link_path[64], exe_path[4096];
+    snprintf(exe_link_path, sizeof(exe_link_path), "/proc/%d/exe", tid);
+    const ssize_t exe_path_len = readlink(exe_link_path, exe_path, sizeof(exe_path) - 1);
+    if (exe_path_len < 0) {
+        return;
+    }
+    exe_path[exe_path_len] = '\0';
+
+    const int exe = exes_intern(exe_path);
+    if (exe != proctree.processes[process].exe) {
+        proctree.processes[process].exe = exe;
+        proctree.exes[exe].processes++;
+    }
+}
+
+static void read_comm(pid_t tid, char comm[PROCTREE_COMM_LEN]) {
+    char comm_path[64];
+    snprintf(comm_path, sizeof(comm_path), "/proc/%d/comm", tid);
+    FILE* const comm_file = fopen(comm_path, "r");
+    if (!comm_file) {
+        return;
+    }
+    if (fgets(comm, PROCTREE_COMM_LEN, comm_file)) {
+        comm[strcspn(comm, "\n")] = '\0';
+    }
+    fclose(comm_file);
+}
+
+static void read_ids(pid_t tid, pid_t* tgid, pid_t* ppid) {
+    char status_path[64];
+    snprintf(status_path, sizeof(status_path), "/proc/%d/status", tid);
+    FILE* const status_file = fopen(status_path, "r");
+    if (!status_file) {
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), status_file)) {
+        int id;
+        if (1 == sscanf(line, "Tgid: %d", &id)) {
+            *tgid = (pid_t)id;
+        } else if (1 == sscanf(line, "PPid: %d", &id)) {
+            *ppid = (pid_t)id;
+            break;                  /* (Follows `Tgid`) */
+        }
+    }
+    fclose(status_file);
+}
+
+/*
+ * Index of executable (added if new)  -- Linear search, since there are few distinct executables (even if run by many processes)
+ */
+static int exes_intern(const char* path) {
+    for (size_t i = 0; i < proctree.exes_count; i++) {
+        if (!strcmp(path, proctree.exes[i].path)) {
+            return (int)i;
+        }
+    }
+
+    if (proctree.exes_count == proctree.exes_capacity) {
+        proctree.exes_capacity = (proctree.exes_capacity) ? (proctree.exes_capacity * 2) : (PROCTREE_EXES_INITIAL_CAPACITY);
+        proctree.exes = DIE_WHEN_ERRNO_VPTR( realloc(proctree.exes, proctree.exes_capacity * sizeof(*(proctree.exes))) );
+    }
+    exe_t* const exe = &proctree.exes[proctree.exes_count];
+    memset(exe, 0, sizeof(*exe));
+    exe->path = DIE_WHEN_ERRNO_VPTR( strdup(path) );
+    return (int)proctree.exes_count++;
+}
+
+static int cmp_exes_by_time(const void* lhs, const void* rhs) {
+    const exe_t* const l = &proctree.exes[*(const int*)lhs];
+    const exe_t* const r = &proctree.exes[*(const int*)rhs];
+
+    if (l->total_ns != r->total_ns) {
+        return (l->total_ns < r->total_ns) ? (1) : (-1);
+    }
+    return strcmp(l->path, r->path);
+}
+
+
+static size_t tasks_slot_of(pid_t tid) {
+    return ((uint32_t)tid * 2654435761U) & (proctree.tasks_capacity - 1);     /* Knuth's multiplicative hash */
+}
+
+static int tasks_lookup(pid_t tid) {
+    if (!proctree.tasks_count || tid <= 0) {
+        return -1;
+    }
+
+    for (size_t slot = tasks_slot_of(tid); proctree.tasks[slot].tid; slot = (slot + 1) & (proctree.tasks_capacity - 1)) {
+        if (tid == proctree.tasks[slot].tid) {
+            return proctree.tasks[slot].process;
+        }
+    }
+    return -1;
+}
+
+static void tasks_insert(pid_t tid, int process) {
+    if ((proctree.tasks_count + 1) * 2 > proctree.tasks_capacity) {     /* Keep load factor <= 0.5 */
+        tasks_grow();
+    }
+
+    size_t slot = tasks_slot_of(tid);
+    while (proctree.tasks[slot].tid) {
+        slot = (slot + 1) & (proctree.tasks_capacity - 1);
+    }
+    proctree.tasks[slot].tid = tid;
+    proctree.tasks[slot].process = process;
+    proctree.tasks_count++;
+}
+
+static void tasks_remove(pid_t tid) {
+    if (!proctree.tasks_count) {
+        return;
+    }
+
+    size_t slot = tasks_slot_of(tid);
+    for ( ; proctree.tasks[slot].tid; slot = (slot + 1) & (proctree.tasks_capacity - 1)) {
+        if (tid == proctree.tasks[slot].tid) { break; }
+    }
+    if (!proctree.tasks[slot].tid) {
+        return;
+    }
+    proctree.tasks[slot].tid = 0;
+    proctree.tasks_count--;
+
+/* Backward shift deletion (see `tracees_remove`) */
+    for (size_t next_slot = (slot + 1) & (proctree.tasks_capacity - 1); proctree.tasks[next_slot].tid; next_slot = (next_slot + 1) & (proctree.tasks_capacity - 1)) {
+        const size_t ideal_slot = tasks_slot_of(proctree.tasks[next_slot].tid);
+        if (((next_slot - ideal_slot) & (proctree.tasks_capacity - 1)) >= ((next_slot - slot) & (proctree.tasks_capacity - 1))) {
+            proctree.tasks[slot] = proctree.tasks[next_slot];
+            proctree.tasks[next_slot].tid = 0;
+            slot = next_slot;
+        }
+    }
+}
+
+static void tasks_grow(void) {
+    task_t* const old_tasks = proctree.tasks;
+    const size_t old_capacity = proctree.tasks_capacity;
+
+    proctree.tasks_capacity = (old_capacity) ? (old_capacity * 2) : (PROCTREE_INITIAL_CAPACITY);
+    proctree.tasks = DIE_WHEN_ERRNO_VPTR( calloc(proctree.tasks_capacity, sizeof(*(proctree.tasks))) );
+    proctree.tasks_count = 0;
+
+    for (size_t slot = 0; slot < old_capacity; slot++) {
+        if (old_tasks[slot].tid) {
+            tasks_insert(old_tasks[slot].tid, old_tasks[slot].process);
+        }
+    }
+    free(old_tasks);
+}
@@ -0,0 +1,32 @@
+/**
+ * Process tree (`-c` / `-C` when following forks or attaching to many): Which tasks belong to which process, who
+ * forked whom + each process's comm and executable  -> Summary is also aggregated per process and per executable
+ *   - Updated incrementally on `PTRACE_EVENT_FORK` / `VFORK` / `CLONE` / `EXEC` / `EXIT` and on task termination
+ *   - Tasks whose creation wasn't seen (e.g., the launched / attached-to processes) are registered lazily (via `/proc`)
+ *   - Compact, also for thousands of short-lived processes: Each process is a small fixed-size node (kept after it
+ *     exited; linked to parent + siblings via indices); per-syscall counters exist only per executable (paths are interned)
+ */
+#ifndef PROCTREE_H
+#define PROCTREE_H
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "syscall_event.h"
+
+
+/* -- Function prototypes -- */
+void proctree_init(void);
+void proctree_fin(void);
+
+void proctree_on_clone(pid_t parent_tid, pid_t child_tid, unsigned long clone_flags);
+void proctree_on_exec(pid_t tid, pid_t former_tid);
+void proctree_on_exit(pid_t tid);
+void proctree_on_terminated(pid_t tid, int exit_status);
+
+void proctree_record(const syscall_event_t* event);
+
+void proctree_fprint(FILE* stream);
+
+
+#endif /* PROCTREE_H */
@@ -1,10 +1,15 @@
+#define _GNU_SOURCE
 #include <errno.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <sys/ptrace.h>
+#include <sys/uio.h>
 
 #include "ptrace_utils.h"
+#include "recording.h"
+#include "stats.h"
 
 #include <common/error.h>
 
@@ -14,7 +19,23 @@
 #endif /* PRINT_COMPLETE_STRING_ARGS */
 
 
+/* -- Globals -- */
+static bool read_via_vm_readv = false;
+#ifndef PRINT_COMPLETE_STRING_ARGS
+static size_t string_max_words = STRING_MAX_WORDS_TO_BE_READ;
+#endif /* PRINT_COMPLETE_STRING_ARGS */
+
+
+/* -- Function prototypes -- */
+static int peek_word(pid_t tid, unsigned long addr, unsigned long* read_word_ptr);
+
+
 /* -- Functions -- */
+int ptrace_read_word(pid_t tid, unsigned long addr,
+                     unsigned long* read_word_ptr) {
+    return peek_word(tid, addr, read_word_ptr);
+}
+
 size_t ptrace_read_string(pid_t tid, unsigned long addr,
                          ssize_t bytes_to_read,
                          char** read_str_ptr_ptr) {
@@ -24,13 +45,14 @@ size_t ptrace_read_string(pid_t tid, unsigned long addr,
 #ifdef PRINT_COMPLETE_STRING_ARGS
     size_t read_str_size_bytes = 2048;
 #else
-    size_t read_str_size_bytes = STRING_MAX_WORDS_TO_BE_READ * sizeof(ptrace_read_word);
+    size_t read_str_size_bytes = string_max_words * sizeof(ptrace_read_word);
 #endif /* PRINT_COMPLETE_STRING_ARGS */
 
     char *read_str_ptr = NULL;
-    if (! (read_str_ptr = malloc(read_str_size_bytes)) ) {
+    if (! (read_str_ptr = malloc(read_str_size_bytes + 1 /* NUL-terminator */)) ) {
         LOG_ERROR_AND_DIE("`malloc`: Failed to allocate memory");
     }
+    STATS_COUNT(STATS_COUNTER_ALLOCS, 1);
     *read_str_ptr_ptr = read_str_ptr;
 
 /* 1. Read string using ptrace */
@@ -40,9 +62,10 @@ size_t ptrace_read_string(pid_t tid, unsigned long addr,
         if (read_bytes + sizeof(ptrace_read_word) > read_str_size_bytes) {
 #ifdef PRINT_COMPLETE_STRING_ARGS
             read_str_size_bytes *= 2;
-            if (! (read_str_ptr = realloc(read_str_ptr, read_str_size_bytes)) ) {
+            if (! (read_str_ptr = realloc(read_str_ptr, read_str_size_bytes + 1 /* NUL-terminator */)) ) {
                 LOG_ERROR_AND_DIE("`realloc`: Failed to allocate memory");
             }
+            STATS_COUNT(STATS_COUNTER_ALLOCS, 1);
             *read_str_ptr_ptr = read_str_ptr;
 #else
             /* If limit has been reached, add shortened suffix + NUL-terminate string */
@@ -55,12 +78,10 @@ size_t ptrace_read_string(pid_t tid, unsigned long addr,
         }
 
     /* 1.2. Read from tracee (each time one word) */
-        errno = 0;
-        ptrace_read_word = ptrace(PTRACE_PEEKDATA, tid, addr + read_bytes);
     /* 1.2.1. Check for errors */
-        if (errno) {
+        if (-1 == peek_word(tid, addr + read_bytes, &ptrace_read_word)) {
             read_str_ptr[read_bytes] = '\0';
-            return read_bytes -1;            /* Length excl. NUL byte */
+            return (read_bytes) ? (read_bytes -1) : (0);     /* Length excl. NUL byte */
         }
 
     /* 1.3. Append read word to buffer */
@@ -74,7 +95,7 @@ size_t ptrace_read_string(pid_t tid, unsigned long addr,
         if (bytes_to_read >= 0) {
             if (read_bytes >= (size_t)bytes_to_read) {
                 read_str_ptr[bytes_to_read] = '\0'; /* Must be after ALL bytes (hence no -1) */
-                return (0 == bytes_to_read) ? (0) : (bytes_to_read - 1);    /* Length excl. NUL byte */
+                return (size_t)bytes_to_read;        /* (Binary data isn't NUL-terminated  -> All bytes belong to it) */
             }
         }
 
@@ -86,3 +107,76 @@ size_t ptrace_read_string(pid_t tid, unsigned long addr,
         }
     }
 }
+
+/*
+ * Reads NUL-terminated path (into caller's buffer) -- bounded by `PATH_MAX`, NOT by the (display) limit of strings
+ *   Returns length, or `-1` if it couldn't be read (completely)
+ */
+ssize_t ptrace_read_path(pid_t tid, unsigned long addr,
+                         char* path_buf) {
+    unsigned long ptrace_read_word;
+    for (size_t read_bytes = 0; read_bytes < PATH_MAX; read_bytes += sizeof(ptrace_read_word)) {
+        if (-1 == peek_word(tid, addr + read_bytes, &ptrace_read_word)) {
+            return -1;
+        }
+
+        const size_t copy_bytes = (PATH_MAX - read_bytes < sizeof(ptrace_read_word)) ?
+                                      (PATH_MAX - read_bytes) : (sizeof(ptrace_read_word));
+        memcpy(path_buf + read_bytes, &ptrace_read_word, copy_bytes);
+        if (memchr(&ptrace_read_word, '\0', copy_bytes)) {
+            return (ssize_t)strlen(path_buf);
+        }
+    }
+    return -1;      /* (Too long, i.e., syscall fails w/ `ENAMETOOLONG`) */
+}
+
+void ptrace_set_read_via_vm_readv(bool enabled) {
+    read_via_vm_readv = enabled;
+}
+
+#ifndef PRINT_COMPLETE_STRING_ARGS
+/* Adjusts limit of read strings at runtime (e.g., via control socket); `0` = default */
+void ptrace_set_string_max_bytes(size_t max_bytes) {
+    string_max_words = (max_bytes) ?
+                           ((max_bytes + sizeof(unsigned long) - 1) / sizeof(unsigned long)) :
+                           (STRING_MAX_WORDS_TO_BE_READ);
+}
+#endif /* PRINT_COMPLETE_STRING_ARGS */
+
+
+/* - Helpers - */
+/*
+ * Reads one word of tracee memory  (all reads of tracee memory go through here  -> Recorded / replayed here)
+ */
+static int peek_word(pid_t tid, unsigned long addr, unsigned long* read_word_ptr) {
+    if (BRANCH_UNLIKELY(RECORDING_REPLAY == recording_mode)) {
+        return (recording_replay_word(addr, read_word_ptr)) ? (0) : (-1);
+    }
+
+    STATS_TIMER_BEGIN(STATS_TIMER_MEM_READ);
+    errno = 0;
+    unsigned long read_word = 0;
+    if (read_via_vm_readv) {
+        const struct iovec local = { .iov_base = &read_word, .iov_len = sizeof(read_word) };
+        const struct iovec remote = { .iov_base = (void*)addr, .iov_len = sizeof(read_word) };
+        if ((ssize_t)sizeof(read_word) != process_vm_readv(tid, &local, 1, &remote, 1, 0) && !errno) {
+            errno = EFAULT;             /* (Partial read) */
+        }
+    } else {
+        read_word = ptrace(PTRACE_PEEKDATA, tid, addr);
+    }
+    const int read_errno = errno;
+    STATS_TIMER_END(STATS_TIMER_MEM_READ);
+    STATS_COUNT(STATS_COUNTER_PTRACE_READ_CALLS, 1);
+    if (read_errno) {
+        return -1;
+    }
+    STATS_COUNT(STATS_COUNTER_PTRACE_READ_BYTES, sizeof(read_word));
+
+    if (BRANCH_UNLIKELY(RECORDING_CAPTURE == recording_mode)) {
+        recording_capture_word(addr, read_word);
+    }
+
+    *read_word_ptr = read_word;
+    return 0;
+}
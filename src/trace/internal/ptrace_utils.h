@@ -1,17 +1,27 @@
 /**
  * Functions utilizing `ptrace`(2)
+ *   (Tracee memory is read via `process_vm_readv`(2) instead, when tracees aren't ptrace'd, e.g., w/ seccomp-notif backend)
  */
 #ifndef PTRACE_UTILS_H
 #define PTRACE_UTILS_H
 
+#include <stdbool.h>
 #include <unistd.h>
 #include "arch/ptrace_utils.h"
 
 
 /* -- Function prototypes -- */
 int ptrace_get_regs_content(pid_t tid, struct user_regs_struct_full *regs);
+int ptrace_read_word(pid_t tid, unsigned long addr,
+                     unsigned long* read_word_ptr);
 size_t ptrace_read_string(pid_t tid, unsigned long addr,
                           ssize_t bytes_to_read,
                           char** read_str_ptr_ptr);        /* WARNING: MUST BE `free`(3)'ed */
+ssize_t ptrace_read_path(pid_t tid, unsigned long addr,
+                         char* path_buf /* `PATH_MAX` bytes */);
+void ptrace_set_read_via_vm_readv(bool enabled);
+#ifndef PRINT_COMPLETE_STRING_ARGS
+void ptrace_set_string_max_bytes(size_t max_bytes);
+#endif /* PRINT_COMPLETE_STRING_ARGS */
 
 #endif /* PTRACE_UTILS_H */
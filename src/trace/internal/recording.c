@@ -0,0 +1,228 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include "syscalls.h"
+#include "recording.h"
+
+
+/* -- Consts -- */
+#define CHUNK_ALIGNMENT 8
+
+
+/* -- Globals -- */
+recording_mode_t recording_mode = RECORDING_OFF;
+
+static struct {
+    FILE* file;
+    const char* path;
+
+    /* Captured chunks of current event */
+    unsigned char* memory;
+    size_t memory_size, memory_capacity;
+    size_t last_chunk_offset;           /* Chunk which is extended by contiguous words */
+} recorder;
+
+static const unsigned char* replay_memory;      /* Chunks of event being replayed */
+static size_t replay_memory_size;
+
+
+/* -- Function prototypes -- */
+static void reserve_memory(size_t size);
+static void append_chunk(unsigned long addr, const void* data, size_t len);
+static void write_event(const recording_event_header_t* header);
+
+
+/* -- Functions -- */
+/* - Tracer - */
+void recording_init(const char* path, bool follow_fork) {
+    if (! (recorder.file = fopen(path, "wb")) ) {
+        LOG_ERROR_AND_DIE("Couldn't open recording file \"%s\" -- %s", path, strerror(errno));
+    }
+    recorder.path = path;
+
+    recording_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+    header.version = RECORDING_VERSION;
+    header.flags = (follow_fork) ? (RECORDING_FOLLOW_FORK) : (0);
+    fwrite(&header, sizeof(header), 1, recorder.file);
+
+    recording_mode = RECORDING_CAPTURE;
+}
+
+void recording_fin(void) {
+    recording_mode = RECORDING_OFF;
+
+    if (fclose(recorder.file)) {
+        LOG_WARN("Couldn't write recording file \"%s\" -- %s", recorder.path, strerror(errno));
+    }
+    free(recorder.memory);
+    memset(&recorder, 0, sizeof(recorder));
+}
+
+
+void recording_capture_begin(void) {
+    recorder.memory_size = 0;
+}
+
+void recording_capture_word(unsigned long addr, unsigned long word) {
+    /* Extend last chunk if contiguous (e.g., strings, which are read word by word) */
+    if (recorder.memory_size) {
+        recording_chunk_t* const last_chunk = (recording_chunk_t*)(recorder.memory + recorder.last_chunk_offset);
+        if (last_chunk->addr + last_chunk->len == addr) {
+            reserve_memory(sizeof(word));
+            memcpy(recorder.memory + recorder.memory_size, &word, sizeof(word));
+            recorder.memory_size += sizeof(word);
+            ((recording_chunk_t*)(recorder.memory + recorder.last_chunk_offset))->len += sizeof(word);
+            return;
+        }
+    }
+    append_chunk(addr, &word, sizeof(word));
+}
+
+
+void recording_record_enter(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS], const char* preformatted_args) {
+    recording_event_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.type = RECORDING_EVENT_ENTER;
+    header.tid = tid;
+    header.nr = syscall_nr;
+    for (int i = 0; i < SYSCALL_MAX_ARGS; i++) {
+        header.args[i] = args[i];
+    }
+
+    /* Preformatted args: Memory has already been replaced (e.g., by `exec`)  -> Record text instead */
+    if (preformatted_args) {
+        header.flags |= RECORDING_EVENT_PREFORMATTED;
+        recorder.memory_size = 0;
+        append_chunk(0, preformatted_args, strlen(preformatted_args));
+    }
+
+    header.memory_size = (uint32_t)recorder.memory_size;
+    write_event(&header);
+    recorder.memory_size = 0;
+}
+
+void recording_record_exit(pid_t tid, long syscall_nr, long rtn_val, bool resumed) {
+    recording_event_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.type = RECORDING_EVENT_EXIT;
+    header.flags = (resumed) ? (RECORDING_EVENT_RESUMED) : (0);
+    header.tid = tid;
+    header.nr = syscall_nr;
+    header.rtn_val = rtn_val;
+    write_event(&header);
+}
+
+
+/* - Replay - */
+int recording_read_file_header(FILE* file, recording_file_header_t* header) {
+    if (1 != fread(header, sizeof(*header), 1, file) ||
+        memcmp(header->magic, RECORDING_MAGIC, sizeof(header->magic)) ||
+        RECORDING_VERSION != header->version) {
+        return -1;
+    }
+    return 0;
+}
+
+int recording_read_event(FILE* file, recorded_event_t* event) {
+    if (1 != fread(&event->header, sizeof(event->header), 1, file)) {
+        return -1;
+    }
+    event->memory = DIE_WHEN_ERRNO_VPTR( malloc(event->header.memory_size + 1) );
+    if (event->header.memory_size && 1 != fread(event->memory, event->header.memory_size, 1, file)) {
+        free(event->memory);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Replays event through decoding -> formatting -> output  (same text as printed by the tracer)
+ */
+void recording_replay_event(FILE* stream, uint32_t file_flags, const recorded_event_t* event) {
+    const char* const scall_name = syscalls_get_name((long)event->header.nr);
+
+    switch ((recording_event_type_t)event->header.type) {
+        case RECORDING_EVENT_ENTER:
+            if (file_flags & RECORDING_FOLLOW_FORK) {
+                fprintf(stream, "\n[%d] ", event->header.tid);
+            }
+            fprintf(stream, "%s(", scall_name);
+
+            if (event->header.flags & RECORDING_EVENT_PREFORMATTED) {
+                const recording_chunk_t* const chunk = (const recording_chunk_t*)event->memory;
+                fwrite(event->memory + sizeof(*chunk), 1, chunk->len, stream);
+            } else {
+                long args[SYSCALL_MAX_ARGS];
+                for (int i = 0; i < SYSCALL_MAX_ARGS; i++) {
+                    args[i] = (long)event->header.args[i];
+                }
+                replay_memory = event->memory;
+                replay_memory_size = event->header.memory_size;
+                syscalls_fprint_args(stream, event->header.tid, (long)event->header.nr, args);
+                replay_memory = NULL;
+                replay_memory_size = 0;
+            }
+            fputc(')', stream);
+            break;
+
+        case RECORDING_EVENT_EXIT:
+        default:
+            if (event->header.flags & RECORDING_EVENT_RESUMED) {
+                fprintf(stream, "\n... [%d - %s (%d)]", event->header.tid, scall_name, event->header.tid);
+            }
+            fputs(" = ", stream);
+            syscalls_fprint_rtn_val(stream, (long)event->header.rtn_val);
+            fputc('\n', stream);
+            break;
+    }
+}
+
+bool recording_replay_word(unsigned long addr, unsigned long* word) {
+    for (size_t offset = 0; offset + sizeof(recording_chunk_t) <= replay_memory_size; ) {
+        const recording_chunk_t* const chunk = (const recording_chunk_t*)(replay_memory + offset);
+        if (chunk->addr <= addr && addr + sizeof(*word) <= chunk->addr + chunk->len) {
+            memcpy(word, replay_memory + offset + sizeof(*chunk) + (addr - chunk->addr), sizeof(*word));
+            return true;
+        }
+        offset += sizeof(*chunk) + ((chunk->len + CHUNK_ALIGNMENT - 1) & ~(size_t)(CHUNK_ALIGNMENT - 1));
+    }
+    return false;
+}
+
+
+/* - Helpers - */
+static void reserve_memory(size_t size) {
+    if (recorder.memory_size + size > recorder.memory_capacity) {
+        recorder.memory_capacity = (recorder.memory_capacity) ? (recorder.memory_capacity * 2) : (4096);
+        while (recorder.memory_size + size > recorder.memory_capacity) {
+            recorder.memory_capacity *= 2;
+        }
+        recorder.memory = DIE_WHEN_ERRNO_VPTR( realloc(recorder.memory, recorder.memory_capacity) );
+    }
+}
+
+static void append_chunk(unsigned long addr, const void* data, size_t len) {
+    const size_t padded_len = (len + CHUNK_ALIGNMENT - 1) & ~(size_t)(CHUNK_ALIGNMENT - 1);
+    reserve_memory(sizeof(recording_chunk_t) + padded_len);
+
+    recording_chunk_t chunk = { addr, (uint32_t)len, 0 };
+    recorder.last_chunk_offset = recorder.memory_size;
+    memcpy(recorder.memory + recorder.memory_size, &chunk, sizeof(chunk));
+    memcpy(recorder.memory + recorder.memory_size + sizeof(chunk), data, len);
+    memset(recorder.memory + recorder.memory_size + sizeof(chunk) + len, 0, padded_len - len);
+    recorder.memory_size += sizeof(chunk) + padded_len;
+}
+
+/*
+ * Writes event header, followed by captured chunks (if any)
+ */
+static void write_event(const recording_event_header_t* header) {
+    fwrite(header, sizeof(*header), 1, recorder.file);
+    if (header->memory_size) {
+        fwrite(recorder.memory, header->memory_size, 1, recorder.file);
+    }
+}
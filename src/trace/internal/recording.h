@@ -0,0 +1,99 @@
+/**
+ * Recording of raw stop data (`--record=<file>`) + offline replay
+ *   Records each printed syscall as it's printed (i.e., same order as the tracer's output):
+ *     - Syscall-enter: Raw args + all words of tracee memory read while decoding them
+ *     - Syscall-exit:  Return value
+ *   During replay, reads of tracee memory (see "ptrace_utils") are served from the recorded words
+ *     -> Decoding, formatting & output can be run (e.g., benchmarked) w/o a tracee, producing the same text
+ *
+ *   NOTE: Not replayed: fd path annotations (`-y`), stack traces & any other messages of the tracer
+ */
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <trace/syscall_types.h>
+
+
+/* -- Consts -- */
+#define RECORDING_MAGIC   "MSRC"
+#define RECORDING_VERSION 1
+
+#define RECORDING_FOLLOW_FORK (1U << 0)         /* File flag: Recorded w/ `-f` (i.e., lines are prefixed w/ tid) */
+
+#define RECORDING_EVENT_PREFORMATTED (1U << 0)  /* Enter: Args were formatted prior being recorded (e.g., `exec`); memory = text */
+#define RECORDING_EVENT_RESUMED      (1U << 1)  /* Exit:  Printed as resumed (`... [tid - name (tid)]`) */
+
+
+/* -- Types -- */
+typedef enum {
+    RECORDING_OFF,
+    RECORDING_CAPTURE,          /* Tracer: Capture words read from tracee memory */
+    RECORDING_REPLAY            /* Replay: Serve reads of tracee memory from recorded words */
+} recording_mode_t;
+
+typedef enum {
+    RECORDING_EVENT_ENTER,
+    RECORDING_EVENT_EXIT
+} recording_event_type_t;
+
+/* File header (followed by events) */
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t reserved;
+} recording_file_header_t;
+
+/* Event (followed by `memory_size` bytes of chunks) */
+typedef struct {
+    uint32_t type;              /* `recording_event_type_t` */
+    uint32_t flags;
+    int32_t tid;
+    uint32_t memory_size;
+    int64_t nr;
+    int64_t args[SYSCALL_MAX_ARGS];
+    int64_t rtn_val;            /* Only exit */
+} recording_event_header_t;
+
+/* Chunk of contiguous tracee memory (followed by `len` bytes, padded to 8 bytes) */
+typedef struct {
+    uint64_t addr;
+    uint32_t len;
+    uint32_t reserved;
+} recording_chunk_t;
+
+typedef struct {
+    recording_event_header_t header;
+    unsigned char* memory;      /* Chunks */
+} recorded_event_t;
+
+
+/* -- Globals -- */
+extern recording_mode_t recording_mode;
+
+
+/* -- Function prototypes -- */
+/* - Tracer - */
+void recording_init(const char* path, bool follow_fork);
+void recording_fin(void);
+
+void recording_capture_begin(void);
+void recording_capture_word(unsigned long addr, unsigned long word);
+
+void recording_record_enter(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS], const char* preformatted_args);
+void recording_record_exit(pid_t tid, long syscall_nr, long rtn_val, bool resumed);
+
+/* - Replay - */
+int recording_read_file_header(FILE* file, recording_file_header_t* header);
+int recording_read_event(FILE* file, recorded_event_t* event);         /* WARNING: `event->memory` MUST be `free`(3)'ed */
+
+void recording_replay_event(FILE* stream, uint32_t file_flags, const recorded_event_t* event);
+bool recording_replay_word(unsigned long addr, unsigned long* word);
+
+
+#endif /* RECORDING_H */
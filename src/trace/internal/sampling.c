@@ -0,0 +1,95 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <common/error.h>
+#include <common/time_utils.h>
+#include <trace/syscallents.h>
+#include "sampling.h"
+
+
+/* -- Globals -- */
+static struct {
+    sampling_policy_t policy;
+
+    unsigned* nr_counters;              /* 1-in-N: Indexed by syscall nr */
+
+    uint64_t window_start_ns;           /* Burst: Current window */
+    unsigned window_count;
+
+    uint64_t seen;                      /* Stats */
+    uint64_t sampled;
+} sampling;
+
+
+/* -- Functions -- */
+void sampling_init(const sampling_policy_t* policy) {
+    sampling.policy = *policy;
+    sampling.nr_counters = (policy->every_nth) ?
+                               (DIE_WHEN_ERRNO_VPTR( calloc(SYSCALLS_ARR_SIZE, sizeof(*(sampling.nr_counters))) )) :
+                               (NULL);
+    sampling.window_start_ns = 0;
+    sampling.window_count = 0;
+    sampling.seen = sampling.sampled = 0;
+}
+
+void sampling_fin(void) {
+    free(sampling.nr_counters);
+    sampling.nr_counters = NULL;
+}
+
+
+/* Adjusts 1-in-N rate at runtime (e.g., by the overhead governor) */
+void sampling_set_every_nth(unsigned every_nth) {
+    if (every_nth && !sampling.nr_counters) {
+        sampling.nr_counters = DIE_WHEN_ERRNO_VPTR( calloc(SYSCALLS_ARR_SIZE, sizeof(*(sampling.nr_counters))) );
+    }
+    sampling.policy.every_nth = every_nth;
+}
+
+
+bool sampling_should_sample(pid_t tid, long syscall_nr) {
+    sampling.seen++;
+
+/* 1. Per thread  (tids of thread pools are usually consecutive  -> Modulo spreads them evenly) */
+    if (sampling.policy.every_nth_thread && 0 != (unsigned)tid % sampling.policy.every_nth_thread) {
+        return false;
+    }
+
+/* 2. 1-in-N per syscall nr */
+    if (sampling.policy.every_nth && syscall_nr >= 0 && syscall_nr <= MAX_SYSCALL_NUM) {
+        unsigned* const counter = &sampling.nr_counters[syscall_nr];
+        const bool nth = (0 == *counter);
+        *counter = (*counter + 1) % sampling.policy.every_nth;
+        if (!nth) {
+            return false;
+        }
+    }
+
+/* 3. First M per window */
+    if (sampling.policy.burst_per_window) {
+        const uint64_t now = time_now_ns();
+        if (now - sampling.window_start_ns >= SAMPLING_BURST_WINDOW_NS) {
+            sampling.window_start_ns = now;
+            sampling.window_count = 0;
+        }
+        if (sampling.window_count >= sampling.policy.burst_per_window) {
+            return false;
+        }
+        sampling.window_count++;
+    }
+
+    sampling.sampled++;
+    return true;
+}
+
+
+void sampling_fprint_stats(FILE* stream) {
+    fprintf(stream, "+++ Sampled %llu of %llu system calls (%.2f%%) +++\n",
+            (unsigned long long)sampling.sampled, (unsigned long long)sampling.seen,
+            (sampling.seen) ? (100.0 * (double)sampling.sampled / (double)sampling.seen) : (0.0));
+}
+
+void sampling_get_counts(uint64_t* sampled, uint64_t* seen) {
+    *sampled = sampling.sampled;
+    *seen = sampling.seen;
+}
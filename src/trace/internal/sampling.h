@@ -0,0 +1,43 @@
+/**
+ * Sampling (`--sample-every`, `--sample-burst`, `--sample-threads`): Bounds the tracer's overhead for hot
+ * syscalls by only fully processing (i.e., reading args from tracee memory, formatting + unwinding) a subset of them
+ *   - 1-in-N per syscall nr
+ *   - Time based: First M syscalls per 100 ms window
+ *   - Per thread: Only 1-in-N threads (by tid), whose syscall sequences hence remain complete
+ *   A syscall is sampled only if all enabled policies agree
+ *   NOTE: Non-sampled syscalls are still counted (exactly) by the summary (`-c`, `-C`)
+ */
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+
+/* -- Consts -- */
+#define SAMPLING_BURST_WINDOW_NS (100ULL * 1000 * 1000)
+
+
+/* -- Types -- */
+typedef struct {
+    unsigned every_nth;                 /* `0` = disabled (same for all others) */
+    unsigned burst_per_window;
+    unsigned every_nth_thread;
+} sampling_policy_t;
+
+
+/* -- Function prototypes -- */
+void sampling_init(const sampling_policy_t* policy);
+void sampling_fin(void);
+
+void sampling_set_every_nth(unsigned every_nth);
+
+bool sampling_should_sample(pid_t tid, long syscall_nr);
+
+void sampling_fprint_stats(FILE* stream);
+void sampling_get_counts(uint64_t* sampled, uint64_t* seen);
+
+
+#endif /* SAMPLING_H */
@@ -0,0 +1,468 @@
+#include <linux/audit.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <common/error.h>
+#include <trace/syscallents.h>
+#include "seccomp_bpf.h"
+
+
+/* -- Consts -- */
+#if defined(__x86_64__)
+#  define SECCOMP_BPF_AUDIT_ARCH AUDIT_ARCH_X86_64
+#elif defined(__i386__)
+#  define SECCOMP_BPF_AUDIT_ARCH AUDIT_ARCH_I386
+#endif
+
+/* Args are only pushed down when they have the same width as in the tracer (i.e., as `long`) */
+#if __SIZEOF_LONG__ == 8 && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define SECCOMP_BPF_ARG_PUSHDOWN
+#  define ARG_LO_OFFSET(N) ((__u32)offsetof(struct seccomp_data, args[N]))
+#  define ARG_HI_OFFSET(N) ((__u32)offsetof(struct seccomp_data, args[N]) + (__u32)sizeof(__u32))
+#endif
+
+#define SIGN_BIT_32 0x80000000U         /* Flipped for signed comparisons (BPF jumps compare unsigned) */
+
+#define BLOCK_MAX_LEN    256
+#define BLOCK_MAX_LABELS 64
+#define BLOCK_MAX_FIXUPS 256
+
+#define LABEL_NEXT (-1)                 /* Fall through (i.e., jump offset 0) */
+
+
+/* -- Types -- */
+typedef enum {
+    ACTION_ALLOW,
+    ACTION_TRACE,
+    ACTION_BLOCK                        /* Depends on args  -> Own BPF block */
+} action_t;
+
+/* BPF code evaluating the filter expression for a specific syscall  (ends w/ `ret TRACE`, `ret ALLOW`) */
+typedef struct {
+    struct sock_filter insns[BLOCK_MAX_LEN];
+    int len;
+    int labels[BLOCK_MAX_LABELS];       /* Label -> insn idx */
+    int labels_count;
+    struct {
+        int insn;
+        int label;
+        enum { FIXUP_JT, FIXUP_JF, FIXUP_K } field;
+    } fixups[BLOCK_MAX_FIXUPS];
+    int fixups_count;
+    bool overflow;
+} bpf_block_t;
+
+typedef struct {
+    struct sock_filter* insns;
+    int len;
+} bpf_code_t;
+
+
+/* -- Globals -- */
+static __u32 trace_ret = SECCOMP_RET_TRACE;     /* Returned for traced syscalls */
+
+
+/* -- Function prototypes -- */
+static action_t syscall_action(const seccomp_bpf_spec_t* spec, long syscall_nr);
+static bool has_fd_or_path_args(long syscall_nr);
+static int add_block(bpf_code_t** blocks, int* blocks_count, const bpf_block_t* block);
+static bpf_code_t assemble_program(const action_t* actions, const int* block_of,
+                                   const bpf_code_t* blocks, int blocks_count);
+
+static bool block_gen(bpf_block_t* block, const filter_expr_t* expr, long syscall_nr);
+static void block_gen_node(bpf_block_t* block, const filter_expr_t* expr, int node_idx, long syscall_nr,
+                           bool negated, int t_label, int f_label);
+static void block_gen_arg_cmp(bpf_block_t* block, int arg_nr, filter_cmp_t cmp, long value,
+                              int t_label, int f_label);
+static void block_emit(bpf_block_t* block, struct sock_filter insn);
+static void block_emit_jump(bpf_block_t* block, __u16 code, __u32 k, int t_label, int f_label);
+static int block_new_label(bpf_block_t* block);
+static void block_place_label(bpf_block_t* block, int label);
+static bool block_resolve(bpf_block_t* block);
+
+
+/* -- Functions -- */
+/*
+ * Returns notification fd (when `spec->user_notif`), otherwise `0`
+ */
+int seccomp_bpf_install(const seccomp_bpf_spec_t* spec) {
+#ifndef SECCOMP_BPF_AUDIT_ARCH
+    LOG_ERROR_AND_DIE("seccomp-BPF isn't supported on this architecture");
+#else
+    trace_ret = (spec->user_notif) ? (SECCOMP_RET_USER_NOTIF) : (SECCOMP_RET_TRACE);
+
+/* 1. Determine action per syscall (+ generate BPF blocks for those depending on args) */
+    static action_t actions[SYSCALLS_ARR_SIZE];
+    static int block_of[SYSCALLS_ARR_SIZE];
+    bpf_code_t* blocks = NULL;
+    int blocks_count = 0;
+
+    bpf_block_t* const block = DIE_WHEN_ERRNO_VPTR( malloc(sizeof(*block)) );
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        actions[nr] = syscall_action(spec, nr);
+        if (ACTION_BLOCK == actions[nr]) {
+            if (block_gen(block, spec->filter, nr)) {
+                block_of[nr] = add_block(&blocks, &blocks_count, block);     /* Identical blocks (e.g., filter doesn't depend on nr) are shared */
+            } else {
+                actions[nr] = ACTION_TRACE;      /* Too complex  -> Conservatively trace */
+            }
+        }
+    }
+    free(block);
+
+/* 2. Assemble program  (fall back to w/o arg pushdown if too long) */
+    bpf_code_t prog = assemble_program(actions, block_of, blocks, blocks_count);
+    if (prog.len > BPF_MAXINSNS) {
+        free(prog.insns);
+        for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+            if (ACTION_BLOCK == actions[nr]) { actions[nr] = ACTION_TRACE; }
+        }
+        prog = assemble_program(actions, block_of, blocks, 0);
+    }
+    for (int i = 0; i < blocks_count; i++) {
+        free(blocks[i].insns);
+    }
+    free(blocks);
+
+/* 3. Install */
+    /* ELUCIDATION:
+     *   - `PR_SET_NO_NEW_PRIVS`: Required for installing seccomp filters w/o `CAP_SYS_ADMIN`
+     *                            (NOTE: `execve`(2) won't grant privileges anymore, e.g., via set-user-ID bit)
+     *   - `SECCOMP_FILTER_FLAG_NEW_LISTENER`: Returns notification fd (close-on-exec) for `SECCOMP_RET_USER_NOTIF`
+     */
+    const struct sock_fprog fprog = { .len = (unsigned short)prog.len, .filter = prog.insns };
+    DIE_WHEN_ERRNO( prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) );
+    int listener_fd = 0;
+    if (spec->user_notif) {
+        listener_fd = (int)DIE_WHEN_ERRNO( syscall(SYS_seccomp, SECCOMP_SET_MODE_FILTER, SECCOMP_FILTER_FLAG_NEW_LISTENER, &fprog) );
+    } else {
+        DIE_WHEN_ERRNO( prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &fprog) );
+    }
+    free(prog.insns);
+    return listener_fd;
+#endif /* SECCOMP_BPF_AUDIT_ARCH */
+}
+
+
+static action_t syscall_action(const seccomp_bpf_spec_t* spec, long syscall_nr) {
+    if (spec->required_syscalls && spec->required_syscalls[syscall_nr]) {
+        return ACTION_TRACE;
+    }
+    if ((spec->syscall_subset && !spec->syscall_subset[syscall_nr]) ||
+        (spec->only_fd_or_path_syscalls && !has_fd_or_path_args(syscall_nr))) {
+        return ACTION_ALLOW;
+    }
+
+    if (spec->filter) {
+        const syscall_event_t event = { .nr = syscall_nr };
+        switch (filter_expr_eval(spec->filter, &event, FILTER_FIELDS_NR)) {
+            case FILTER_NO_MATCH: return ACTION_ALLOW;
+            case FILTER_UNKNOWN:  return ACTION_BLOCK;
+            case FILTER_MATCH:
+            default:              break;
+        }
+    }
+    return ACTION_TRACE;
+}
+
+static bool has_fd_or_path_args(long syscall_nr) {
+    const syscall_entry_t* const scall = &syscalls[syscall_nr];
+    for (int arg_nr = 0; scall->name && arg_nr < scall->nargs; arg_nr++) {
+        if (ARG_FD == scall->args[arg_nr] || ARG_PATH == scall->args[arg_nr]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int add_block(bpf_code_t** blocks, int* blocks_count, const bpf_block_t* block) {
+    for (int i = 0; i < *blocks_count; i++) {
+        if (block->len == (*blocks)[i].len &&
+            !memcmp(block->insns, (*blocks)[i].insns, block->len * sizeof(block->insns[0]))) {
+            return i;
+        }
+    }
+
+    *blocks = DIE_WHEN_ERRNO_VPTR( realloc(*blocks, (*blocks_count + 1) * sizeof(**blocks)) );
+    bpf_code_t* const code = &(*blocks)[*blocks_count];
+    code->len = block->len;
+    code->insns = DIE_WHEN_ERRNO_VPTR( malloc(block->len * sizeof(block->insns[0])) );
+    memcpy(code->insns, block->insns, block->len * sizeof(block->insns[0]));
+    return (*blocks_count)++;
+}
+
+/*
+ * Program layout:
+ *   - Header:   Foreign arch / unknown syscall nr  -> ret TRACE
+ *   - Dispatch: `jeq <nr>; ja <target>` for each syscall whose action differs from the default (= majority) action
+ *   - ret <default>; ret <non-default>
+ *   - Blocks
+ */
+static bpf_code_t assemble_program(const action_t* actions, const int* block_of,
+                                   const bpf_code_t* blocks, int blocks_count) {
+    int counts[3] = { 0 };
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        counts[actions[nr]]++;
+    }
+    const action_t default_action = (counts[ACTION_ALLOW] >= counts[ACTION_TRACE]) ? (ACTION_ALLOW) : (ACTION_TRACE);
+    const __u32 default_ret = (ACTION_ALLOW == default_action) ? (SECCOMP_RET_ALLOW) : (trace_ret);
+    const __u32 other_ret = (ACTION_ALLOW == default_action) ? (trace_ret) : (SECCOMP_RET_ALLOW);
+
+    const int header_len = 6;
+    const int dispatch_len = 2 * (SYSCALLS_ARR_SIZE - counts[default_action]);
+    int blocks_len = 0;
+    for (int i = 0; i < blocks_count; i++) {
+        blocks_len += blocks[i].len;
+    }
+
+    bpf_code_t prog;
+    prog.len = header_len + dispatch_len + 2 + blocks_len;
+    prog.insns = DIE_WHEN_ERRNO_VPTR( calloc(prog.len, sizeof(*(prog.insns))) );
+
+    const int other_ret_idx = header_len + dispatch_len + 1;
+    int block_start_idx[blocks_count + 1];
+    block_start_idx[0] = other_ret_idx + 1;
+    for (int i = 1; i < blocks_count; i++) {
+        block_start_idx[i] = block_start_idx[i - 1] + blocks[i - 1].len;
+    }
+
+    int idx = 0;
+/* Header */
+    prog.insns[idx++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, arch));
+    prog.insns[idx++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, SECCOMP_BPF_AUDIT_ARCH, 1, 0);
+    prog.insns[idx++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, trace_ret);
+    prog.insns[idx++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr));
+    prog.insns[idx++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, MAX_SYSCALL_NUM, 0, 1);     /* Incl. x32 syscalls */
+    prog.insns[idx++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, trace_ret);
+
+/* Dispatch */
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        if (default_action == actions[nr]) {
+            continue;
+        }
+        const int target_idx = (ACTION_BLOCK == actions[nr]) ? (block_start_idx[block_of[nr]]) : (other_ret_idx);
+        prog.insns[idx++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (__u32)nr, 0, 1);
+        prog.insns[idx] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JA, (__u32)(target_idx - (idx + 1)), 0, 0);
+        idx++;
+    }
+    prog.insns[idx++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, default_ret);
+    prog.insns[idx++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, other_ret);
+
+/* Blocks */
+    for (int i = 0; i < blocks_count; i++) {
+        memcpy(prog.insns + idx, blocks[i].insns, blocks[i].len * sizeof(*(prog.insns)));
+        idx += blocks[i].len;
+    }
+
+    return prog;
+}
+
+
+/* - Block generation - */
+static bool block_gen(bpf_block_t* block, const filter_expr_t* expr, long syscall_nr) {
+    block->len = block->labels_count = block->fixups_count = 0;
+    block->overflow = false;
+
+    const int t_label = block_new_label(block);
+    const int f_label = block_new_label(block);
+    block_gen_node(block, expr, expr->root, syscall_nr, false, t_label, f_label);
+
+    block_place_label(block, t_label);
+    block_emit(block, (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, trace_ret));
+    block_place_label(block, f_label);
+    block_emit(block, (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW));
+
+    return block_resolve(block);
+}
+
+/*
+ * Generates "jumping code": Jumps to `t_label` if node evaluates to true (false if `negated`), otherwise to `f_label`
+ *   Comparisons which can't be expressed (e.g., of `rval`) are conservatively treated as true (regardless of `negated`)
+ */
+static void block_gen_node(bpf_block_t* block, const filter_expr_t* expr, int node_idx, long syscall_nr,
+                           bool negated, int t_label, int f_label) {
+    static const filter_cmp_t negated_cmps[] = {
+        [FILTER_CMP_EQ] = FILTER_CMP_NE, [FILTER_CMP_NE] = FILTER_CMP_EQ,
+        [FILTER_CMP_LT] = FILTER_CMP_GE, [FILTER_CMP_GE] = FILTER_CMP_LT,
+        [FILTER_CMP_LE] = FILTER_CMP_GT, [FILTER_CMP_GT] = FILTER_CMP_LE,
+    };
+    static const filter_cmp_t mirrored_cmps[] = {
+        [FILTER_CMP_EQ] = FILTER_CMP_EQ, [FILTER_CMP_NE] = FILTER_CMP_NE,
+        [FILTER_CMP_LT] = FILTER_CMP_GT, [FILTER_CMP_GT] = FILTER_CMP_LT,
+        [FILTER_CMP_LE] = FILTER_CMP_GE, [FILTER_CMP_GE] = FILTER_CMP_LE,
+    };
+
+    const filter_node_t* const node = &expr->nodes[node_idx];
+    const bool is_and = (FILTER_NODE_AND == node->type);
+    switch (node->type) {
+        case FILTER_NODE_NOT:
+            block_gen_node(block, expr, node->lhs, syscall_nr, !negated, t_label, f_label);
+            return;
+
+        /* De Morgan: `!(a && b)` = `!a || !b` */
+        case FILTER_NODE_AND:
+        case FILTER_NODE_OR: {
+            const int rhs_label = block_new_label(block);
+            if (is_and != negated) {
+                block_gen_node(block, expr, node->lhs, syscall_nr, negated, rhs_label, f_label);
+            } else {
+                block_gen_node(block, expr, node->lhs, syscall_nr, negated, t_label, rhs_label);
+            }
+            block_place_label(block, rhs_label);
+            block_gen_node(block, expr, node->rhs, syscall_nr, negated, t_label, f_label);
+            return;
+        }
+
+        case FILTER_NODE_CMP:
+        default: {
+            filter_operand_t lhs = node->operands[0];
+            filter_operand_t rhs = node->operands[1];
+            filter_cmp_t cmp = node->cmp;
+
+            /* `nr` is known */
+            if (lhs.is_field && FILTER_FIELD_NR == lhs.field) { lhs = (filter_operand_t){ .is_field = false, .value = syscall_nr }; }
+            if (rhs.is_field && FILTER_FIELD_NR == rhs.field) { rhs = (filter_operand_t){ .is_field = false, .value = syscall_nr }; }
+
+            if (!lhs.is_field && !rhs.is_field) {           /* Constant */
+                block_emit_jump(block, BPF_JMP | BPF_JA, 0,
+                                (filter_expr_cmp(cmp, lhs.value, rhs.value) != negated) ? (t_label) : (f_label), LABEL_NEXT);
+                return;
+            }
+
+            if (!lhs.is_field) {                            /* Normalize to `<field> <cmp> <const>` */
+                const filter_operand_t tmp = lhs;
+                lhs = rhs;
+                rhs = tmp;
+                cmp = mirrored_cmps[cmp];
+            }
+            if (!rhs.is_field && lhs.field >= FILTER_FIELD_ARG0 && lhs.field <= FILTER_FIELD_ARG5) {
+                block_gen_arg_cmp(block, lhs.field - FILTER_FIELD_ARG0, (negated) ? (negated_cmps[cmp]) : (cmp), rhs.value,
+                                  t_label, f_label);
+                return;
+            }
+
+            block_emit_jump(block, BPF_JMP | BPF_JA, 0, t_label, LABEL_NEXT);    /* Can't be expressed */
+            return;
+        }
+    }
+}
+
+/* Signed 64-bit comparison using 32-bit (unsigned) BPF comparisons: Upper halves (w/ flipped sign bit) first, then lower halves */
+static void block_gen_arg_cmp(bpf_block_t* block, int arg_nr, filter_cmp_t cmp, long value,
+                              int t_label, int f_label) {
+#ifdef SECCOMP_BPF_ARG_PUSHDOWN
+    const __u32 value_lo = (__u32)value;
+    const __u32 value_hi = (__u32)((unsigned long)value >> 32);
+
+    block_emit(block, (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ARG_HI_OFFSET(arg_nr)));
+    switch (cmp) {
+        case FILTER_CMP_EQ:
+        case FILTER_CMP_NE: {
+            const int eq_label = (FILTER_CMP_EQ == cmp) ? (t_label) : (f_label);
+            const int ne_label = (FILTER_CMP_EQ == cmp) ? (f_label) : (t_label);
+            block_emit_jump(block, BPF_JMP | BPF_JEQ | BPF_K, value_hi, LABEL_NEXT, ne_label);
+            block_emit(block, (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ARG_LO_OFFSET(arg_nr)));
+            block_emit_jump(block, BPF_JMP | BPF_JEQ | BPF_K, value_lo, eq_label, ne_label);
+            return;
+        }
+        case FILTER_CMP_LT:
+        case FILTER_CMP_GE: {
+            const int lt_label = (FILTER_CMP_LT == cmp) ? (t_label) : (f_label);
+            const int ge_label = (FILTER_CMP_LT == cmp) ? (f_label) : (t_label);
+            block_emit(block, (struct sock_filter)BPF_STMT(BPF_ALU | BPF_XOR | BPF_K, SIGN_BIT_32));
+            block_emit_jump(block, BPF_JMP | BPF_JGT | BPF_K, value_hi ^ SIGN_BIT_32, ge_label, LABEL_NEXT);
+            block_emit_jump(block, BPF_JMP | BPF_JEQ | BPF_K, value_hi ^ SIGN_BIT_32, LABEL_NEXT, lt_label);
+            block_emit(block, (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ARG_LO_OFFSET(arg_nr)));
+            block_emit_jump(block, BPF_JMP | BPF_JGE | BPF_K, value_lo, ge_label, lt_label);
+            return;
+        }
+        case FILTER_CMP_GT:
+        case FILTER_CMP_LE:
+        default: {
+            const int gt_label = (FILTER_CMP_GT == cmp) ? (t_label) : (f_label);
+            const int le_label = (FILTER_CMP_GT == cmp) ? (f_label) : (t_label);
+            block_emit(block, (struct sock_filter)BPF_STMT(BPF_ALU | BPF_XOR | BPF_K, SIGN_BIT_32));
+            block_emit_jump(block, BPF_JMP | BPF_JGT | BPF_K, value_hi ^ SIGN_BIT_32, gt_label, LABEL_NEXT);
+            block_emit_jump(block, BPF_JMP | BPF_JEQ | BPF_K, value_hi ^ SIGN_BIT_32, LABEL_NEXT, le_label);
+            block_emit(block, (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ARG_LO_OFFSET(arg_nr)));
+            block_emit_jump(block, BPF_JMP | BPF_JGT | BPF_K, value_lo, gt_label, le_label);
+            return;
+        }
+    }
+#else
+    (void)arg_nr; (void)cmp; (void)value; (void)f_label;
+    block_emit_jump(block, BPF_JMP | BPF_JA, 0, t_label, LABEL_NEXT);
+#endif /* SECCOMP_BPF_ARG_PUSHDOWN */
+}
+
+
+static void block_emit(bpf_block_t* block, struct sock_filter insn) {
+    if (block->len == BLOCK_MAX_LEN) {
+        block->overflow = true;
+        return;
+    }
+    block->insns[block->len++] = insn;
+}
+
+/* `BPF_JA`: Target in `k` (= `t_label`) */
+static void block_emit_jump(bpf_block_t* block, __u16 code, __u32 k, int t_label, int f_label) {
+    const bool is_ja = (BPF_JA == BPF_OP(code));
+    const int labels[2] = { t_label, f_label };
+
+    for (int i = 0; i < ((is_ja) ? (1) : (2)); i++) {
+        if (LABEL_NEXT == labels[i]) {
+            continue;
+        }
+        if (block->fixups_count == BLOCK_MAX_FIXUPS) {
+            block->overflow = true;
+            return;
+        }
+        block->fixups[block->fixups_count].insn = block->len;
+        block->fixups[block->fixups_count].label = labels[i];
+        block->fixups[block->fixups_count].field = (is_ja) ? (FIXUP_K) : ((!i) ? (FIXUP_JT) : (FIXUP_JF));
+        block->fixups_count++;
+    }
+    block_emit(block, (struct sock_filter)BPF_JUMP(code, k, 0, 0));
+}
+
+static int block_new_label(bpf_block_t* block) {
+    if (block->labels_count == BLOCK_MAX_LABELS) {
+        block->overflow = true;
+        return 0;
+    }
+    block->labels[block->labels_count] = -1;
+    return block->labels_count++;
+}
+
+static void block_place_label(bpf_block_t* block, int label) {
+    block->labels[label] = block->len;
+}
+
+static bool block_resolve(bpf_block_t* block) {
+    if (block->overflow) {
+        return false;
+    }
+
+    for (int i = 0; i < block->fixups_count; i++) {
+        const int insn_idx = block->fixups[i].insn;
+        const int offset = block->labels[block->fixups[i].label] - (insn_idx + 1);
+        if (offset < 0 || (FIXUP_K != block->fixups[i].field && offset > UINT8_MAX)) {     /* Only forward jumps; `jt`/`jf` are 8 bit */
+            return false;
+        }
+
+        switch (block->fixups[i].field) {
+            case FIXUP_JT: block->insns[insn_idx].jt = (__u8)offset; break;
+            case FIXUP_JF: block->insns[insn_idx].jf = (__u8)offset; break;
+            case FIXUP_K:
+            default:       block->insns[insn_idx].k = (__u32)offset; break;
+        }
+    }
+    return true;
+}
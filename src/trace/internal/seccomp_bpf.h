@@ -0,0 +1,38 @@
+/**
+ * seccomp-BPF prefilter (`--seccomp-bpf`)
+ *   Installed by the tracee itself (prior `exec`), so that syscalls which can't be traced
+ *   never stop the tracee (`SECCOMP_RET_ALLOW`); all others cause a `PTRACE_EVENT_SECCOMP` stop
+ *   (`SECCOMP_RET_TRACE`), which replaces the syscall-enter-stop
+ *
+ *   Pushed down into the BPF program:
+ *     - Syscall subset (`-e`) + syscalls w/o fd- / path args (when using path filters)
+ *     - Filter expression (`--filter`): Comparisons of `nr` & entry args w/ constants
+ *       (comparisons which BPF can't express, e.g., of `rval`, are conservatively treated as matching)
+ *
+ *   Also used by the seccomp-notif backend: Traced syscalls are then reported via a notification fd (`SECCOMP_RET_USER_NOTIF`)
+ *
+ *   NOTE: The filter is inherited by all children  -> They MUST be traced too (i.e., requires `-f`)
+ */
+#ifndef SECCOMP_BPF_H
+#define SECCOMP_BPF_H
+
+#include <stdbool.h>
+
+#include "filter_expr.h"
+
+
+/* -- Types -- */
+typedef struct {
+    const bool* syscall_subset;         /* `NULL` = all syscalls */
+    bool only_fd_or_path_syscalls;      /* Path- / fd filters are used */
+    const filter_expr_t* filter;        /* `NULL` = none */
+    const bool* required_syscalls;      /* Always traced (e.g., for maintaining fd tables); `NULL` = none */
+    bool user_notif;                    /* `SECCOMP_RET_USER_NOTIF` (instead of `SECCOMP_RET_TRACE`) */
+} seccomp_bpf_spec_t;
+
+
+/* -- Function prototypes -- */
+int seccomp_bpf_install(const seccomp_bpf_spec_t* spec);
+
+
+#endif /* SECCOMP_BPF_H */
@@ -0,0 +1,166 @@
+#include <dirent.h>
+#include <errno.h>
+#include <linux/seccomp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <common/error.h>
+#include <common/time_utils.h>
+#include "seccomp_notif.h"
+
+
+/* -- Consts -- */
+#define LISTENER_FD_LINK "anon_inode:seccomp notify"     /* Target of the notification fd's link in `/proc/<pid>/fd` */
+
+
+/* -- Globals -- */
+static struct {
+    int listener_fd;
+    size_t notif_count, resp_count;     /* # of structs per buffer (kernel's structs may be larger than ours) */
+} notifier = { .listener_fd = -1 };
+
+
+/* -- Function prototypes -- */
+static int find_listener_fd(pid_t tracee_pid);
+
+
+/* -- Functions -- */
+/*
+ * Whether the kernel supports user notifications (+ continuing notified syscalls) and picking up another process's fds
+ */
+bool seccomp_notif_available(void) {
+    __u32 action = SECCOMP_RET_USER_NOTIF;
+    if (-1 == syscall(SYS_seccomp, SECCOMP_GET_ACTION_AVAIL, 0, &action)) {
+        return false;
+    }
+    return !(-1 == syscall(SYS_pidfd_getfd, -1, 0, 0) && ENOSYS == errno);
+}
+
+
+/*
+ * Picks up the notification fd of the filter installed by the tracee (`-1` = tracee exited before installing one)
+ */
+int seccomp_notif_open(pid_t tracee_pid) {
+/* 0. Get pidfd  (readable once tracee has exited) */
+    const int pidfd = (int)DIE_WHEN_ERRNO( syscall(SYS_pidfd_open, tracee_pid, 0) );
+
+/* 1. Wait until tracee has installed its filter, then duplicate its notification fd */
+    for (;;) {
+        const int tracee_listener_fd = find_listener_fd(tracee_pid);
+        if (-1 != tracee_listener_fd &&
+            -1 != (notifier.listener_fd = (int)syscall(SYS_pidfd_getfd, pidfd, tracee_listener_fd, 0))) {
+            break;
+        }
+
+        struct pollfd tracee_exit = { .fd = pidfd, .events = POLLIN };
+        if (poll(&tracee_exit, 1, SECCOMP_NOTIF_LISTENER_POLL_INTERVAL_MS) > 0) {
+            close(pidfd);
+            return -1;
+        }
+    }
+    close(pidfd);
+
+/* 2. Determine buffer sizes */
+    struct seccomp_notif_sizes sizes;
+    DIE_WHEN_ERRNO( syscall(SYS_seccomp, SECCOMP_GET_NOTIF_SIZES, 0, &sizes) );
+    notifier.notif_count = (sizes.seccomp_notif + sizeof(struct seccomp_notif) - 1) / sizeof(struct seccomp_notif);
+    notifier.resp_count = (sizes.seccomp_notif_resp + sizeof(struct seccomp_notif_resp) - 1) / sizeof(struct seccomp_notif_resp);
+    return 0;
+}
+
+void seccomp_notif_close(void) {
+    if (-1 != notifier.listener_fd) {
+        close(notifier.listener_fd);
+        notifier.listener_fd = -1;
+    }
+}
+
+
+/*
+ * Receives next notification (may be called by multiple threads concurrently)
+ */
+seccomp_notif_recv_result_t seccomp_notif_recv(seccomp_notif_event_t* notif) {
+/* 0. Wait for notification  (`SECCOMP_IOCTL_NOTIF_RECV` itself keeps blocking once all tasks have exited) */
+    struct pollfd listener = { .fd = notifier.listener_fd, .events = POLLIN };
+    if (-1 == poll(&listener, 1, -1)) {
+        if (EINTR == errno) {
+            return SECCOMP_NOTIF_RETRY;
+        }
+        LOG_ERROR_AND_DIE("Waiting for seccomp notification failed -- %s", strerror(errno));
+    }
+    if (!(listener.revents & POLLIN)) {
+        return (listener.revents & (POLLHUP | POLLERR)) ? (SECCOMP_NOTIF_DONE) : (SECCOMP_NOTIF_RETRY);
+    }
+
+/* 1. Receive  (another thread may have been faster  -> Blocks until next notification, or is interrupted) */
+    struct seccomp_notif reqs[notifier.notif_count];
+    memset(reqs, 0, sizeof(reqs));      /* (MUST be zeroed) */
+    if (-1 == ioctl(notifier.listener_fd, SECCOMP_IOCTL_NOTIF_RECV, reqs)) {
+        if (EINTR == errno || ENOENT == errno) {
+            return SECCOMP_NOTIF_RETRY;
+        }
+        LOG_ERROR_AND_DIE("Receiving seccomp notification failed -- %s", strerror(errno));
+    }
+
+    notif->id = reqs[0].id;
+    memset(&notif->event, 0, sizeof(notif->event));
+    notif->event.tid = (pid_t)reqs[0].pid;
+    notif->event.nr = reqs[0].data.nr;
+    for (int i = 0; i < SYSCALL_MAX_ARGS; i++) {
+        notif->event.args[i] = (long)reqs[0].data.args[i];
+    }
+    notif->event.enter_ns = time_now_ns();
+    return SECCOMP_NOTIF_RECEIVED;
+}
+
+/*
+ * Whether notifying task is still blocked in the notified syscall (i.e., whether what has been read from its memory is valid)
+ */
+bool seccomp_notif_id_valid(uint64_t id) {
+    __u64 notif_id = id;
+    return 0 == ioctl(notifier.listener_fd, SECCOMP_IOCTL_NOTIF_ID_VALID, &notif_id);
+}
+
+/*
+ * Lets notifying task execute the syscall (as if it hadn't been notified)
+ */
+void seccomp_notif_continue(uint64_t id) {
+    struct seccomp_notif_resp resps[notifier.resp_count];
+    memset(resps, 0, sizeof(resps));
+    resps[0].id = id;
+    resps[0].flags = SECCOMP_USER_NOTIF_FLAG_CONTINUE;
+    if (-1 == ioctl(notifier.listener_fd, SECCOMP_IOCTL_NOTIF_SEND, resps) && ENOENT != errno) {     /* (`ENOENT`: Task died meanwhile) */
+        LOG_ERROR_AND_DIE("Continuing notified syscall failed -- %s", strerror(errno));
+    }
+}
+
+
+/* - Helpers - */
+static int find_listener_fd(pid_t tracee_pid) {
+    char fd_dir_path[64];
+    snprintf(fd_dir_path, sizeof(fd_dir_path), "/proc/%d/fd", tracee_pid);
+    DIR* const fd_dir = opendir(fd_dir_path);
+    if (!fd_dir) {
+        return -1;
+    }
+
+    int listener_fd = -1;
+    for (struct dirent* entry; -1 == listener_fd && (entry = readdir(fd_dir)); ) {
+        char link_path[sizeof(fd_dir_path) + sizeof(entry->d_name)], link_target[64];
+        snprintf(link_path, sizeof(link_path), "%s/%s", fd_dir_path, entry->d_name);
+        const ssize_t link_target_len = readlink(link_path, link_target, sizeof(link_target) - 1);
+        if (link_target_len < 0) {
+            continue;
+        }
+        link_target[link_target_len] = '\0';
+        if (!strcmp(LISTENER_FD_LINK, link_target)) {
+            listener_fd = atoi(entry->d_name);
+        }
+    }
+    closedir(fd_dir);
+    return listener_fd;
+}
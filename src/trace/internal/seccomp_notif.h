@@ -0,0 +1,56 @@
+/**
+ * seccomp user-notification backend (`--backend=seccomp-notif`)  -- ONLY for launched programs (not w/ `-p` / `-D`)
+ *   The tracee installs (prior `exec`) a seccomp filter returning `SECCOMP_RET_USER_NOTIF` for the selected syscalls
+ *   (generated like the `--seccomp-bpf` prefilter), i.e., only these are reported -- via a notification fd, w/o ptrace
+ *   (no signal- / group-stops; the filter is inherited by all children  -> Implies `-f`)
+ *     - The tracer picks up the notification fd from the tracee (`pidfd_getfd`(2)); since the fd doesn't survive `exec`,
+ *       `execve` / `execveat` are always notified (tracee is blocked in `exec` until the tracer has picked it up)
+ *     - Notifications may be received by multiple threads in parallel (`--notif-workers`)
+ *     - Args are read from tracee memory via `process_vm_readv`(2) while the notifying task is blocked in the syscall,
+ *       then the notification is validated (`SECCOMP_IOCTL_NOTIF_ID_VALID`: task may have died + its tid been reused)
+ *       and the syscall is continued (`SECCOMP_USER_NOTIF_FLAG_CONTINUE`)
+ *
+ *   Entry-only: Syscall results are never seen  -> Lines have no return value
+ *     Supported:     Decoded args, `-e`, `--filter` (on nr, args + tid), `-t` / `-tt` / `-ttt`, `-r`, `--tracer-cpu=<cpu>`
+ *     Not supported: `-T`, `-c` / `-C`, `-z` / `-Z`, `-y`, `-P` / `--fd`, `-n` / `-a`, `--filter` on rval / errno / duration,
+ *                    `--flight-recorder`, `--record`, sampling, escalation, `--stats`  (-> Falls back to ptrace)
+ */
+#ifndef SECCOMP_NOTIF_H
+#define SECCOMP_NOTIF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "syscall_event.h"
+
+
+/* -- Consts -- */
+#define SECCOMP_NOTIF_LISTENER_POLL_INTERVAL_MS 1       /* While waiting for the tracee to install its filter */
+
+
+/* -- Types -- */
+typedef struct {
+    uint64_t id;
+    syscall_event_t event;              /* `tid`, `nr`, `args` + `enter_ns` (= time of receipt) */
+} seccomp_notif_event_t;
+
+typedef enum {
+    SECCOMP_NOTIF_RECEIVED,
+    SECCOMP_NOTIF_RETRY,                /* Interrupted, or notifying task died meanwhile */
+    SECCOMP_NOTIF_DONE                  /* All tasks using the filter have exited */
+} seccomp_notif_recv_result_t;
+
+
+/* -- Function prototypes -- */
+bool seccomp_notif_available(void);
+
+int seccomp_notif_open(pid_t tracee_pid);
+void seccomp_notif_close(void);
+
+seccomp_notif_recv_result_t seccomp_notif_recv(seccomp_notif_event_t* notif);
+bool seccomp_notif_id_valid(uint64_t id);
+void seccomp_notif_continue(uint64_t id);
+
+
+#endif /* SECCOMP_NOTIF_H */
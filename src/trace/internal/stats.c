@@ -0,0 +1,178 @@
+#define _GNU_SOURCE             /* `fopencookie` */
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <common/error.h>
+#include "stats.h"
+
+
+/* -- Consts -- */
+#define STATS_MAX_TIMER_NESTING 8
+
+
+/* -- Globals -- */
+bool stats_enabled = false;
+uint64_t stats_counters[STATS_COUNTERS_COUNT];
+
+static struct {
+    uint64_t self_ns;
+    uint64_t calls;
+} timers[STATS_TIMERS_COUNT];
+
+static struct {                 /* Stack of running timers (for exclusive accounting) */
+    stats_timer_t timer;
+    uint64_t begin_ns;
+    uint64_t children_ns;
+} running_timers[STATS_MAX_TIMER_NESTING];
+static int running_timers_count;
+
+static uint64_t start_ns;
+static FILE* original_stderr;
+
+static const char* const timer_names[STATS_TIMERS_COUNT] = {
+    [STATS_TIMER_WAITPID]  = "waitpid",
+    [STATS_TIMER_GET_REGS] = "get regs",
+    [STATS_TIMER_MEM_READ] = "memory reads",
+    [STATS_TIMER_DECODE]   = "decode",
+    [STATS_TIMER_FORMAT]   = "format",
+    [STATS_TIMER_OUTPUT]   = "output writes",
+    [STATS_TIMER_UNWIND]   = "unwind",
+};
+
+
+/* -- Function prototypes -- */
+static uint64_t now_raw_ns(void);
+static ssize_t timed_write(void* cookie, const char* buf, size_t size);
+
+
+/* -- Functions -- */
+void stats_init(void) {
+    memset(timers, 0, sizeof(timers));
+    memset(stats_counters, 0, sizeof(stats_counters));
+    running_timers_count = 0;
+    stats_enabled = true;
+    start_ns = now_raw_ns();
+
+    /* Output is written via `stderr`  -> Replace it w/ (unbuffered) stream which times its writes */
+    static const cookie_io_functions_t timed_io = { .read = NULL, .write = timed_write, .seek = NULL, .close = NULL };
+    FILE* const timed_stderr = fopencookie(NULL, "w", timed_io);
+    if (timed_stderr && !setvbuf(timed_stderr, NULL, _IONBF, 0)) {
+        original_stderr = stderr;
+        stderr = timed_stderr;
+    } else {
+        LOG_WARN("Couldn't instrument output writes");
+    }
+}
+
+void stats_fin(void) {
+    if (original_stderr) {
+        fclose(stderr);
+        stderr = original_stderr;
+        original_stderr = NULL;
+    }
+    stats_enabled = false;
+}
+
+
+void stats_timer_begin(stats_timer_t timer) {
+    if (running_timers_count < STATS_MAX_TIMER_NESTING) {
+        running_timers[running_timers_count].timer = timer;
+        running_timers[running_timers_count].begin_ns = now_raw_ns();
+        running_timers[running_timers_count].children_ns = 0;
+    }
+    running_timers_count++;
+}
+
+void stats_timer_end(stats_timer_t timer) {
+    if (--running_timers_count >= STATS_MAX_TIMER_NESTING) {        /* (Too deeply nested  -> Not accounted) */
+        return;
+    }
+    if (running_timers_count < 0 || running_timers[running_timers_count].timer != timer) {
+        LOG_ERROR_AND_DIE("Unbalanced stats timer \"%s\"", timer_names[timer]);
+    }
+
+    const uint64_t elapsed_ns = now_raw_ns() - running_timers[running_timers_count].begin_ns;
+    timers[timer].self_ns += elapsed_ns - running_timers[running_timers_count].children_ns;
+    timers[timer].calls++;
+    if (running_timers_count > 0) {
+        running_timers[running_timers_count - 1].children_ns += elapsed_ns;
+    }
+}
+
+
+void stats_fprint(FILE* stream) {
+    const uint64_t total_ns = now_raw_ns() - start_ns;
+    const double total_s = (double)total_ns / 1e9;
+
+    fprintf(stream, "\n--- Tracer statistics (%.3fs) ---\n", total_s);
+    fprintf(stream, "%-16s %11s %8s %11s %9s\n"
+                    "---------------- ----------- -------- ----------- ---------\n",
+            "phase", "seconds", "% time", "calls", "ns/call");
+
+    uint64_t accounted_ns = 0;
+    for (int t = 0; t < STATS_TIMERS_COUNT; t++) {
+        accounted_ns += timers[t].self_ns;
+        if (!timers[t].calls) {
+            continue;
+        }
+        fprintf(stream, "%-16s %11.6f %8.2f %11llu %9llu\n",
+                timer_names[t], (double)timers[t].self_ns / 1e9,
+                (total_ns) ? (100.0 * (double)timers[t].self_ns / (double)total_ns) : (0.0),
+                (unsigned long long)timers[t].calls,
+                (unsigned long long)(timers[t].self_ns / timers[t].calls));
+    }
+    const uint64_t other_ns = (total_ns > accounted_ns) ? (total_ns - accounted_ns) : (0);
+    fprintf(stream, "%-16s %11.6f %8.2f\n", "other",
+            (double)other_ns / 1e9, (total_ns) ? (100.0 * (double)other_ns / (double)total_ns) : (0.0));
+
+    fprintf(stream, "\n%-24s %llu (%.0f/s)\n"
+                    "%-24s %llu calls, %llu bytes\n"
+                    "%-24s %llu calls, %llu bytes\n"
+                    "%-24s %llu bytes\n"
+                    "%-24s %llu\n"
+                    "%-24s %llu\n"
+                    "%-24s %llu\n",
+            "stops:",
+            (unsigned long long)stats_counters[STATS_COUNTER_STOPS],
+            (total_s > 0) ? ((double)stats_counters[STATS_COUNTER_STOPS] / total_s) : (0.0),
+            "memory reads (ptrace):",
+            (unsigned long long)stats_counters[STATS_COUNTER_PTRACE_READ_CALLS],
+            (unsigned long long)stats_counters[STATS_COUNTER_PTRACE_READ_BYTES],
+            "memory reads (vm_readv):",
+            (unsigned long long)stats_counters[STATS_COUNTER_VM_READV_CALLS],
+            (unsigned long long)stats_counters[STATS_COUNTER_VM_READV_BYTES],
+            "output:", (unsigned long long)stats_counters[STATS_COUNTER_OUTPUT_BYTES],
+            "dropped events:", (unsigned long long)stats_counters[STATS_COUNTER_DROPPED_EVENTS],
+            "allocations:", (unsigned long long)stats_counters[STATS_COUNTER_ALLOCS],
+            "tracer rebinds:", (unsigned long long)stats_counters[STATS_COUNTER_TRACER_REBINDS]);
+}
+
+
+/* - Helpers - */
+static uint64_t now_raw_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static ssize_t timed_write(void* cookie, const char* buf, size_t size) {
+    (void)cookie;
+
+    STATS_TIMER_BEGIN(STATS_TIMER_OUTPUT);
+    size_t written = 0;
+    while (written < size) {
+        const ssize_t rc = write(STDERR_FILENO, buf + written, size - written);
+        if (-1 == rc) {
+            if (EINTR == errno) { continue; }
+            break;
+        }
+        written += (size_t)rc;
+    }
+    STATS_TIMER_END(STATS_TIMER_OUTPUT);
+
+    STATS_COUNT(STATS_COUNTER_OUTPUT_BYTES, written);
+    return (written) ? ((ssize_t)written) : (-1);
+}
@@ -0,0 +1,70 @@
+/**
+ * Tracer self-instrumentation (`--stats`): Where does the tracer spend its time ?
+ *   - Timers of hot path phases (exclusive, i.e., time spent in nested phases is only accounted to those),
+ *     based on `CLOCK_MONOTONIC_RAW` (vDSO  -> no syscall)
+ *   - Counters (stops, memory reads, dropped events, allocations, ...)
+ *   Disabled by default  -> Costs only a (predictable) branch per instrumentation point
+ */
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <common/compiler.h>
+
+
+/* -- Types -- */
+typedef enum {
+    STATS_TIMER_WAITPID,
+    STATS_TIMER_GET_REGS,
+    STATS_TIMER_MEM_READ,
+    STATS_TIMER_DECODE,
+    STATS_TIMER_FORMAT,
+    STATS_TIMER_OUTPUT,
+    STATS_TIMER_UNWIND,
+    STATS_TIMERS_COUNT
+} stats_timer_t;
+
+typedef enum {
+    STATS_COUNTER_STOPS,
+    STATS_COUNTER_PTRACE_READ_CALLS,
+    STATS_COUNTER_PTRACE_READ_BYTES,
+    STATS_COUNTER_VM_READV_CALLS,
+    STATS_COUNTER_VM_READV_BYTES,
+    STATS_COUNTER_OUTPUT_BYTES,
+    STATS_COUNTER_DROPPED_EVENTS,       /* Events which passed all filters, but weren't printed (e.g., not sampled) */
+    STATS_COUNTER_ALLOCS,
+    STATS_COUNTER_TRACER_REBINDS,       /* CPU affinity changes of tracer (`--tracer-cpu=auto`) */
+    STATS_COUNTERS_COUNT
+} stats_counter_t;
+
+
+/* -- Globals -- */
+extern bool stats_enabled;
+extern uint64_t stats_counters[STATS_COUNTERS_COUNT];
+
+
+/* -- Function prototypes -- */
+void stats_init(void);
+void stats_fin(void);
+
+void stats_timer_begin(stats_timer_t timer);
+void stats_timer_end(stats_timer_t timer);
+
+void stats_fprint(FILE* stream);
+
+
+/* -- Macros -- */
+#define STATS_TIMER_BEGIN(TIMER) \
+  do { if (BRANCH_UNLIKELY(stats_enabled)) { stats_timer_begin(TIMER); } } while (0)
+
+#define STATS_TIMER_END(TIMER) \
+  do { if (BRANCH_UNLIKELY(stats_enabled)) { stats_timer_end(TIMER); } } while (0)
+
+#define STATS_COUNT(COUNTER, N) \
+  do { if (BRANCH_UNLIKELY(stats_enabled)) { stats_counters[COUNTER] += (N); } } while (0)
+
+
+#endif /* STATS_H */
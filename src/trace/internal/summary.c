@@ -0,0 +1,146 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include <trace/syscallents.h>
+#include "calibration.h"
+#include "syscalls.h"
+#include "summary.h"
+
+
+/* -- Types -- */
+typedef struct {
+    long nr;
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} summary_entry_t;
+
+struct summary_table {
+    summary_entry_t entries[SYSCALLS_ARR_SIZE];     /* Indexed by syscall nr */
+};
+
+
+/* -- Globals -- */
+static summary_table_t* summary = NULL;
+
+
+/* -- Function prototypes -- */
+static int cmp_entries_by_time(const void* lhs, const void* rhs);
+
+
+/* -- Functions -- */
+void summary_init(void) {
+    summary = summary_table_new();
+}
+
+void summary_fin(void) {
+    summary_table_free(summary);
+    summary = NULL;
+}
+
+void summary_record(const syscall_event_t* event) {
+    summary_table_record(summary, event);
+}
+
+void summary_fprint(FILE* stream) {
+    if (calibration_stop_roundtrip_ns) {
+        fprintf(stream, "(durations corrected by calibrated ptrace stop round-trip of %llu ns)\n",
+                (unsigned long long)calibration_stop_roundtrip_ns);
+    }
+    summary_table_fprint(stream, summary);
+}
+
+
+summary_table_t* summary_table_new(void) {
+    summary_table_t* const table = DIE_WHEN_ERRNO_VPTR( calloc(1, sizeof(*table)) );
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        table->entries[nr].nr = nr;
+    }
+    return table;
+}
+
+void summary_table_free(summary_table_t* table) {
+    free(table);
+}
+
+
+void summary_table_record(summary_table_t* table, const syscall_event_t* event) {
+    if (event->nr < 0 || event->nr > MAX_SYSCALL_NUM) {
+        return;
+    }
+
+    summary_entry_t* const entry = &table->entries[event->nr];
+    const uint64_t duration_ns = calibration_correct_duration_ns(event->exit_ns - event->enter_ns);
+    entry->calls++;
+    entry->errors += (0 != syscall_event_errno(event));
+    entry->total_ns += duration_ns;
+    if (duration_ns > entry->max_ns) {
+        entry->max_ns = duration_ns;
+    }
+}
+
+
+void summary_table_fprint(FILE* stream, const summary_table_t* table) {
+/* 1. Sort (copy of) entries by time spent */
+    summary_entry_t* const sorted = DIE_WHEN_ERRNO_VPTR( malloc(SYSCALLS_ARR_SIZE * sizeof(*sorted)) );
+    memcpy(sorted, table->entries, SYSCALLS_ARR_SIZE * sizeof(*sorted));
+    qsort(sorted, SYSCALLS_ARR_SIZE, sizeof(*sorted), cmp_entries_by_time);
+
+    uint64_t total_calls = 0, total_errors = 0, total_ns = 0;
+    for (long i = 0; i < SYSCALLS_ARR_SIZE; i++) {
+        total_calls += sorted[i].calls;
+        total_errors += sorted[i].errors;
+        total_ns += sorted[i].total_ns;
+    }
+
+/* 2. Print table */
+    fprintf(stream, "%% time     seconds  usecs/call   max usecs     calls    errors syscall\n"
+                    "------ ----------- ----------- ----------- --------- --------- ----------------\n");
+    for (long i = 0; i < SYSCALLS_ARR_SIZE && sorted[i].calls; i++) {
+        const summary_entry_t* const entry = &sorted[i];
+        const char* const scall_name = syscalls_get_name(entry->nr);
+
+        fprintf(stream, "%6.2f %11.6f %11llu %11llu %9llu ",
+                (total_ns) ? (100.0 * (double)entry->total_ns / (double)total_ns) : (0.0),
+                (double)entry->total_ns / 1e9,
+                (unsigned long long)(entry->total_ns / 1000 / entry->calls),
+                (unsigned long long)(entry->max_ns / 1000),
+                (unsigned long long)entry->calls);
+        if (entry->errors) {
+            fprintf(stream, "%9llu ", (unsigned long long)entry->errors);
+        } else {
+            fprintf(stream, "%9s ", "");
+        }
+        if (scall_name) {
+            fprintf(stream, "%s\n", scall_name);
+        } else {
+            fprintf(stream, "sys_%ld\n", entry->nr);
+        }
+    }
+    fprintf(stream, "------ ----------- ----------- ----------- --------- --------- ----------------\n"
+                    "100.00 %11.6f %11llu %11s %9llu %9llu total\n",
+            (double)total_ns / 1e9,
+            (unsigned long long)((total_calls) ? (total_ns / 1000 / total_calls) : (0)),
+            "",
+            (unsigned long long)total_calls, (unsigned long long)total_errors);
+
+    free(sorted);
+}
+
+
+/* - Helpers - */
+static int cmp_entries_by_time(const void* lhs, const void* rhs) {
+    const summary_entry_t* const l = lhs;
+    const summary_entry_t* const r = rhs;
+
+    if (l->total_ns != r->total_ns) {
+        return (l->total_ns < r->total_ns) ? (1) : (-1);
+    }
+    if (l->calls != r->calls) {
+        return (l->calls < r->calls) ? (1) : (-1);
+    }
+    return (l->nr > r->nr) - (l->nr < r->nr);
+}
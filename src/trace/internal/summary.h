@@ -0,0 +1,32 @@
+/**
+ * Syscall summary (`-c`): Per syscall counts of calls, errors + time spent (printed when tracing stops)
+ *   Cheap, since only raw syscall events are accumulated (i.e., no tracee memory reads nor formatting)
+ *   Additional tables (e.g., per executable, see `proctree.h`) may be kept via `summary_table_xxx`
+ */
+#ifndef SUMMARY_H
+#define SUMMARY_H
+
+#include <stdio.h>
+
+#include "syscall_event.h"
+
+
+/* -- Types -- */
+typedef struct summary_table summary_table_t;
+
+
+/* -- Function prototypes -- */
+void summary_init(void);
+void summary_fin(void);
+
+void summary_record(const syscall_event_t* event);
+
+void summary_fprint(FILE* stream);
+
+summary_table_t* summary_table_new(void);
+void summary_table_free(summary_table_t* table);
+void summary_table_record(summary_table_t* table, const syscall_event_t* event);
+void summary_table_fprint(FILE* stream, const summary_table_t* table);
+
+
+#endif /* SUMMARY_H */
@@ -0,0 +1,57 @@
+/**
+ * Hand-written syscall decoders
+ *   Replace the generated decoders (see `syscalldecoders.c` in the build dir) for syscalls
+ *   whose args can't be decoded by type only (e.g., structs, arrays)
+ *   NOTE: Decoders are detected by the generator via their signature `void syscall_decode_<name>(`
+ */
+#include <stdio.h>
+
+#include <trace/syscalldecoders.h>
+#include "ptrace_utils.h"
+
+
+/* -- Consts -- */
+#define STR_ARRAY_MAX_ELEMENTS_TO_BE_PRINTED 32
+
+
+/* -- Function prototypes -- */
+static void fprint_str_array(FILE *stream, pid_t tid, long addr);
+
+
+/* -- Functions -- */
+void syscall_decode_execve(FILE *stream, pid_t tid, const long args[SYSCALL_MAX_ARGS]) {
+    syscall_decoder_fprint_str(stream, tid, args[0], -1);
+    fputs(", ", stream);
+    fprint_str_array(stream, tid, args[1]);
+    fputs(", ", stream);
+    syscall_decoder_fprint_ptr(stream, args[2]);     /* `envp` is (like strace w/o `-v`) only printed as address */
+}
+
+
+/* - Helpers - */
+/*
+ * Prints NULL-terminated array of strings (e.g., `argv`) in tracee's address space
+ * Falls back to printing the address if array can't be read
+ */
+static void fprint_str_array(FILE *stream, pid_t tid, long addr) {
+    unsigned long element_addr;
+    if (!addr || -1 == ptrace_read_word(tid, addr, &element_addr)) {
+        syscall_decoder_fprint_ptr(stream, addr);
+        return;
+    }
+
+    fputc('[', stream);
+    for (int i = 0; element_addr; ) {
+        if (i > 0) { fputs(", ", stream); }
+        if (i >= STR_ARRAY_MAX_ELEMENTS_TO_BE_PRINTED) {
+            fputs("...", stream);
+            break;
+        }
+        syscall_decoder_fprint_str(stream, tid, (long)element_addr, -1);
+
+        if (-1 == ptrace_read_word(tid, addr + (++i * sizeof(element_addr)), &element_addr)) {
+            break;
+        }
+    }
+    fputc(']', stream);
+}
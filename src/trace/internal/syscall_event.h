@@ -0,0 +1,35 @@
+/**
+ * Raw (i.e., not yet formatted) syscall event
+ *   Captured on syscall-enter (nr, args) & completed on syscall-exit (return value)
+ */
+#ifndef SYSCALL_EVENT_H
+#define SYSCALL_EVENT_H
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <trace/syscall_types.h>
+
+
+/* -- Consts -- */
+#define SYSCALL_EVENT_MAX_ERRNO 4095        /* Return values in [-4095, -1] are errors (see kernel's `IS_ERR_VALUE`) */
+
+
+/* -- Types -- */
+typedef struct {
+    pid_t tid;
+    long nr;
+    long args[SYSCALL_MAX_ARGS];
+    long rtn_val;
+    uint64_t enter_ns;                      /* `CLOCK_MONOTONIC` timestamps (only taken when required, otherwise 0) */
+    uint64_t exit_ns;
+} syscall_event_t;
+
+
+/* -- Functions -- */
+static inline long syscall_event_errno(const syscall_event_t* event) {
+    return (event->rtn_val < 0 && event->rtn_val >= -SYSCALL_EVENT_MAX_ERRNO) ? (-(event->rtn_val)) : (0);
+}
+
+
+#endif /* SYSCALL_EVENT_H */
@@ -10,7 +10,9 @@ const char* arg_type_enum_to_str(arg_type_t arg) {
     static const char* strings[] = {
             [ARG_INT] = "ARG_INT",
             [ARG_PTR] = "ARG_PTR",
-            [ARG_STR] = "ARG_STR"
+            [ARG_STR] = "ARG_STR",
+            [ARG_FD]  = "ARG_FD",
+            [ARG_PATH] = "ARG_PATH"
     };
     return strings[arg];
 }
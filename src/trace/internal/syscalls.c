@@ -1,4 +1,5 @@
 #include <ctype.h>
+#include <fcntl.h>
 #include <locale.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -6,13 +7,23 @@
 
 #include <common/error.h>
 #include <trace/syscallents.h>
+#include <trace/syscalldecoders.h>
+#include "errnos.h"
 #include "ptrace_utils.h"
+#include "stats.h"
 #include <trace/syscall_types.h>
+#include "syscall_event.h"
 #include "syscalls.h"
+#include "tracees.h"
+
+
+/* -- Globals -- */
+static bool annotate_fds = false;
+static bool decode_payloads = true;     /* Read (+ decode) args from tracee memory (otherwise args are printed raw) */
 
 
 /* -- Function prototypes -- */
-static long from_regs_struct_get_syscall_arg(struct user_regs_struct_full *regs, int which);
+static void fprint_args(FILE *stream, pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]);
 static void fprint_str_esc(FILE *stream, char *str, size_t str_len);
 
 
@@ -37,9 +48,121 @@ long syscalls_get_nr(char* syscall_name) {
     return -1L;
 }
 
+/*
+ * Nr of syscall (in native syscall table; `SYSCALLS_NR_UNKNOWN` if it has none) the task is stopped in
+ *   The ABI is determined on each stop from the regs (which have been read anyway), i.e., it's never stale (e.g., after
+ *   `exec`ing a binary of another ABI)
+ *   NOTE: 64-bit tasks using the 32-bit syscall entry (`int 0x80`) aren't detected (their code segment remains the 64-bit
+ *         one; only `PTRACE_GET_SYSCALL_INFO`'s arch tells, which would cost another ptrace call per stop)  -> Such
+ *         syscalls are decoded as native ones
+ *     - 32-bit tasks: Mapped onto native syscall w/ same kernel entry point (i.e., same signature; args are in other
+ *                     regs, see `syscalls_get_args`)  -> i386 specific ones (e.g., `mmap2`, `socketcall`) and ones w/
+ *                     another calling convention than their native namesake (e.g., `mmap` = `old_mmap`) are
+ *                     `SYSCALLS_NR_UNKNOWN`
+ *     - x32 tasks:    Nr w/ `__X32_SYSCALL_BIT` set (x32 specific syscalls are in the native table, as `__SNR_COMPAT_xxx`)
+ */
+long syscalls_get_nr_of_regs(struct user_regs_struct_full *regs) {
+    long syscall_nr = USER_REGS_STRUCT_SC_NO((*regs));
+    if (NO_SYSCALL == syscall_nr) {
+        return NO_SYSCALL;
+    }
+
+#ifdef HAVE_COMPAT32_SYSCALLS
+    if (USER_REGS_STRUCT_SC_IS_COMPAT32((*regs))) {
+        return (syscall_nr >= 0 && syscall_nr <= MAX_COMPAT32_SYSCALL_NUM && -1 != syscalls_compat32_to_native[syscall_nr]) ?
+               (syscalls_compat32_to_native[syscall_nr]) : (SYSCALLS_NR_UNKNOWN);
+    }
+#endif /* HAVE_COMPAT32_SYSCALLS */
+#ifdef __X32_SYSCALL_BIT
+    syscall_nr &= ~(long)__X32_SYSCALL_BIT;
+#endif /* __X32_SYSCALL_BIT */
+    return (syscall_nr >= 0 && syscall_nr <= MAX_SYSCALL_NUM) ? (syscall_nr) : (SYSCALLS_NR_UNKNOWN);
+}
+
+void syscalls_get_args(struct user_regs_struct_full *regs, long args[SYSCALL_MAX_ARGS]) {
+#ifdef HAVE_COMPAT32_SYSCALLS
+    if (USER_REGS_STRUCT_SC_IS_COMPAT32((*regs))) {
+        args[0] = USER_REGS_STRUCT_SC_COMPAT32_ARG0((*regs));
+        args[1] = USER_REGS_STRUCT_SC_COMPAT32_ARG1((*regs));
+        args[2] = USER_REGS_STRUCT_SC_COMPAT32_ARG2((*regs));
+        args[3] = USER_REGS_STRUCT_SC_COMPAT32_ARG3((*regs));
+        args[4] = USER_REGS_STRUCT_SC_COMPAT32_ARG4((*regs));
+        args[5] = USER_REGS_STRUCT_SC_COMPAT32_ARG5((*regs));
+
+        /* Sign-extend int args (e.g., `AT_FDCWD`, `-1`); ptrs remain zero-extended */
+        const long syscall_nr = syscalls_get_nr_of_regs(regs);
+        if (syscalls_get_name(syscall_nr)) {
+            const syscall_entry_t* const scall = &syscalls[syscall_nr];
+            for (int arg_nr = 0; arg_nr < scall->nargs; arg_nr++) {
+                if (ARG_INT == scall->args[arg_nr] || ARG_FD == scall->args[arg_nr]) {
+                    args[arg_nr] = (long)(int)args[arg_nr];
+                }
+            }
+        }
+        return;
+    }
+#endif /* HAVE_COMPAT32_SYSCALLS */
+    args[0] = USER_REGS_STRUCT_SC_ARG0((*regs));
+    args[1] = USER_REGS_STRUCT_SC_ARG1((*regs));
+    args[2] = USER_REGS_STRUCT_SC_ARG2((*regs));
+    args[3] = USER_REGS_STRUCT_SC_ARG3((*regs));
+    args[4] = USER_REGS_STRUCT_SC_ARG4((*regs));
+    args[5] = USER_REGS_STRUCT_SC_ARG5((*regs));
+}
+
 
-void syscalls_print_args(__attribute__((unused)) pid_t tid, struct user_regs_struct_full *regs) {   // `user_regs_struct_full *regs` only for efficiency's sake (not necessary, could be fetched again ...)
-    const long syscall_nr = USER_REGS_STRUCT_SC_NO((*regs));
+void syscalls_print_args(FILE *stream, pid_t tid, struct user_regs_struct_full *regs) {
+    const long syscall_nr = syscalls_get_nr_of_regs(regs);
+
+    syscall_decoder_t decoder;
+    if ((syscall_nr >= 0 && syscall_nr <= MAX_SYSCALL_NUM) && (decoder = syscall_decoders[syscall_nr])) {
+        long args[SYSCALL_MAX_ARGS];
+        syscalls_get_args(regs, args);
+        decoder(stream, tid, args);
+    } else {
+        syscalls_print_args_generic(stream, tid, regs);     /* Fallback for syscalls w/o (generated) decoder */
+    }
+}
+
+/* Same as `syscalls_print_args`, but based on raw (i.e., previously captured) args */
+void syscalls_fprint_args(FILE *stream, pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]) {
+    STATS_TIMER_BEGIN(STATS_TIMER_DECODE);
+    fprint_args(stream, tid, syscall_nr, args);
+    STATS_TIMER_END(STATS_TIMER_DECODE);
+}
+
+static void fprint_args(FILE *stream, pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]) {
+    if (!decode_payloads && syscalls_get_name(syscall_nr)) {
+        const syscall_entry_t* const scall = &syscalls[syscall_nr];
+        for (int arg_nr = 0; arg_nr < scall->nargs; arg_nr++) {
+            if (arg_nr > 0) { fputs(", ", stream); }
+            if (ARG_INT == scall->args[arg_nr] || ARG_FD == scall->args[arg_nr]) {
+                fprintf(stream, "%ld", args[arg_nr]);
+            } else {
+                syscall_decoder_fprint_ptr(stream, args[arg_nr]);
+            }
+        }
+        return;
+    }
+
+    syscall_decoder_t decoder;
+    if ((syscall_nr >= 0 && syscall_nr <= MAX_SYSCALL_NUM) && (decoder = syscall_decoders[syscall_nr])) {
+        decoder(stream, tid, args);
+        return;
+    }
+
+    /* Fallback for syscalls w/o (generated) decoder */
+    LOG_WARN("Unknown syscall w/ nr %ld", syscall_nr);
+    for (int arg_nr = 0; arg_nr < SYSCALL_MAX_ARGS; arg_nr++) {
+        if (arg_nr > 0) { fputs(", ", stream); }
+        syscall_decoder_fprint_ptr(stream, args[arg_nr]);
+    }
+}
+
+void syscalls_print_args_generic(FILE *stream, pid_t tid, struct user_regs_struct_full *regs) {   // `user_regs_struct_full *regs` only for efficiency's sake (not necessary, could be fetched again ...)
+    const long syscall_nr = syscalls_get_nr_of_regs(regs);
+    long args[SYSCALL_MAX_ARGS];
+    syscalls_get_args(regs, args);
 
     const syscall_entry_t* ent = NULL;
     int nargs = SYSCALL_MAX_ARGS;
@@ -52,55 +175,103 @@ void syscalls_print_args(__attribute__((unused)) pid_t tid, struct user_regs_str
     }
 
     for (int arg_nr = 0; arg_nr < nargs; arg_nr++) {
-        long arg = from_regs_struct_get_syscall_arg(regs, arg_nr);
+        long arg = args[arg_nr];
         long type = ent ? ent->args[arg_nr] : ARG_PTR;      /* Default to `ARG_PTR` */
 
         switch (type) {
             case ARG_INT:
-                fprintf(stderr, "%ld", arg);
+                syscall_decoder_fprint_int(stream, arg);
                 break;
-            case ARG_STR: {
+            case ARG_FD:
+                syscall_decoder_fprint_fd(stream, tid, arg);
+                break;
+            case ARG_STR:
+            case ARG_PATH: {
                 const long bytes_to_read = (__SNR_write == syscall_nr || __SNR_read == syscall_nr) ?        // TODO: REVISE
-                                                 (from_regs_struct_get_syscall_arg(regs, 2)) :
+                                                 (args[2]) :
                                                  (-1);
-
-                char* ptrace_read_str;
-                size_t ptrace_read_str_len = ptrace_read_string(tid, arg, bytes_to_read, &ptrace_read_str);
-
-                // fprintf(stderr, "\"%s\"", strval);
-                fprintf(stderr, "\""); fprint_str_esc(stderr, ptrace_read_str, ptrace_read_str_len); fprintf(stderr, "\"");
-
-                free(ptrace_read_str);
+                syscall_decoder_fprint_str(stream, tid, arg, bytes_to_read);
                 break;
             }
             default:    /* e.g., ARG_PTR */
-                fprintf(stderr, "0x%lx", (unsigned long)arg);
+                syscall_decoder_fprint_ptr(stream, arg);
                 break;
         }
         if (arg_nr != nargs -1)
-            fprintf(stderr, ", ");
+            fputs(", ", stream);
+    }
+}
+
+void syscall_decoder_fprint_str(FILE *stream, pid_t tid, long addr, long bytes_to_read) {
+    char* ptrace_read_str;
+    size_t ptrace_read_str_len = ptrace_read_string(tid, addr, bytes_to_read, &ptrace_read_str);
+
+    // fprintf(stream, "\"%s\"", strval);
+    fputc('"', stream); fprint_str_esc(stream, ptrace_read_str, ptrace_read_str_len); fputc('"', stream);
+
+    free(ptrace_read_str);
+}
+
+void syscall_decoder_fprint_fd(FILE *stream, pid_t tid, long fd) {
+    if (AT_FDCWD == (int)fd) {
+        fputs("AT_FDCWD", stream);
+        return;
+    }
+
+    fprintf(stream, "%d", (int)fd);
+    if (annotate_fds) {
+        syscalls_fprint_fd_path(stream, tid, fd);
     }
 }
 
-static long from_regs_struct_get_syscall_arg(struct user_regs_struct_full *regs, int which) {
-    switch (which) {
-        case 0: return USER_REGS_STRUCT_SC_ARG0((*regs));
-        case 1: return USER_REGS_STRUCT_SC_ARG1((*regs));
-        case 2: return USER_REGS_STRUCT_SC_ARG2((*regs));
-        case 3: return USER_REGS_STRUCT_SC_ARG3((*regs));
-        case 4: return USER_REGS_STRUCT_SC_ARG4((*regs));
-        case 5: return USER_REGS_STRUCT_SC_ARG5((*regs));
+void syscalls_fprint_fd_path(FILE *stream, pid_t tid, long fd) {
+    tracee_t* const tracee = tracees_get_or_add(tid);
 
-        default: return -1L;        /* Invalid */
+    const char* path;
+    if ((path = fds_get_path(tracees_get_fds(tracee), tid, (int)fd))) {
+        fputc('<', stream); fprint_str_esc(stream, (char*)path, strlen(path)); fputc('>', stream);
     }
 }
 
+/*
+ * Prints return value; errors (strace like) w/ symbolic errno name, e.g., `-1 ENOENT (No such file or directory)`
+ */
+void syscalls_fprint_rtn_val(FILE *stream, long rtn_val) {
+    if (rtn_val >= 0 || rtn_val < -SYSCALL_EVENT_MAX_ERRNO) {
+        fprintf(stream, "%ld", rtn_val);
+        return;
+    }
+
+    const long err = -rtn_val;
+    const char* const err_name = errnos_get_name(err);
+    if (!err_name) {
+        fprintf(stream, "-1 (errno %ld)", err);
+    } else if (err >= ERRNOS_FIRST_KERNEL_INTERNAL) {      /* Not seen by user space (syscall will be restarted) */
+        fprintf(stream, "? %s", err_name);
+    } else {
+        fprintf(stream, "-1 %s (%s)", err_name, strerror((int)err));
+    }
+}
+
+void syscalls_set_payload_decoding(bool enabled) {
+    decode_payloads = enabled;
+}
+
+bool syscalls_get_payload_decoding(void) {
+    return decode_payloads;
+}
+
+void syscalls_set_fd_annotation(bool enabled) {
+    annotate_fds = enabled;
+}
+
 /*
  * Prints ASCII control chars in `str` using a hex representation
  * Doesn't rely on NUL-terminator (since arbitrary binary data
  * might incl. also `\0`)
  */
 static void fprint_str_esc(FILE *stream, char *str, size_t str_len) {
+    STATS_TIMER_BEGIN(STATS_TIMER_FORMAT);
     setlocale(LC_ALL, "C");
 
     for (unsigned int i = 0; i < str_len; i++) {
@@ -112,6 +283,7 @@ static void fprint_str_esc(FILE *stream, char *str, size_t str_len) {
             fprintf(stream, "\\x%02x", (unsigned char)c);
         }
     }
+    STATS_TIMER_END(STATS_TIMER_FORMAT);
 }
 
 
@@ -5,8 +5,16 @@
 #ifndef TRACE_SYSCALLS_H
 #define TRACE_SYSCALLS_H
 
+#include <stdbool.h>
+#include <stdio.h>
 #include <unistd.h>
 
+#include <trace/syscall_types.h>
+
+
+/* -- Consts -- */
+#define SYSCALLS_NR_UNKNOWN (-2)    /* Syscall w/o entry in syscall table (e.g., i386's `socketcall`; see `syscalls_get_nr_of_regs`) */
+
 
 /* -- Type declarations -- */
 struct user_regs_struct_full ;
@@ -15,8 +23,19 @@ struct user_regs_struct_full ;
 /* -- Function prototypes -- */
 const char *syscalls_get_name(long syscall_nr);
 long syscalls_get_nr(char* syscall_name);
+long syscalls_get_nr_of_regs(struct user_regs_struct_full *regs);
+
+void syscalls_print_args(FILE *stream, pid_t tid, struct user_regs_struct_full *regs);
+void syscalls_fprint_args(FILE *stream, pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]);
+void syscalls_print_args_generic(FILE *stream, pid_t tid, struct user_regs_struct_full *regs);
+void syscalls_get_args(struct user_regs_struct_full *regs, long args[SYSCALL_MAX_ARGS]);
+
+void syscalls_fprint_rtn_val(FILE *stream, long rtn_val);
 
-void syscalls_print_args(pid_t tid, struct user_regs_struct_full *regs);
+void syscalls_set_fd_annotation(bool enabled);
+void syscalls_set_payload_decoding(bool enabled);
+bool syscalls_get_payload_decoding(void);
+void syscalls_fprint_fd_path(FILE *stream, pid_t tid, long fd);
 
 void syscalls_print_all(void);
 
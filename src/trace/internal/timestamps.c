@@ -0,0 +1,155 @@
+#include <string.h>
+#include <time.h>
+
+#include <common/time_utils.h>
+#include "timestamps.h"
+
+
+/* -- Consts -- */
+#define NS_PER_SEC 1000000000ULL
+#define NS_PER_US  1000ULL
+
+
+/* -- Globals -- */
+static struct {
+    timestamps_format_t format;
+    bool relative;
+
+    int64_t realtime_offset_ns;         /* `CLOCK_REALTIME` - `CLOCK_MONOTONIC` */
+
+    /* Per-second prefix cache */
+    int64_t cached_sec;
+    char cached_prefix[32];
+    size_t cached_prefix_len;
+
+    uint64_t last_timestamp_ns;         /* `-r`: Latest one printed (so far) */
+} timestamps = { .cached_sec = -1 };
+
+
+/* -- Function prototypes -- */
+static char* append_digits(char* buf, uint64_t value, int digits);
+static char* append_seconds_us(char* buf, uint64_t ns, int seconds_width);
+static void update_prefix(int64_t sec);
+
+
+/* -- Functions -- */
+void timestamps_init(timestamps_format_t format, bool relative) {
+    timestamps.format = format;
+    timestamps.relative = relative;
+
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    timestamps.realtime_offset_ns = ((int64_t)realtime.tv_sec * (int64_t)NS_PER_SEC + realtime.tv_nsec) - (int64_t)time_now_ns();
+    timestamps.cached_sec = -1;
+    timestamps.last_timestamp_ns = 0;
+}
+
+
+void timestamps_fprint(FILE* stream, uint64_t timestamp_ns) {
+    char buf[64];
+    char* p = buf;
+
+/* `-r`: Time since previous syscall (overrides absolute timestamps)
+ *   NOTE: Lines printed on syscall-exit (e.g., `-z`) carry their syscall-enter timestamp, i.e., may be older than the
+ *         previous line (w/ `-f`)  -> Printed as `0` (+ don't move the reference back) */
+    if (timestamps.relative) {
+        const uint64_t delta_ns = (timestamps.last_timestamp_ns && timestamp_ns > timestamps.last_timestamp_ns) ?
+                                      (timestamp_ns - timestamps.last_timestamp_ns) : (0);
+        if (timestamp_ns > timestamps.last_timestamp_ns) {
+            timestamps.last_timestamp_ns = timestamp_ns;
+        }
+        p = append_seconds_us(p, delta_ns, 6);
+
+/* `-t` / `-tt` / `-ttt`: Wall-clock time */
+    } else {
+        const int64_t realtime_ns = (int64_t)timestamp_ns + timestamps.realtime_offset_ns;
+        const int64_t sec = realtime_ns / (int64_t)NS_PER_SEC;
+        if (sec != timestamps.cached_sec) {
+            update_prefix(sec);
+        }
+        memcpy(p, timestamps.cached_prefix, timestamps.cached_prefix_len);
+        p += timestamps.cached_prefix_len;
+
+        switch (timestamps.format) {
+            case TIMESTAMPS_TIME_US:
+            case TIMESTAMPS_EPOCH_US:
+                *p++ = '.';
+                p = append_digits(p, (uint64_t)(realtime_ns % (int64_t)NS_PER_SEC) / NS_PER_US, 6);
+                break;
+            case TIMESTAMPS_NONE:
+            case TIMESTAMPS_TIME:
+            default:
+                break;
+        }
+    }
+
+    *p++ = ' ';
+    fwrite(buf, 1, (size_t)(p - buf), stream);
+}
+
+void timestamps_fprint_duration(FILE* stream, uint64_t duration_ns) {
+    char buf[64];
+    char* p = buf;
+
+    *p++ = ' ';
+    *p++ = '<';
+    p = append_seconds_us(p, duration_ns, 1);
+    *p++ = '>';
+    fwrite(buf, 1, (size_t)(p - buf), stream);
+}
+
+/*
+ * Converts timestamp (taken once per stop) to wall-clock time (ns since epoch)
+ */
+int64_t timestamps_to_realtime_ns(uint64_t timestamp_ns) {
+    return (int64_t)timestamp_ns + timestamps.realtime_offset_ns;
+}
+
+
+/* - Helpers - */
+/*
+ * Appends `value` w/ (at least) `digits` digits (zero-padded); returns end
+ */
+static char* append_digits(char* buf, uint64_t value, int digits) {
+    char tmp[24];
+    int len = 0;
+    do {
+        tmp[len++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value || len < digits);
+
+    while (len) {
+        *buf++ = tmp[--len];
+    }
+    return buf;
+}
+
+/*
+ * Appends `<seconds>.<us>` (seconds right-aligned to `seconds_width`); returns end
+ */
+static char* append_seconds_us(char* buf, uint64_t ns, int seconds_width) {
+    char seconds[24];
+    const int seconds_len = (int)(append_digits(seconds, ns / NS_PER_SEC, 1) - seconds);
+    for (int i = seconds_len; i < seconds_width; i++) {
+        *buf++ = ' ';
+    }
+    memcpy(buf, seconds, (size_t)seconds_len);
+    buf += seconds_len;
+
+    *buf++ = '.';
+    return append_digits(buf, (ns % NS_PER_SEC) / NS_PER_US, 6);
+}
+
+static void update_prefix(int64_t sec) {
+    timestamps.cached_sec = sec;
+
+    if (TIMESTAMPS_EPOCH_US == timestamps.format) {
+        timestamps.cached_prefix_len = (size_t)(append_digits(timestamps.cached_prefix, (uint64_t)sec, 1) - timestamps.cached_prefix);
+        return;
+    }
+
+    const time_t sec_time = (time_t)sec;
+    struct tm local_time;
+    localtime_r(&sec_time, &local_time);
+    timestamps.cached_prefix_len = strftime(timestamps.cached_prefix, sizeof(timestamps.cached_prefix), "%H:%M:%S", &local_time);
+}
@@ -0,0 +1,26 @@
+/**
+ * Timestamp columns (`-t` / `-tt` / `-ttt`, `-r`) + syscall durations (`-T`)
+ *   Timestamps are taken once per stop (`CLOCK_MONOTONIC` via vDSO) and converted to wall-clock time
+ *   using an offset determined once at init
+ *   The wall-clock prefix (e.g., `HH:MM:SS`) is only formatted once per second (cached), each column is
+ *   written w/ a single `fwrite`
+ */
+#ifndef TIMESTAMPS_H
+#define TIMESTAMPS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../tracing.h"
+
+
+/* -- Function prototypes -- */
+void timestamps_init(timestamps_format_t format, bool relative);
+
+void timestamps_fprint(FILE* stream, uint64_t timestamp_ns);
+void timestamps_fprint_duration(FILE* stream, uint64_t duration_ns);
+
+int64_t timestamps_to_realtime_ns(uint64_t timestamp_ns);
+
+
+#endif /* TIMESTAMPS_H */
@@ -0,0 +1,242 @@
+#define _GNU_SOURCE             /* `CLONE_FILES` */
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/error.h>
+#include "stats.h"
+#include "tracees.h"
+
+
+/* -- Consts -- */
+#define TRACEES_INITIAL_CAPACITY 64         /* MUST be a power of 2 */
+
+
+/* -- Globals -- */
+/* Hash table (open addressing w/ linear probing; `NULL` = empty slot) */
+static struct {
+    tracee_t** slots;
+    size_t capacity;
+    size_t count;
+} tracees = { NULL, 0, 0 };
+
+
+/* -- Function prototypes -- */
+static size_t tracees_slot_of(pid_t tid);
+static tracee_t* tracees_new(pid_t tid, fds_t* fds);
+static void tracees_insert(tracee_t* tracee);
+static tracee_t* tracees_unlink(pid_t tid);
+static void tracees_grow(void);
+static void tracees_free(tracee_t* tracee);
+
+
+/* -- Functions -- */
+tracee_t* tracees_get(pid_t tid) {
+    if (!tracees.count) {
+        return NULL;
+    }
+
+    for (size_t slot = tracees_slot_of(tid); tracees.slots[slot]; slot = (slot + 1) & (tracees.capacity - 1)) {
+        if (tid == tracees.slots[slot]->tid) {
+            return tracees.slots[slot];
+        }
+    }
+    return NULL;
+}
+
+tracee_t* tracees_get_or_add(pid_t tid) {
+    tracee_t* tracee;
+    if ((tracee = tracees_get(tid))) {
+        return tracee;
+    }
+
+    tracee = tracees_new(tid, NULL);
+    tracees_insert(tracee);
+    return tracee;
+}
+
+void tracees_remove(pid_t tid) {
+    tracee_t* const tracee = tracees_unlink(tid);
+    if (!tracee) {
+        return;
+    }
+
+    tracees_free(tracee);
+}
+
+void tracees_fin(void) {
+    for (size_t slot = 0; slot < tracees.capacity; slot++) {
+        if (tracees.slots[slot]) {
+            tracees_free(tracees.slots[slot]);
+        }
+    }
+    free(tracees.slots);
+    tracees.slots = NULL;
+    tracees.capacity = tracees.count = 0;
+}
+
+void tracees_for_each(void (*callback)(tracee_t* tracee, void* ctx), void* ctx) {
+    for (size_t slot = 0; slot < tracees.capacity; slot++) {
+        if (tracees.slots[slot]) {
+            callback(tracees.slots[slot], ctx);
+        }
+    }
+}
+
+
+fds_t* tracees_get_fds(tracee_t* tracee) {
+    if (!tracee->fds) {     /* Not inherited (e.g., tracee attached to or task whose creation wasn't seen)  -> Seed from `/proc` */
+        tracee->fds = fds_new();
+        fds_seed(tracee->fds, tracee->tid);
+    }
+    return tracee->fds;
+}
+
+pid_t tracees_get_tgid(tracee_t* tracee) {
+    if (!tracee->tgid) {    /* (Doesn't change during task's lifetime, not even on `exec`) */
+        char status_path[64], line[128];
+        snprintf(status_path, sizeof(status_path), "/proc/%d/status", tracee->tid);
+        FILE* const status_file = fopen(status_path, "r");
+        if (status_file) {
+            while (fgets(line, sizeof(line), status_file) && 1 != sscanf(line, "Tgid: %d", &tracee->tgid)) { }
+            fclose(status_file);
+        }
+        if (!tracee->tgid) {        /* (Task is already gone) */
+            tracee->tgid = tracee->tid;
+        }
+    }
+    return tracee->tgid;
+}
+
+
+void tracees_on_clone(pid_t parent_tid, pid_t child_tid, unsigned long clone_flags) {
+    tracee_t* const parent = tracees_get_or_add(parent_tid);
+    tracee_t* child = tracees_get(child_tid);
+
+    if (!parent->fds) {                     /* fd table of parent not in use (yet)  -> Child's will be seeded lazily too */
+        if (!child) {
+            tracees_insert(tracees_new(child_tid, NULL));
+        }
+    } else if (clone_flags & CLONE_FILES) {        /* Shared fd table (e.g., threads) */
+        if (child) {
+            fds_unref(child->fds);
+            child->fds = fds_ref(parent->fds);
+        } else {
+            tracees_insert(tracees_new(child_tid, fds_ref(parent->fds)));
+        }
+    } else if (!child) {                    /* Copied fd table (e.g., `fork`) */
+        tracees_insert(tracees_new(child_tid, fds_copy(parent->fds)));
+    } else if (!child->fds) {               /* (NOTE: Child w/ fd table in use was already seeded from `/proc`) */
+        child->fds = fds_copy(parent->fds);
+    }
+}
+
+/*
+ * Task `exec`d  (reported prior its syscall-exit of `exec`)
+ *   - fd table has been replaced (`O_CLOEXEC` fds are closed, no longer shared w/ other tasks)  -> Reseeded lazily
+ *   - `former_tid` != `tid`: Non-leader thread `exec`d + took over the leader's tid  -> Its state (it's in the `exec`
+ *     syscall) replaces the leader's (which is stale, since the leader is gone w/o being reported)
+ */
+void tracees_on_exec(pid_t tid, pid_t former_tid) {
+    if (former_tid != tid) {
+        tracee_t* const former = tracees_unlink(former_tid);
+        if (former) {
+            tracees_remove(tid);
+            former->tid = tid;
+            tracees_insert(former);
+        }
+    }
+
+    tracee_t* const tracee = tracees_get(tid);
+    if (tracee) {
+        fds_unref(tracee->fds);
+        tracee->fds = NULL;
+    }
+}
+
+
+/* - Helpers - */
+static size_t tracees_slot_of(pid_t tid) {
+    return ((uint32_t)tid * 2654435761U) & (tracees.capacity - 1);     /* Knuth's multiplicative hash */
+}
+
+static tracee_t* tracees_new(pid_t tid, fds_t* fds) {
+    tracee_t* tracee = DIE_WHEN_ERRNO_VPTR( calloc(1, sizeof(*tracee)) );
+    STATS_COUNT(STATS_COUNTER_ALLOCS, 1);
+    tracee->tid = tid;
+    tracee->fds = fds;
+    return tracee;
+}
+
+static void tracees_insert(tracee_t* tracee) {
+    if ((tracees.count + 1) * 2 > tracees.capacity) {      /* Keep load factor <= 0.5 */
+        tracees_grow();
+    }
+
+    size_t slot = tracees_slot_of(tracee->tid);
+    while (tracees.slots[slot]) {
+        slot = (slot + 1) & (tracees.capacity - 1);
+    }
+    tracees.slots[slot] = tracee;
+    tracees.count++;
+}
+
+/*
+ * Removes tracee from table (w/o freeing it)
+ */
+static tracee_t* tracees_unlink(pid_t tid) {
+    if (!tracees.count) {
+        return NULL;
+    }
+
+    size_t slot = tracees_slot_of(tid);
+    for ( ; tracees.slots[slot]; slot = (slot + 1) & (tracees.capacity - 1)) {
+        if (tid == tracees.slots[slot]->tid) { break; }
+    }
+    tracee_t* const tracee = tracees.slots[slot];
+    if (!tracee) {
+        return NULL;
+    }
+    tracees.slots[slot] = NULL;
+    tracees.count--;
+
+/* Backward shift deletion (keeps probe sequences intact w/o tombstones) */
+    for (size_t next_slot = (slot + 1) & (tracees.capacity - 1); tracees.slots[next_slot]; next_slot = (next_slot + 1) & (tracees.capacity - 1)) {
+        const size_t ideal_slot = tracees_slot_of(tracees.slots[next_slot]->tid);
+        /* Move entry into the gap if its ideal slot doesn't lie cyclically in (gap, next_slot] */
+        if (((next_slot - ideal_slot) & (tracees.capacity - 1)) >= ((next_slot - slot) & (tracees.capacity - 1))) {
+            tracees.slots[slot] = tracees.slots[next_slot];
+            tracees.slots[next_slot] = NULL;
+            slot = next_slot;
+        }
+    }
+    return tracee;
+}
+
+static void tracees_grow(void) {
+    tracee_t** const old_slots = tracees.slots;
+    const size_t old_capacity = tracees.capacity;
+
+    tracees.capacity = (old_capacity) ? (old_capacity * 2) : (TRACEES_INITIAL_CAPACITY);
+    tracees.slots = DIE_WHEN_ERRNO_VPTR( calloc(tracees.capacity, sizeof(*(tracees.slots))) );
+    tracees.count = 0;
+
+    for (size_t slot = 0; slot < old_capacity; slot++) {
+        if (old_slots[slot]) {
+            tracees_insert(old_slots[slot]);
+        }
+    }
+    free(old_slots);
+}
+
+static void tracees_free(tracee_t* tracee) {
+    fds_unref(tracee->fds);
+    free(tracee->syscall_formatted_args);
+    if (tracee->pending_line) {
+        fclose(tracee->pending_line);
+        free(tracee->pending_line_buf);
+    }
+    free(tracee);
+}
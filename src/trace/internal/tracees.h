@@ -0,0 +1,52 @@
+/**
+ * State of traced tasks (i.e., threads), looked up by tid
+ */
+#ifndef TRACEES_H
+#define TRACEES_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "fds.h"
+#include "syscall_event.h"
+
+
+/* -- Types -- */
+typedef struct {
+    pid_t tid;
+    pid_t tgid;                 /* Thread group (i.e., pid); determined lazily (use `tracees_get_tgid`); `0` = not yet */
+    fds_t* fds;                 /* Shared by tasks created w/ `CLONE_FILES`; created lazily (use `tracees_get_fds`) */
+
+    bool syscall_discarded;     /* Current syscall didn't pass filters on syscall-enter  -> Skip its syscall-exit */
+    bool syscall_deferred;      /* Filter result of current syscall depends on its result  -> Printed (entirely) on syscall-exit */
+    bool syscall_unsampled;     /* Current syscall wasn't sampled  -> Only counted (not printed) on syscall-exit */
+    syscall_event_t syscall_event;      /* Raw data of current syscall (only captured when required, e.g., for deferred syscalls) */
+    char* syscall_formatted_args;       /* Args of deferred syscall, which had to be formatted on syscall-enter (e.g., `execve`); `NULL` = none */
+
+    bool syscall_in_flight;     /* Flight recorder: Syscall-enter recorded, syscall-exit not yet */
+    unsigned long syscall_ip;   /* Flight recorder: Call-site of current syscall */
+
+    FILE* pending_line;         /* `--output-mode=complete`: Line of current syscall, written on syscall-exit; created lazily */
+    char* pending_line_buf;     /* (Buffer of `pending_line`, an `open_memstream`) */
+    size_t pending_line_buf_size;
+
+    bool seccomp_entered;       /* Stopped on syscall-enter via `PTRACE_EVENT_SECCOMP`  -> Syscall-exit must be requested explicitly */
+} tracee_t;
+
+
+/* -- Function prototypes -- */
+tracee_t* tracees_get(pid_t tid);
+tracee_t* tracees_get_or_add(pid_t tid);
+void tracees_remove(pid_t tid);
+void tracees_fin(void);
+void tracees_for_each(void (*callback)(tracee_t* tracee, void* ctx), void* ctx);
+
+fds_t* tracees_get_fds(tracee_t* tracee);
+pid_t tracees_get_tgid(tracee_t* tracee);
+
+void tracees_on_clone(pid_t parent_tid, pid_t child_tid, unsigned long clone_flags);
+void tracees_on_exec(pid_t tid, pid_t former_tid);
+
+
+#endif /* TRACEES_H */
@@ -0,0 +1,29 @@
+#include <stdio.h>
+
+#include <trace/syscallents.h>
+#include "errnos.h"
+#include "syscalls.h"
+#include "triggers.h"
+
+
+/* -- Functions -- */
+/*
+ * Checks whether (completed) syscall matches one of the triggers; if so, describes the matching trigger in `reason`
+ */
+bool triggers_match(const triggers_t* triggers, const syscall_event_t* event,
+                    char* reason, size_t reason_size) {
+    if (triggers->syscalls &&
+        event->nr >= 0 && event->nr <= MAX_SYSCALL_NUM && triggers->syscalls[event->nr]) {
+        snprintf(reason, reason_size, "syscall %s", syscalls_get_name(event->nr));
+        return true;
+    }
+
+    const long err = syscall_event_errno(event);
+    for (int i = 0; err && i < triggers->errnos_count; i++) {
+        if (err == triggers->errnos[i]) {
+            snprintf(reason, reason_size, "errno %s", errnos_get_name(err));
+            return true;
+        }
+    }
+    return false;
+}
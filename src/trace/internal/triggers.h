@@ -0,0 +1,26 @@
+/**
+ * Sets of syscalls + errnos which trigger an action (e.g., dumping the flight recorder or escalating to full tracing)
+ */
+#ifndef TRIGGERS_H
+#define TRIGGERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "syscall_event.h"
+
+
+/* -- Types -- */
+typedef struct {
+    const bool* syscalls;       /* Indexed by syscall nr; `NULL` = none */
+    const int* errnos;
+    int errnos_count;
+} triggers_t;
+
+
+/* -- Function prototypes -- */
+bool triggers_match(const triggers_t* triggers, const syscall_event_t* event,
+                    char* reason, size_t reason_size);
+
+
+#endif /* TRIGGERS_H */
@@ -27,6 +27,7 @@ static unw_addr_space_t unw_as;
 
 /* -- Function prototypes -- */
 static Dwfl* init_ldw_for_proc(pid_t tid);
+static void print_frame(const char* module_name, const char* symbol, unsigned long offset, unsigned long ip, void* ctx);
 
 
 /* -- Functions -- */
@@ -54,6 +55,10 @@ void unwind_fin(void) {
 
 
 void unwind_print_backtrace_of_proc(pid_t tid) {
+    unwind_for_each_frame_of_proc(tid, print_frame, stderr);
+}
+
+void unwind_for_each_frame_of_proc(pid_t tid, unwind_frame_callback_t callback, void* ctx) {
     assert( unw_as && "Unwind context may be inited prior usage." );
 
 
@@ -75,7 +80,7 @@ void unwind_print_backtrace_of_proc(pid_t tid) {
     Dwfl* dwfl = init_ldw_for_proc(tid);
 
 
-/* 1. Print frames in execution stack of process */
+/* 1. Walk frames in execution stack of process */
 #ifdef MAX_STACKTRACE_DEPTH
     int cur_stack_depth = 0;
     do {
@@ -93,12 +98,11 @@ void unwind_print_backtrace_of_proc(pid_t tid) {
             LOG_ERROR_AND_DIE("libunwind -- failed to walk the stack of process %d", tid);
         }
 
-    /* 1.2. Get + Print so filename */
+    /* 1.2. Get so filename */
         Dwfl_Module* module = dwfl_addrmodule(dwfl, (uintptr_t)ip);
         const char *module_name = dwfl_module_info(module, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
-        fprintf(stderr, " > %s", /*strrchr(module_name,'/') +1*/ module_name);
 
-    /* 1.3. Print function (i.e., symbol) + offset in function */
+    /* 1.3. Get function (i.e., symbol) + offset in function, then pass frame to callback */
         /* ELUCIDATION:
          *   `unw_get_proc_name`(3): Get name of function which created stackframe identified by `cursor`
          *     - `sym` = pointer to a char buffer which will hold the procedure name and
@@ -114,19 +118,16 @@ void unwind_print_backtrace_of_proc(pid_t tid) {
                 symbol = symbol_buf;
             }
 
-            fprintf(stderr, "(%s+0x%lx)", symbol, offset);
+            callback(module_name, symbol, (unsigned long)offset, (unsigned long)ip, ctx);
             // Deallocate demangled C++ symbol name (if returned by `cplus_demangle`)
             if (symbol_buf != symbol) {
                 free(symbol);
                 symbol = NULL;
             }
         } else {
-            fprintf(stderr, "(-- found no symbol)");
+            callback(module_name, NULL, 0, (unsigned long)ip, ctx);
         }
 
-    /* 1.4. Print IP-address */
-        fprintf(stderr, " [0x%lx]\n", ip);
-
 
     /* ELUCIDATION:
      *   `unw_step`(3): Advances unwind `cursor` to the next older, less deeply nested stackframe
@@ -158,3 +159,14 @@ static Dwfl* init_ldw_for_proc(pid_t tid) {
     dwfl_end(dwfl);
     LOG_ERROR_AND_DIE("libdw -- failed to init for process %d", tid);
 }
+
+static void print_frame(const char* module_name, const char* symbol, unsigned long offset, unsigned long ip, void* ctx) {
+    FILE* const stream = ctx;
+    fprintf(stream, " > %s", /*strrchr(module_name,'/') +1*/ module_name);
+    if (symbol) {
+        fprintf(stream, "(%s+0x%lx)", symbol, offset);
+    } else {
+        fprintf(stream, "(-- found no symbol)");
+    }
+    fprintf(stream, " [0x%lx]\n", ip);
+}
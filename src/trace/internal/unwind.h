@@ -7,10 +7,17 @@
 #include <unistd.h>
 
 
+/* -- Types -- */
+/* `symbol` = `NULL` if none was found */
+typedef void (*unwind_frame_callback_t)(const char* module_name, const char* symbol, unsigned long offset,
+                                        unsigned long ip, void* ctx);
+
+
 /* -- Function prototypes -- */
 void unwind_init(void);
 void unwind_fin(void);
 void unwind_print_backtrace_of_proc(pid_t tid);
+void unwind_for_each_frame_of_proc(pid_t tid, unwind_frame_callback_t callback, void* ctx);
 
 
 #endif /* UNWIND_H */
@@ -1,14 +1,40 @@
 #include <errno.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/prctl.h>
 #include <sys/ptrace.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "internal/attach.h"
+#include "internal/calibration.h"
+#include "internal/control.h"
+#include "internal/filter_expr.h"
+#include "internal/flight_recorder.h"
+#include "internal/governor.h"
+#include "internal/json.h"
+#include "internal/metrics.h"
+#include "internal/output.h"
+#include "internal/output_file.h"
+#include "internal/path_filters.h"
+#include "internal/perf_backend.h"
+#include "internal/placement.h"
+#include "internal/proctree.h"
 #include "internal/ptrace_utils.h"
+#include "internal/recording.h"
+#include "internal/sampling.h"
+#include "internal/seccomp_bpf.h"
+#include "internal/seccomp_notif.h"
+#include "internal/stats.h"
+#include "internal/summary.h"
 #include "internal/syscalls.h"
+#include "internal/timestamps.h"
+#include "internal/tracees.h"
+#include "internal/triggers.h"
 #include "tracing.h"
 
 #ifdef WITH_STACK_UNWINDING
@@ -16,18 +42,113 @@
 #endif
 
 #include <common/error.h>
+#include <common/time_utils.h>
+#include <trace/syscallents.h>
 
 
 /* -- Consts -- */
 #define PTRACE_TRAP_INDICATOR_BIT (1 << 7)
 
+#define PERF_POLL_TIMEOUT_MS 100        /* (Bounds latency of noticing the tracee's exit) */
+
+#define NOTIF_WAKE_UP_SIGNAL SIGUSR1    /* Interrupts workers blocked in receiving a notification (once tracees have exited) */
+#define NOTIF_WAKE_UP_INTERVAL_NS 1000000L
+
+
+/* -- Types -- */
+typedef struct {                        /* Tasks to be detached (`detach_all_tasks`) */
+    struct {
+        pid_t tid;                      /* `0` = done */
+        bool stop_sent;                 /* `false` = detached on its initial stop (new child) */
+    }* entries;
+    size_t count;
+    size_t capacity;
+} detach_tasks_t;
+
+
+/* -- Globals -- */
+/* seccomp-notif backend's workers */
+static struct {
+    const tracer_options_t* options;
+    pthread_t* threads;                 /* `threads[0]` = main thread */
+    unsigned threads_count;
+    unsigned running_count;             /* (Accessed atomically, as is `done`) */
+    bool done;
+    pthread_mutex_t output_lock;        /* Lines are printed as a whole (+ timestamps' state is shared) */
+} notif_workers = { .output_lock = PTHREAD_MUTEX_INITIALIZER };
+
 
 /* -- Function prototypes -- */
-static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status);
+static int set_bp_and_wait_for_trap(const tracer_options_t* options,
+                                    pid_t next_bp_tid, int *exit_status);
+static pid_t wait_for_any_tracee(const tracer_options_t* options, int* status);
+static void handle_clone_event(const tracer_options_t* options, pid_t parent_tid, int ptrace_event);
+static void handle_exec_event(const tracer_options_t* options, pid_t tid);
+static bool handle_control_request(const tracer_options_t* options);
+static int detach_all_tasks(const tracer_options_t* options);
+static void collect_tid(tracee_t* tracee, void* ctx);
+static size_t detach_tasks_find_or_add(detach_tasks_t* tasks, pid_t tid, size_t* remaining);
+static void install_seccomp_bpf(const tracer_options_t* options);
+static void attach_to_all_tasks(const tracer_options_t* options);
+static int ptrace_options_of(const tracer_options_t* options);
+static bool attaches_to_many(const tracer_options_t* options);
+static bool tags_tids(const tracer_options_t* options);
+static bool uses_proctree(const tracer_options_t* options);
+static bool uses_path_filters(const tracer_options_t* options);
+static bool tracks_fds(const tracer_options_t* options);
+static bool uses_tracee_state(const tracer_options_t* options);
+static bool uses_escalation(const tracer_options_t* options);
+static bool uses_sampling(const tracer_options_t* options);
+static bool escalation_triggered(const tracer_options_t* options, const triggers_t* triggers,
+                                 const syscall_event_t* event, char* reason, size_t reason_size);
+static bool trace_status_matches(trace_status_t trace_status, const syscall_event_t* event);
+static bool signal_is_fatal(pid_t tid, int sig);
+static bool is_initial_stop(int sig, const siginfo_t* si);
+static bool sigstop_pending(pid_t tid);
+static bool syscall_replaces_memory(long syscall_nr);
+static char* format_syscall_args(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]);
+static void print_syscall_enter(const tracer_options_t* options, FILE* stream, pid_t tid, uint64_t timestamp_ns,
+                                const char* scall_name, long syscall_nr, const long args[SYSCALL_MAX_ARGS],
+                                const char* formatted_args);
 static void wait_for_user_input(void);
+static const char* syscall_name_or_generic(long syscall_nr);
+
+static const char* perf_unsupported_option(const tracer_options_t* options);
+static int do_perf_tracer(const tracer_options_t* options);
+static bool perf_tracee_exited(const tracer_options_t* options, int* exit_status);
+static void handle_perf_event(const tracer_options_t* options, const perf_backend_event_t* perf_event);
+static void print_perf_unfinished(tracee_t* tracee, void* ctx);
+
+static const char* seccomp_notif_unsupported_option(const tracer_options_t* options);
+static int do_seccomp_notif_tracer(const tracer_options_t* options);
+static void* seccomp_notif_worker(void* ctx);
+static void handle_seccomp_notif(const tracer_options_t* options, const seccomp_notif_event_t* notif);
+static void wake_up_notif_worker(int sig);
 
 
 /* -- Functions -- */
+/*
+ * Falls back to ptrace when the selected backend can't be used w/ the given options
+ * (MUST be called prior forking the tracee, as the seccomp-notif backend is also set up by the tracee)
+ */
+void tracing_select_backend(tracer_options_t* options) {
+    if (TRACE_BACKEND_SECCOMP_NOTIF != options->backend) {
+        return;         /* (perf backend is set up by tracer only  -> Decides itself) */
+    }
+
+    const char* const unsupported_option = seccomp_notif_unsupported_option(options);
+    if (unsupported_option) {
+        LOG_WARN("seccomp-notif backend doesn't support %s -- Falling back to ptrace", unsupported_option);
+        options->backend = TRACE_BACKEND_PTRACE;
+    } else if (!seccomp_notif_available()) {
+        LOG_WARN("seccomp-notif backend not available (requires Linux >= 5.6) -- Falling back to ptrace");
+        options->backend = TRACE_BACKEND_PTRACE;
+    } else {
+        options->follow_fork = true;        /* (Filter is inherited by all children) */
+    }
+}
+
+
 int do_tracee(int argc, char** argv,
               tracer_options_t* tracer_options) {
 /* exec setup: Create new array for argv of to be exec'd command */
@@ -35,7 +156,13 @@ int do_tracee(int argc, char** argv,
     memcpy(tracee_exec_argv, argv, (argc * sizeof(argv[0])));
     tracee_exec_argv[argc] = NULL;
 
-    if (!tracer_options->daemonize) {
+    if (TRACE_BACKEND_SECCOMP_NOTIF == tracer_options->backend) {
+        /* No ptrace: Selected syscalls are reported via the filter's notification fd, which the tracer picks up
+         * (while we're blocked in `exec`, which is always notified)
+         */
+        install_seccomp_bpf(tracer_options);
+
+    } else if (!tracer_options->daemonize) {
         /* ELUCIDATION:
          *   - `PTRACE_TRACEME`: Starts tracing + causes next signal (sent to this
          *                       process) to stop it & notify the parent(via `wait`),
@@ -48,6 +175,11 @@ int do_tracee(int argc, char** argv,
          */
         DIE_WHEN_ERRNO( kill(getpid(), SIGSTOP) );
 
+        /* Install seccomp-BPF prefilter  (AFTER tracer has set `PTRACE_O_TRACESECCOMP`, otherwise traced syscalls would fail w/ `ENOSYS`) */
+        if (tracer_options->seccomp_bpf) {
+            install_seccomp_bpf(tracer_options);
+        }
+
     } else {
     /* Allow non-root child (= tracer) to trace parent (= tracee)   (ONLY PERTINENT when Yama ptrace_scope = 1 AND `PTRACE_ATTACH` is used) */
         DIE_WHEN_ERRNO( prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY) );
@@ -95,11 +227,41 @@ int do_tracer(tracer_options_t* options) {
         0 != setvbuf(stderr, NULL, _IONBF, 0)) {
         LOG_ERROR_AND_DIE("Couldn't set buffering options for std-io");
     }
+    if (options->output_path) {         /* NOTE: Replaces fd of `stderr` (prior anything else gets a hold of it) */
+        output_file_init(options->output_path, options->output_rotate_size, options->output_rotate_interval_ns,
+                         options->output_rotate_keep, options->output_compression);
+    }
+    if (options->print_stats) {         /* NOTE: Replaces `stderr` (for timing the output) */
+        stats_init();
+    }
+
+/* 0a'. Stop-free backend  (falls back to ptrace when it can't be used) */
+    if (TRACE_BACKEND_PERF == options->backend) {
+        const char* const unsupported_option = perf_unsupported_option(options);
+        char error[128];
+        if (unsupported_option) {
+            LOG_WARN("perf backend doesn't support %s -- Falling back to ptrace", unsupported_option);
+        } else if (-1 == perf_backend_open(options->tracee_pid, options->follow_fork, error, sizeof(error))) {
+            LOG_WARN("perf backend not available (%s) -- Falling back to ptrace", error);
+        } else {
+            return do_perf_tracer(options);
+        }
+    }
+    if (TRACE_BACKEND_SECCOMP_NOTIF == options->backend) {        /* (Already checked by `tracing_select_backend`) */
+        return do_seccomp_notif_tracer(options);
+    }
+
+    if (options->record_path) {
+        recording_init(options->record_path, tags_tids(options));
+    }
 
 
     const pid_t tracee_pid = options->tracee_pid;
+    const bool attach_to_many = attaches_to_many(options);
 
-    if (options->attach_to_tracee || options->daemonize) {
+    if (attach_to_many) {
+        attach_to_all_tasks(options);
+    } else if (options->attach_to_tracee || options->daemonize) {
         /* ELUCIDATION:
          *  - `PTRACE_ATTACH`: Attach to process specified by `pid`
          *                     (making it a tracee of the calling process)
@@ -113,7 +275,8 @@ int do_tracer(tracer_options_t* options) {
 
 
 /* 0b. Setup: Wait until child stops  --> Either already stopped by previous `PTRACE_ATTACH` or by itself */
-{   /* ELUCIDATION:
+if (!attach_to_many) {      /* (Seized tasks are restarted by the trace loop, once it sees their interrupt stops) */
+    /* ELUCIDATION:
      *  - `WIFSTOPPED`: Returns nonzero value if child process is stopped
      */
     int tracee_status;
@@ -132,34 +295,212 @@ int do_tracer(tracer_options_t* options) {
      *                              the newly cloned process, which will start w/ a SIGSTOP;
      *                              `waitpid(2)` by the tracer will return a status value such that
      *                              `status>>8 == (SIGTRAP | (PTRACE_EVENT_CLONE<<8))`
+     *
+     *   - `PTRACE_O_TRACESECCOMP`: Stop the tracee when a seccomp filter returns `SECCOMP_RET_TRACE`
+     *                              (`status>>8 == (SIGTRAP | (PTRACE_EVENT_SECCOMP<<8))`)
      */
-    DIE_WHEN_ERRNO( ptrace(PTRACE_SETOPTIONS,
-                           tracee_pid,
-                           0,
-                           PTRACE_O_TRACESYSGOOD
-                                | ( (options->follow_fork) ? (PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK | PTRACE_O_TRACEVFORK) : (0)) ) );
+    if (!attach_to_many) {          /* (Set by `PTRACE_SEIZE`) */
+        DIE_WHEN_ERRNO( ptrace(PTRACE_SETOPTIONS, tracee_pid, 0, ptrace_options_of(options)) );
+    }
 
 #ifdef WITH_STACK_UNWINDING
-    if (options->print_stacktrace) {
+    if (options->print_stacktrace || uses_escalation(options)) {
         unwind_init();
     }
 #endif /* WITH_STACK_UNWINDING */
 
+    const bool use_path_filters = uses_path_filters(options);
+    const bool track_fds = tracks_fds(options);
+    const bool use_tracee_state = uses_tracee_state(options);
+    const filter_expr_t* const filter = options->filter;
+    const bool filter_needs_timestamps = filter && filter_expr_uses_field(filter, FILTER_FIELD_DURATION);
+    const bool filter_on_status = (TRACE_STATUS_ALL != options->trace_status);
+    const bool use_flight_recorder = (options->flight_recorder_size > 0);
+    const bool use_summary = options->summary;
+    const bool summary_only = use_summary && !options->summary_with_output;
+    const bool use_proctree = uses_proctree(options);
+    const bool use_governor = (options->overhead_budget_percent > 0);
+    const bool use_control = (NULL != options->control_socket);
+    const bool use_sampling = uses_sampling(options) || use_governor || use_control;      /* (Governor / control socket may enable sampling) */
+    const bool use_escalation = uses_escalation(options);
+    const bool use_auto_placement = (TRACER_PLACEMENT_AUTO == options->tracer_placement);
+    const bool use_timestamps = (TIMESTAMPS_NONE != options->timestamps) || options->relative_timestamps;
+    const bool use_json = (OUTPUT_FORMAT_JSON == options->output_format);     /* (Events are complete on syscall-exit) */
+    const bool use_metrics = (options->metrics_interval_ns > 0);
+    const bool need_timestamps = filter_needs_timestamps || use_flight_recorder || use_summary || use_escalation ||
+                                 use_timestamps || options->print_durations || use_json || use_metrics;
+    const bool decide_on_exit = filter_on_status || use_flight_recorder || use_summary || use_escalation || use_json ||
+                                use_metrics;   /* Whether syscall is printed (entirely) is only known on syscall-exit */
+
+    const triggers_t flight_recorder_triggers = {
+        .syscalls = options->flight_recorder_trigger_syscalls,
+        .errnos = options->flight_recorder_trigger_errnos,
+        .errnos_count = options->flight_recorder_trigger_errnos_count
+    };
+    const triggers_t escalation_triggers = {
+        .syscalls = options->escalation_trigger_syscalls,
+        .errnos = options->escalation_trigger_errnos,
+        .errnos_count = options->escalation_trigger_errnos_count
+    };
+    uint64_t escalated_until_ns = 0;        /* Escalation: Full tracing until (`0` = cheap mode, i.e., only counting / recording) */
+    bool shed_syscalls[SYSCALLS_ARR_SIZE] = { false };     /* Governor: Syscalls whose syscall-exit isn't stopped on anymore */
+#ifdef WITH_STACK_UNWINDING
+    bool unwinding_enabled = true;          /* (May be disabled by governor) */
+#endif /* WITH_STACK_UNWINDING */
+
+    if (options->annotate_fds) {
+        syscalls_set_fd_annotation(true);
+    }
+    if (use_timestamps || use_json) {
+        timestamps_init(options->timestamps, options->relative_timestamps);
+    }
+    if (use_json) {
+        json_init(options->annotate_fds);
+    }
+    output_init(options->output_mode, tags_tids(options));
+    if (TRACER_PLACEMENT_NONE != options->tracer_placement) {     /* (Prior calibration, which hence measures the placement) */
+        placement_init(options->tracer_placement, options->tracer_cpus);
+    }
+    if (options->calibrate_durations) {     /* Reported as header of output */
+        calibration_t calibration;
+        if (-1 != calibration_run(&calibration)) {
+            if (use_json) {
+                json_fprint_calibration(stderr, time_now_ns(), &calibration);
+            } else {
+                calibration_fprint(stderr, &calibration);
+            }
+            calibration_stop_roundtrip_ns = calibration.p50_ns;
+        }
+    }
+    if (use_path_filters) {
+        path_filters_init(options->trace_path_prefixes, options->trace_path_prefixes_count,
+                          options->trace_fds, options->trace_fds_count);
+    }
+    if (track_fds && !attach_to_many) {          /* (Seized tasks are seeded lazily) */
+        tracees_get_fds(tracees_get_or_add(tracee_pid));     /* Seeds fd table of tracee (from `/proc/<pid>/fd`) */
+    }
+    if (use_flight_recorder) {
+        flight_recorder_init(options->flight_recorder_size, &flight_recorder_triggers,
+                             options->flight_recorder_binary_path);
+    }
+    if (use_summary) {
+        summary_init();
+    }
+    if (use_proctree) {
+        proctree_init();
+    }
+    if (use_metrics) {
+        metrics_init(options->metrics_interval_ns, options->metrics_format, options->metrics_output,
+                     options->metrics_per_process, options->metrics_cumulative);
+    }
+    if (use_sampling) {
+        const sampling_policy_t sampling_policy = {
+            .every_nth = options->sample_every_nth,
+            .burst_per_window = options->sample_burst_per_window,
+            .every_nth_thread = options->sample_every_nth_thread
+        };
+        sampling_init(&sampling_policy);
+    }
+    if (use_governor) {
+        const governor_knobs_t governor_knobs = {
+#ifdef WITH_STACK_UNWINDING
+            .can_disable_unwinding = options->print_stacktrace || use_escalation,
+#else
+            .can_disable_unwinding = false,
+#endif /* WITH_STACK_UNWINDING */
+            .can_disable_payloads = !(summary_only || use_flight_recorder) || use_escalation,
+            .sample_every_nth = options->sample_every_nth,
+            .can_shed_syscalls = options->seccomp_bpf
+        };
+        governor_init(options->overhead_budget_percent, &governor_knobs);
+    }
+    if (use_control) {
+        control_config_t control_config = {
+            .syscall_subset_enabled = (NULL != options->syscall_subset_to_be_traced),
+            .sample_every_nth = options->sample_every_nth,
+            .string_max_bytes = 0,
+            .unwinding = true
+        };
+        if (options->syscall_subset_to_be_traced) {
+            memcpy(control_config.syscall_subset, options->syscall_subset_to_be_traced, sizeof(control_config.syscall_subset));
+        }
+#ifdef WITH_STACK_UNWINDING
+        control_init(options->control_socket, &control_config, options->print_stacktrace || use_escalation);
+#else
+        control_init(options->control_socket, &control_config, false);
+#endif /* WITH_STACK_UNWINDING */
+    }
+
+
+    if (options->attach_cgroup) {
+        attach_cgroup_start_polling();
+    }
+
 
 /* 1. Trace */
     int tracee_exit_status = -1;
-    for (pid_t trapped_tracee_sttid = tracee_pid; ; ) {     /* `sttid`, aka., "status tid" = tid which contains status information in sign bit (has stopped = positive, has terminated = negative) */
+    for (pid_t trapped_tracee_sttid = (attach_to_many) ? (-1) : (tracee_pid); ; ) {     /* `sttid`, aka., "status tid" = tid which contains status information in sign bit (has stopped = positive, has terminated = negative) */
 
     /* 1.1. Wait for a tracee to change state (stop or terminate --> HERE ONLY TERMINATION OR SYSCALL TRAPS) */
-        trapped_tracee_sttid = set_bp_and_wait_for_trap(trapped_tracee_sttid, &tracee_exit_status);
+        if (use_flight_recorder) {
+            flight_recorder_dump_if_requested();
+        }
+        governor_decision_t governor_decision;
+        if (use_governor && governor_poll(&governor_decision)) {
+            output_interrupt();
+            if (use_json) {
+                json_fprint_governor(stderr, time_now_ns(), &governor_decision);
+            } else {
+                governor_fprint_decision(stderr, &governor_decision);
+            }
+            switch (governor_decision.action) {
+                case GOVERNOR_ACTION_DISABLE_UNWINDING:
+#ifdef WITH_STACK_UNWINDING
+                    unwinding_enabled = false;
+#endif /* WITH_STACK_UNWINDING */
+                    break;
+                case GOVERNOR_ACTION_DISABLE_PAYLOADS:
+                    syscalls_set_payload_decoding(false);
+                    break;
+                case GOVERNOR_ACTION_TIGHTEN_SAMPLING:
+                    sampling_set_every_nth(governor_decision.sample_every_nth);
+                    break;
+                case GOVERNOR_ACTION_SHED_SYSCALL:
+                    shed_syscalls[governor_decision.shed_syscall_nr] = true;
+                    break;
+                case GOVERNOR_ACTION_NONE:
+                default:
+                    break;
+            }
+        }
+        if (0 == (trapped_tracee_sttid = set_bp_and_wait_for_trap(options, trapped_tracee_sttid, &tracee_exit_status))) {
+            break;          /* -> No tracees left (when attached to many) */
+        }
+        const uint64_t stop_ns = (need_timestamps) ? (time_now_ns()) : (0);       /* (Only taken once per stop) */
+        if (use_auto_placement && 0 < trapped_tracee_sttid) {
+            placement_on_stop(trapped_tracee_sttid);
+        }
 
 
     /* 1.2. Check status */
         /*   -> Thread terminated */
         if (0 > trapped_tracee_sttid) {
-            fprintf(stderr, "\n+++ [%d] terminated w/ %d +++\n", -(trapped_tracee_sttid), tracee_exit_status);
+            if (use_json) {
+                json_fprint_exit(stderr, stop_ns, -(trapped_tracee_sttid), tracee_exit_status);
+            } else {
+                output_abandon_syscall((use_tracee_state) ? (tracees_get(-(trapped_tracee_sttid))) : (NULL), -(trapped_tracee_sttid));
+                output_interrupt();
+                fprintf(stderr, "\n+++ [%d] terminated w/ %d +++\n", -(trapped_tracee_sttid), tracee_exit_status);
+            }
 
-            if (-(tracee_pid) == trapped_tracee_sttid) { break; }    /* -> Thread group leader exited -> Stop tracing */
+            if (use_tracee_state) {
+                tracees_remove(-(trapped_tracee_sttid));
+            }
+            if (use_proctree) {
+                proctree_on_terminated(-(trapped_tracee_sttid), tracee_exit_status);
+            }
+
+            if (-(tracee_pid) == trapped_tracee_sttid && !attach_to_many) { break; }    /* -> Thread group leader exited -> Stop tracing */
             else {                                                   /* -> LWP in thread group exited */
                 trapped_tracee_sttid = -1;       /* NOTE: `-1` = tracee has exited (pertinent for `wait_for_trap`) */
                 continue;
@@ -168,37 +509,129 @@ int do_tracer(tracer_options_t* options) {
         /*   -> Thread stopped (i.e., hit breakpoint) */
         } else {
             struct user_regs_struct_full regs;
-            if (-1 == ptrace_get_regs_content(trapped_tracee_sttid, &regs)) {
+            STATS_TIMER_BEGIN(STATS_TIMER_GET_REGS);
+            const int get_regs_rtn = ptrace_get_regs_content(trapped_tracee_sttid, &regs);
+            STATS_TIMER_END(STATS_TIMER_GET_REGS);
+            if (-1 == get_regs_rtn) {
                 LOG_DEBUG("Couldn't read register contents -- process got probably `SIGKILL`ed");
                 trapped_tracee_sttid = -1;
                 continue;
             }
 
-            const long syscall_nr = USER_REGS_STRUCT_SC_NO(regs);
-            if (NO_SYSCALL == syscall_nr ||                                /* "Trap" was, e.g., a signal */
-                (options->syscall_subset_to_be_traced &&
-                 !(options->syscall_subset_to_be_traced[syscall_nr]))) {   /* Current "trapped" syscall shall not be traced */
+            const long syscall_nr = syscalls_get_nr_of_regs(&regs);       /* (Of task's ABI, e.g., 32-bit) */
+            if (NO_SYSCALL == syscall_nr) {                                /* "Trap" was, e.g., a signal */
+                continue;
+            }
+            if (SYSCALLS_NR_UNKNOWN == syscall_nr) {                       /* No entry in syscall table  -> Can't be decoded */
+                static bool skipping_reported = false;                     /* (Reported once, as they may be frequent, e.g., i386's `mmap2`) */
+                if (!skipping_reported) {
+                    LOG_WARN("Skipping syscalls w/o entry in syscall table, e.g., i386 specific ones (first: raw nr=%ld)",
+                             (long)USER_REGS_STRUCT_SC_NO(regs));
+                    skipping_reported = true;
+                }
+                LOG_DEBUG("Skipping syscall w/o entry in syscall table (raw nr=%ld)", (long)USER_REGS_STRUCT_SC_NO(regs));
                 continue;
             }
+            const bool* const syscall_subset = (!use_control) ? (options->syscall_subset_to_be_traced) :     /* (May be changed via control socket) */
+                                               ((control_get_config()->syscall_subset_enabled) ? (control_get_config()->syscall_subset) : (NULL));
+            const bool syscall_in_subset = !(syscall_subset && !(syscall_subset[syscall_nr]));     /* Current "trapped" syscall shall be traced ? */
 
-            const char* scall_name = NULL;
-            if (! (scall_name = syscalls_get_name(syscall_nr)) ) {
-                LOG_WARN("Unknown syscall w/ nr=%ld", syscall_nr);
-                static char fallback_generic_syscall_name[128];
-                snprintf(fallback_generic_syscall_name, sizeof(fallback_generic_syscall_name), "sys_%ld", syscall_nr);
-                scall_name = fallback_generic_syscall_name;
+            tracee_t* const tracee = (use_tracee_state) ? (tracees_get_or_add(trapped_tracee_sttid)) : (NULL);
+            long args[SYSCALL_MAX_ARGS];
+            syscalls_get_args(&regs, args);
+
+            /* Maintain fd table  (ALSO for syscalls which aren't traced) */
+            if (track_fds && USER_REGS_STRUCT_SC_HAS_RTNED(regs)) {
+                fds_update_on_syscall_exit(tracees_get_fds(tracee), trapped_tracee_sttid,
+                                           syscall_nr, args, USER_REGS_STRUCT_SC_RTNVAL(regs));
+            }
+
+            if (!syscall_in_subset) {
+                continue;
             }
 
+            const char* const scall_name = syscall_name_or_generic(syscall_nr);
+
             /* >> SYSCALL-ENTER: Print syscall-nr + -args << */
             if (!USER_REGS_STRUCT_SC_HAS_RTNED(regs)) {
                 // LOG_DEBUG("%d:: SYSCALL_ENTER ...", status_tid);
 
-                if (options->follow_fork) {
-                    fprintf(stderr, "\n[%d] ", trapped_tracee_sttid);
+                /* Governor: Shed syscalls (i.e., don't stop on their syscall-exit, which requires seccomp-BPF) */
+                if (use_governor && options->seccomp_bpf) {
+                    if (shed_syscalls[syscall_nr]) {
+                        STATS_COUNT(STATS_COUNTER_DROPPED_EVENTS, 1);
+                        tracee->seccomp_entered = false;
+                        continue;
+                    }
+                    if (syscall_nr != options->pause_on_syscall_nr &&     /* (Syscalls required for tracer's state can't be shed) */
+                        !(track_fds && fds_syscall_may_change_fds(syscall_nr))) {
+                        governor_count_syscall(syscall_nr);
+                    }
+                }
+
+                if (tracee) {
+                    tracee->syscall_discarded = tracee->syscall_deferred = tracee->syscall_unsampled = false;
+                    if (tracee->syscall_formatted_args) {
+                        free(tracee->syscall_formatted_args);
+                        tracee->syscall_formatted_args = NULL;
+                    }
+                }
+
+                /* Capture raw data (only formatted if syscall passes filters which depend on its result) */
+                if (filter || decide_on_exit || options->print_durations) {
+                    syscall_event_t* const event = &tracee->syscall_event;
+                    event->tid = trapped_tracee_sttid;
+                    event->nr = syscall_nr;
+                    memcpy(event->args, args, sizeof(args));
+                    event->enter_ns = stop_ns;
+                }
+
+                /* Discard syscalls not matching filter expression (as far as it can be evaluated yet)  (prior ANY formatting) */
+                if (filter) {
+                    const filter_result_t filter_result = filter_expr_eval(filter, &tracee->syscall_event, FILTER_FIELDS_ENTRY);
+                    if (FILTER_NO_MATCH == filter_result) {
+                        tracee->syscall_discarded = true;
+                        continue;
+                    }
+                    tracee->syscall_deferred = (FILTER_UNKNOWN == filter_result);      /* Depends on result  -> Decide (+ print) on syscall-exit */
+                }
+                if (decide_on_exit) {
+                    tracee->syscall_deferred = true;
+                }
+
+                /* Discard syscalls not matching path- / fd filters  (prior ANY formatting) */
+                if (use_path_filters &&
+                    (tracee->syscall_discarded = !path_filters_match(tracee, syscall_nr, args))) {
+                    continue;
+                }
+
+                /* Sampling: Non-sampled syscalls are only counted (if required) but never formatted  (prior reading ANY args from tracee memory) */
+                if (use_sampling && !sampling_should_sample(trapped_tracee_sttid, syscall_nr)) {
+                    STATS_COUNT(STATS_COUNTER_DROPPED_EVENTS, 1);
+                    if (!decide_on_exit) {
+                        tracee->syscall_discarded = true;
+                        continue;
+                    }
+                    tracee->syscall_unsampled = true;
+                }
+
+                /* Deferred syscalls which replace the tracee's memory (i.e., `exec`): Args can only be read now */
+                if (tracee && tracee->syscall_deferred && !tracee->syscall_unsampled && syscall_replaces_memory(syscall_nr)) {
+                    free(tracee->syscall_formatted_args);
+                    tracee->syscall_formatted_args = (use_json) ? (json_format_args(trapped_tracee_sttid, syscall_nr, args)) :
+                                                                  (format_syscall_args(trapped_tracee_sttid, syscall_nr, args));
+                }
+
+                /* Flight recorder: Keep call-site for dumps (syscall is recorded on syscall-exit) */
+                if (use_flight_recorder) {
+                    tracee->syscall_in_flight = true;
+                    tracee->syscall_ip = USER_REGS_STRUCT_IP(regs);
+                }
+
+                if (!tracee || !tracee->syscall_deferred) {
+                    print_syscall_enter(options, output_begin_syscall(tracee, trapped_tracee_sttid),
+                                        trapped_tracee_sttid, stop_ns, scall_name, syscall_nr, args, NULL);
                 }
-                fprintf(stderr, "%s(", scall_name);
-                syscalls_print_args(trapped_tracee_sttid, &regs);
-                fprintf(stderr, ")");
 
                 /* OPTIONAL: Stop (i.e., single step) if requested */
                 if (syscall_nr == options->pause_on_syscall_nr) {
@@ -209,44 +642,989 @@ int do_tracer(tracer_options_t* options) {
             } else {
                 // LOG_DEBUG("%d:: SYSCALL_EXIT ...", status_tid);
 
-                if (options->follow_fork) {      /* For task identification (in log) when following `clone`s */
-                    fprintf(stderr, "\n... [%d - %s (%d)]",
-                            trapped_tracee_sttid, scall_name, trapped_tracee_sttid);
+                if (tracee && tracee->syscall_discarded) {
+                    tracee->syscall_discarded = false;
+                    continue;
                 }
+
                 const long syscall_rtn_val = USER_REGS_STRUCT_SC_RTNVAL(regs);
-                fprintf(stderr, " = %ld\n", syscall_rtn_val);
+                bool escalation_fired = false;
+                bool resumed = false;
+                FILE* line;                 /* Stream rest of syscall's line is written to (depends on output mode) */
+
+                /* Deferred syscall: Evaluate filter (now incl. result), then print it entirely */
+                if (tracee && tracee->syscall_deferred) {
+                    tracee->syscall_deferred = tracee->syscall_in_flight = false;
+
+                    syscall_event_t* const event = &tracee->syscall_event;
+                    event->rtn_val = syscall_rtn_val;
+                    event->exit_ns = stop_ns;
+                    if (!trace_status_matches(options->trace_status, event) ||
+                        (filter && FILTER_MATCH != filter_expr_eval(filter, event, FILTER_FIELDS_EXIT))) {
+                        continue;
+                    }
+
+                    /* Cheap mode: Only count / record (w/o reading tracee memory or formatting) */
+                    if (use_summary) {
+                        summary_record(event);
+                    }
+                    if (use_proctree) {
+                        proctree_record(event);
+                    }
+                    if (use_metrics) {
+                        metrics_record(event, (options->metrics_per_process) ? (tracees_get_tgid(tracee)) : (0));
+                    }
+                    if (use_flight_recorder) {
+                        flight_recorder_record(event, tracee->syscall_ip);
+                    }
+
+                    /* Escalation: Switch to full tracing (for a window) when a trigger fires, otherwise stay cheap */
+                    if (use_escalation) {
+                        char reason[64];
+                        if ((escalation_fired = escalation_triggered(options, &escalation_triggers, event, reason, sizeof(reason)))) {
+                            if (!escalated_until_ns) {
+                                if (use_json) {
+                                    json_fprint_escalation(stderr, event->exit_ns, reason);
+                                } else {
+                                    output_interrupt();
+                                    fprintf(stderr, "\n+++ Escalating to full tracing (trigger: %s) +++\n", reason);
+                                }
+                                if (use_flight_recorder) {      /* Events leading up to trigger */
+                                    flight_recorder_dump(reason);
+                                }
+                            }
+                            escalated_until_ns = event->exit_ns + options->escalation_window_ns;     /* (Window is extended by each trigger) */
+
+                        } else if (escalated_until_ns && event->exit_ns >= escalated_until_ns) {
+                            if (use_json) {
+                                json_fprint_escalation(stderr, event->exit_ns, NULL);
+                            } else {
+                                output_interrupt();
+                                fprintf(stderr, "\n+++ Back to cheap mode +++\n");
+                            }
+                            escalated_until_ns = 0;
+                        }
+                        if (!escalated_until_ns) {
+                            continue;
+                        }
+                    } else if (summary_only || use_flight_recorder) {
+                        continue;
+                    }
+                    if (tracee->syscall_unsampled) {    /* Sampling: Only counted (+ recorded), also while escalated */
+                        continue;
+                    }
+
+                    /* JSON: Entire event is written at once (incl. stack trace) */
+                    if (use_json) {
+#ifdef WITH_STACK_UNWINDING
+                        const bool with_stack = (options->print_stacktrace || escalation_fired) && unwinding_enabled &&
+                                                (!use_control || control_get_config()->unwinding);
+#else
+                        const bool with_stack = false;
+#endif /* WITH_STACK_UNWINDING */
+                        json_fprint_syscall(stderr, tracees_get_tgid(tracee), event,
+                                            calibration_correct_duration_ns(event->exit_ns - event->enter_ns),
+                                            tracee->syscall_formatted_args, with_stack);
+                        continue;
+                    }
+
+                    line = output_begin_syscall(tracee, trapped_tracee_sttid);
+                    print_syscall_enter(options, line, trapped_tracee_sttid, event->enter_ns, scall_name, event->nr, event->args,
+                                        tracee->syscall_formatted_args);
+
+                } else {
+                    line = output_resume_syscall(tracee, trapped_tracee_sttid, scall_name, &resumed);
+                }
+                fputs(" = ", line);
+                syscalls_fprint_rtn_val(line, syscall_rtn_val);
+                if (options->record_path) {
+                    recording_record_exit(trapped_tracee_sttid, syscall_nr, syscall_rtn_val, resumed);
+                }
+
+                if (options->annotate_fds &&    /* Print path of returned fd */
+                    syscall_rtn_val >= 0 && fds_syscall_returns_fd(syscall_nr, args)) {
+                    syscalls_fprint_fd_path(line, trapped_tracee_sttid, syscall_rtn_val);
+                }
+                if (options->print_durations) {
+                    timestamps_fprint_duration(line, calibration_correct_duration_ns(stop_ns - tracee->syscall_event.enter_ns));
+                }
+                fputc('\n', line);
+                output_end_syscall(tracee);
 
 #ifdef WITH_STACK_UNWINDING
-                if (options->print_stacktrace) {
+                if ((options->print_stacktrace || escalation_fired) && unwinding_enabled &&      /* Escalation: Always unwind offending thread */
+                    (!use_control || control_get_config()->unwinding)) {
+                    STATS_TIMER_BEGIN(STATS_TIMER_UNWIND);
                     unwind_print_backtrace_of_proc(trapped_tracee_sttid);
+                    STATS_TIMER_END(STATS_TIMER_UNWIND);
                 }
 #endif /* WITH_STACK_UNWINDING */
             }
         }
 
     }
+    output_interrupt();
 
 
 /* 2. Cleanup */
+    if (use_control) {
+        control_fin();
+    }
 #ifdef WITH_STACK_UNWINDING
-    if (options->print_stacktrace) {
+    if (options->print_stacktrace || use_escalation) {
         unwind_fin();
     }
 #endif /* WITH_STACK_UNWINDING */
 
+    if (attach_to_many) {
+        attach_fin();
+    }
+
+    if (use_path_filters) {
+        path_filters_fin();
+    }
+    if (use_flight_recorder) {
+        flight_recorder_fin();
+    }
+    if (use_metrics) {
+        metrics_fin();
+    }
+    if (use_summary) {
+        fputc('\n', stderr);
+        summary_fprint(stderr);
+        summary_fin();
+    }
+    if (use_proctree) {
+        fputc('\n', stderr);
+        proctree_fprint(stderr);
+        proctree_fin();
+    }
+    if (use_sampling) {
+        if ((uses_sampling(options) || use_governor) && use_json) {
+            uint64_t sampled, seen;
+            sampling_get_counts(&sampled, &seen);
+            json_fprint_sampling(stderr, time_now_ns(), sampled, seen);
+        } else if (uses_sampling(options) || use_governor) {
+            sampling_fprint_stats(stderr);
+        }
+        sampling_fin();
+    }
+    if (options->record_path) {
+        recording_fin();
+    }
+    if (options->print_stats) {
+        fputc('\n', stderr);
+        stats_fprint(stderr);
+        stats_fin();
+    }
+    if (use_tracee_state) {
+        tracees_fin();
+    }
+
 
 /* 3. Exit  (returning exit status of thread group leader) */
-    fprintf(stderr, "+++ exited w/ %d +++\n", tracee_exit_status);
+    if (!use_json) {        /* (Already reported as exit event) */
+        fprintf(stderr, "+++ exited w/ %d +++\n", tracee_exit_status);
+    }
     return tracee_exit_status;
 }
 
 
+/*
+ * Propagates state of parent to newly created task (based on clone flags)
+ *   - Called during `PTRACE_EVENT_FORK/VFORK/CLONE` stop of parent (i.e., regs still contain the syscall args)
+ */
+static void handle_clone_event(const tracer_options_t* options, pid_t parent_tid, int ptrace_event) {
+/* 1. Get tid of new task */
+    unsigned long child_tid;
+    if (-1 == ptrace(PTRACE_GETEVENTMSG, parent_tid, 0, &child_tid)) {
+        return;
+    }
+
+/* 2. Get clone flags (`fork`/`vfork` don't share fd table) */
+    unsigned long clone_flags = 0;
+    struct user_regs_struct_full regs;
+    if (PTRACE_EVENT_CLONE == ptrace_event && -1 != ptrace_get_regs_content(parent_tid, &regs)) {
+        long args[SYSCALL_MAX_ARGS];
+        syscalls_get_args(&regs, args);
+
+        if (__SNR_clone3 == syscalls_get_nr_of_regs(&regs)) {
+            ptrace_read_word(parent_tid, args[0], &clone_flags);      /* `struct clone_args` starts w/ `__u64 flags` */
+        } else {
+            clone_flags = (unsigned long)args[0];
+        }
+    }
+
+    if (tracks_fds(options)) {
+        tracees_on_clone(parent_tid, (pid_t)child_tid, clone_flags);
+    } else if (options->control_socket) {
+        tracees_get_or_add((pid_t)child_tid);       /* (Known prior its initial stop, in case of `detach`) */
+    }
+    if (uses_proctree(options)) {
+        proctree_on_clone(parent_tid, (pid_t)child_tid, clone_flags);
+    }
+}
+
+/*
+ * Invalidates per-task state which became stale by `exec` (before the task's syscall-exit of `exec` is seen)
+ */
+static void handle_exec_event(const tracer_options_t* options, pid_t tid) {
+    unsigned long former_tid;           /* Event msg = tid prior `exec` */
+    if (-1 == ptrace(PTRACE_GETEVENTMSG, tid, 0, &former_tid)) {
+        return;
+    }
+
+    if (uses_tracee_state(options)) {
+        tracees_on_exec(tid, (pid_t)former_tid);
+    }
+    if (uses_proctree(options)) {
+        proctree_on_exec(tid, (pid_t)former_tid);
+    }
+}
+
+/*
+ * Applies request received via control socket (if any); called only between stops (i.e., w/o any tracee held stopped)
+ *   Returns whether tracer has detached from all tracees (i.e., tracing ends)
+ */
+static bool handle_control_request(const tracer_options_t* options) {
+    control_request_t* const request = control_take_request();
+    if (!request) {
+        return false;
+    }
+
+    const control_config_t* const config = control_get_config();     /* (Already the requested one) */
+    bool detached = false;
+    switch (request->command) {
+        case CONTROL_COMMAND_SET_TRACE:
+        case CONTROL_COMMAND_SET_UNWIND:
+            break;                  /* (Read from config on each stop) */
+        case CONTROL_COMMAND_SET_SAMPLE_EVERY:
+            sampling_set_every_nth(config->sample_every_nth);
+            break;
+        case CONTROL_COMMAND_SET_STRSIZE:
+#ifndef PRINT_COMPLETE_STRING_ARGS
+            ptrace_set_string_max_bytes(config->string_max_bytes);
+#endif /* PRINT_COMPLETE_STRING_ARGS */
+            break;
+        case CONTROL_COMMAND_SET_OUTPUT:
+            output_interrupt();
+            control_redirect_output(request->output_fd);
+            break;
+        case CONTROL_COMMAND_STATS:
+        {
+            bool reported = false;
+            if (options->print_stats) {
+                stats_fprint(request->reply);
+                reported = true;
+            }
+            if (options->summary) {
+                summary_fprint(request->reply);
+                reported = true;
+            }
+            if (uses_sampling(options) || options->overhead_budget_percent > 0 || config->sample_every_nth) {
+                sampling_fprint_stats(request->reply);
+                reported = true;
+            }
+            if (!reported) {
+                fputs("(nothing to report; requires --stats, -c / -C or sampling)\n", request->reply);
+            }
+        }
+            break;
+        case CONTROL_COMMAND_DETACH:
+        {
+            const int detached_count = detach_all_tasks(options);
+            fprintf(request->reply, "detached from %d tasks\n", detached_count);
+            if (OUTPUT_FORMAT_JSON != options->output_format) {
+                output_interrupt();
+                fprintf(stderr, "\n+++ Detached from %d tasks +++\n", detached_count);
+            }
+            detached = true;
+        }
+            break;
+        default:
+            break;
+    }
+
+    control_complete_request(request);
+    return detached;
+}
+
+/*
+ * Detaches from all tasks, which are all running (i.e., must be stopped first, as `PTRACE_DETACH` requires a stop)
+ *   - Seized tasks: Interrupted (`PTRACE_INTERRUPT`); detached on their next stop (signals are passed on)
+ *   - Tasks attached via `PTRACE_ATTACH`: Sent a `SIGSTOP`, which MUST be consumed prior detaching (otherwise they'd
+ *     remain stopped)  -> Continued (w/o syscall stops) until it arrives (told apart from the initial `SIGSTOP` of new
+ *     children via its sender)
+ *   - Children created meanwhile are detached on their initial stop
+ */
+static int detach_all_tasks(const tracer_options_t* options) {
+/* 1. Collect tids (tracee table can't be changed while iterating it) */
+    detach_tasks_t tasks = { NULL, 0, 0 };
+    tracees_for_each(collect_tid, &tasks);
+
+/* 2. Stop each one */
+    const bool seized = attaches_to_many(options);
+    size_t remaining = 0;
+    for (size_t i = 0; i < tasks.count; i++) {
+        const pid_t tid = tasks.entries[i].tid;
+        if (-1 == ((seized) ? (ptrace(PTRACE_INTERRUPT, tid, 0, 0)) : (syscall(SYS_tkill, tid, SIGSTOP)))) {
+            tasks.entries[i].tid = 0;       /* (Has exited meanwhile) */
+        } else {
+            tasks.entries[i].stop_sent = true;
+            remaining++;
+        }
+    }
+
+/* 3. Detach each one on its (requested / initial) stop */
+    const pid_t tracer_pid = getpid();
+    int detached_count = 0;
+    while (remaining > 0) {
+        int status;
+        const pid_t tid = waitpid(-1, &status, __WALL);
+        if (-1 == tid) {
+            if (EINTR == errno) { continue; }
+            break;                  /* (No tracees left) */
+        }
+
+        const size_t i = detach_tasks_find_or_add(&tasks, tid, &remaining);
+        if (!WIFSTOPPED(status)) {
+            tasks.entries[i].tid = 0;           /* (Has exited meanwhile) */
+            remaining--;
+            continue;
+        }
+
+        const int stopsig = WSTOPSIG(status);
+        const int ptrace_event = status >> 16;
+        siginfo_t si;
+        const bool signal_delivery_stop = (0 == ptrace_event) && (SIGTRAP | PTRACE_TRAP_INDICATOR_BIT) != stopsig &&
+                                          -1 != ptrace(PTRACE_GETSIGINFO, tid, 0, &si);     /* (Fails for group-stops) */
+        if (PTRACE_EVENT_FORK == ptrace_event || PTRACE_EVENT_VFORK == ptrace_event || PTRACE_EVENT_CLONE == ptrace_event) {
+            unsigned long child_tid;
+            if (-1 != ptrace(PTRACE_GETEVENTMSG, tid, 0, &child_tid)) {
+                detach_tasks_find_or_add(&tasks, (pid_t)child_tid, &remaining);
+            }
+
+
+        } else if (seized || (signal_delivery_stop && SIGSTOP == stopsig &&
+                              (!tasks.entries[i].stop_sent || (SI_TKILL == si.si_code && tracer_pid == si.si_pid) ||
+                               (is_initial_stop(stopsig, &si) && !sigstop_pending(tid))))) {     /* (Ours was merged into the initial one) */
+            const int forwarded_signal = (seized && signal_delivery_stop) ? (stopsig) : (0);
+            if (-1 != ptrace(PTRACE_DETACH, tid, 0, forwarded_signal)) {
+                detached_count++;
+            }
+            tasks.entries[i].tid = 0;
+            remaining--;
+            continue;
+        }
+        ptrace(PTRACE_CONT, tid, 0, (signal_delivery_stop && !is_initial_stop(stopsig, &si)) ? (stopsig) : (0));
+    }
+
+    free(tasks.entries);
+    return detached_count;
+}
+
+static void collect_tid(tracee_t* tracee, void* ctx) {
+    size_t remaining = 0;
+    detach_tasks_find_or_add(ctx, tracee->tid, &remaining);
+}
+
+static size_t detach_tasks_find_or_add(detach_tasks_t* tasks, pid_t tid, size_t* remaining) {
+    for (size_t i = 0; i < tasks->count; i++) {
+        if (tid == tasks->entries[i].tid) {
+            return i;
+        }
+    }
+
+    if (tasks->count == tasks->capacity) {
+        tasks->capacity = (tasks->capacity) ? (tasks->capacity * 2) : (16);
+        tasks->entries = DIE_WHEN_ERRNO_VPTR( realloc(tasks->entries, tasks->capacity * sizeof(*tasks->entries)) );
+    }
+    tasks->entries[tasks->count].tid = tid;
+    tasks->entries[tasks->count].stop_sent = false;
+    (*remaining)++;
+    return tasks->count++;
+}
+
+/*
+ * Installs seccomp-BPF prefilter in calling process (= tracee), so that only syscalls which may be
+ * printed (or are required for maintaining the tracer's state) stop the tracee  (or are notified, w/ seccomp-notif backend)
+ */
+static void install_seccomp_bpf(const tracer_options_t* options) {
+    const bool user_notif = (TRACE_BACKEND_SECCOMP_NOTIF == options->backend);
+    static bool required_syscalls[SYSCALLS_ARR_SIZE];
+    for (long nr = 0; nr < SYSCALLS_ARR_SIZE; nr++) {
+        required_syscalls[nr] = (nr == options->pause_on_syscall_nr) ||
+                                (tracks_fds(options) && fds_syscall_may_change_fds(nr)) ||
+                                (user_notif && syscall_replaces_memory(nr));
+    }
+
+    const seccomp_bpf_spec_t spec = {
+        .syscall_subset = options->syscall_subset_to_be_traced,
+        .only_fd_or_path_syscalls = uses_path_filters(options),
+        .filter = options->filter,
+        .required_syscalls = required_syscalls,
+        .user_notif = user_notif
+    };
+    seccomp_bpf_install(&spec);
+}
+
+/*
+ * Seizes all threads of the specified processes + all tasks in the cgroup (when attaching to many)
+ */
+static void attach_to_all_tasks(const tracer_options_t* options) {
+    attach_init(ptrace_options_of(options), options->attach_cgroup);
+
+    int seized_count = 0;
+    for (int i = 0; i < options->attach_pids_count; i++) {
+        const int process_seized_count = attach_process(options->attach_pids[i]);
+        if (-1 == process_seized_count) {
+            LOG_WARN("Couldn't attach to process %d", options->attach_pids[i]);
+        } else {
+            seized_count += process_seized_count;
+        }
+    }
+    if (options->attach_cgroup) {
+        const int cgroup_seized_count = attach_cgroup_scan();
+        if (-1 == cgroup_seized_count) {
+            LOG_WARN("Couldn't read tasks of cgroup \"%s\"", options->attach_cgroup);
+        } else {
+            seized_count += cgroup_seized_count;
+        }
+    }
+    if (!seized_count) {
+        LOG_ERROR_AND_DIE("Couldn't attach to any task");
+    }
+}
+
+static int ptrace_options_of(const tracer_options_t* options) {
+    return PTRACE_O_TRACESYSGOOD
+           | ( (options->follow_fork) ? (PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK | PTRACE_O_TRACEVFORK) : (0))
+           | ( (options->seccomp_bpf) ? (PTRACE_O_TRACESECCOMP) : (0))
+           | ( (uses_tracee_state(options)) ? (PTRACE_O_TRACEEXEC) : (0))        /* (Invalidates per-task state) */
+           | ( (uses_proctree(options)) ? (PTRACE_O_TRACEEXEC | PTRACE_O_TRACEEXIT) : (0));
+}
+
+static bool attaches_to_many(const tracer_options_t* options) {
+    return (options->attach_pids_count > 1 || options->attach_cgroup);
+}
+
+/* Whether lines are prefixed w/ the tid (i.e., whether there may be multiple tracees) */
+static bool tags_tids(const tracer_options_t* options) {
+    return (options->follow_fork || attaches_to_many(options));
+}
+
+static bool uses_proctree(const tracer_options_t* options) {      /* Summary is also aggregated per process + executable */
+    return (options->summary && tags_tids(options));
+}
+
+static bool uses_path_filters(const tracer_options_t* options) {
+    return (options->trace_path_prefixes_count > 0 || options->trace_fds_count > 0);
+}
+
+static bool tracks_fds(const tracer_options_t* options) {
+    return (options->annotate_fds || uses_path_filters(options));
+}
+
+static bool uses_tracee_state(const tracer_options_t* options) {
+    return (tracks_fds(options) || options->filter || options->seccomp_bpf || attaches_to_many(options) ||
+            TRACE_STATUS_ALL != options->trace_status || options->flight_recorder_size > 0 ||
+            options->summary || uses_escalation(options) || uses_sampling(options) ||
+            options->print_durations || OUTPUT_MODE_COMPLETE == options->output_mode ||
+            OUTPUT_FORMAT_JSON == options->output_format || options->metrics_interval_ns > 0 ||
+            options->overhead_budget_percent > 0 ||     /* (Governor may enable sampling) */
+            options->control_socket);      /* (Control socket: Tasks to detach from) */
+}
+
+static bool uses_escalation(const tracer_options_t* options) {
+    return (options->escalation_latency_ns > 0 || options->escalation_trigger_syscalls ||
+            options->escalation_trigger_errnos_count > 0);
+}
+
+static bool uses_sampling(const tracer_options_t* options) {
+    return (options->sample_every_nth > 0 || options->sample_burst_per_window > 0 ||
+            options->sample_every_nth_thread > 0);
+}
+
+/*
+ * Checks whether (completed) syscall is slower than the latency threshold or matches an escalation trigger
+ */
+static bool escalation_triggered(const tracer_options_t* options, const triggers_t* triggers,
+                                 const syscall_event_t* event, char* reason, size_t reason_size) {
+    const uint64_t duration_ns = calibration_correct_duration_ns(event->exit_ns - event->enter_ns);
+    if (options->escalation_latency_ns && duration_ns >= options->escalation_latency_ns) {
+        const char* const scall_name = syscalls_get_name(event->nr);
+        if (scall_name) {
+            snprintf(reason, reason_size, "%s took %.6fs", scall_name, (double)duration_ns / 1e9);
+        } else {
+            snprintf(reason, reason_size, "sys_%ld took %.6fs", event->nr, (double)duration_ns / 1e9);
+        }
+        return true;
+    }
+    return triggers_match(triggers, event, reason, reason_size);
+}
+
+static bool trace_status_matches(trace_status_t trace_status, const syscall_event_t* event) {
+    switch (trace_status) {
+        case TRACE_STATUS_FAILED:     return 0 != syscall_event_errno(event);
+        case TRACE_STATUS_SUCCESSFUL: return 0 == syscall_event_errno(event);
+        case TRACE_STATUS_ALL:
+        default:                      return true;
+    }
+}
+
+/*
+ * Checks whether delivering `sig` will terminate the tracee, i.e., it's neither ignored nor caught
+ * (based on `SigIgn` / `SigCgt` in `/proc/<tid>/status`) and its default action isn't to ignore or stop
+ */
+static bool signal_is_fatal(pid_t tid, int sig) {
+    switch (sig) {
+        case SIGCHLD: case SIGCONT: case SIGURG:  case SIGWINCH:
+        case SIGSTOP: case SIGTSTP: case SIGTTIN: case SIGTTOU:
+            return false;
+        default:
+            break;
+    }
+
+    char status_path[64];
+    snprintf(status_path, sizeof(status_path), "/proc/%d/status", tid);
+    FILE* status_file;
+    if (! (status_file = fopen(status_path, "r")) ) {
+        return true;                /* (Tracee is probably about to vanish anyways) */
+    }
+
+    unsigned long long handled_sigs = 0, sigs;
+    char line[128];
+    while (fgets(line, sizeof(line), status_file)) {
+        if (1 == sscanf(line, "SigIgn: %llx", &sigs) ||
+            1 == sscanf(line, "SigCgt: %llx", &sigs)) {
+            handled_sigs |= sigs;
+        }
+    }
+    fclose(status_file);
+
+    return !(handled_sigs & (1ULL << (sig - 1)));
+}
+
+/*
+ * Whether signal-delivery stop is the initial `SIGSTOP` of a child auto-attached (w/o `PTRACE_SEIZE`), which is
+ * queued by the kernel w/o sender (unlike, e.g., a `kill -STOP`)
+ */
+static bool is_initial_stop(int sig, const siginfo_t* si) {
+    return (SIGSTOP == sig && SI_USER == si->si_code && 0 == si->si_pid);
+}
+
+/*
+ * Whether a `SIGSTOP` is pending for thread `tid` (based on `SigPnd` in `/proc/<tid>/status`)
+ */
+static bool sigstop_pending(pid_t tid) {
+    char status_path[64];
+    snprintf(status_path, sizeof(status_path), "/proc/%d/status", tid);
+    FILE* status_file;
+    if (! (status_file = fopen(status_path, "r")) ) {
+        return false;
+    }
+
+    unsigned long long pending_sigs = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), status_file) && 1 != sscanf(line, "SigPnd: %llx", &pending_sigs)) { }
+    fclose(status_file);
+
+    return (pending_sigs & (1ULL << (SIGSTOP - 1)));
+}
+
+static bool syscall_replaces_memory(long syscall_nr) {
+    return (__SNR_execve == syscall_nr || __SNR_execveat == syscall_nr);
+}
+
+static char* format_syscall_args(pid_t tid, long syscall_nr, const long args[SYSCALL_MAX_ARGS]) {
+    char* formatted_args = NULL;
+    size_t formatted_args_size;
+    FILE* const stream = DIE_WHEN_ERRNO_VPTR( open_memstream(&formatted_args, &formatted_args_size) );
+    STATS_COUNT(STATS_COUNTER_ALLOCS, 1);
+    syscalls_fprint_args(stream, tid, syscall_nr, args);
+    fclose(stream);
+    return formatted_args;
+}
+
+static void print_syscall_enter(const tracer_options_t* options, FILE* stream, pid_t tid, uint64_t timestamp_ns,
+                                const char* scall_name, long syscall_nr, const long args[SYSCALL_MAX_ARGS],
+                                const char* formatted_args) {
+    if (tags_tids(options)) {       /* (Lines are only left unterminated in interleaved mode) */
+        fprintf(stream, (OUTPUT_MODE_INTERLEAVED == options->output_mode) ? ("\n[%d] ") : ("[%d] "), tid);
+    }
+    if (TIMESTAMPS_NONE != options->timestamps || options->relative_timestamps) {
+        timestamps_fprint(stream, timestamp_ns);
+    }
+    fprintf(stream, "%s(", scall_name);
+    if (options->record_path) {
+        recording_capture_begin();
+    }
+    if (formatted_args) {
+        fputs(formatted_args, stream);
+    } else {
+        syscalls_fprint_args(stream, tid, syscall_nr, args);
+    }
+    fputc(')', stream);
+    if (options->record_path) {
+        recording_record_enter(tid, syscall_nr, args, formatted_args);
+    }
+}
+
 static void wait_for_user_input(void) {
     int c;
     while ('\n' != (c = getchar()) && EOF != c) { }     /* Wait until user presses enter to continue */
 }
 
-static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status) {  /* NOTEs: 'bp' = breakpoint; Reports only 'trap events' which are due to termination or stops caused by syscall's */
+static const char* syscall_name_or_generic(long syscall_nr) {
+    const char* scall_name = NULL;
+    if (! (scall_name = syscalls_get_name(syscall_nr)) ) {
+        LOG_WARN("Unknown syscall w/ nr=%ld", syscall_nr);
+        static char fallback_generic_syscall_name[128];
+        snprintf(fallback_generic_syscall_name, sizeof(fallback_generic_syscall_name), "sys_%ld", syscall_nr);
+        scall_name = fallback_generic_syscall_name;
+    }
+    return scall_name;
+}
+
+
+/* - perf backend - */
+/*
+ * Option which requires tracees to stop (e.g., for reading their memory) or the ptrace event loop (`NULL` = none)
+ */
+static const char* perf_unsupported_option(const tracer_options_t* options) {
+    if (options->daemonize) { return "-D"; }
+    if (attaches_to_many(options)) { return "multiple -p / --cgroup"; }
+    if (options->annotate_fds) { return "-y"; }
+    if (uses_path_filters(options)) { return "-P / --fd"; }
+    if (-1 != options->pause_on_syscall_nr) { return "-n / -a"; }
+    if (options->seccomp_bpf) { return "--seccomp-bpf"; }
+    if (options->flight_recorder_size > 0) { return "--flight-recorder"; }
+    if (options->record_path) { return "--record"; }
+    if (uses_sampling(options) || options->overhead_budget_percent > 0) { return "sampling / --overhead-budget"; }
+    if (uses_escalation(options)) { return "--escalate-*"; }
+    if (OUTPUT_FORMAT_JSON == options->output_format) { return "--format=json"; }
+    if (options->metrics_interval_ns > 0) { return "--interval"; }
+    if (options->control_socket) { return "--control-socket"; }
+#ifdef WITH_STACK_UNWINDING
+    if (options->print_stacktrace) { return "-k"; }
+#endif /* WITH_STACK_UNWINDING */
+    return NULL;
+}
+
+/*
+ * Tracing w/ perf backend (events have already been opened): Tracees never stop, their syscall events are consumed
+ * from the perf ring buffers + fed into the same filters, summary + formatting as those of the ptrace backend
+ *   Syscalls are printed entirely on syscall-exit (those which never return, e.g., `exit_group`, as unfinished)
+ */
+static int do_perf_tracer(const tracer_options_t* options) {
+    const pid_t tracee_pid = options->tracee_pid;
+
+/* 0. Setup */
+    /* Let tracee (which stopped itself prior `exec`) continue w/o ptrace */
+    if (!options->attach_to_tracee) {
+        int tracee_status;
+        do {
+            DIE_WHEN_ERRNO( waitpid(tracee_pid, &tracee_status, 0) );
+        } while (!WIFSTOPPED(tracee_status));
+        DIE_WHEN_ERRNO( ptrace(PTRACE_DETACH, tracee_pid, 0, 0) );
+    }
+
+    syscalls_set_payload_decoding(false);       /* Tracee's memory changes while it runs  -> Args are printed raw */
+    if (TIMESTAMPS_NONE != options->timestamps || options->relative_timestamps) {
+        timestamps_init(options->timestamps, options->relative_timestamps);
+    }
+    if (options->summary) {
+        summary_init();
+    }
+    if (TRACER_PLACEMENT_PINNED == options->tracer_placement) {
+        placement_init(options->tracer_placement, options->tracer_cpus);
+    }
+    if (options->calibrate_durations || TRACER_PLACEMENT_AUTO == options->tracer_placement) {
+        LOG_WARN("--calibrate / --tracer-cpu=auto have no effect w/ perf backend (tracees don't stop)");
+    }
+
+/* 1. Consume events (in timestamp order) until tracee exits */
+    int tracee_exit_status = -1;
+    for (bool tracee_exited = false; !tracee_exited; ) {
+        tracee_exited = perf_tracee_exited(options, &tracee_exit_status);
+
+        perf_backend_event_t* events;
+        const size_t events_count = perf_backend_read(&events, PERF_POLL_TIMEOUT_MS, tracee_exited);     /* (Flush once exited) */
+        for (size_t i = 0; i < events_count; i++) {
+            handle_perf_event(options, &events[i]);
+        }
+    }
+    tracees_for_each(print_perf_unfinished, (void*)options);
+    fprintf(stderr, "\n+++ [%d] terminated w/ %d +++\n", tracee_pid, tracee_exit_status);
+
+/* 2. Cleanup */
+    const uint64_t lost_events = perf_backend_lost_events();
+    perf_backend_close();
+    if (lost_events) {
+        fprintf(stderr, "+++ %llu events lost (ring buffers overran) +++\n", (unsigned long long)lost_events);
+    }
+    if (options->summary) {
+        fputc('\n', stderr);
+        summary_fprint(stderr);
+        summary_fin();
+    }
+    if (options->print_stats) {
+        fputc('\n', stderr);
+        stats_fprint(stderr);
+        stats_fin();
+    }
+    tracees_fin();
+
+/* 3. Exit  (returning exit status of tracee) */
+    fprintf(stderr, "+++ exited w/ %d +++\n", tracee_exit_status);
+    return tracee_exit_status;
+}
+
+static bool perf_tracee_exited(const tracer_options_t* options, int* exit_status) {
+    /* Attached (i.e., not our child): Exit status isn't available */
+    if (options->attach_to_tracee) {
+        return -1 == kill(options->tracee_pid, 0) && ESRCH == errno;
+    }
+
+    int tracee_status;
+    if (options->tracee_pid != DIE_WHEN_ERRNO( waitpid(options->tracee_pid, &tracee_status, WNOHANG) )) {
+        return false;
+    }
+    if (WIFEXITED(tracee_status)) {
+        *exit_status = WEXITSTATUS(tracee_status);
+    } else if (WIFSIGNALED(tracee_status)) {
+        *exit_status = WTERMSIG(tracee_status);
+    }
+    return WIFEXITED(tracee_status) || WIFSIGNALED(tracee_status);
+}
+
+static void handle_perf_event(const tracer_options_t* options, const perf_backend_event_t* perf_event) {
+    const syscall_event_t* const raw_event = &perf_event->event;
+    tracee_t* const tracee = tracees_get_or_add(raw_event->tid);
+    syscall_event_t* const event = &tracee->syscall_event;
+
+/* >> SYSCALL-ENTER: Keep raw data (printed on syscall-exit) << */
+    if (PERF_BACKEND_SYS_ENTER == perf_event->type) {
+        if (tracee->syscall_deferred) {         /* Previous syscall never returned (e.g., `exit`) */
+            print_perf_unfinished(tracee, (void*)options);
+        }
+        const bool syscall_in_subset = (raw_event->nr >= 0 && raw_event->nr < SYSCALLS_ARR_SIZE) &&
+                                       !(options->syscall_subset_to_be_traced && !(options->syscall_subset_to_be_traced[raw_event->nr]));
+        if (!syscall_in_subset) {
+            return;
+        }
+        *event = *raw_event;
+        tracee->syscall_deferred = !(options->filter &&
+                                     FILTER_NO_MATCH == filter_expr_eval(options->filter, event, FILTER_FIELDS_ENTRY));
+        return;
+    }
+
+/* >> SYSCALL-EXIT: Evaluate filters (now incl. result), count + print syscall entirely << */
+    if (!tracee->syscall_deferred || event->nr != raw_event->nr) {      /* (Not traced, or entered prior tracing started) */
+        return;
+    }
+    tracee->syscall_deferred = false;
+    event->rtn_val = raw_event->rtn_val;
+    event->exit_ns = raw_event->exit_ns;
+    if (!trace_status_matches(options->trace_status, event) ||
+        (options->filter && FILTER_MATCH != filter_expr_eval(options->filter, event, FILTER_FIELDS_EXIT))) {
+        return;
+    }
+
+    if (options->summary) {
+        summary_record(event);
+        if (!options->summary_with_output) {
+            return;
+        }
+    }
+    print_syscall_enter(options, stderr, event->tid, event->enter_ns, syscall_name_or_generic(event->nr), event->nr, event->args, NULL);
+    fputs(" = ", stderr);
+    syscalls_fprint_rtn_val(stderr, event->rtn_val);
+    if (options->print_durations) {
+        timestamps_fprint_duration(stderr, event->exit_ns - event->enter_ns);
+    }
+    fputc('\n', stderr);
+}
+
+static void print_perf_unfinished(tracee_t* tracee, void* ctx) {
+    const tracer_options_t* const options = ctx;
+    if (!tracee->syscall_deferred) {
+        return;
+    }
+    tracee->syscall_deferred = false;
+
+    const syscall_event_t* const event = &tracee->syscall_event;
+    if (TRACE_STATUS_ALL != options->trace_status ||       /* (Result unknown  -> Can't match filters depending on it) */
+        (options->filter && FILTER_MATCH != filter_expr_eval(options->filter, event, FILTER_FIELDS_ENTRY)) ||
+        (options->summary && !options->summary_with_output)) {
+        return;
+    }
+    print_syscall_enter(options, stderr, event->tid, event->enter_ns, syscall_name_or_generic(event->nr), event->nr, event->args, NULL);
+    fputs(" = ?\n", stderr);
+}
+
+
+/* - seccomp-notif backend - */
+/*
+ * Option which requires syscall results, tracee state or the ptrace event loop (`NULL` = none)
+ */
+static const char* seccomp_notif_unsupported_option(const tracer_options_t* options) {
+    if (options->attach_to_tracee) { return "-p / --cgroup"; }
+    if (options->daemonize) { return "-D"; }
+    if (options->print_durations) { return "-T"; }
+    if (options->summary) { return "-c / -C"; }
+    if (TRACE_STATUS_ALL != options->trace_status) { return "-z / -Z"; }
+    if (options->annotate_fds) { return "-y"; }
+    if (uses_path_filters(options)) { return "-P / --fd"; }
+    if (-1 != options->pause_on_syscall_nr) { return "-n / -a"; }
+    if (options->filter && (options->filter->used_fields & ~FILTER_FIELDS_ENTRY)) { return "--filter on rval / errno / duration"; }
+    if (options->seccomp_bpf) { return "--seccomp-bpf"; }
+    if (options->flight_recorder_size > 0) { return "--flight-recorder"; }
+    if (options->record_path) { return "--record"; }
+    if (uses_sampling(options) || options->overhead_budget_percent > 0) { return "sampling / --overhead-budget"; }
+    if (uses_escalation(options)) { return "--escalate-*"; }
+    if (options->print_stats) { return "--stats"; }
+    if (OUTPUT_FORMAT_JSON == options->output_format) { return "--format=json"; }
+    if (options->metrics_interval_ns > 0) { return "--interval"; }
+    if (options->control_socket) { return "--control-socket"; }
+#ifdef WITH_STACK_UNWINDING
+    if (options->print_stacktrace) { return "-k"; }
+#endif /* WITH_STACK_UNWINDING */
+    return NULL;
+}
+
+/*
+ * Tracing w/ seccomp-notif backend: Tracees are never ptrace'd; the syscalls selected by the tracee's filter are received
+ * by `options->notif_workers` threads (in parallel), which read + format their args while the notifying task is blocked
+ * in the syscall + then continue it  -> Syscalls are printed on syscall-enter only (i.e., w/o result)
+ */
+static int do_seccomp_notif_tracer(const tracer_options_t* options) {
+    const pid_t tracee_pid = options->tracee_pid;
+
+/* 0. Setup */
+    ptrace_set_read_via_vm_readv(true);
+    if (TIMESTAMPS_NONE != options->timestamps || options->relative_timestamps) {
+        timestamps_init(options->timestamps, options->relative_timestamps);
+    }
+    if (TRACER_PLACEMENT_PINNED == options->tracer_placement) {
+        placement_init(options->tracer_placement, options->tracer_cpus);
+    }
+    if (options->calibrate_durations || TRACER_PLACEMENT_AUTO == options->tracer_placement) {
+        LOG_WARN("--calibrate / --tracer-cpu=auto have no effect w/ seccomp-notif backend (tracees don't stop)");
+    }
+
+    /* NOTE: No `SA_RESTART`, so that a blocking `SECCOMP_IOCTL_NOTIF_RECV` is interrupted */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = wake_up_notif_worker;
+    sigemptyset(&sa.sa_mask);
+    DIE_WHEN_ERRNO( sigaction(NOTIF_WAKE_UP_SIGNAL, &sa, NULL) );
+
+/* 1. Handle notifications (in parallel) until all tracees have exited */
+    if (-1 == seccomp_notif_open(tracee_pid)) {
+        LOG_WARN("Tracee exited before installing its seccomp filter");
+    } else {
+        notif_workers.options = options;
+        notif_workers.threads_count = options->notif_workers;
+        notif_workers.threads = DIE_WHEN_ERRNO_VPTR( calloc(notif_workers.threads_count, sizeof(*notif_workers.threads)) );
+        notif_workers.running_count = notif_workers.threads_count;
+        notif_workers.done = false;
+
+        notif_workers.threads[0] = pthread_self();
+        for (unsigned i = 1; i < notif_workers.threads_count; i++) {
+            if (pthread_create(&notif_workers.threads[i], NULL, seccomp_notif_worker, NULL)) {
+                LOG_ERROR_AND_DIE("Couldn't create notification worker");
+            }
+        }
+        seccomp_notif_worker(NULL);         /* (Main thread is a worker too) */
+
+        /* Wake up workers still blocked in receiving  (wake-up is repeated, as it's lost when sent right before they block) */
+        const struct timespec wake_up_interval = { .tv_sec = 0, .tv_nsec = NOTIF_WAKE_UP_INTERVAL_NS };
+        while (__atomic_load_n(&notif_workers.running_count, __ATOMIC_ACQUIRE)) {
+            for (unsigned i = 1; i < notif_workers.threads_count; i++) {
+                pthread_kill(notif_workers.threads[i], NOTIF_WAKE_UP_SIGNAL);
+            }
+            nanosleep(&wake_up_interval, NULL);
+        }
+        for (unsigned i = 1; i < notif_workers.threads_count; i++) {
+            pthread_join(notif_workers.threads[i], NULL);
+        }
+        free(notif_workers.threads);
+        notif_workers.threads = NULL;
+        seccomp_notif_close();
+    }
+
+    int tracee_status, tracee_exit_status = -1;
+    DIE_WHEN_ERRNO( waitpid(tracee_pid, &tracee_status, 0) );
+    if (WIFEXITED(tracee_status)) {
+        tracee_exit_status = WEXITSTATUS(tracee_status);
+    } else if (WIFSIGNALED(tracee_status)) {
+        tracee_exit_status = WTERMSIG(tracee_status);
+    }
+    fprintf(stderr, "\n+++ [%d] terminated w/ %d +++\n", tracee_pid, tracee_exit_status);
+
+/* 2. Cleanup */
+    signal(NOTIF_WAKE_UP_SIGNAL, SIG_DFL);
+    ptrace_set_read_via_vm_readv(false);
+
+/* 3. Exit  (returning exit status of tracee) */
+    fprintf(stderr, "+++ exited w/ %d +++\n", tracee_exit_status);
+    return tracee_exit_status;
+}
+
+static void* seccomp_notif_worker(void* ctx) {
+    (void)ctx;
+
+    while (!__atomic_load_n(&notif_workers.done, __ATOMIC_ACQUIRE)) {
+        seccomp_notif_event_t notif;
+        switch (seccomp_notif_recv(&notif)) {
+            case SECCOMP_NOTIF_RECEIVED:
+                handle_seccomp_notif(notif_workers.options, &notif);
+                break;
+            case SECCOMP_NOTIF_DONE:
+                __atomic_store_n(&notif_workers.done, true, __ATOMIC_RELEASE);
+                break;
+            case SECCOMP_NOTIF_RETRY:
+            default:
+                break;
+        }
+    }
+
+    __atomic_sub_fetch(&notif_workers.running_count, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void handle_seccomp_notif(const tracer_options_t* options, const seccomp_notif_event_t* notif) {
+    const syscall_event_t* const event = &notif->event;
+
+/* 0. Filters  (notified syscalls are a superset: `exec` is always notified + filter may not have been fully pushed down) */
+    const bool syscall_in_subset = (event->nr >= 0 && event->nr < SYSCALLS_ARR_SIZE) &&
+                                   !(options->syscall_subset_to_be_traced && !(options->syscall_subset_to_be_traced[event->nr]));
+    const bool print = syscall_in_subset &&
+                       !(options->filter && FILTER_MATCH != filter_expr_eval(options->filter, event, FILTER_FIELDS_ENTRY));
+
+/* 1. Read + format args while task is blocked in syscall  (discarded, if it died meanwhile, as its tid may have been reused) */
+    char* const formatted_args = (print) ? (format_syscall_args(event->tid, event->nr, event->args)) : (NULL);
+    const bool notif_valid = seccomp_notif_id_valid(notif->id);
+
+/* 2. Continue syscall  (prior printing, so that tracee isn't held up by output) */
+    seccomp_notif_continue(notif->id);
+
+/* 3. Print (entry-only) */
+    if (formatted_args && notif_valid) {
+        pthread_mutex_lock(&notif_workers.output_lock);
+        print_syscall_enter(options, stderr, event->tid, event->enter_ns, syscall_name_or_generic(event->nr), event->nr, event->args, formatted_args);
+        pthread_mutex_unlock(&notif_workers.output_lock);
+    }
+    free(formatted_args);
+}
+
+static void wake_up_notif_worker(int sig) {
+    (void)sig;
+}
+
+static int set_bp_and_wait_for_trap(const tracer_options_t* options,
+                                    pid_t next_bp_tid, int *exit_status) {  /* NOTEs: 'bp' = breakpoint; Reports only 'trap events' which are due to termination or stops caused by syscall's */
 
     for (int pending_signal = 0; ; ) {
     /* (0) Restart stopped tracee but set next breakpoint (on next syscall)   (AND "forward" received signal to tracee) */
@@ -266,9 +1644,18 @@ static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status) {  /* N
          *                         At this point, the signal is NOT YET delivered to the process, and can be
          *                         suppressed by the tracer. If the tracer doesn't suppress the signal, it
          *                         passes the signal to the tracee in the next ptrace restart request.
+         *
+         *     - seccomp-BPF:      Syscall-enter-stops are replaced by `PTRACE_EVENT_SECCOMP` stops (only for syscalls
+         *                         for which the filter returned `SECCOMP_RET_TRACE`)  -> Tracee is restarted w/ `PTRACE_CONT`,
+         *                         except after such a stop (to get the corresponding syscall-exit-stop)
          */
         if (-1 != next_bp_tid) {        /* `-1` = Wait only  (-> don't set breakpoint when prior trapped tracee terminated) */
-            DIE_WHEN_ERRNO( ptrace(PTRACE_SYSCALL, next_bp_tid, 0, pending_signal) );
+            if (options->overhead_budget_percent > 0) {
+                governor_stop_end();
+            }
+            const int restart_request = (options->seccomp_bpf && !tracees_get_or_add(next_bp_tid)->seccomp_entered) ?
+                                            (PTRACE_CONT) : (PTRACE_SYSCALL);
+            DIE_WHEN_ERRNO( ptrace(restart_request, next_bp_tid, 0, pending_signal) );
         }
 
         /* Reset signal (after it has been delivered) */
@@ -281,7 +1668,38 @@ static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status) {  /* N
          *               See also https://kernelnewbies.kernelnewbies.narkive.com/9Zd9eWeb/waitpid-2-and-clone-thread
          */
         int trapped_tracee_status;
-        const pid_t trapped_tracee_tid = DIE_WHEN_ERRNO( waitpid(-1, &trapped_tracee_status, __WALL) );
+        pid_t trapped_tracee_tid;
+        bool detached = (options->control_socket && handle_control_request(options));     /* (No tracee is held stopped now) */
+        STATS_TIMER_BEGIN(STATS_TIMER_WAITPID);
+        while (!detached && -1 == (trapped_tracee_tid = wait_for_any_tracee(options, &trapped_tracee_status))) {
+            if (ECHILD == errno && attaches_to_many(options)) {
+                if (!options->attach_cgroup || attach_cgroup_scan() <= 0) {
+                    return 0;                    /* >>>   No tracees left (all attached tasks have exited) */
+                }
+                continue;
+            }
+            if (EINTR != errno) {
+                LOG_ERROR_AND_DIE("`waitpid` failed -- %s", strerror(errno));
+            }
+            if (options->flight_recorder_size > 0) {       /* Interrupted by `SIGUSR2` (e.g., all tracees stalled) */
+                flight_recorder_dump_if_requested();
+            }
+            if (options->attach_cgroup) {                  /* Interrupted by `SIGALRM` (poll interval elapsed) */
+                attach_cgroup_scan_if_requested();
+            }
+            if (options->control_socket) {                 /* Interrupted by `CONTROL_WAKE_UP_SIGNAL` */
+                detached = handle_control_request(options);
+            }
+        }
+        STATS_TIMER_END(STATS_TIMER_WAITPID);
+        if (detached) {
+            *exit_status = 0;            /* (Tracees continue running) */
+            return 0;                    /* >>>   No tracees left (detached from all) */
+        }
+        STATS_COUNT(STATS_COUNTER_STOPS, 1);
+        if (options->overhead_budget_percent > 0) {     /* Tracer's cost per stop = time until tracee is restarted */
+            governor_stop_begin();
+        }
 
 
     /* (2) Check tracee's process status */
@@ -313,6 +1731,9 @@ static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status) {  /* N
              *                (due to by tracer set `PTRACE_O_TRACESYSGOOD` option))
              */
             if ((SIGTRAP | PTRACE_TRAP_INDICATOR_BIT) == stopsig) {
+                if (options->seccomp_bpf) {
+                    tracees_get_or_add(trapped_tracee_tid)->seccomp_entered = false;
+                }
                 return trapped_tracee_tid;       /* >>>   Tracee was stopped (indicated by positive returned tid; only possible stop reason here: due to syscall breakpoint) */
 
             /* (II) `PTRACE_EVENT_xxx` stops
@@ -320,7 +1741,24 @@ static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status) {  /* N
              *                 `WSTOPSIG(status)` returns `SIGTRAP`)
              */
             } else if (SIGTRAP == stopsig) {
-                // ... Check for ptrace-events here ...
+                /* ELUCIDATION:
+                 *   - Event is encoded in bits 16-23 of status, i.e., `status>>8 == (SIGTRAP | (PTRACE_EVENT_xxx<<8))`
+                 */
+                const int ptrace_event = trapped_tracee_status >> 16;
+                if (PTRACE_EVENT_SECCOMP == ptrace_event) {         /* Replaces syscall-enter-stop when using seccomp-BPF */
+                    tracees_get_or_add(trapped_tracee_tid)->seccomp_entered = true;
+                    return trapped_tracee_tid;
+                }
+                if ((tracks_fds(options) || uses_proctree(options) || options->control_socket) &&
+                    (PTRACE_EVENT_FORK == ptrace_event || PTRACE_EVENT_VFORK == ptrace_event || PTRACE_EVENT_CLONE == ptrace_event)) {
+                    handle_clone_event(options, trapped_tracee_tid, ptrace_event);
+                } else if (PTRACE_EVENT_EXEC == ptrace_event) {
+                    handle_exec_event(options, trapped_tracee_tid);
+                } else if (PTRACE_EVENT_EXIT == ptrace_event && uses_proctree(options)) {
+                    proctree_on_exit(trapped_tracee_tid);
+                }
+                // ... Check for other ptrace-events here ...
+                /* (`PTRACE_EVENT_STOP` of seized tasks (`PTRACE_INTERRUPT`, new children) -> Simply restarted) */
 
             /* (III) Group-stops
              *    ELUCIDATION:
@@ -331,10 +1769,26 @@ static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status) {  /* N
             } else if (ptrace(PTRACE_GETSIGINFO, trapped_tracee_tid, 0, &si) < 0) {
                 // ...
 
-            /* (IV) Signal-delivery stops */
+            /* (IV) Initial `SIGSTOP` of children auto-attached to a tracee attached w/o `PTRACE_SEIZE`
+             *      -> Suppressed (delivering it would put the child into a group-stop, which persists (e.g., once detached)) */
+            } else if (is_initial_stop(stopsig, &si)) {
+                // ...
+
+            /* (V) Signal-delivery stops */
             } else {
-                fprintf(stderr, "\n+++ [%d] received (not delivered yet) signal \"%s\" +++\n", trapped_tracee_tid, strsignal(stopsig));
+                if (OUTPUT_FORMAT_JSON == options->output_format) {
+                    json_fprint_signal(stderr, time_now_ns(), trapped_tracee_tid, stopsig);
+                } else {
+                    output_interrupt();
+                    fprintf(stderr, "\n+++ [%d] received (not delivered yet) signal \"%s\" +++\n", trapped_tracee_tid, strsignal(stopsig));
+                }
                 pending_signal = stopsig;
+
+                if (options->flight_recorder_size > 0 && signal_is_fatal(trapped_tracee_tid, stopsig)) {
+                    char trigger[64];
+                    snprintf(trigger, sizeof(trigger), "signal %s", strsignal(stopsig));
+                    flight_recorder_dump(trigger);
+                }
             }
 
 
@@ -354,3 +1808,19 @@ static int set_bp_and_wait_for_trap(pid_t next_bp_tid, int *exit_status) {  /* N
         }
     }
 }
+
+/*
+ * `waitpid`(2) for any tracee -- w/ cgroup poll signal unblocked meanwhile (interrupts it, but NO other blocking call)
+ */
+static pid_t wait_for_any_tracee(const tracer_options_t* options, int* status) {
+    if (!options->attach_cgroup) {
+        return waitpid(-1, status, __WALL);
+    }
+
+    attach_cgroup_set_poll_signal_unblocked(true);
+    const pid_t tid = waitpid(-1, status, __WALL);
+    const int wait_errno = errno;
+    attach_cgroup_set_poll_signal_unblocked(false);
+    errno = wait_errno;
+    return tid;
+}
@@ -2,17 +2,119 @@
 #define TRACING_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 
+/* -- Type declarations -- */
+struct filter_expr ;
+
+
 /* -- Types -- */
+typedef enum {
+  TRACE_STATUS_ALL,
+  TRACE_STATUS_FAILED,          /* Only syscalls which returned an error */
+  TRACE_STATUS_SUCCESSFUL       /* Only syscalls which didn't return an error */
+} trace_status_t;
+
+typedef enum {
+  TIMESTAMPS_NONE,
+  TIMESTAMPS_TIME,              /* `-t`:   `HH:MM:SS` */
+  TIMESTAMPS_TIME_US,           /* `-tt`:  `HH:MM:SS.uuuuuu` */
+  TIMESTAMPS_EPOCH_US           /* `-ttt`: Seconds since epoch (`sssssssss.uuuuuu`) */
+} timestamps_format_t;
+
+typedef enum {
+  TRACE_BACKEND_PTRACE,
+  TRACE_BACKEND_PERF,           /* `raw_syscalls` tracepoints via `perf_event_open` (tracees never stop; falls back to ptrace) */
+  TRACE_BACKEND_SECCOMP_NOTIF   /* seccomp user notifications (launched programs only; entry-only; falls back to ptrace) */
+} trace_backend_t;
+
+typedef enum {
+  OUTPUT_FORMAT_TEXT,
+  OUTPUT_FORMAT_JSON            /* NDJSON: One object per event (see `internal/json.h`) */
+} output_format_t;
+
+typedef enum {
+  OUTPUT_MODE_INTERLEAVED,      /* Syscall-enter + -exit are written when they happen (exit on own `... [tid - name (tid)]` line w/ -f) */
+  OUTPUT_MODE_COMPLETE,         /* One line per syscall, written at once on syscall-exit */
+  OUTPUT_MODE_STRACE            /* Like strace: `<unfinished ...>` / `<... name resumed>` only when another task's output interleaves */
+} output_mode_t;
+
+typedef enum {
+  METRICS_FORMAT_OPENMETRICS,   /* OpenMetrics text exposition (terminated by `# EOF`) */
+  METRICS_FORMAT_JSON           /* One JSON object per snapshot (see `internal/metrics.h`) */
+} metrics_format_t;
+
+typedef enum {
+  OUTPUT_COMPRESSION_NONE,
+  OUTPUT_COMPRESSION_ZSTD,      /* Requires build w/ libzstd (`WITH_ZSTD`) */
+  OUTPUT_COMPRESSION_LZ4        /* Requires build w/ liblz4 (`WITH_LZ4`) */
+} output_compression_t;
+
+typedef enum {
+  TRACER_PLACEMENT_NONE,        /* Tracer runs wherever the scheduler puts it */
+  TRACER_PLACEMENT_PINNED,      /* `--tracer-cpu=<cpu>` / `--tracer-affinity=<cpu_list>` */
+  TRACER_PLACEMENT_AUTO         /* `--tracer-cpu=auto`: Follows LLC of CPUs tracees last ran on */
+} tracer_placement_t;
+
 typedef struct {
+  trace_backend_t backend;
+  unsigned notif_workers;                       /* Threads receiving seccomp notifications (seccomp-notif backend) */
   pid_t tracee_pid;
   bool attach_to_tracee;
+  const pid_t* attach_pids;                     /* `-p` (multiple = all are traced until every one has exited) */
+  int attach_pids_count;
+  const char* attach_cgroup;                    /* `--cgroup`: Trace all tasks of cgroup (`NULL` = none) */
   long pause_on_syscall_nr;
   const bool* syscall_subset_to_be_traced;
   bool follow_fork;
   bool daemonize;
+  bool annotate_fds;
+  timestamps_format_t timestamps;
+  bool relative_timestamps;                     /* `-r` (overrides `timestamps`) */
+  bool print_durations;                         /* `-T` */
+  output_format_t output_format;
+  output_mode_t output_mode;
+  bool calibrate_durations;                     /* Subtract ptrace stop round-trip from `-T` durations */
+  tracer_placement_t tracer_placement;
+  const bool* tracer_cpus;                      /* `bool[CPU_UTILS_MAX_CPUS]`; CPUs tracer may run on (`NULL` = all) */
+  const char* const* trace_path_prefixes;
+  int trace_path_prefixes_count;
+  const int* trace_fds;
+  int trace_fds_count;
+  const struct filter_expr* filter;
+  trace_status_t trace_status;
+  bool seccomp_bpf;
+  size_t flight_recorder_size;                  /* `0` = disabled */
+  const bool* flight_recorder_trigger_syscalls;
+  const int* flight_recorder_trigger_errnos;
+  int flight_recorder_trigger_errnos_count;
+  const char* flight_recorder_binary_path;      /* `NULL` = dump as text */
+  bool summary;                                 /* Count syscalls (instead of printing them) */
+  bool summary_with_output;                     /* Count syscalls in addition to printing them */
+  bool print_stats;                             /* Self-instrumentation of tracer */
+  const char* record_path;                      /* `NULL` = don't record */
+  unsigned sample_every_nth;                    /* `0` = disabled (same for all `sample_xxx`) */
+  unsigned sample_burst_per_window;
+  unsigned sample_every_nth_thread;
+  double overhead_budget_percent;               /* `0` = governor disabled */
+  uint64_t escalation_latency_ns;               /* `0` = disabled */
+  const bool* escalation_trigger_syscalls;      /* `NULL` = none */
+  const int* escalation_trigger_errnos;
+  int escalation_trigger_errnos_count;
+  uint64_t escalation_window_ns;
+  uint64_t metrics_interval_ns;                 /* `--interval` (`0` = no periodic metrics snapshots) */
+  metrics_format_t metrics_format;
+  const char* metrics_output;                   /* `NULL` = `stderr`; `unix:<path>` = UNIX socket */
+  bool metrics_per_process;
+  bool metrics_cumulative;                      /* Snapshots report totals since start (otherwise: only last interval) */
+  const char* control_socket;                   /* `NULL` = no control socket */
+  const char* output_path;                      /* `-o` (`NULL` = `stderr`) */
+  uint64_t output_rotate_size;                  /* `0` = no size-based rotation */
+  uint64_t output_rotate_interval_ns;           /* `0` = no time-based rotation */
+  unsigned output_rotate_keep;                  /* Max. nr of files (incl. current one) */
+  output_compression_t output_compression;
 #ifdef WITH_STACK_UNWINDING
   bool print_stacktrace;
 #endif /* WITH_STACK_UNWINDING */
@@ -20,6 +122,8 @@ typedef struct {
 
 
 /* -- Function prototypes -- */
+void tracing_select_backend(tracer_options_t* options);
+
 int do_tracee(int argc, char** argv,
               tracer_options_t* options);
 int do_tracer(tracer_options_t* options);